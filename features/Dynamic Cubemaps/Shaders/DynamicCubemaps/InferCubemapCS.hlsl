@@ -8,6 +8,11 @@ RWTexture2DArray<float4> EnvInferredTexture : register(u0);
 
 SamplerState LinearSampler : register(s0);
 
+cbuffer InferData : register(b0)
+{
+	uint Face;
+}
+
 // Calculate normalized sampling direction vector based on current fragment coordinates.
 // This is essentially "inverse-sampling": we reconstruct what the sampling vector would be if we wanted it to "hit"
 // this particular fragment in a cubemap.
@@ -46,8 +51,9 @@ float3 GetSamplingVector(uint3 ThreadID, in RWTexture2DArray<float4> OutputTextu
 	return normalize(result);
 }
 
-[numthreads(8, 8, 1)] void main(uint3 ThreadID
+[numthreads(8, 8, 1)] void main(uint3 DispatchThreadID
 								: SV_DispatchThreadID) {
+	uint3 ThreadID = uint3(DispatchThreadID.xy, Face);
 	float3 uv = GetSamplingVector(ThreadID, EnvInferredTexture);
 	float4 color = EnvCaptureTexture.SampleLevel(LinearSampler, uv, 0);
 
@@ -3,77 +3,54 @@
 
 // Pre-filters environment cube map using GGX NDF importance sampling.
 // Part of specular IBL split-sum approximation.
+// Samples are importance sampled on the CPU (PrefilterSamples.cpp), every scheduled face mip is filtered in one dispatch.
 
-static const float PI = 3.141592;
-static const float TwoPI = 2 * PI;
 static const float Epsilon = 0.00001;
 
 static const uint NumSamples = 16;
-static const float InvNumSamples = 1.0 / float(NumSamples);
 
-cbuffer SpecularMapFilterSettings : register(b0)
-{
-	float roughness;
-};
-
-TextureCube inputTexture : register(t0);
-RWTexture2DArray<float4> outputTexture : register(u0);
-
-SamplerState linear_wrap_sampler : register(s0);
+#define MIPLEVELS 8
+#define MAX_ITEMS (6 * (MIPLEVELS - 1))
 
-// Compute Van der Corput radical inverse
-// See: http://holger.dammertz.org/stuff/notes_HammersleyOnHemisphere.html
-float radicalInverse_VdC(uint bits)
+struct PrefilterItem
 {
-	bits = (bits << 16u) | (bits >> 16u);
-	bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
-	bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
-	bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
-	bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
-	return float(bits) * 2.3283064365386963e-10;  // / 0x100000000
-}
+	uint face;
+	uint mip;
+	uint firstGroup;  // of the flattened dispatch
+	uint size;        // of the face at this mip
+};
 
-// Sample i-th point from Hammersley point set of NumSamples points total.
-float2 sampleHammersley(uint i)
+cbuffer SpecularMapFilterSettings : register(b0)
 {
-	return float2(i * InvNumSamples, radicalInverse_VdC(i));
-}
+	PrefilterItem Items[MAX_ITEMS];
+	uint ItemCount;
+};
 
-// Importance sample GGX normal distribution function for a fixed roughness value.
-// This returns normalized half-vector between Li & Lo.
-// For derivation see: http://blog.tobias-franke.eu/2014/03/30/notes_on_importance_sampling.html
-float3 sampleGGX(float u1, float u2, float roughness)
+cbuffer SpecularSampleTable : register(b1)
 {
-	float alpha = roughness * roughness;
-
-	float cosTheta = sqrt((1.0 - u2) / (1.0 + (alpha * alpha - 1.0) * u2));
-	float sinTheta = sqrt(1.0 - cosTheta * cosTheta);  // Trig. identity
-	float phi = TwoPI * u1;
+	float4 Samples[(MIPLEVELS - 1) * NumSamples];  // tangent space half vector, source mip
+	uint4 MipSampleCounts[MIPLEVELS - 1];
+};
 
-	// Convert to Cartesian upon return.
-	return float3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
-}
+TextureCube inputTexture : register(t0);
 
-// GGX/Towbridge-Reitz normal distribution function.
-// Uses Disney's reparametrization of alpha = roughness^2.
-float ndfGGX(float cosLh, float roughness)
-{
-	float alpha = roughness * roughness;
-	float alphaSq = alpha * alpha;
+// UAV arrays can't be indexed dynamically
+RWTexture2DArray<float4> outputMip1 : register(u0);
+RWTexture2DArray<float4> outputMip2 : register(u1);
+RWTexture2DArray<float4> outputMip3 : register(u2);
+RWTexture2DArray<float4> outputMip4 : register(u3);
+RWTexture2DArray<float4> outputMip5 : register(u4);
+RWTexture2DArray<float4> outputMip6 : register(u5);
+RWTexture2DArray<float4> outputMip7 : register(u6);
 
-	float denom = (cosLh * cosLh) * (alphaSq - 1.0) + 1.0;
-	return alphaSq / (PI * denom * denom);
-}
+SamplerState linear_wrap_sampler : register(s0);
 
 // Calculate normalized sampling direction vector based on current fragment coordinates.
 // This is essentially "inverse-sampling": we reconstruct what the sampling vector would be if we wanted it to "hit"
 // this particular fragment in a cubemap.
-float3 getSamplingVector(uint3 ThreadID)
+float3 getSamplingVector(uint3 ThreadID, float outputSize)
 {
-	float outputWidth, outputHeight, outputDepth;
-	outputTexture.GetDimensions(outputWidth, outputHeight, outputDepth);
-
-	float2 st = ThreadID.xy / float2(outputWidth, outputHeight);
+	float2 st = ThreadID.xy / outputSize;
 	float2 uv = 2.0 * float2(st.x, 1.0 - st.y) - 1.0;
 
 	// Select vector based on cubemap face index.
@@ -128,26 +105,28 @@ float3 Lin2sRGB(float3 color)
 	return color > 0.0031308 ? 1.055 * pow(color, 1.0 / 2.4) - 0.055 : 12.92 * color;
 }
 
-[numthreads(8, 8, 1)] void main(uint3 ThreadID
-								: SV_DispatchThreadID) {
-	// Make sure we won't write past output when computing higher mipmap levels.
-	uint outputWidth, outputHeight, outputDepth;
-	outputTexture.GetDimensions(outputWidth, outputHeight, outputDepth);
-	if (ThreadID.x >= outputWidth || ThreadID.y >= outputHeight) {
-		return;
+[numthreads(8, 8, 1)] void main(uint3 GroupID
+								: SV_GroupID, uint3 GroupThreadID
+								: SV_GroupThreadID) {
+	// all scheduled face mips share one dispatch, find the one this group belongs to
+	uint itemIndex = 0;
+	for (uint item = 1; item < ItemCount; item++) {
+		if (GroupID.x >= Items[item].firstGroup)
+			itemIndex = item;
 	}
+	PrefilterItem prefilterItem = Items[itemIndex];
 
-	// Get input cubemap dimensions at zero mipmap level.
-	float inputWidth, inputHeight, inputLevels;
-	inputTexture.GetDimensions(0, inputWidth, inputHeight, inputLevels);
+	uint groupsPerRow = (prefilterItem.size + 7) / 8;
+	uint localGroup = GroupID.x - prefilterItem.firstGroup;
+	uint3 ThreadID = uint3(uint2(localGroup % groupsPerRow, localGroup / groupsPerRow) * 8 + GroupThreadID.xy, prefilterItem.face);
 
-	// Solid angle associated with a single cubemap texel at zero mipmap level.
-	// This will come in handy for importance sampling below.
-	float wt = 4.0 * PI / (6 * inputWidth * inputHeight);
+	// Make sure we won't write past output when computing higher mipmap levels.
+	if (ThreadID.x >= prefilterItem.size || ThreadID.y >= prefilterItem.size) {
+		return;
+	}
 
 	// Approximation: Assume zero viewing angle (isotropic reflections).
-	float3 N = getSamplingVector(ThreadID);
-	float3 Lo = N;
+	float3 N = getSamplingVector(ThreadID, prefilterItem.size);
 
 	float3 S, T;
 	computeBasisVectors(N, S, T);
@@ -157,35 +136,43 @@ float3 Lin2sRGB(float3 color)
 
 	// Convolve environment map using GGX NDF importance sampling.
 	// Weight by cosine term since Epic claims it generally improves quality.
-	for (uint i = 0; i < NumSamples; ++i) {
-		float2 u = sampleHammersley(i);
-		float3 Lh = tangentToWorld(sampleGGX(u.x, u.y, roughness), N, S, T);
-
-		// Compute incident direction (Li) by reflecting viewing direction (Lo) around half-vector (Lh).
-		float3 Li = 2.0 * dot(Lo, Lh) * Lh - Lo;
-
-		float cosLi = dot(N, Li);
-		if (cosLi > 0.0) {
-			// Use Mipmap Filtered Importance Sampling to improve convergence.
-			// See: https://developer.nvidia.com/gpugems/GPUGems3/gpugems3_ch20.html, section 20.4
-
-			float cosLh = max(dot(N, Lh), 0.0);
-
-			// GGX normal distribution function (D term) probability density function.
-			// Scaling by 1/4 is due to change of density in terms of Lh to Li (and since N=V, rest of the scaling factor cancels out).
-			float pdf = ndfGGX(cosLh, roughness) * 0.25;
-
-			// Solid angle associated with this sample.
-			float ws = 1.0 / (NumSamples * pdf);
-
-			// Mip level to sample from.
-			float mipLevel = max(0.5 * log2(ws / wt) + 1.0, 0.0);
-
-			color += sRGB2Lin(inputTexture.SampleLevel(linear_wrap_sampler, Li, mipLevel).rgb) * cosLi;
-			weight += cosLi;
-		}
+	uint sampleOffset = (prefilterItem.mip - 1) * NumSamples;
+	uint sampleCount = MipSampleCounts[prefilterItem.mip - 1].x;
+	for (uint i = 0; i < sampleCount; ++i) {
+		float4 prefilterSample = Samples[sampleOffset + i];
+		float3 Lh = tangentToWorld(prefilterSample.xyz, N, S, T);
+
+		// Compute incident direction (Li) by reflecting viewing direction (Lo = N) around half-vector (Lh).
+		float3 Li = 2.0 * dot(N, Lh) * Lh - N;
+		float cosLi = 2.0 * prefilterSample.z * prefilterSample.z - 1.0;
+
+		color += sRGB2Lin(inputTexture.SampleLevel(linear_wrap_sampler, Li, prefilterSample.w).rgb) * cosLi;
+		weight += cosLi;
 	}
 	color /= weight;
 
-	outputTexture[ThreadID] = float4(Lin2sRGB(color), 1.0);
+	float4 output = float4(Lin2sRGB(color), 1.0);
+	switch (prefilterItem.mip) {
+	case 1:
+		outputMip1[ThreadID] = output;
+		break;
+	case 2:
+		outputMip2[ThreadID] = output;
+		break;
+	case 3:
+		outputMip3[ThreadID] = output;
+		break;
+	case 4:
+		outputMip4[ThreadID] = output;
+		break;
+	case 5:
+		outputMip5[ThreadID] = output;
+		break;
+	case 6:
+		outputMip6[ThreadID] = output;
+		break;
+	default:
+		outputMip7[ThreadID] = output;
+		break;
+	}
 }
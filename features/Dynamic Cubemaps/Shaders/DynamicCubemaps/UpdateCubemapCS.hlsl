@@ -54,6 +54,7 @@ cbuffer UpdateData : register(b1)
 {
 	uint Reset;
 	float3 CameraPreviousPosAdjust2;
+	uint Face;
 }
 
 bool IsSaturated(float value) { return value == saturate(value); }
@@ -79,8 +80,11 @@ float smoothbumpstep(float edge0, float edge1, float x)
 	return x * x * (3.0 - x - x);
 }
 
-[numthreads(8, 8, 1)] void main(uint3 ThreadID
+[numthreads(8, 8, 1)] void main(uint3 DispatchThreadID
 								: SV_DispatchThreadID) {
+	// one face per dispatch, faces are scheduled individually
+	uint3 ThreadID = uint3(DispatchThreadID.xy, Face);
+
 	float3 captureDirection = -GetSamplingVector(ThreadID, DynamicCubemap);
 	float3 viewDirection = WorldToView(captureDirection, false);
 	float2 uv = ViewToUV(viewDirection, false);
@@ -7,6 +7,30 @@ cbuffer GrassCollisionPerFrame : register(b5)
 {
 	CollisionData collisionData[256];
 	uint numCollisions;
+	uint useField;
+	float fieldSize;
+	float pad0;
+	float4 fieldOffset[2];  // xy wrap a position relative to the eye onto the field, z is the eye height
+}
+
+#if defined(VSHADER)
+Texture2D<float4> TexDisplacementField : register(t8);
+SamplerState SampDisplacementField : register(s8);
+
+// Vertical distance from the bending collisions over which the displacement fades out.
+// The field only has room for one height per texel, so collisions bend a disc of their radius instead of the sphere
+// of the direct mode, and the bend fades linearly with the distance to their weighted height.
+static const float FieldHeightRange = 128.0;
+
+float3 GetFieldDisplacement(float3 worldPosition, uint eyeIndex)
+{
+	float4 field = TexDisplacementField.SampleLevel(SampDisplacementField, (worldPosition.xy + fieldOffset[eyeIndex].xy) / fieldSize, 0);
+	if (field.z <= 0.0)
+		return 0.0;
+
+	float height = field.w / field.z;
+	float heightFade = 1.0 - saturate(abs(worldPosition.z + fieldOffset[eyeIndex].z - height) / FieldHeightRange);
+	return float3(field.xy, -length(field.xy)) * heightFade;
 }
 
 float3 GetDisplacedPosition(float3 position, float alpha, uint eyeIndex = 0)
@@ -14,6 +38,9 @@ float3 GetDisplacedPosition(float3 position, float alpha, uint eyeIndex = 0)
 	float3 worldPosition = mul(World[eyeIndex], float4(position, 1.0)).xyz;
 
 	if (length(worldPosition) < 1024.0 && alpha > 0.0) {
+		if (useField)
+			return GetFieldDisplacement(worldPosition, eyeIndex) * alpha;
+
 		float3 displacement = 0.0;
 
 		for (uint i = 0; i < numCollisions; i++) {
@@ -30,3 +57,4 @@ float3 GetDisplacedPosition(float3 position, float alpha, uint eyeIndex = 0)
 
 	return 0.0;
 }
+#endif
@@ -0,0 +1,52 @@
+#include "GrassCollision.hlsli"
+
+cbuffer FieldCB : register(b0)
+{
+	int2 Origin;          // first cell of the window
+	int2 PreviousOrigin;  // first cell of the window at the last update
+	float2 OriginOffset;  // corner of the first cell relative to the eye
+	float Decay;          // fraction of the displacement kept since the last update
+	float EyeHeight;
+};
+
+RWTexture2D<float4> FieldRW : register(u0);
+
+int2 PositiveModulo(int2 value, int divisor)
+{
+	return ((value % divisor) + divisor) % divisor;
+}
+
+// Each texel holds the horizontal displacement, the strongest bend weight, and the height of the bending collisions times that weight
+[numthreads(8, 8, 1)] void main(uint2 texel
+								: SV_DispatchThreadID) {
+	int2 index = PositiveModulo(int2(texel) - Origin, FIELD_RESOLUTION);
+	int2 cell = Origin + index;
+
+	// a cell that just scrolled in finds whatever the cell on the opposite side left behind
+	bool kept = all(cell >= PreviousOrigin) && all(cell < PreviousOrigin + FIELD_RESOLUTION);
+	float4 field = kept ? FieldRW[texel] * Decay : 0.0;
+	if (field.z < 1e-3)
+		field = 0.0;
+
+	float2 position = OriginOffset + (index + 0.5) * FIELD_CELL_SIZE;
+
+	float2 displacement = 0.0;
+	float weight = 0.0;
+	float height = 0.0;
+	float heightWeight = 0.0;
+	for (uint i = 0; i < numCollisions; i++) {
+		float3 centre = collisionData[i].centre[0].xyz;
+		float2 direction = position - centre.xy;
+		float power = 1.0 - saturate(length(direction) / collisionData[i].centre[0].w);
+		displacement += power * direction;
+		weight = max(weight, power);
+		height += power * centre.z;
+		heightWeight += power;
+	}
+
+	// fresh bends replace fading trails that are weaker
+	if (weight > field.z)
+		field = float4(displacement, weight, (height / heightWeight + EyeHeight) * weight);
+
+	FieldRW[texel] = field;
+}
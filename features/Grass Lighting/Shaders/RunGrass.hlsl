@@ -500,10 +500,10 @@ PS_OUTPUT main(PS_INPUT input, bool frontFace
 
 	psout.Specular = float4(specularColor, 1);
 	psout.Albedo = float4(albedo, 1);
-	psout.Masks = float4(0, 0, 0, 0);
+	psout.Masks = EncodeMasks(0, 0, 0, 0);
 
 	float3 normalVS = normalize(WorldToView(normal, false, eyeIndex));
-	psout.NormalGlossiness = float4(EncodeNormal(normalVS), specColor.w, 1);
+	psout.NormalGlossiness = EncodeNormalGlossiness(normalVS, specColor.w, 1);
 #	endif  // RENDER_DEPTH
 	return psout;
 }
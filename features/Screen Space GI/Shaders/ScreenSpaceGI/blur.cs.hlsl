@@ -28,7 +28,7 @@ static const float3 g_Poisson8[8] = {
 
 [numthreads(8, 8, 1)] void main(const uint2 dtid
 								: SV_DispatchThreadID) {
-	const float2 frameScale = FrameDim * RcpTexDim;
+	const float2 frameScale = FrameDim * BufferDim.zw;
 
 	float radius = BlurRadius;
 #ifdef TEMPORAL_DENOISER
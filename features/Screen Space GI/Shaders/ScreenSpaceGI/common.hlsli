@@ -24,36 +24,26 @@
 
 cbuffer SSGICB : register(b1)
 {
-	float4x4 PrevInvViewMat[2];
-	float4 NDCToViewMul;
-	float4 NDCToViewAdd;
-
-	float2 TexDim;
-	float2 RcpTexDim;
-	float2 FrameDim;
-	float2 RcpFrameDim;
-
-	uint FrameIndex;
-
 	uint NumSlices;
 	uint NumSteps;
 	float DepthMIPSamplingOffset;
+	uint UpdateInterval;  // shade one in this many pixels per frame
 
 	float EffectRadius;
 	float EffectFalloffRange;
 	float ThinOccluderCompensation;
 	float Thickness;
+
 	float2 DepthFadeRange;
 	float DepthFadeScaleConst;
-
 	float BackfaceStrength;
+
 	float GIBounceFade;
 	float GIDistanceCompensation;
 	float GICompensationMaxDist;
-
 	float AOPower;
-	float GIStrength;
 
+	float GIStrength;
 	float DepthDisocclusion;
 	float NormalDisocclusion;
 	uint MaxAccumFrames;
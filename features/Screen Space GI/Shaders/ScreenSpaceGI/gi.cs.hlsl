@@ -72,7 +72,7 @@ void CalculateGI(
 	uint2 dtid, float2 uv, float viewspaceZ, float3 viewspaceNormal,
 	out float4 o_currGIAO, out float3 o_bentNormal)
 {
-	const float2 frameScale = FrameDim * RcpTexDim;
+	const float2 frameScale = FrameDim * BufferDim.zw;
 
 	uint eyeIndex = GetEyeIndexFromTexCoord(uv);
 	float2 normalizedScreenPos = ConvertFromStereoUV(uv, eyeIndex);
@@ -98,7 +98,7 @@ void CalculateGI(
 
 	//////////////////////////////////////////////////////////////////
 
-	const float2 localNoise = SpatioTemporalNoise(dtid, FrameIndex);
+	const float2 localNoise = SpatioTemporalNoise(dtid, FrameCountAlwaysActive);
 	const float noiseSlice = localNoise.x;
 	const float noiseStep = localNoise.y;
 
@@ -339,13 +339,17 @@ void CalculateGI(
 
 [numthreads(8, 8, 1)] void main(const uint2 dtid
 								: SV_DispatchThreadID) {
-	const float2 frameScale = FrameDim * RcpTexDim;
+	const float2 frameScale = FrameDim * BufferDim.zw;
 
 	uint2 pxCoord = dtid;
-#if defined(HALF_RATE)
-	const uint halfWidth = uint(FrameDim.x) >> 1;
-	const bool useHistory = dtid.x >= halfWidth;
-	pxCoord.x = (pxCoord.x % halfWidth) * 2 + (dtid.y + FrameIndex + useHistory) % 2;
+#if defined(INTERLEAVED)
+	// the dispatch is split into UpdateInterval column ranges, only the first one shades and the rest keep history
+	const uint rangeWidth = (uint(FrameDim.x) + UpdateInterval - 1) / UpdateInterval;
+	const uint range = dtid.x / rangeWidth;
+	const bool useHistory = range != 0;
+	pxCoord.x = (pxCoord.x % rangeWidth) * UpdateInterval + (dtid.y + FrameCountAlwaysActive + range) % UpdateInterval;
+	if (range >= UpdateInterval || pxCoord.x >= uint(FrameDim.x))
+		return;
 #else
 	const static bool useHistory = false;
 #endif
@@ -380,7 +384,7 @@ void CalculateGI(
 
 #ifdef TEMPORAL_DENOISER
 		float lerpFactor = rcp(srcAccumFrames[pxCoord] * 255);
-#	if defined(HALF_RATE)
+#	if defined(INTERLEAVED)
 		if (useHistory && lerpFactor != 1)
 			lerpFactor = 0;
 #	endif
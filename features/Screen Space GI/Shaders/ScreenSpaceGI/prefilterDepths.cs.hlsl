@@ -60,7 +60,7 @@ groupshared float g_scratchDepths[8][8];
 [numthreads(8, 8, 1)] void main(uint2 dispatchThreadID
 								: SV_DispatchThreadID, uint2 groupThreadID
 								: SV_GroupThreadID) {
-	const float2 frameScale = FrameDim * RcpTexDim;
+	const float2 frameScale = FrameDim * BufferDim.zw;
 
 	// MIP 0
 	const uint2 baseCoord = dispatchThreadID;
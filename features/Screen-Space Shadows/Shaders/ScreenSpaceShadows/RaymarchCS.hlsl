@@ -7,20 +7,26 @@ Texture2D<unorm half> DepthTexture : register(t0);     // Depth Buffer Texture (
 RWTexture2D<unorm half> OutputTexture : register(u0);  // Output screen-space shadow buffer (typically single-channel, 8bit)
 SamplerState PointBorderSampler : register(s0);        // A point sampler, with Wrap Mode set to Clamp-To-Border-Color (D3D12_TEXTURE_ADDRESS_MODE_BORDER), and Border Color set to "FarDepthValue" (typically zero), or some other far-depth value out of DepthBounds.
 													   // If you have issues where invalid shadows are appearing from off-screen, it is likely that this sampler is not correctly setup
+#define MAX_DISPATCHES 8
+
 cbuffer PerFrame : register(b1)
 {
-	// Runtime data returned from BuildDispatchList():
-	float4 LightCoordinate;  // Values stored in DispatchList::LightCoordinate_Shader by BuildDispatchList()
-	int2 WaveOffset;         // Values stored in DispatchData::WaveOffset_Shader by BuildDispatchList()
-
-	// Renderer Specific Values:
-	float FarDepthValue;   // Set to the Depth Buffer Value for the far clip plane, as determined by renderer projection matrix setup (typically 0).
-	float NearDepthValue;  // Set to the Depth Buffer Value for the near clip plane, as determined by renderer projection matrix setup (typically 1).
+	// Runtime data from BendDispatchCache:
+	float4 LightCoordinate;             // Values stored in DispatchList::LightCoordinate_Shader by BuildDispatchList()
+	int4 Dispatches[MAX_DISPATCHES];  // Wave offset in xy, first merged group in z, groups along y in w, for each dispatch of BuildDispatchList()
 
 	// Sampling data:
 	float2 InvDepthTextureSize;  // Inverse of the texture dimensions for 'DepthTexture' (used to convert from pixel coordinates to UVs)
 								 // If 'PointBorderSampler' is an Unnormalized sampler, then this value can be hard-coded to 1.
 								 // The 'USE_HALF_PIXEL_OFFSET' macro might need to be defined if sampling at exact pixel coordinates isn't precise (e.g., if odd patterns appear in the shadow).
+
+	// Renderer Specific Values:
+	float FarDepthValue;   // Set to the Depth Buffer Value for the far clip plane, as determined by renderer projection matrix setup (typically 0).
+	float NearDepthValue;  // Set to the Depth Buffer Value for the near clip plane, as determined by renderer projection matrix setup (typically 1).
+
+	uint DispatchCount;
+	uint3 pad0;
+
 	float SurfaceThickness;
 	float BilinearThreshold;
 	float ShadowContrast;
@@ -31,11 +37,20 @@ cbuffer PerFrame : register(b1)
 	: SV_GroupID,
 	int groupThreadID
 	: SV_GroupThreadID) {
+	// The dispatches are stacked along y, find the one this group belongs to
+	uint dispatchIndex = 0;
+	[unroll] for (uint i = 1; i < MAX_DISPATCHES; i++)
+		dispatchIndex += (i < DispatchCount && groupID.y >= Dispatches[i].z) ? 1 : 0;
+
+	int4 dispatch = Dispatches[dispatchIndex];
+	int group = groupID.y - dispatch.z;
+	groupID = int3(groupID.x, group % dispatch.w, group / dispatch.w);
+
 	DispatchParameters parameters;
 	parameters.SetDefaults();
 
 	parameters.LightCoordinate = LightCoordinate;
-	parameters.WaveOffset = WaveOffset;
+	parameters.WaveOffset = dispatch.xy;
 	parameters.FarDepthValue = 1;
 	parameters.NearDepthValue = 0;
 	parameters.InvDepthTextureSize = InvDepthTextureSize;
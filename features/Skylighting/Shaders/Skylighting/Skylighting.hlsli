@@ -14,7 +14,7 @@ struct SkylightingSettings
 	float4 MixParams;  // x: min diffuse visibility, y: diffuse mult, z: min specular visibility, w: specular mult
 
 	uint DirectionalDiffuse;
-	float3 _pad1;
+	float3 OcclusionPosOffset;  // camera movement since the occlusion map was captured
 };
 
 #endif
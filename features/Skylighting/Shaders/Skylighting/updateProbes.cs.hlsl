@@ -11,6 +11,7 @@ cbuffer SkylightingCB : register(b1)
 };
 
 Texture2D<unorm float> srcOcclusionDepth : register(t0);
+StructuredBuffer<uint> brickList : register(t1);  // x | y << 8 | z << 16, bricks selected by the CPU scheduler
 
 RWTexture3D<sh2> outProbeArray : register(u0);
 RWTexture3D<uint> outAccumFramesArray : register(u1);
@@ -19,10 +20,17 @@ SamplerState samplerPointClamp : register(s0);
 
 #define ARRAY_DIM uint3(128, 128, 64)
 #define ARRAY_SIZE float3(10000, 10000, 10000 * 0.5)
+#define BRICK_SIZE 8
 
-[numthreads(8, 8, 1)] void main(uint3 dtid
-								: SV_DispatchThreadID) {
+// one group per brick slice: x is the brick list index, z the slice within the brick
+[numthreads(BRICK_SIZE, BRICK_SIZE, 1)] void main(uint3 gid
+												  : SV_GroupID, uint3 gtid
+												  : SV_GroupThreadID) {
 	const static float fadeInThreshold = 64;
+
+	const uint packedBrick = brickList[gid.x];
+	const uint3 brick = uint3(packedBrick & 0xFF, (packedBrick >> 8) & 0xFF, packedBrick >> 16);
+	const uint3 dtid = brick * BRICK_SIZE + uint3(gtid.xy, gid.z);
 	const static sh2 unitSH = shEvaluate(float3(0, 0, 1));
 
 	uint3 cellID = (int3(dtid) - settings.ArrayOrigin.xyz) % ARRAY_DIM;
@@ -31,7 +39,7 @@ SamplerState samplerPointClamp : register(s0);
 	float3 cellCentreMS = cellID + 0.5 - ARRAY_DIM / 2;
 	cellCentreMS = cellCentreMS / ARRAY_DIM * ARRAY_SIZE + settings.PosOffset.xyz;
 
-	float3 cellCentreOS = mul(settings.OcclusionViewProj, float4(cellCentreMS, 1)).xyz;
+	float3 cellCentreOS = mul(settings.OcclusionViewProj, float4(cellCentreMS + settings.OcclusionPosOffset, 1)).xyz;  // re-project into the last capture
 	cellCentreOS.y = -cellCentreOS.y;
 	float2 occlusionUV = cellCentreOS.xy * 0.5 + 0.5;
 
@@ -0,0 +1,88 @@
+// Lists the 8x8 tiles the blur passes are dispatched indirectly over.
+// The vertical pass runs on tiles holding SSS pixels, the horizontal pass on every tile their vertical samples can read,
+// so the vertical pass never reads a texel of the temporary texture the horizontal pass skipped.
+
+Texture2D<float4> MaskTexture : register(t0);
+Texture2D<float4> DepthTexture : register(t1);
+
+RWByteAddressBuffer IndirectArgs : register(u0);  // counts cleared to 0 beforehand
+RWStructuredBuffer<uint> TileList : register(u1);  // vertical tiles, horizontal ones with LIST_REACHED
+RWTexture2D<uint> TileMask : register(u2);         // tiles the horizontal pass covers, cleared to 0 beforehand
+
+#include "../Common/DeferredShared.hlsli"
+#include "SSSCommon.hlsli"
+
+#if defined(PREPARE_ARGS)
+
+// a 1D list past 65535 tiles does not fit in one dimension, it wraps into y
+void StoreArgs(uint argsOffset, uint tileCount)
+{
+	uint x = min(tileCount, MAX_GROUPS_PER_DIMENSION);
+	uint y = (tileCount + MAX_GROUPS_PER_DIMENSION - 1) / MAX_GROUPS_PER_DIMENSION;
+	IndirectArgs.Store3(argsOffset, uint3(x, y, 1));
+}
+
+[numthreads(1, 1, 1)] void main() {
+	StoreArgs(HORIZONTAL_ARGS, IndirectArgs.Load(HORIZONTAL_COUNT));
+	StoreArgs(VERTICAL_ARGS, IndirectArgs.Load(VERTICAL_COUNT));
+}
+
+#elif defined(LIST_REACHED)
+
+[numthreads(8, 8, 1)] void main(uint3 DTid
+								: SV_DispatchThreadID) {
+	uint2 tileCount;
+	TileMask.GetDimensions(tileCount.x, tileCount.y);
+	if (any(DTid.xy >= tileCount) || !TileMask[DTid.xy])
+		return;
+
+	uint index;
+	IndirectArgs.InterlockedAdd(HORIZONTAL_COUNT, 1, index);
+	TileList[index] = PackTile(DTid.xy);
+}
+
+#else
+
+groupshared uint hasSSS;
+groupshared uint maxReach;  // as uint, the order of positive floats is kept
+
+[numthreads(8, 8, 1)] void main(uint3 DTid
+								: SV_DispatchThreadID, uint3 Gid
+								: SV_GroupID, uint GIndex
+								: SV_GroupIndex) {
+	if (GIndex == 0) {
+		hasSSS = 0;
+		maxReach = 0;
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (all(DTid.xy < uint2(FrameDim))) {
+		float4 mask = MaskTexture[DTid.xy];
+		if (mask.x > 0) {
+			InterlockedOr(hasSSS, 1);
+			float reach = GetBlurReach(GetScreenDepth(DepthTexture[DTid.xy].r), mask.x, GetProfileIndex(mask));
+			InterlockedMax(maxReach, asuint(min(reach, BufferDim.x + BufferDim.y)));
+		}
+	}
+	GroupMemoryBarrierWithGroupSync();
+
+	if (!hasSSS)
+		return;
+
+	if (GIndex == 0) {
+		uint index;
+		IndirectArgs.InterlockedAdd(VERTICAL_COUNT, 1, index);
+		TileList[index] = PackTile(Gid.xy);
+	}
+
+	// samples are clamped to the screen, the tile itself is always covered
+	int reach = ceil(asfloat(maxReach));
+	int2 tileMin = int2(Gid.xy * TILE_SIZE);
+	uint2 lo = max(tileMin - reach, 0) / TILE_SIZE;
+	uint2 hi = min(tileMin + (TILE_SIZE - 1) + reach, int2(BufferDim.xy) - 1) / TILE_SIZE;
+	uint2 size = hi - lo + 1;
+	for (uint i = GIndex; i < size.x * size.y; i += TILE_SIZE * TILE_SIZE)
+		TileMask[lo + uint2(i % size.x, i / size.x)] = 1;
+}
+
+#endif
@@ -0,0 +1,41 @@
+// Shared by the tile classification and the blur passes, mirrored on the CPU by SSSTiles
+
+#define SSSS_N_SAMPLES 21
+#define SSSS_N_PROFILES 2  // base and human
+
+cbuffer PerFrameSSS : register(b1)
+{
+	float4 Kernels[SSSS_N_SAMPLES * SSSS_N_PROFILES];
+	float4 Profiles[SSSS_N_PROFILES];  // blur radius and thickness in xy
+};
+
+#define TILE_SIZE 8
+#define MAX_GROUPS_PER_DIMENSION 65535
+
+// byte offsets in the indirect argument buffer, thread group counts of each blur pass and the length of its tile list
+#define HORIZONTAL_ARGS 0
+#define VERTICAL_ARGS 12
+#define HORIZONTAL_COUNT 24
+#define VERTICAL_COUNT 28
+
+uint PackTile(uint2 tile)
+{
+	return tile.x | (tile.y << 16);
+}
+
+uint2 UnpackTile(uint tile)
+{
+	return uint2(tile & 0xFFFF, tile >> 16);
+}
+
+// Human skin writes its amount to y as well, everything else uses the base profile
+uint GetProfileIndex(float4 mask)
+{
+	return mask.y == mask.x ? 1 : 0;
+}
+
+// Pixels the vertical samples of a pixel can land away on either axis, the kernels range from -3 to 3 times finalStep in SSSSBlurCS
+float GetBlurReach(float screenDepth, float sssAmount, uint profileIndex)
+{
+	return ProjScale.x / screenDepth * BufferDim.y * sssAmount * Profiles[profileIndex].x;
+}
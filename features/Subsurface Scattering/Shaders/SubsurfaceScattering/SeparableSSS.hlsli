@@ -94,7 +94,7 @@ float4 SSSSBlurCS(
 	float2 texcoord,
 	float2 dir,
 	float sssAmount,
-	bool humanProfile)
+	uint profileIndex)
 {
 	// Fetch color of current pixel:
 	float4 colorM = ColorTexture[DTid.xy];
@@ -110,15 +110,15 @@ float4 SSSSBlurCS(
 	float depthM = DepthTexture[DTid.xy].r;
 	depthM = GetScreenDepth(depthM);
 
-	float2 profile = humanProfile ? HumanProfile.xy : BaseProfile.xy;
-	uint kernelOffset = humanProfile ? SSSS_N_SAMPLES : 0;
+	float2 profile = Profiles[profileIndex].xy;
+	uint kernelOffset = profileIndex * SSSS_N_SAMPLES;
 
 	// Accumulate center sample, multiplying it with its gaussian weight:
 	float4 colorBlurred = colorM;
 	colorBlurred.rgb *= Kernels[kernelOffset].rgb;
 
 	// World-space width
-	float distanceToProjectionWindow = 1.0 / tan(0.5 * radians(SSSS_FOVY));
+	float distanceToProjectionWindow = ProjScale.x;  // 1 / tan(fov / 2)
 	float scale = distanceToProjectionWindow / depthM;
 
 	// Calculate the final step to fetch the surrounding pixels:
@@ -130,12 +130,12 @@ float4 SSSSBlurCS(
 #if defined(VR)
 	finalStep.x *= 0.5;               // Halve horizontal screen resolution
 	uint eyeIndex = texcoord >= 0.5;  // 0 = left 1 = right
-	uint bufferDimHalfX = uint(BufferDim.x * 0.5);
-	uint2 minCoord = uint2(eyeIndex ? bufferDimHalfX : 0, 0);
-	uint2 maxCoord = uint2(eyeIndex ? BufferDim.x : bufferDimHalfX, BufferDim.y);
+	int bufferDimHalfX = int(BufferDim.x * 0.5);
+	int2 minCoord = int2(eyeIndex ? bufferDimHalfX : 0, 0);
+	int2 maxCoord = int2(eyeIndex ? BufferDim.x : bufferDimHalfX, BufferDim.y) - 1;
 #else
-	uint2 minCoord = uint2(0, 0);
-	uint2 maxCoord = uint2(BufferDim.x, BufferDim.y);
+	int2 minCoord = int2(0, 0);
+	int2 maxCoord = int2(BufferDim.x, BufferDim.y) - 1;
 #endif
 
 	float jitter = InterleavedGradientNoise(DTid.xy) * M_2PI;
@@ -149,7 +149,8 @@ float4 SSSSBlurCS(
 		// Apply randomized rotation
 		offset = mul(offset, rotationMatrix);
 
-		uint2 coords = DTid.xy + int2(offset + 0.5);
+		// signed, so offsets past the top or left edge clamp to it instead of wrapping to the far one
+		int2 coords = int2(DTid.xy) + int2(offset + 0.5);
 
 		// Clamp for dynamic resolution
 		coords = clamp(coords, minCoord, maxCoord);
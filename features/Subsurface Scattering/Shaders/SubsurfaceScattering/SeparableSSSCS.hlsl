@@ -3,41 +3,44 @@ RWTexture2D<float4> SSSRW : register(u0);
 Texture2D<float4> ColorTexture : register(t0);
 Texture2D<float4> DepthTexture : register(t1);
 Texture2D<float4> MaskTexture : register(t2);
-
-#define SSSS_N_SAMPLES 21
-
-cbuffer PerFrameSSS : register(b1)
-{
-	float4 Kernels[SSSS_N_SAMPLES + SSSS_N_SAMPLES];
-	float4 BaseProfile;
-	float4 HumanProfile;
-	float SSSS_FOVY;
-};
+StructuredBuffer<uint> TileList : register(t3);  // from ClassifyTilesCS
+ByteAddressBuffer IndirectArgs : register(t4);
 
 #include "../Common/Color.hlsl"
 #include "../Common/Constants.hlsli"
 #include "../Common/DeferredShared.hlsli"
+#include "SSSCommon.hlsli"
 
 #include "SeparableSSS.hlsli"
 
-[numthreads(8, 8, 1)] void main(uint3 DTid
-								: SV_DispatchThreadID) {
+[numthreads(8, 8, 1)] void main(uint3 GTid
+								: SV_GroupThreadID, uint3 Gid
+								: SV_GroupID) {
+	// the list wraps into y past MAX_GROUPS_PER_DIMENSION tiles, the last row is partly past its end
+	uint index = Gid.x + Gid.y * MAX_GROUPS_PER_DIMENSION;
+#if defined(HORIZONTAL)
+	if (index >= IndirectArgs.Load(HORIZONTAL_COUNT))
+		return;
+#else
+	if (index >= IndirectArgs.Load(VERTICAL_COUNT))
+		return;
+#endif
+
+	uint3 DTid = uint3(UnpackTile(TileList[index]) * TILE_SIZE + GTid.xy, 0);
 	float2 texCoord = (DTid.xy + 0.5) * BufferDim.zw;
 
 #if defined(HORIZONTAL)
 
-	float sssAmount = MaskTexture[DTid.xy].x;
-	bool humanProfile = MaskTexture[DTid.xy].y == sssAmount;
+	float4 mask = MaskTexture[DTid.xy];
 
-	float4 color = SSSSBlurCS(DTid.xy, texCoord, float2(1.0, 0.0), sssAmount, humanProfile);
+	float4 color = SSSSBlurCS(DTid.xy, texCoord, float2(1.0, 0.0), mask.x, GetProfileIndex(mask));
 	SSSRW[DTid.xy] = max(0, color);
 
 #else
 
-	float sssAmount = MaskTexture[DTid.xy].x;
-	bool humanProfile = MaskTexture[DTid.xy].y == sssAmount;
+	float4 mask = MaskTexture[DTid.xy];
 
-	float4 color = SSSSBlurCS(DTid.xy, texCoord, float2(0.0, 1.0), sssAmount, humanProfile);
+	float4 color = SSSSBlurCS(DTid.xy, texCoord, float2(0.0, 1.0), mask.x, GetProfileIndex(mask));
 	color.rgb = Lin2sRGB(color.rgb);
 	SSSRW[DTid.xy] = float4(color.rgb, 1.0);
 
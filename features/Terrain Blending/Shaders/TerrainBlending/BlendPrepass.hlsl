@@ -0,0 +1,42 @@
+// Follows TerrainBlendPrepass on the CPU, a change to one belongs in the other
+
+RWTexture2D<float> BlendedDepthTexture : register(u0);
+RWTexture2D<unorm half> BlendedDepthTexture16 : register(u1);
+RWTexture2D<float> TerrainOffsetTexture : register(u2);
+
+Texture2D<unorm float> MainDepthTexture : register(t0);
+Texture2D<unorm float> TerrainDepthTexture : register(t1);
+Texture2D<unorm float> MainDepthTextureAfterTerrain : register(t2);
+
+groupshared uint tileHasTerrain;
+
+[numthreads(8, 8, 1)] void main(uint3 DTid
+								: SV_DispatchThreadID, uint GI
+								: SV_GroupIndex) {
+	if (GI == 0)
+		tileHasTerrain = 0;
+	GroupMemoryBarrierWithGroupSync();
+
+	float mainDepth = MainDepthTexture[DTid.xy];
+	float terrainDepth = TerrainDepthTexture[DTid.xy];
+
+	// terrain depth is cleared to 1 every frame
+	if (terrainDepth < 1.0)
+		tileHasTerrain = 1;
+	GroupMemoryBarrierWithGroupSync();
+
+	float mixedDepth = min(mainDepth, terrainDepth);
+	BlendedDepthTexture[DTid.xy] = mixedDepth;
+	BlendedDepthTexture16[DTid.xy] = mixedDepth;
+
+	// Only terrain reads the offset, a tile without any has nothing drawn after terrain to look for
+	float fixedDepth = mainDepth;
+
+	if (tileHasTerrain) {
+		float mainDepthAfterTerrain = MainDepthTextureAfterTerrain[DTid.xy];
+		if (mainDepth < mainDepthAfterTerrain)
+			fixedDepth = 1;
+	}
+
+	TerrainOffsetTexture[DTid.xy] = fixedDepth;
+}
@@ -10,6 +10,8 @@ struct AOGenBuffer
 	float3 pos0;
 	float3 pos1;
 	float2 zRange;
+
+	uint2 tileOffset;
 };
 
 RWTexture2D<float> RWTexOcclusion : register(u0);
@@ -67,7 +69,10 @@ float3 ReconstructNormal(float2 uv, float2 texelSize)
 	TexHeightmap.GetDimensions(dims.x, dims.y);
 	float2 texelSize = rcp(dims);
 
-	uint2 px_coord = tid.xy;
+	uint2 px_coord = tid.xy + aoGen[0].tileOffset;
+	if (any(px_coord >= dims))
+		return;
+
 	float2 uv = (px_coord + 0.5) * texelSize;
 
 	float3 normal = -ReconstructNormal(uv, texelSize);
@@ -109,6 +114,6 @@ float3 ReconstructNormal(float2 uv, float2 texelSize)
 	visibility /= aoGen[0].sliceCount;
 
 	float norm_z = (pos.z - aoGen[0].zRange.x) / (aoGen[0].zRange.y - aoGen[0].zRange.x);
-	RWTexOcclusion[tid] = visibility;
-	RWTexNormalisedHeight[tid] = norm_z;
+	RWTexOcclusion[px_coord] = visibility;
+	RWTexNormalisedHeight[px_coord] = norm_z;
 }
\ No newline at end of file
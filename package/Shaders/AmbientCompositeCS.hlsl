@@ -30,64 +30,32 @@ RWTexture2D<half3> MainRW : register(u0);
 RWTexture2D<half3> DiffuseAmbientRW : register(u1);
 #endif
 
+#include "Common/AmbientComposite.hlsli"
+
 [numthreads(8, 8, 1)] void main(uint3 dispatchID
 								: SV_DispatchThreadID) {
 	half2 uv = half2(dispatchID.xy + 0.5) * BufferDim.zw;
 	uint eyeIndex = GetEyeIndexFromTexCoord(uv);
 	uv = ConvertFromStereoUV(uv, eyeIndex);
 
-	half3 normalGlossiness = NormalRoughnessTexture[dispatchID.xy];
-	half3 normalVS = DecodeNormal(normalGlossiness.xy);
+	half3 normalVS = DecodeNormal(NormalRoughnessTexture[dispatchID.xy].xy);
 
 	half3 diffuseColor = MainRW[dispatchID.xy];
 	half3 albedo = AlbedoTexture[dispatchID.xy];
 
-	half3 normalWS = normalize(mul(CameraViewInverse[eyeIndex], half4(normalVS, 0)).xyz);
-
-	half3 directionalAmbientColor = mul(DirectionalAmbient, half4(normalWS, 1.0));
-
-	half3 ambient = directionalAmbientColor;
-
-	diffuseColor = sRGB2Lin(diffuseColor);
-	ambient = sRGB2Lin(ambient);
-	albedo = sRGB2Lin(albedo);
-
-	half visibility = 1.0;
+	float rawDepth = 0;
 #if defined(SKYLIGHTING)
-	float rawDepth = DepthTexture[dispatchID.xy];
-	float4 positionCS = float4(2 * float2(uv.x, -uv.y + 1) - 1, rawDepth, 1);
-	float4 positionMS = mul(CameraViewProjInverse[eyeIndex], positionCS);
-	positionMS.xyz = positionMS.xyz / positionMS.w;
-#	if defined(VR)
-	positionMS.xyz += CameraPosAdjust[eyeIndex] - CameraPosAdjust[0];
-#	endif
-
-	sh2 skylighting = sampleSkylighting(skylightingSettings, SkylightingProbeArray, positionMS.xyz, normalWS);
-	half skylightingDiffuse = shHallucinateZH3Irradiance(skylighting, skylightingSettings.DirectionalDiffuse ? normalWS : float3(0, 0, 1));
-	skylightingDiffuse = lerp(skylightingSettings.MixParams.x, 1, saturate(skylightingDiffuse * skylightingSettings.MixParams.y));
-
-	visibility = skylightingDiffuse;
+	rawDepth = DepthTexture[dispatchID.xy];
 #endif
 
+	half4 ssgiDiffuse = half4(0, 0, 0, 1);
 #if defined(SSGI)
-	half4 ssgiDiffuse = SSGITexture[dispatchID.xy];
-	ssgiDiffuse.rgb *= albedo;
-
-	visibility = min(visibility, ssgiDiffuse.a);
-
-	DiffuseAmbientRW[dispatchID.xy] = albedo * ambient + ssgiDiffuse.rgb;
-
-#	if defined(INTERIOR)
-	diffuseColor *= ssgiDiffuse.a;
-#	endif
-	diffuseColor += ssgiDiffuse.rgb;
+	ssgiDiffuse = SSGITexture[dispatchID.xy];
 #endif
 
-	diffuseColor = Lin2sRGB(diffuseColor);
-	ambient = Lin2sRGB(ambient * visibility);
-	albedo = Lin2sRGB(albedo);
-
-	diffuseColor += ambient * albedo;
-
-	MainRW[dispatchID.xy] = diffuseColor;
-};
\ No newline at end of file
+	half3 diffuseAmbient;
+	MainRW[dispatchID.xy] = AmbientComposite(uv, eyeIndex, normalVS, diffuseColor, albedo, rawDepth, ssgiDiffuse, diffuseAmbient);
+#if defined(SSGI)
+	DiffuseAmbientRW[dispatchID.xy] = diffuseAmbient;
+#endif
+};
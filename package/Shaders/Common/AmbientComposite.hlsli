@@ -0,0 +1,55 @@
+// Adds directional ambient, skylighting and SSGI to the diffuse lighting, shared by AmbientCompositeCS and the
+// DeferredCompositeCS permutation that runs both composites in one dispatch.
+// With SKYLIGHTING, skylightingSettings and SkylightingProbeArray have to be declared before this is included.
+
+half3 AmbientComposite(half2 uv, uint eyeIndex, half3 normalVS, half3 diffuseColor, half3 albedo, float rawDepth, half4 ssgiDiffuse, out half3 diffuseAmbient)
+{
+	half3 normalWS = normalize(mul(CameraViewInverse[eyeIndex], half4(normalVS, 0)).xyz);
+
+	half3 directionalAmbientColor = mul(DirectionalAmbient, half4(normalWS, 1.0));
+
+	half3 ambient = directionalAmbientColor;
+
+	diffuseColor = sRGB2Lin(diffuseColor);
+	ambient = sRGB2Lin(ambient);
+	albedo = sRGB2Lin(albedo);
+
+	diffuseAmbient = 0;
+
+	half visibility = 1.0;
+#if defined(SKYLIGHTING)
+	float4 positionCS = float4(2 * float2(uv.x, -uv.y + 1) - 1, rawDepth, 1);
+	float4 positionMS = mul(CameraViewProjInverse[eyeIndex], positionCS);
+	positionMS.xyz = positionMS.xyz / positionMS.w;
+#	if defined(VR)
+	positionMS.xyz += CameraPosAdjust[eyeIndex] - CameraPosAdjust[0];
+#	endif
+
+	sh2 skylighting = sampleSkylighting(skylightingSettings, SkylightingProbeArray, positionMS.xyz, normalWS);
+	half skylightingDiffuse = shHallucinateZH3Irradiance(skylighting, skylightingSettings.DirectionalDiffuse ? normalWS : float3(0, 0, 1));
+	skylightingDiffuse = lerp(skylightingSettings.MixParams.x, 1, saturate(skylightingDiffuse * skylightingSettings.MixParams.y));
+
+	visibility = skylightingDiffuse;
+#endif
+
+#if defined(SSGI)
+	ssgiDiffuse.rgb *= albedo;
+
+	visibility = min(visibility, ssgiDiffuse.a);
+
+	diffuseAmbient = albedo * ambient + ssgiDiffuse.rgb;
+
+#	if defined(INTERIOR)
+	diffuseColor *= ssgiDiffuse.a;
+#	endif
+	diffuseColor += ssgiDiffuse.rgb;
+#endif
+
+	diffuseColor = Lin2sRGB(diffuseColor);
+	ambient = Lin2sRGB(ambient * visibility);
+	albedo = Lin2sRGB(albedo);
+
+	diffuseColor += ambient * albedo;
+
+	return diffuseColor;
+}
@@ -5,6 +5,12 @@ cbuffer PerFrameDeferredShared : register(b11)
 	row_major float3x4 DirectionalAmbient;
 	uint FrameCount;
 	uint FrameCountAlwaysActive;
+	float2 FrameDim;  // dynamic resolution
+	float2 RcpFrameDim;
+	float2 ProjScale;  // projection x and y scale of the first eye
+	float4 NDCToViewMul;
+	float4 NDCToViewAdd;
+	float4x4 PrevInvViewMat[2];
 };
 
 float GetScreenDepth(float depth)
@@ -30,4 +30,35 @@ half2 EncodeNormalVanilla(half3 n)
 	n.z = max(1.0 / 1000.0, sqrt(8 + -8 * n.z));
 	n.xy /= n.z;
 	return n.xy + 0.5;
-}
\ No newline at end of file
+}
+
+// Channel assignments of the deferred targets, shared by the writers and the composite passes.
+// The last channel of each write is the pixel alpha for blending, it is not stored by every layout.
+
+half4 EncodeNormalGlossiness(half3 normalVS, half glossiness, half alpha)
+{
+	return half4(EncodeNormal(normalVS), glossiness, alpha);
+}
+
+half3 DecodeNormalGlossiness(half3 encoded, out half glossiness)
+{
+	glossiness = encoded.z;
+	return DecodeNormal(encoded.xy);
+}
+
+// Subsurface amount, subsurface human profile and wetness normal amount
+half4 EncodeMasks(half sssAmount, half sssHuman, half wetnessNormal, half alpha)
+{
+	return half4(sssAmount, sssHuman, wetnessNormal, alpha);
+}
+
+half GetWetnessNormalMask(half3 masks)
+{
+	return masks.z;
+}
+
+// Stored as two channels by the compact layout
+half2 GetSnowParameters(half3 masks2)
+{
+	return masks2.xy;
+}
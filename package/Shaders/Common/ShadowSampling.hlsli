@@ -16,7 +16,7 @@ struct PerGeometry
 	float4x3 FocusShadowMapProj[4];
 	// Since PerGeometry is passed between c++ and hlsl, can't have different defines due to strong typing
 	float4x3 ShadowMapProj[2][3];
-	float4x4 CameraViewProjInverse[2];
+	row_major float4x4 CameraViewProjInverse[2];
 };
 
 Texture2DArray<float4> TexShadowMapSampler : register(t25);
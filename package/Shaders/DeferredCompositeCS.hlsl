@@ -37,21 +37,51 @@ cbuffer SkylightingCB : register(b1)
 Texture3D<sh2> SkylightingProbeArray : register(t9);
 #endif
 
+// AmbientCompositeCS in the same dispatch, when nothing between the two reads other pixels of MainRW
+#if defined(AMBIENT_COMPOSITE)
+Texture2D<unorm float> AmbientDepthTexture : register(t10);  // without terrain blending, as in AmbientCompositeCS
+#	if defined(SSGI)
+Texture2D<half4> SSGITexture : register(t11);
+RWTexture2D<half3> DiffuseAmbientRW : register(u3);
+#	endif
+
+#	include "Common/AmbientComposite.hlsli"
+#endif
+
 [numthreads(8, 8, 1)] void main(uint3 dispatchID
 								: SV_DispatchThreadID) {
 	half2 uv = half2(dispatchID.xy + 0.5) * BufferDim.zw;
 	uint eyeIndex = GetEyeIndexFromTexCoord(uv);
 	uv = ConvertFromStereoUV(uv, eyeIndex);
 
-	half3 normalGlossiness = NormalRoughnessTexture[dispatchID.xy];
-	half3 normalVS = DecodeNormal(normalGlossiness.xy);
+	half glossiness;
+	half3 normalVS = DecodeNormalGlossiness(NormalRoughnessTexture[dispatchID.xy], glossiness);
 
 	half3 diffuseColor = MainRW[dispatchID.xy];
 	half3 specularColor = SpecularTexture[dispatchID.xy];
 	half3 albedo = AlbedoTexture[dispatchID.xy];
-	half2 snowParameters = Masks2Texture[dispatchID.xy].xy;
 
-	half glossiness = normalGlossiness.z;
+#if defined(AMBIENT_COMPOSITE)
+	{
+		float rawDepth = 0;
+#	if defined(SKYLIGHTING)
+		rawDepth = AmbientDepthTexture[dispatchID.xy];
+#	endif
+
+		half4 ssgiDiffuse = half4(0, 0, 0, 1);
+#	if defined(SSGI)
+		ssgiDiffuse = SSGITexture[dispatchID.xy];
+#	endif
+
+		half3 diffuseAmbient;
+		diffuseColor = AmbientComposite(uv, eyeIndex, normalVS, diffuseColor, albedo, rawDepth, ssgiDiffuse, diffuseAmbient);
+#	if defined(SSGI)
+		DiffuseAmbientRW[dispatchID.xy] = diffuseAmbient;
+#	endif
+	}
+#endif
+	half2 snowParameters = GetSnowParameters(Masks2Texture[dispatchID.xy]);
+
 	half3 color = diffuseColor + specularColor;
 
 #if defined(DYNAMIC_CUBEMAPS)
@@ -61,7 +91,7 @@ Texture3D<sh2> SkylightingProbeArray : register(t9);
 	if (reflectance.x > 0.0 || reflectance.y > 0.0 || reflectance.z > 0.0) {
 		half3 normalWS = normalize(mul(CameraViewInverse[eyeIndex], half4(normalVS, 0)).xyz);
 
-		half wetnessMask = MasksTexture[dispatchID.xy].z;
+		half wetnessMask = GetWetnessNormalMask(MasksTexture[dispatchID.xy]);
 
 		normalWS = lerp(normalWS, float3(0, 0, 1), wetnessMask);
 
@@ -252,7 +252,7 @@ PS_OUTPUT main(PS_INPUT input)
 	psout.Normal.zw = 0;
 
 	psout.Albedo = float4(baseColor.xyz * 0.5, 1);
-	psout.Masks = float4(0, 0, 1, 0);
+	psout.Masks = EncodeMasks(0, 0, 1, 0);
 #		else
 	float3 ddx = ddx_coarse(input.WorldPosition);
 	float3 ddy = ddy_coarse(input.WorldPosition);
@@ -211,7 +211,7 @@ PS_OUTPUT main(PS_INPUT input)
 	psout.Normal.zw = 0;
 
 	psout.Albedo = float4(albedo, 1);
-	psout.Masks = float4(0, 0, 0, 0);
+	psout.Masks = EncodeMasks(0, 0, 0, 0);
 #	endif
 
 	return psout;
@@ -13,7 +13,7 @@ struct PerGeometry
 	float4x3 FocusShadowMapProj[4];
 	// Since PerGeometry is passed between c++ and hlsl, can't have different defines due to strong typing
 	float4x3 ShadowMapProj[2][3];
-	float4x4 CameraViewProjInverse[2];
+	row_major float4x4 CameraViewProjInverse[2];  // row major, matching the copy from the camera constants
 };
 
 // copied from UtilShader(b2). Assume RENDER_SHADOWMASK
@@ -93,8 +93,12 @@ float RgbToLuminance(float3 color)
 
 	// Average
 	if (threadIndex == 0) {
+		uint width, height;
+		InputTexture.GetDimensions(width, height);
+
 		float avgLuma = dot(sampleCache[0], 1.0 / 8.0) / GROUP_SIZE + 0.1;
-		float2 avgMotionVectors = dot(sampleCacheMotionVectors[0], 1.0 / 8.0) / GROUP_SIZE;
+		// motion vectors are in uv, the rate model works in pixels per frame
+		float2 avgMotionVectors = sampleCacheMotionVectors[0] / (8.0 * GROUP_SIZE) * float2(width, height);
 		float errX = errXCache[0];
 		float errY = errYCache[0];
 		OutputTexture[GroupID.xy] = float4(float2(errX, errY) / abs(avgLuma), avgMotionVectors);
@@ -1,13 +1,33 @@
+// Follows VRSRateModel on the CPU, a change to one belongs in the other
+
+cbuffer ShadingRateCB : register(b0)
+{
+	float ThresholdCentre;  // error a tile in the centre of the screen may have before it is shaded finer
+	float ThresholdEdge;    // the same one uv unit from the centre, the corners are at 0.71
+	float Hysteresis;       // fraction the error must fall below the threshold before a tile coarsens
+	float MotionScale;      // scales motion in pixels per frame before it hides error
+};
+
 RWTexture2D<uint> vrsSurface : register(u0);
+RWTexture2D<uint> levelHistory : register(u1);
 Texture2D<float4> nasDataSurface : register(t0);
 
+// 0 full, 1 half, 2 quarter rate
+uint GetLevel(float halfError, float quarterError, float threshold)
+{
+	return halfError >= threshold ? 0 : (quarterError > threshold ? 1 : 2);
+}
+
 [numthreads(32, 32, 1)] void main(uint3 DispatchThreadID
-								  : SV_DispatchThreadID, uint3 GroupThreadID
-								  : SV_GroupThreadID, uint3 GroupID
-								  : SV_GroupID) {
+								  : SV_DispatchThreadID) {
+	uint screenWidth, screenHeight;
+	nasDataSurface.GetDimensions(screenWidth, screenHeight);
+	if (any(DispatchThreadID.xy >= uint2(screenWidth, screenHeight)))
+		return;
+
 	float4 nasData = nasDataSurface[DispatchThreadID.xy];
 
-	float2 mVec = abs(nasData.zw);
+	float2 mVec = abs(nasData.zw) * MotionScale;
 
 	// Error scalers (equations from the I3D 2019 paper)
 	// bhv for half rate, bqv for quarter rate
@@ -19,39 +39,33 @@ Texture2D<float4> nasDataSurface : register(t0);
 	float2 diff2 = diff * bhv;
 	float2 diff4 = diff * bqv;
 
-	uint screenWidth, screenHeight;
-	nasDataSurface.GetDimensions(screenWidth, screenHeight);
-
 	float2 uv = DispatchThreadID.xy * rcp(float2(screenWidth, screenHeight));
-	float threshold = lerp(0.07, 0.14, distance(float2(0.5, 0.5), uv));
+	float threshold = lerp(ThresholdCentre, ThresholdEdge, distance(float2(0.5, 0.5), uv));
+	float strictThreshold = threshold * (1.0 - Hysteresis);
 
-	/*`
-        D3D12_SHADING_RATE_1X1	= 0,   // 0b0000
-        D3D12_SHADING_RATE_1X2	= 0x1, // 0b0001
-        D3D12_SHADING_RATE_2X1	= 0x4, // 0b0100
-        D3D12_SHADING_RATE_2X2	= 0x5, // 0b0101
-        D3D12_SHADING_RATE_2X4	= 0x6, // 0b0110
-        D3D12_SHADING_RATE_4X2	= 0x9, // 0b1001
-        D3D12_SHADING_RATE_4X4	= 0xa  // 0b1010
-    */
+	uint2 strict = uint2(GetLevel(diff2.x, diff4.x, strictThreshold), GetLevel(diff2.y, diff4.y, strictThreshold));
+	uint2 loose = uint2(GetLevel(diff2.x, diff4.x, threshold), GetLevel(diff2.y, diff4.y, threshold));
 
-	// Compute block shading rate based on if the error computation goes over the threshold
-	// shading rates in D3D are purposely designed to be able to combined, e.g. 2x1 | 1x2 = 2x2
-	uint ShadingRate = 0;
-	ShadingRate |= ((diff2.x >= threshold) ? 0 : ((diff4.x > threshold) ? 0x4 : 0x8));
-	ShadingRate |= ((diff2.y >= threshold) ? 0 : ((diff4.y > threshold) ? 0x1 : 0x2));
+	// finer right away, coarser only once the margin is cleared
+	uint previous = levelHistory[DispatchThreadID.xy];
+	uint2 levels = clamp(uint2(previous & 0x3, previous >> 2), strict, loose);
 
-	// Disable 4x4 shading rate (low quality, limited perf gain)
-	if (ShadingRate == 0xa) {
-		ShadingRate = (diff2.x > diff2.y) ? 0x6 : 0x9;  // use 2x4 or 4x2 based on directional gradient
+	if (all(levels == 2)) {
+		// Disable 4x4 shading rate (low quality, limited perf gain), keep the quarter rate along the flatter axis
+		if (diff2.x > diff2.y)
+			levels.x = 1;
+		else
+			levels.y = 1;
 	}
 	// Disable 4x1 or 1x4 shading rate (unsupported)
-	else if (ShadingRate == 0x8) {
-		ShadingRate = 0x4;
-	} else if (ShadingRate == 0x2) {
-		ShadingRate = 0x1;
+	else if (levels.x == 2 && levels.y == 0) {
+		levels.x = 1;
+	} else if (levels.y == 2 && levels.x == 0) {
+		levels.y = 1;
 	}
 
+	levelHistory[DispatchThreadID.xy] = levels.x | (levels.y << 2);
+
 	// vsrd[i].shadingRateTable[0] = NV_PIXEL_X1_PER_RASTER_PIXEL;
 	// vsrd[i].shadingRateTable[1] = NV_PIXEL_X1_PER_2X1_RASTER_PIXELS;
 	// vsrd[i].shadingRateTable[2] = NV_PIXEL_X1_PER_1X2_RASTER_PIXELS;
@@ -59,19 +73,11 @@ Texture2D<float4> nasDataSurface : register(t0);
 	// vsrd[i].shadingRateTable[4] = NV_PIXEL_X1_PER_4X2_RASTER_PIXELS;
 	// vsrd[i].shadingRateTable[5] = NV_PIXEL_X1_PER_2X4_RASTER_PIXELS;
 	// vsrd[i].shadingRateTable[6] = NV_PIXEL_X1_PER_4X4_RASTER_PIXELS;
+	static const uint rateIndices[3][3] = {
+		{ 0, 1, 1 },
+		{ 2, 3, 4 },
+		{ 2, 5, 6 }
+	};
 
-	if (ShadingRate == 0x1)
-		ShadingRate = 2;
-	else if (ShadingRate == 0x4)
-		ShadingRate = 1;
-	else if (ShadingRate == 0x5)
-		ShadingRate = 3;
-	else if (ShadingRate == 0x6)
-		ShadingRate = 5;
-	else if (ShadingRate == 0x9)
-		ShadingRate = 4;
-	else if (ShadingRate == 0xa)
-		ShadingRate = 6;
-
-	vrsSurface[DispatchThreadID.xy] = ShadingRate;
-}
\ No newline at end of file
+	vrsSurface[DispatchThreadID.xy] = rateIndices[levels.y][levels.x];
+}
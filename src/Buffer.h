@@ -9,6 +9,8 @@
 #include <wrl\client.h>
 #include <wrl\wrappers\corewrappers.h>
 
+#include "UploadCache.h"
+
 template <typename T>
 D3D11_BUFFER_DESC StructuredBufferDesc(uint64_t count, bool uav = true, bool dynamic = false)
 {
@@ -59,6 +61,29 @@ public:
 	ID3D11Buffer* CB() const { return resource.Get(); }
 
 	void Update(void const* src_data, size_t data_size)
+	{
+		lastUpload.Invalidate();
+		Upload(src_data, data_size);
+	}
+
+	template <typename T>
+	void Update(T const& src_data)
+	{
+		Update(&src_data, sizeof(T));
+	}
+
+	// for buffers derived from settings, skips the upload while the data matches the last one
+	template <typename T>
+	bool UpdateIfChanged(T const& src_data)
+	{
+		if (!lastUpload.Changed(src_data))
+			return false;
+		Upload(&src_data, sizeof(T));
+		return true;
+	}
+
+private:
+	void Upload(void const* src_data, size_t data_size)
 	{
 		ID3D11DeviceContext* ctx = reinterpret_cast<ID3D11DeviceContext*>(RE::BSGraphics::Renderer::GetSingleton()->GetRuntimeData().context);
 		if (desc.Usage & D3D11_USAGE_DYNAMIC) {
@@ -71,15 +96,9 @@ public:
 			ctx->UpdateSubresource(resource.Get(), 0, nullptr, src_data, 0, 0);
 	}
 
-	template <typename T>
-	void Update(T const& src_data)
-	{
-		Update(&src_data, sizeof(T));
-	}
-
-private:
 	Microsoft::WRL::ComPtr<ID3D11Buffer> resource;
 	D3D11_BUFFER_DESC desc;
+	UploadCache lastUpload;  // cleared by plain updates
 };
 
 template <typename T>
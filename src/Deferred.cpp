@@ -1,5 +1,6 @@
 #include "Deferred.h"
 
+#include "DeferredPassGraph.h"
 #include "ShaderCache.h"
 #include "State.h"
 #include "Util.h"
@@ -10,6 +11,36 @@
 #include "Features/SubsurfaceScattering.h"
 #include "Features/TerrainBlending.h"
 
+// resources the deferred passes declare to DeferredPassGraph
+namespace DeferredResource
+{
+	enum : uint
+	{
+		Main,
+		Albedo,
+		Specular,
+		NormalRoughness,
+		Masks,
+		Depth,
+		SSGI,
+		PrevDiffuseAmbient,
+		Cubemap
+	};
+}
+
+// passes run by DeferredPasses, in execution order
+namespace DeferredPass
+{
+	enum : uint
+	{
+		SSGI,
+		AmbientComposite,
+		SubsurfaceScattering,
+		DynamicCubemaps,
+		DeferredComposite
+	};
+}
+
 struct DepthStates
 {
 	ID3D11DepthStencilState* a[6][40];
@@ -30,17 +61,43 @@ void SetupRenderTarget(RE::RENDER_TARGET target, D3D11_TEXTURE2D_DESC texDesc, D
 	rtvDesc.Format = format;
 	uavDesc.Format = format;
 
+	// Compact formats such as B5G6R5 cannot be written through a typed UAV
+	UINT support = 0;
+	device->CheckFormatSupport(format, &support);
+	bool typedUAV = support & D3D11_FORMAT_SUPPORT_TYPED_UNORDERED_ACCESS_VIEW;
+	if (!typedUAV)
+		texDesc.BindFlags &= ~D3D11_BIND_UNORDERED_ACCESS;
+
 	auto& data = renderer->GetRuntimeData().renderTargets[target];
 	DX::ThrowIfFailed(device->CreateTexture2D(&texDesc, nullptr, &data.texture));
 	DX::ThrowIfFailed(device->CreateShaderResourceView(data.texture, &srvDesc, &data.SRV));
 	DX::ThrowIfFailed(device->CreateRenderTargetView(data.texture, &rtvDesc, &data.RTV));
-	DX::ThrowIfFailed(device->CreateUnorderedAccessView(data.texture, &uavDesc, &data.UAV));
+	if (typedUAV)
+		DX::ThrowIfFailed(device->CreateUnorderedAccessView(data.texture, &uavDesc, &data.UAV));
+}
+
+// Falls back to a_wide when the compact format cannot be blended into on this device
+DXGI_FORMAT GetGBufferFormat(DXGI_FORMAT a_compact, DXGI_FORMAT a_wide)
+{
+	if (Deferred::GetSingleton()->activeGBufferLayout != Deferred::GBufferLayout::Compact)
+		return a_wide;
+
+	constexpr UINT required = D3D11_FORMAT_SUPPORT_TEXTURE2D | D3D11_FORMAT_SUPPORT_SHADER_LOAD | D3D11_FORMAT_SUPPORT_RENDER_TARGET | D3D11_FORMAT_SUPPORT_BLENDABLE;
+
+	UINT support = 0;
+	if (FAILED(State::GetSingleton()->device->CheckFormatSupport(a_compact, &support)) || (support & required) != required) {
+		logger::warn("[Deferred] {} unsupported, using {}", magic_enum::enum_name(a_compact), magic_enum::enum_name(a_wide));
+		return a_wide;
+	}
+	return a_compact;
 }
 
 void Deferred::SetupResources()
 {
 	auto renderer = RE::BSGraphics::Renderer::GetSingleton();
 
+	activeGBufferLayout = gbufferLayout;
+
 	{
 		auto& main = renderer->GetRuntimeData().renderTargets[RE::RENDER_TARGETS::kMAIN];
 
@@ -83,17 +140,16 @@ void Deferred::SetupResources()
 		// Specular
 		SetupRenderTarget(SPECULAR, texDesc, srvDesc, rtvDesc, uavDesc, DXGI_FORMAT_R11G11B10_FLOAT);
 		// Reflectance
-		SetupRenderTarget(REFLECTANCE, texDesc, srvDesc, rtvDesc, uavDesc, DXGI_FORMAT_R8G8B8A8_UNORM);
+		SetupRenderTarget(REFLECTANCE, texDesc, srvDesc, rtvDesc, uavDesc, GetGBufferFormat(DXGI_FORMAT_B5G6R5_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM));
 		// Normal + Roughness
 		SetupRenderTarget(NORMALROUGHNESS, texDesc, srvDesc, rtvDesc, uavDesc, DXGI_FORMAT_R8G8B8A8_UNORM);
 		// Masks
 		SetupRenderTarget(MASKS, texDesc, srvDesc, rtvDesc, uavDesc, DXGI_FORMAT_R8G8B8A8_UNORM);
 		// Additional Masks
-		SetupRenderTarget(MASKS2, texDesc, srvDesc, rtvDesc, uavDesc, DXGI_FORMAT_R8G8B8A8_UNORM);
-	}
-
-	{
-		deferredCB = new ConstantBuffer(ConstantBufferDesc<DeferredCB>());
+		SetupRenderTarget(MASKS2, texDesc, srvDesc, rtvDesc, uavDesc, GetGBufferFormat(DXGI_FORMAT_R8G8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM));
+		// Takes the place of unread targets, all bound targets must match in size so only the format can shrink
+		if (activeGBufferLayout == GBufferLayout::Compact)
+			SetupRenderTarget(DISCARDED, texDesc, srvDesc, rtvDesc, uavDesc, DXGI_FORMAT_R8_UNORM);
 	}
 
 	{
@@ -168,38 +224,69 @@ void Deferred::SetupResources()
 	}
 }
 
+bool Deferred::CopyShadowConstants()
+{
+	auto& context = State::GetSingleton()->context;
+	auto regions = ShadowCopyLayout::GetRegions(REL::Module::IsVR());
+
+	winrt::com_ptr<ID3D11Buffer> sources[13];
+	for (uint slot : { 0, 2, 12 })
+		context->PSGetConstantBuffers(slot, 1, sources[slot].put());
+
+	bool copyable = std::ranges::all_of(regions, [&](const ShadowCopyLayout::Region& region) {
+		auto& source = sources[region.slot];
+		if (!source)
+			return false;
+		D3D11_BUFFER_DESC desc;
+		source->GetDesc(&desc);
+		return desc.ByteWidth >= (region.firstVector + region.numVectors) * sizeof(float4);
+	});
+
+	if (!copyable)
+		return false;
+
+	for (const auto& region : regions) {
+		D3D11_BOX box{ region.firstVector * (uint)sizeof(float4), 0, 0, (region.firstVector + region.numVectors) * (uint)sizeof(float4), 1, 1 };
+		context->CopySubresourceRegion(perShadow->resource.get(), 0, region.dstOffset, 0, 0, sources[region.slot].get(), 0, &box);
+	}
+	return true;
+}
+
 void Deferred::CopyShadowData()
 {
 	auto& context = State::GetSingleton()->context;
 
-	ID3D11UnorderedAccessView* uavs[1]{ perShadow->uav.get() };
-	context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
+	// Gathering the constants in a compute pass is only needed when they cannot be copied directly
+	if (!CopyShadowConstants()) {
+		ID3D11UnorderedAccessView* uavs[1]{ perShadow->uav.get() };
+		context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
 
-	ID3D11Buffer* buffers[1];
-	context->PSGetConstantBuffers(2, 1, buffers);
-	context->CSSetConstantBuffers(0, 1, buffers);
+		ID3D11Buffer* buffers[1];
+		context->PSGetConstantBuffers(2, 1, buffers);
+		context->CSSetConstantBuffers(0, 1, buffers);
 
-	context->PSGetConstantBuffers(12, 1, buffers);
-	context->CSSetConstantBuffers(1, 1, buffers);
+		context->PSGetConstantBuffers(12, 1, buffers);
+		context->CSSetConstantBuffers(1, 1, buffers);
 
-	context->PSGetConstantBuffers(0, 1, buffers);
-	context->CSSetConstantBuffers(2, 1, buffers);
+		context->PSGetConstantBuffers(0, 1, buffers);
+		context->CSSetConstantBuffers(2, 1, buffers);
 
-	context->PSGetShaderResources(4, 1, &shadowView);
+		context->CSSetShader(copyShadowCS, nullptr, 0);
 
-	context->CSSetShader(copyShadowCS, nullptr, 0);
+		context->Dispatch(1, 1, 1);
 
-	context->Dispatch(1, 1, 1);
+		uavs[0] = nullptr;
+		context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
 
-	uavs[0] = nullptr;
-	context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
+		buffers[0] = nullptr;
+		context->CSSetConstantBuffers(0, 1, buffers);
+		context->CSSetConstantBuffers(1, 1, buffers);
+		context->CSSetConstantBuffers(2, 1, buffers);
 
-	buffers[0] = nullptr;
-	context->CSSetConstantBuffers(0, 1, buffers);
-	context->CSSetConstantBuffers(1, 1, buffers);
-	context->CSSetConstantBuffers(2, 1, buffers);
+		context->CSSetShader(nullptr, nullptr, 0);
+	}
 
-	context->CSSetShader(nullptr, nullptr, 0);
+	context->PSGetShaderResources(4, 1, &shadowView);
 
 	{
 		ID3D11ShaderResourceView* srvs[2]{
@@ -211,32 +298,6 @@ void Deferred::CopyShadowData()
 	}
 }
 
-void Deferred::UpdateConstantBuffer()
-{
-	DeferredCB data{};
-
-	auto state = State::GetSingleton();
-
-	data.BufferDim.x = state->screenSize.x;
-	data.BufferDim.y = state->screenSize.y;
-	data.BufferDim.z = 1.0f / data.BufferDim.x;
-	data.BufferDim.w = 1.0f / data.BufferDim.y;
-
-	data.CameraData = Util::GetCameraData();
-
-	const auto& shaderManager = RE::BSShaderManager::State::GetSingleton();
-	const RE::NiTransform& dalcTransform = shaderManager.directionalAmbientTransform;
-	Util::StoreTransform3x4NoScale(data.DirectionalAmbient, dalcTransform);
-
-	auto imageSpaceManager = RE::ImageSpaceManager::GetSingleton();
-
-	auto useTAA = !REL::Module::IsVR() ? imageSpaceManager->GetRuntimeData().BSImagespaceShaderISTemporalAA->taaEnabled : imageSpaceManager->GetVRRuntimeData().BSImagespaceShaderISTemporalAA->taaEnabled;
-	data.FrameCount = useTAA ? RE::BSGraphics::State::GetSingleton()->frameCount : 0;
-	data.FrameCountAlwaysActive = RE::BSGraphics::State::GetSingleton()->frameCount;
-
-	deferredCB->Update(data);
-}
-
 void Deferred::PrepassPasses()
 {
 	auto& shaderCache = SIE::ShaderCache::Instance();
@@ -377,6 +438,10 @@ void Deferred::StartDeferred()
 		MASKS2
 	};
 
+	// Reflectance is only read back by dynamic cubemaps, the slot cannot be left empty as the targets after it would not be bound
+	if (activeGBufferLayout == GBufferLayout::Compact && !DynamicCubemaps::GetSingleton()->loaded)
+		targets[5] = DISCARDED;
+
 	for (uint i = 2; i < 8; i++) {
 		renderTargets[i] = targets[i];                                             // We must use unused targets to be indexable
 		setRenderTargetMode[i] = RE::BSGraphics::SetRenderTargetMode::SRTM_CLEAR;  // Dirty from last frame, this calls ClearRenderTargetView once
@@ -389,18 +454,65 @@ void Deferred::StartDeferred()
 	PrepassPasses();
 }
 
+// steps of the enabled passes, each holding DeferredPass values
+static std::vector<std::vector<uint>> BuildPassSchedule(uint a_enabledPasses)
+{
+	// passes in execution order, the graph merges the two composites when nothing in between looks at other pixels of main
+	DeferredPassGraph graph;
+	std::vector<uint> ids;
+	auto addPass = [&](uint a_id, DeferredPassGraph::Pass a_pass) {
+		if (a_enabledPasses & (1 << a_id)) {
+			ids.push_back(a_id);
+			graph.AddPass(std::move(a_pass));
+		}
+	};
+
+	using enum DeferredPassGraph::Access;
+
+	addPass(DeferredPass::SSGI,
+		{ .name = "SSGI",
+			.reads = { { DeferredResource::Main, Neighbourhood }, { DeferredResource::Depth, Neighbourhood }, { DeferredResource::NormalRoughness, Neighbourhood }, { DeferredResource::PrevDiffuseAmbient, Neighbourhood } },
+			.writes = { DeferredResource::SSGI } });
+
+	addPass(DeferredPass::AmbientComposite,
+		{ .name = "Ambient Composite",
+			.reads = { { DeferredResource::Main }, { DeferredResource::Albedo }, { DeferredResource::NormalRoughness }, { DeferredResource::Depth }, { DeferredResource::SSGI } },
+			.writes = { DeferredResource::Main, DeferredResource::PrevDiffuseAmbient },
+			.fusable = true });
+
+	addPass(DeferredPass::SubsurfaceScattering,
+		{ .name = "Subsurface Scattering",
+			.reads = { { DeferredResource::Main, Neighbourhood }, { DeferredResource::Depth, Neighbourhood }, { DeferredResource::Masks, Neighbourhood } },
+			.writes = { DeferredResource::Main } });
+
+	addPass(DeferredPass::DynamicCubemaps,
+		{ .name = "Dynamic Cubemaps",
+			.reads = { { DeferredResource::Main, Neighbourhood }, { DeferredResource::Depth, Neighbourhood } },
+			.writes = { DeferredResource::Cubemap } });
+
+	addPass(DeferredPass::DeferredComposite,
+		{ .name = "Deferred Composite",
+			.reads = { { DeferredResource::Main }, { DeferredResource::Specular }, { DeferredResource::Albedo }, { DeferredResource::NormalRoughness }, { DeferredResource::Masks }, { DeferredResource::Depth }, { DeferredResource::Cubemap, Neighbourhood } },
+			.writes = { DeferredResource::Main },
+			.fusable = true });
+
+	auto steps = graph.Schedule();
+	for (auto& step : steps)
+		for (auto& pass : step)
+			pass = ids[pass];
+	return steps;
+}
+
 void Deferred::DeferredPasses()
 {
 	auto renderer = RE::BSGraphics::Renderer::GetSingleton();
 	auto& context = State::GetSingleton()->context;
 
-	UpdateConstantBuffer();
-
 	{
 		REL::Relocation<ID3D11Buffer**> perFrame{ REL::RelocationID(524768, 411384) };
-		ID3D11Buffer* buffers[2] = { deferredCB->CB(), *perFrame.get() };
+		ID3D11Buffer* buffers[2] = { State::GetSingleton()->sharedViewCB->CB(), *perFrame.get() };
 
-		context->CSSetConstantBuffers(11, 2, buffers);
+		context->CSSetConstantBuffers(State::SharedViewSlot, 2, buffers);
 	}
 
 	auto specular = renderer->GetRuntimeData().renderTargets[SPECULAR];
@@ -421,58 +533,45 @@ void Deferred::DeferredPasses()
 		interior = sky->mode.get() != RE::Sky::Mode::kFull;
 
 	auto skylighting = Skylighting::GetSingleton();
-
 	auto ssgi = ScreenSpaceGI::GetSingleton();
+	auto sss = SubsurfaceScattering::GetSingleton();
+	auto dynamicCubemaps = DynamicCubemaps::GetSingleton();
+	auto terrainBlending = TerrainBlending::GetSingleton();
 
 	auto dispatchCount = Util::GetScreenDispatchCount();
 
-	if (ssgi->loaded) {
-		ssgi->DrawSSGI(prevDiffuseAmbientTexture);
-
-		// Ambient Composite
-		{
-			ID3D11Buffer* buffer = skylighting->loaded ? skylighting->skylightingCB->CB() : nullptr;
-			context->CSSetConstantBuffers(1, 1, &buffer);
-
-			ID3D11ShaderResourceView* srvs[5]{
-				albedo.SRV,
-				normalRoughness.SRV,
-				skylighting->loaded ? depth.depthSRV : nullptr,
-				skylighting->loaded ? skylighting->texProbeArray->srv.get() : nullptr,
-				ssgi->loaded ? ssgi->texGI[ssgi->outputGIIdx]->srv.get() : nullptr,
-			};
-
-			context->CSSetShaderResources(0, ARRAYSIZE(srvs), srvs);
-
-			ID3D11UnorderedAccessView* uavs[2]{ main.UAV, prevDiffuseAmbientTexture->uav.get() };
-			context->CSSetUnorderedAccessViews(0, ARRAYSIZE(uavs), uavs, nullptr);
+	auto ambientComposite = [&]() {
+		ID3D11Buffer* buffer = skylighting->loaded ? skylighting->skylightingCB->CB() : nullptr;
+		context->CSSetConstantBuffers(1, 1, &buffer);
 
-			auto shader = interior ? GetComputeAmbientCompositeInterior() : GetComputeAmbientComposite();
-			context->CSSetShader(shader, nullptr, 0);
+		ID3D11ShaderResourceView* srvs[5]{
+			albedo.SRV,
+			normalRoughness.SRV,
+			skylighting->loaded ? depth.depthSRV : nullptr,
+			skylighting->loaded ? skylighting->texProbeArray->srv.get() : nullptr,
+			ssgi->loaded ? ssgi->texGI[ssgi->outputGIIdx]->srv.get() : nullptr,
+		};
 
-			context->Dispatch(dispatchCount.x, dispatchCount.y, 1);
+		context->CSSetShaderResources(0, ARRAYSIZE(srvs), srvs);
 
-			buffer = nullptr;
-			context->CSSetConstantBuffers(0, 1, &buffer);
-		}
-	}
+		ID3D11UnorderedAccessView* uavs[2]{ main.UAV, prevDiffuseAmbientTexture->uav.get() };
+		context->CSSetUnorderedAccessViews(0, ARRAYSIZE(uavs), uavs, nullptr);
 
-	auto sss = SubsurfaceScattering::GetSingleton();
-	if (sss->loaded)
-		sss->DrawSSS();
+		auto shader = interior ? GetComputeAmbientCompositeInterior() : GetComputeAmbientComposite();
+		context->CSSetShader(shader, nullptr, 0);
 
-	auto dynamicCubemaps = DynamicCubemaps::GetSingleton();
-	if (dynamicCubemaps->loaded)
-		dynamicCubemaps->UpdateCubemap();
+		context->Dispatch(dispatchCount.x, dispatchCount.y, 1);
 
-	auto terrainBlending = TerrainBlending::GetSingleton();
+		buffer = nullptr;
+		context->CSSetConstantBuffers(0, 1, &buffer);
+	};
 
-	// Deferred Composite
-	{
+	// with a_ambient, also runs the ambient composite in the same dispatch
+	auto mainComposite = [&](bool a_ambient) {
 		ID3D11Buffer* buffer = skylighting->loaded ? skylighting->skylightingCB->CB() : nullptr;
 		context->CSSetConstantBuffers(1, 1, &buffer);
 
-		ID3D11ShaderResourceView* srvs[10]{
+		ID3D11ShaderResourceView* srvs[12]{
 			specular.SRV,
 			albedo.SRV,
 			normalRoughness.SRV,
@@ -482,7 +581,9 @@ void Deferred::DeferredPasses()
 			dynamicCubemaps->loaded ? reflectance.SRV : nullptr,
 			dynamicCubemaps->loaded ? dynamicCubemaps->envTexture->srv.get() : nullptr,
 			dynamicCubemaps->loaded ? dynamicCubemaps->envReflectionsTexture->srv.get() : nullptr,
-			dynamicCubemaps->loaded && skylighting->loaded ? skylighting->texProbeArray->srv.get() : nullptr
+			(dynamicCubemaps->loaded || a_ambient) && skylighting->loaded ? skylighting->texProbeArray->srv.get() : nullptr,
+			a_ambient && skylighting->loaded ? depth.depthSRV : nullptr,
+			a_ambient && ssgi->loaded ? ssgi->texGI[ssgi->outputGIIdx]->srv.get() : nullptr
 		};
 
 		if (dynamicCubemaps->loaded)
@@ -490,24 +591,67 @@ void Deferred::DeferredPasses()
 
 		context->CSSetShaderResources(0, ARRAYSIZE(srvs), srvs);
 
-		ID3D11UnorderedAccessView* uavs[3]{ main.UAV, normals.UAV, snow.UAV };
+		ID3D11UnorderedAccessView* uavs[4]{ main.UAV, normals.UAV, snow.UAV, a_ambient ? prevDiffuseAmbientTexture->uav.get() : nullptr };
 		context->CSSetUnorderedAccessViews(0, ARRAYSIZE(uavs), uavs, nullptr);
 
-		auto shader = interior ? GetComputeMainCompositeInterior() : GetComputeMainComposite();
+		ID3D11ComputeShader* shader;
+		if (a_ambient)
+			shader = interior ? GetComputeAmbientMainCompositeInterior() : GetComputeAmbientMainComposite();
+		else
+			shader = interior ? GetComputeMainCompositeInterior() : GetComputeMainComposite();
 		context->CSSetShader(shader, nullptr, 0);
 
 		context->Dispatch(dispatchCount.x, dispatchCount.y, 1);
 
 		buffer = nullptr;
 		context->CSSetConstantBuffers(0, 1, &buffer);
+	};
+
+	uint enabledPasses = 1 << DeferredPass::DeferredComposite;
+	if (ssgi->loaded)
+		enabledPasses |= 1 << DeferredPass::SSGI | 1 << DeferredPass::AmbientComposite;
+	if (sss->loaded && sss->validMaterials)
+		enabledPasses |= 1 << DeferredPass::SubsurfaceScattering;
+	if (dynamicCubemaps->loaded)
+		enabledPasses |= 1 << DeferredPass::DynamicCubemaps;
+
+	if (enabledPasses != scheduledPasses) {
+		passSchedule = BuildPassSchedule(enabledPasses);
+		scheduledPasses = enabledPasses;
+	}
+
+	for (auto& step : passSchedule) {
+		// only the two composites are fusable
+		if (step.size() > 1) {
+			mainComposite(true);
+			continue;
+		}
+
+		switch (step[0]) {
+		case DeferredPass::SSGI:
+			ssgi->DrawSSGI(prevDiffuseAmbientTexture);
+			break;
+		case DeferredPass::AmbientComposite:
+			ambientComposite();
+			break;
+		case DeferredPass::SubsurfaceScattering:
+			sss->DrawSSS();
+			break;
+		case DeferredPass::DynamicCubemaps:
+			dynamicCubemaps->UpdateCubemap();
+			break;
+		case DeferredPass::DeferredComposite:
+			mainComposite(false);
+			break;
+		}
 	}
 
 	// Clear
 	{
-		ID3D11ShaderResourceView* views[10]{ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+		ID3D11ShaderResourceView* views[12]{ nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
 		context->CSSetShaderResources(0, ARRAYSIZE(views), views);
 
-		ID3D11UnorderedAccessView* uavs[3]{ nullptr, nullptr, nullptr };
+		ID3D11UnorderedAccessView* uavs[4]{ nullptr, nullptr, nullptr, nullptr };
 		context->CSSetUnorderedAccessViews(0, ARRAYSIZE(uavs), uavs, nullptr);
 
 		ID3D11Buffer* buffer = nullptr;
@@ -694,6 +838,14 @@ void Deferred::ClearShaderCache()
 		mainCompositeInteriorCS->Release();
 		mainCompositeInteriorCS = nullptr;
 	}
+	if (ambientMainCompositeCS) {
+		ambientMainCompositeCS->Release();
+		ambientMainCompositeCS = nullptr;
+	}
+	if (ambientMainCompositeInteriorCS) {
+		ambientMainCompositeInteriorCS->Release();
+		ambientMainCompositeInteriorCS = nullptr;
+	}
 }
 
 ID3D11ComputeShader* Deferred::GetComputeAmbientComposite()
@@ -763,4 +915,46 @@ ID3D11ComputeShader* Deferred::GetComputeMainCompositeInterior()
 		mainCompositeInteriorCS = static_cast<ID3D11ComputeShader*>(Util::CompileShader(L"Data\\Shaders\\DeferredCompositeCS.hlsl", defines, "cs_5_0"));
 	}
 	return mainCompositeInteriorCS;
-}
\ No newline at end of file
+}
+
+ID3D11ComputeShader* Deferred::GetComputeAmbientMainComposite()
+{
+	if (!ambientMainCompositeCS) {
+		logger::debug("Compiling DeferredCompositeCS AMBIENT_COMPOSITE");
+
+		std::vector<std::pair<const char*, const char*>> defines;
+		defines.push_back({ "AMBIENT_COMPOSITE", nullptr });
+
+		if (DynamicCubemaps::GetSingleton()->loaded)
+			defines.push_back({ "DYNAMIC_CUBEMAPS", nullptr });
+
+		if (Skylighting::GetSingleton()->loaded)
+			defines.push_back({ "SKYLIGHTING", nullptr });
+
+		if (ScreenSpaceGI::GetSingleton()->loaded)
+			defines.push_back({ "SSGI", nullptr });
+
+		ambientMainCompositeCS = static_cast<ID3D11ComputeShader*>(Util::CompileShader(L"Data\\Shaders\\DeferredCompositeCS.hlsl", defines, "cs_5_0"));
+	}
+	return ambientMainCompositeCS;
+}
+
+ID3D11ComputeShader* Deferred::GetComputeAmbientMainCompositeInterior()
+{
+	if (!ambientMainCompositeInteriorCS) {
+		logger::debug("Compiling DeferredCompositeCS AMBIENT_COMPOSITE INTERIOR");
+
+		std::vector<std::pair<const char*, const char*>> defines;
+		defines.push_back({ "AMBIENT_COMPOSITE", nullptr });
+		defines.push_back({ "INTERIOR", nullptr });
+
+		if (DynamicCubemaps::GetSingleton()->loaded)
+			defines.push_back({ "DYNAMIC_CUBEMAPS", nullptr });
+
+		if (ScreenSpaceGI::GetSingleton()->loaded)
+			defines.push_back({ "SSGI", nullptr });
+
+		ambientMainCompositeInteriorCS = static_cast<ID3D11ComputeShader*>(Util::CompileShader(L"Data\\Shaders\\DeferredCompositeCS.hlsl", defines, "cs_5_0"));
+	}
+	return ambientMainCompositeInteriorCS;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Buffer.h"
+#include "ShadowCopyLayout.h"
 #include "State.h"
 #include "Util.h"
 
@@ -10,6 +11,7 @@
 #define NORMALROUGHNESS RE::RENDER_TARGETS::kRAWINDIRECT_DOWNSCALED
 #define MASKS RE::RENDER_TARGETS::kRAWINDIRECT_PREVIOUS
 #define MASKS2 RE::RENDER_TARGETS::kRAWINDIRECT_PREVIOUS_DOWNSCALED
+#define DISCARDED RE::RENDER_TARGETS::kRAWINDIRECT_SWAP
 
 class Deferred
 {
@@ -20,14 +22,25 @@ public:
 		return &singleton;
 	}
 
+	enum class GBufferLayout : uint
+	{
+		Wide,    // every target RGBA8 apart from R11G11B10 specular
+		Compact  // channels that are never read back are not stored, unread targets are not bound
+	};
+
+	// Saved setting, changes apply after a restart
+	GBufferLayout gbufferLayout = GBufferLayout::Wide;
+	// Layout the targets were created with, copied from gbufferLayout in SetupResources
+	GBufferLayout activeGBufferLayout = GBufferLayout::Wide;
+
 	void SetupResources();
 	void CopyShadowData();
+	bool CopyShadowConstants();
 	void StartDeferred();
 	void OverrideBlendStates();
 	void ResetBlendStates();
 	void DeferredPasses();
 	void EndDeferred();
-	void UpdateConstantBuffer();
 
 	void PrepassPasses();
 
@@ -37,6 +50,8 @@ public:
 	ID3D11ComputeShader* GetComputeMainComposite();
 
 	ID3D11ComputeShader* GetComputeMainCompositeInterior();
+	ID3D11ComputeShader* GetComputeAmbientMainComposite();
+	ID3D11ComputeShader* GetComputeAmbientMainCompositeInterior();
 
 	ID3D11BlendState* deferredBlendStates[7];
 	ID3D11BlendState* forwardBlendStates[7];
@@ -48,41 +63,21 @@ public:
 	ID3D11ComputeShader* mainCompositeCS = nullptr;
 	ID3D11ComputeShader* mainCompositeInteriorCS = nullptr;
 
+	ID3D11ComputeShader* ambientMainCompositeCS = nullptr;
+	ID3D11ComputeShader* ambientMainCompositeInteriorCS = nullptr;
+
 	bool inWorld = false;
 	bool deferredPass = false;
 
 	Texture2D* prevDiffuseAmbientTexture = nullptr;
 
-	struct alignas(16) DeferredCB
-	{
-		float4 BufferDim;
-		float4 CameraData;
-		DirectX::XMFLOAT3X4 DirectionalAmbient;
-		uint FrameCount;
-		uint FrameCountAlwaysActive;
-		uint pad0[2];
-	};
-
-	ConstantBuffer* deferredCB = nullptr;
-
 	ID3D11SamplerState* linearSampler = nullptr;
 
-	struct alignas(16) PerGeometry
-	{
-		float4 VPOSOffset;
-		float4 ShadowSampleParam;    // fPoissonRadiusScale / iShadowMapResolution in z and w
-		float4 EndSplitDistances;    // cascade end distances int xyz, cascade count int z
-		float4 StartSplitDistances;  // cascade start ditances int xyz, 4 int z
-		float4 FocusShadowFadeParam;
-		float4 DebugColor;
-		float4 PropertyColor;
-		float4 AlphaTestRef;
-		float4 ShadowLightParam;  // Falloff in x, ShadowDistance squared in z
-		DirectX::XMFLOAT4X3 FocusShadowMapProj[4];
-		// Since PerGeometry is passed between c++ and hlsl, can't have different defines due to strong typing
-		DirectX::XMFLOAT4X3 ShadowMapProj[2][3];
-		DirectX::XMFLOAT4X3 CameraViewProjInverse[2];
-	};
+	// Schedule of DeferredPasses, rebuilt when the set of enabled passes changes
+	uint scheduledPasses = 0;
+	std::vector<std::vector<uint>> passSchedule;
+
+	using PerGeometry = ShadowCopyLayout::PerGeometry;
 
 	ID3D11ComputeShader* copyShadowCS = nullptr;
 	Buffer* perShadow = nullptr;
@@ -0,0 +1,35 @@
+#include "DeferredPassGraph.h"
+
+uint DeferredPassGraph::AddPass(Pass a_pass)
+{
+	passes.push_back(std::move(a_pass));
+	return (uint)passes.size() - 1;
+}
+
+bool DeferredPassGraph::DependsAcrossPixels(const Pass& a_reader, const Pass& a_writer) const
+{
+	return std::ranges::any_of(a_reader.reads, [&](const Read& read) {
+		return read.access == Access::Neighbourhood && std::ranges::find(a_writer.writes, read.resource) != a_writer.writes.end();
+	});
+}
+
+std::vector<std::vector<uint>> DeferredPassGraph::Schedule() const
+{
+	std::vector<std::vector<uint>> steps;
+
+	for (uint index = 0; index < passes.size(); index++) {
+		const auto& pass = passes[index];
+
+		bool fuse = pass.fusable && !steps.empty() && std::ranges::all_of(steps.back(), [&](uint other) {
+			// both orders matter, a neighbourhood read of either can see the other half finished or not
+			return passes[other].fusable && !DependsAcrossPixels(pass, passes[other]) && !DependsAcrossPixels(passes[other], pass);
+		});
+
+		if (fuse)
+			steps.back().push_back(index);
+		else
+			steps.push_back({ index });
+	}
+
+	return steps;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Groups neighbouring full-screen deferred passes into one dispatch unless one reads other pixels of what the other writes
+class DeferredPassGraph
+{
+public:
+	enum class Access
+	{
+		Pixel,         // only the pixel being shaded
+		Neighbourhood  // any pixel
+	};
+
+	struct Read
+	{
+		uint resource;
+		Access access = Access::Pixel;
+	};
+
+	struct Pass
+	{
+		std::string_view name;
+		std::vector<Read> reads;
+		std::vector<uint> writes;
+		bool fusable = false;  // one thread per pixel over the whole screen
+	};
+
+	uint AddPass(Pass a_pass);
+	const Pass& GetPass(uint a_pass) const { return passes[a_pass]; }
+
+	/**
+	 * @return Passes grouped into steps that each run as one dispatch, in execution order
+	 */
+	std::vector<std::vector<uint>> Schedule() const;
+
+private:
+	bool DependsAcrossPixels(const Pass& a_reader, const Pass& a_writer) const;
+
+	std::vector<Pass> passes;
+};
@@ -7,6 +7,28 @@
 #include <DirectXTex.h>
 
 constexpr auto MIPLEVELS = 8;
+static_assert(CubemapScheduler::MipCount == MIPLEVELS);
+static_assert(PrefilterSamples::MaxMips == MIPLEVELS - 1);
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(
+	DynamicCubemaps::UpdateSettings,
+	FacesPerFrame,
+	MipsPerFrame)
+
+void DynamicCubemaps::LoadSettings(json& o_json)
+{
+	updateSettings = o_json;
+}
+
+void DynamicCubemaps::SaveSettings(json& o_json)
+{
+	o_json = updateSettings;
+}
+
+void DynamicCubemaps::RestoreDefaultSettings()
+{
+	updateSettings = {};
+}
 
 void DynamicCubemaps::DrawSettings()
 {
@@ -38,6 +60,18 @@ void DynamicCubemaps::DrawSettings()
 			}
 		}
 
+		if (ImGui::TreeNodeEx("Update Budget", ImGuiTreeNodeFlags_DefaultOpen)) {
+			ImGui::SliderInt("Faces Per Frame", (int*)&updateSettings.FacesPerFrame, 1, CubemapScheduler::FaceCount);
+			if (auto _tt = Util::HoverTooltipWrapper())
+				ImGui::Text("Cubemap faces captured and inferred each frame. Faces in front of the camera are updated first.");
+
+			ImGui::SliderInt("Mips Per Frame", (int*)&updateSettings.MipsPerFrame, 1, CubemapScheduler::FaceCount * (MIPLEVELS - 1));
+			if (auto _tt = Util::HoverTooltipWrapper())
+				ImGui::Text("Face mip levels prefiltered for rough reflections each frame.");
+
+			ImGui::TreePop();
+		}
+
 		if (ImGui::TreeNodeEx("Dynamic Cubemap Creator", ImGuiTreeNodeFlags_DefaultOpen)) {
 			ImGui::Text("You must enable creator mode by adding the shader define CREATOR");
 			ImGui::Checkbox("Enable Creator", (bool*)&settings.Enabled);
@@ -140,7 +174,7 @@ RE::BSEventNotifyControl MenuOpenCloseEventHandler::ProcessEvent(const RE::MenuO
 	// When entering a new cell, reset the capture
 	if (a_event->menuName == RE::LoadingMenu::MENU_NAME) {
 		if (!a_event->opening)
-			DynamicCubemaps::GetSingleton()->resetCapture = true;
+			DynamicCubemaps::GetSingleton()->scheduler.RequestReset(true);
 	}
 	return RE::BSEventNotifyControl::kContinue;
 }
@@ -218,7 +252,7 @@ ID3D11ComputeShader* DynamicCubemaps::GetComputeShaderSpecularIrradiance()
 	return specularIrradianceCS;
 }
 
-void DynamicCubemaps::UpdateCubemapCapture()
+void DynamicCubemaps::UpdateCubemapCapture(const CubemapScheduler::Plan& a_plan)
 {
 	auto renderer = RE::BSGraphics::Renderer::GetSingleton();
 
@@ -235,28 +269,28 @@ void DynamicCubemaps::UpdateCubemapCapture()
 
 	ID3D11Buffer* buffers[2];
 	context->PSGetConstantBuffers(12, 1, buffers);
-
-	UpdateCubemapCB updateData{};
-	updateData.Reset = resetCapture;
-
-	static float3 cameraPreviousPosAdjust = { 0, 0, 0 };
-	updateData.CameraPreviousPosAdjust = cameraPreviousPosAdjust;
-
-	auto eyePosition = Util::GetEyePosition(0);
-
-	cameraPreviousPosAdjust = { eyePosition.x, eyePosition.y, eyePosition.z };
-
-	updateCubemapCB->Update(updateData);
 	buffers[1] = updateCubemapCB->CB();
 
 	context->CSSetConstantBuffers(0, 2, buffers);
 
-	resetCapture = false;
-
 	context->CSSetSamplers(0, 1, &computeSampler);
 
 	context->CSSetShader(GetComputeShaderUpdate(), nullptr, 0);
-	context->Dispatch((uint32_t)std::ceil(envCaptureTexture->desc.Width / 8.0f), (uint32_t)std::ceil(envCaptureTexture->desc.Height / 8.0f), 6);
+
+	auto eyePosition = Util::GetEyePosition(0);
+
+	// faces skipped for a while reproject by everything the camera moved since they were last captured
+	for (auto face : a_plan.captureFaces) {
+		UpdateCubemapCB updateData{};
+		updateData.Reset = a_plan.reset;
+		updateData.CameraPreviousPosAdjust = facePreviousPosAdjust[face];
+		updateData.Face = face;
+		updateCubemapCB->Update(updateData);
+
+		facePreviousPosAdjust[face] = { eyePosition.x, eyePosition.y, eyePosition.z };
+
+		context->Dispatch((uint32_t)std::ceil(envCaptureTexture->desc.Width / 8.0f), (uint32_t)std::ceil(envCaptureTexture->desc.Height / 8.0f), 1);
+	}
 
 	uavs[0] = nullptr;
 	uavs[1] = nullptr;
@@ -277,13 +311,15 @@ void DynamicCubemaps::UpdateCubemapCapture()
 	context->CSSetSamplers(0, 1, &nullSampler);
 }
 
-void DynamicCubemaps::Inferrence(bool a_reflections)
+void DynamicCubemaps::Inferrence(bool a_reflections, std::span<const uint> a_faces)
 {
 	auto renderer = RE::BSGraphics::Renderer::GetSingleton();
 	auto& context = State::GetSingleton()->context;
 
+	auto inferredTexture = a_reflections ? envInferredReflectionsTexture : envInferredTexture;
+
 	// Infer local reflection information
-	ID3D11UnorderedAccessView* uav = envInferredTexture->uav.get();
+	ID3D11UnorderedAccessView* uav = inferredTexture->uav.get();
 
 	context->CSSetUnorderedAccessViews(0, 1, &uav, nullptr);
 
@@ -296,9 +332,18 @@ void DynamicCubemaps::Inferrence(bool a_reflections)
 
 	context->CSSetSamplers(0, 1, &computeSampler);
 
+	ID3D11Buffer* buffer = inferCubemapCB->CB();
+	context->CSSetConstantBuffers(0, 1, &buffer);
+
 	context->CSSetShader(a_reflections ? GetComputeShaderInferrenceReflections() : GetComputeShaderInferrence(), nullptr, 0);
 
-	context->Dispatch((uint32_t)std::ceil(envCaptureTexture->desc.Width / 8.0f), (uint32_t)std::ceil(envCaptureTexture->desc.Height / 8.0f), 6);
+	for (auto face : a_faces) {
+		InferCubemapCB inferData{};
+		inferData.Face = face;
+		inferCubemapCB->Update(inferData);
+
+		context->Dispatch((uint32_t)std::ceil(envCaptureTexture->desc.Width / 8.0f), (uint32_t)std::ceil(envCaptureTexture->desc.Height / 8.0f), 1);
+	}
 
 	srvs[0] = nullptr;
 	srvs[1] = nullptr;
@@ -309,94 +354,101 @@ void DynamicCubemaps::Inferrence(bool a_reflections)
 
 	context->CSSetUnorderedAccessViews(0, 1, &uav, nullptr);
 
+	buffer = nullptr;
+	context->CSSetConstantBuffers(0, 1, &buffer);
+
 	context->CSSetShader(nullptr, 0, 0);
 
 	ID3D11SamplerState* sampler = nullptr;
 	context->CSSetSamplers(0, 1, &sampler);
 }
 
-void DynamicCubemaps::Irradiance(bool a_reflections)
+void DynamicCubemaps::Irradiance(bool a_reflections, std::span<const uint> a_faces, std::span<const std::pair<uint, uint>> a_mips)
 {
 	auto& context = State::GetSingleton()->context;
 
+	auto inferredTexture = a_reflections ? envInferredReflectionsTexture : envInferredTexture;
+	auto outputTexture = a_reflections ? envReflectionsTexture : envTexture;
+
 	// Copy cubemap to other resources
-	for (uint face = 0; face < 6; face++) {
-		uint srcSubresourceIndex = D3D11CalcSubresource(0, face, MIPLEVELS);
-		context->CopySubresourceRegion(a_reflections ? envReflectionsTexture->resource.get() : envTexture->resource.get(), D3D11CalcSubresource(0, face, MIPLEVELS), 0, 0, 0, envInferredTexture->resource.get(), srcSubresourceIndex, nullptr);
+	for (auto face : a_faces) {
+		uint subresourceIndex = D3D11CalcSubresource(0, face, MIPLEVELS);
+		context->CopySubresourceRegion(outputTexture->resource.get(), subresourceIndex, 0, 0, 0, inferredTexture->resource.get(), subresourceIndex, nullptr);
 	}
 
+	if (a_mips.empty())
+		return;
+
 	// Compute pre-filtered specular environment map.
 	{
-		auto srv = envInferredTexture->srv.get();
+		auto srv = inferredTexture->srv.get();
 		context->GenerateMips(srv);
 
+		// flatten every face mip into one row of groups
+		SpecularMapFilterSettingsCB spmapConstants{};
+		uint groupCount = 0;
+		std::uint32_t size = std::max(envTexture->desc.Width, envTexture->desc.Height);
+		for (auto [face, level] : a_mips) {
+			uint mipSize = std::max(1u, size >> level);
+			uint groupsPerRow = (mipSize + 7) / 8;
+			spmapConstants.items[spmapConstants.itemCount++] = { face, level, groupCount, mipSize };
+			groupCount += groupsPerRow * groupsPerRow;
+		}
+		spmapCB->Update(spmapConstants);
+
 		context->CSSetShaderResources(0, 1, &srv);
 		context->CSSetSamplers(0, 1, &computeSampler);
 		context->CSSetShader(GetComputeShaderSpecularIrradiance(), nullptr, 0);
 
-		ID3D11Buffer* buffer = spmapCB->CB();
-		context->CSSetConstantBuffers(0, 1, &buffer);
-
-		float const delta_roughness = 1.0f / std::max(float(MIPLEVELS - 1), 1.0f);
-
-		std::uint32_t size = std::max(envTexture->desc.Width, envTexture->desc.Height);
-
-		for (std::uint32_t level = 1; level < MIPLEVELS; level++, size /= 2) {
-			const UINT numGroups = (UINT)std::max(1u, size / 8);
+		ID3D11Buffer* buffers[2] = { spmapCB->CB(), spmapSamplesCB->CB() };
+		context->CSSetConstantBuffers(0, 2, buffers);
 
-			const SpecularMapFilterSettingsCB spmapConstants = { level * delta_roughness };
-			spmapCB->Update(spmapConstants);
-
-			auto uav = a_reflections ? uavReflectionsArray[level - 1] : uavArray[level - 1];
-
-			context->CSSetUnorderedAccessViews(0, 1, &uav, nullptr);
-			context->Dispatch(numGroups, numGroups, 6);
-		}
+		context->CSSetUnorderedAccessViews(0, MIPLEVELS - 1, a_reflections ? uavReflectionsArray : uavArray, nullptr);
+		context->Dispatch(groupCount, 1, 1);
 	}
 
 	ID3D11ShaderResourceView* nullSRV = { nullptr };
 	ID3D11SamplerState* nullSampler = { nullptr };
-	ID3D11Buffer* nullBuffer = { nullptr };
-	ID3D11UnorderedAccessView* nullUAV = { nullptr };
+	ID3D11Buffer* nullBuffers[2] = { nullptr };
+	ID3D11UnorderedAccessView* nullUAVs[MIPLEVELS - 1] = { nullptr };
 
 	context->CSSetShaderResources(0, 1, &nullSRV);
 	context->CSSetSamplers(0, 1, &nullSampler);
 	context->CSSetShader(nullptr, 0, 0);
-	context->CSSetConstantBuffers(0, 1, &nullBuffer);
-	context->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
+	context->CSSetConstantBuffers(0, 2, nullBuffers);
+	context->CSSetUnorderedAccessViews(0, MIPLEVELS - 1, nullUAVs, nullptr);
 }
 
 void DynamicCubemaps::UpdateCubemap()
 {
-	switch (nextTask) {
-	case NextTask::kInferrence:
-		nextTask = NextTask::kIrradiance;
-		Inferrence(false);
-		break;
-
-	case NextTask::kIrradiance:
-		if (activeReflections)
-			nextTask = NextTask::kInferrence2;
-		else
-			nextTask = NextTask::kCapture;
-		Irradiance(false);
-		break;
-
-	case NextTask::kInferrence2:
-		Inferrence(true);
-		nextTask = NextTask::kIrradiance2;
-		break;
-
-	case NextTask::kIrradiance2:
-		nextTask = NextTask::kCapture;
-		Irradiance(true);
-		break;
-
-	case NextTask::kCapture:
-		UpdateCubemapCapture();
-		nextTask = NextTask::kInferrence;
-		break;
+	CubemapScheduler::Environment environment{ .reflections = activeReflections };
+
+	if (auto camera = RE::Main::WorldRootCamera()) {
+		auto& rotate = camera->world.rotate;
+		environment.cameraForward = { rotate.entry[0][0], rotate.entry[1][0], rotate.entry[2][0] };
 	}
+
+	if (auto sky = RE::Sky::GetSingleton()) {
+		environment.interior = sky->mode.get() != RE::Sky::Mode::kFull;
+		environment.weatherTransition = sky->currentWeatherPct;
+	}
+
+	auto shadowSceneNode = RE::BSShaderManager::State::GetSingleton().shadowSceneNode[0];
+	if (auto dirLight = skyrim_cast<RE::NiDirectionalLight*>(shadowSceneNode->GetRuntimeData().sunLight->light.get())) {
+		const auto& direction = dirLight->GetWorldDirection();
+		environment.sunDirection = { direction.x, direction.y, direction.z };
+		environment.sunDirection.Normalize();
+	}
+
+	auto plan = scheduler.Update(environment, std::chrono::steady_clock::now(), updateSettings.FacesPerFrame, updateSettings.MipsPerFrame);
+
+	UpdateCubemapCapture(plan);
+
+	bool reflections = plan.target == 1;
+	if (!plan.inferFaces.empty())
+		Inferrence(reflections, { plan.inferFaces.data(), plan.inferFaces.size() });
+	if (!plan.inferFaces.empty() || !plan.prefilterMips.empty())
+		Irradiance(reflections, { plan.inferFaces.data(), plan.inferFaces.size() }, { plan.prefilterMips.data(), plan.prefilterMips.size() });
 }
 
 void DynamicCubemaps::PostDeferred()
@@ -481,11 +533,20 @@ void DynamicCubemaps::SetupResources()
 		envInferredTexture->CreateSRV(srvDesc);
 		envInferredTexture->CreateUAV(uavDesc);
 
+		envInferredReflectionsTexture = new Texture2D(texDesc);
+		envInferredReflectionsTexture->CreateSRV(srvDesc);
+		envInferredReflectionsTexture->CreateUAV(uavDesc);
+
 		updateCubemapCB = new ConstantBuffer(ConstantBufferDesc<UpdateCubemapCB>());
+		inferCubemapCB = new ConstantBuffer(ConstantBufferDesc<InferCubemapCB>());
 	}
 
 	{
 		spmapCB = new ConstantBuffer(ConstantBufferDesc<SpecularMapFilterSettingsCB>());
+
+		// samples only depend on roughness and the source size, so they are generated once
+		spmapSamplesCB = new ConstantBuffer(ConstantBufferDesc<PrefilterSamples::Table>());
+		spmapSamplesCB->Update(PrefilterSamples::Generate(std::max(envInferredTexture->desc.Width, envInferredTexture->desc.Height), MIPLEVELS));
 	}
 
 	{
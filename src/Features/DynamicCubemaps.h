@@ -2,6 +2,8 @@
 
 #include "Buffer.h"
 #include "Feature.h"
+#include "Features/DynamicCubemaps/CubemapScheduler.h"
+#include "Features/DynamicCubemaps/PrefilterSamples.h"
 
 class MenuOpenCloseEventHandler : public RE::BSTEventSink<RE::MenuOpenCloseEvent>
 {
@@ -23,14 +25,23 @@ public:
 
 	ID3D11SamplerState* computeSampler = nullptr;
 
+	// every face mip prefiltered this frame, in one dispatch
 	struct alignas(16) SpecularMapFilterSettingsCB
 	{
-		float roughness;
-		float pad[3];
+		struct
+		{
+			uint face;
+			uint mip;
+			uint firstGroup;
+			uint size;
+		} items[CubemapScheduler::FaceCount * (CubemapScheduler::MipCount - 1)];
+		uint itemCount;
+		uint pad0[3];
 	};
 
 	ID3D11ComputeShader* specularIrradianceCS = nullptr;
 	ConstantBuffer* spmapCB = nullptr;
+	ConstantBuffer* spmapSamplesCB = nullptr;
 	Texture2D* envTexture = nullptr;
 	Texture2D* envReflectionsTexture = nullptr;
 	ID3D11UnorderedAccessView* uavArray[7];
@@ -42,34 +53,43 @@ public:
 	{
 		uint Reset;
 		float3 CameraPreviousPosAdjust;
+		uint Face;
+		uint pad0[3];
 	};
 
 	ID3D11ComputeShader* updateCubemapCS = nullptr;
 	ConstantBuffer* updateCubemapCB = nullptr;
 
+	struct alignas(16) InferCubemapCB
+	{
+		uint Face;
+		uint pad0[3];
+	};
+
 	ID3D11ComputeShader* inferCubemapCS = nullptr;
 	ID3D11ComputeShader* inferCubemapReflectionsCS = nullptr;
+	ConstantBuffer* inferCubemapCB = nullptr;
 
 	Texture2D* envCaptureTexture = nullptr;
 	Texture2D* envCaptureRawTexture = nullptr;
 	Texture2D* envCapturePositionTexture = nullptr;
 	Texture2D* envInferredTexture = nullptr;
+	Texture2D* envInferredReflectionsTexture = nullptr;
 
 	ID3D11ShaderResourceView* defaultCubemap = nullptr;
 
 	bool activeReflections = false;
-	bool resetCapture = true;
 
-	enum class NextTask
+	CubemapScheduler scheduler;
+	float3 facePreviousPosAdjust[CubemapScheduler::FaceCount]{};
+
+	struct UpdateSettings
 	{
-		kCapture,
-		kInferrence,
-		kInferrence2,
-		kIrradiance,
-		kIrradiance2
+		uint FacesPerFrame = 2;
+		uint MipsPerFrame = 6;
 	};
 
-	NextTask nextTask = NextTask::kCapture;
+	UpdateSettings updateSettings;
 
 	// Editor window
 
@@ -97,6 +117,10 @@ public:
 	virtual void DrawSettings() override;
 	virtual void DataLoaded() override;
 
+	virtual void LoadSettings(json& o_json) override;
+	virtual void SaveSettings(json& o_json) override;
+	virtual void RestoreDefaultSettings() override;
+
 	std::vector<std::string> iniVRCubeMapSettings{
 		{ "bAutoWaterSilhouetteReflections:Water" },  //IniSettings 0x1eaa018
 		{ "bForceHighDetailReflections:Water" },      //IniSettings 0x1eaa030
@@ -117,11 +141,11 @@ public:
 	ID3D11ComputeShader* GetComputeShaderInferrenceReflections();
 	ID3D11ComputeShader* GetComputeShaderSpecularIrradiance();
 
-	void UpdateCubemapCapture();
+	void UpdateCubemapCapture(const CubemapScheduler::Plan& a_plan);
 
-	void Inferrence(bool a_reflections);
+	void Inferrence(bool a_reflections, std::span<const uint> a_faces);
 
-	void Irradiance(bool a_reflections);
+	void Irradiance(bool a_reflections, std::span<const uint> a_faces, std::span<const std::pair<uint, uint>> a_mips);
 
 	virtual bool SupportsVR() override { return true; };
 };
@@ -0,0 +1,141 @@
+#include "Features/DynamicCubemaps/CubemapScheduler.h"
+
+void CubemapScheduler::RequestReset(bool a_immediate)
+{
+	if (a_immediate) {
+		immediateReset = true;
+		return;
+	}
+	lastResetRequest = std::chrono::steady_clock::now().time_since_epoch().count();
+	deferredReset = true;
+}
+
+bool CubemapScheduler::ConsumeReset(std::chrono::steady_clock::time_point a_now)
+{
+	if (immediateReset.exchange(false)) {
+		deferredReset = false;
+		return true;
+	}
+	if (!deferredReset)
+		return false;
+
+	auto lastRequest = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(lastResetRequest.load()));
+	if (a_now - lastRequest < ResetSettleTime)
+		return false;
+	return deferredReset.exchange(false);
+}
+
+bool CubemapScheduler::EnvironmentChanged(const Environment& a_environment)
+{
+	if (!reference) {
+		reference = a_environment;
+		return false;
+	}
+
+	bool changed = a_environment.sunDirection.Dot(reference->sunDirection) < SunChangeCos ||
+	               std::abs(a_environment.weatherTransition - reference->weatherTransition) > WeatherChange;
+	if (changed)
+		reference = a_environment;
+	return changed;
+}
+
+void CubemapScheduler::MarkAllStale()
+{
+	for (uint face = 0; face < FaceCount; face++) {
+		captureAge[face] += FaceCount;
+		for (uint target = 0; target < TargetCount; target++)
+			inferPending[target][face] = true;
+	}
+}
+
+CubemapScheduler::Plan CubemapScheduler::Update(const Environment& a_environment, std::chrono::steady_clock::time_point a_now, uint a_facesPerFrame, uint a_mipsPerFrame)
+{
+	Plan plan;
+
+	a_facesPerFrame = std::clamp(a_facesPerFrame, 1u, FaceCount);
+
+	bool interiorChanged = reference && reference->interior != a_environment.interior;
+	if (ConsumeReset(a_now) || interiorChanged) {
+		plan.reset = true;
+		reference = a_environment;
+	} else if (EnvironmentChanged(a_environment)) {
+		MarkAllStale();
+	}
+
+	plan.target = a_environment.reflections ? nextTarget : 0;
+	nextTarget = (nextTarget + 1) % TargetCount;
+
+	std::array<float, FaceCount> visibility;
+	for (uint face = 0; face < FaceCount; face++)
+		visibility[face] = 1.f + VisibilityWeight * std::max(0.f, a_environment.cameraForward.Dot(GetCaptureDirection(face)));
+
+	std::array<uint, FaceCount> faces;
+	std::iota(faces.begin(), faces.end(), 0);
+
+	// capture, faces the camera looks at gather new samples, the rest only reproject so they can wait longer
+	if (plan.reset) {
+		plan.captureFaces.assign(faces.begin(), faces.end());
+		captureAge.fill(0);
+		for (auto& pending : inferPending)
+			pending.fill(true);
+	} else {
+		std::sort(faces.begin(), faces.end(), [&](uint a, uint b) {
+			return (captureAge[a] + 1) * visibility[a] > (captureAge[b] + 1) * visibility[b];
+		});
+		for (uint i = 0; i < FaceCount; i++) {
+			uint face = faces[i];
+			if (i < a_facesPerFrame) {
+				plan.captureFaces.push_back(face);
+				captureAge[face] = 0;
+				for (auto& pending : inferPending)
+					pending[face] = true;
+			} else {
+				captureAge[face]++;
+			}
+		}
+	}
+
+	// inference and prefiltering of the target, most visible faces first
+	std::sort(faces.begin(), faces.end(), [&](uint a, uint b) { return visibility[a] > visibility[b]; });
+
+	auto& pending = inferPending[plan.target];
+	auto& nextMip = nextPrefilterMip[plan.target];
+	for (auto face : faces) {
+		if (plan.inferFaces.size() >= a_facesPerFrame)
+			break;
+		if (pending[face]) {
+			plan.inferFaces.push_back(face);
+			pending[face] = false;
+			nextMip[face] = 1;
+		}
+	}
+
+	for (auto face : faces) {
+		for (; nextMip[face] != 0 && nextMip[face] < MipCount; nextMip[face]++) {
+			if (plan.prefilterMips.size() >= a_mipsPerFrame)
+				return plan;
+			plan.prefilterMips.emplace_back(face, nextMip[face]);
+		}
+	}
+
+	return plan;
+}
+
+float3 CubemapScheduler::GetCaptureDirection(uint a_face)
+{
+	// UpdateCubemapCS captures along the negated sampling vector of the face centre
+	switch (a_face) {
+	case 0:
+		return { -1, 0, 0 };
+	case 1:
+		return { 1, 0, 0 };
+	case 2:
+		return { 0, -1, 0 };
+	case 3:
+		return { 0, 1, 0 };
+	case 4:
+		return { 0, 0, -1 };
+	default:
+		return { 0, 0, 1 };
+	}
+}
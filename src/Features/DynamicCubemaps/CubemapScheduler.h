@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+/**
+ * Decides which dynamic cubemap faces and prefiltered mips are updated each frame.
+ * Faces are ranked by capture age weighted by how directly the camera faces them, and all go stale when the sun or weather moves on.
+ */
+class CubemapScheduler
+{
+public:
+	static constexpr uint FaceCount = 6;
+	static constexpr uint TargetCount = 2;  // environment, reflections
+	static constexpr uint MipCount = 8;     // prefiltered levels of each target, mip 0 is the inferred capture
+
+	static constexpr auto ResetSettleTime = std::chrono::seconds(2);
+	static constexpr float SunChangeCos = 0.9994f;  // ~2 degrees
+	static constexpr float WeatherChange = 0.05f;
+	static constexpr float VisibilityWeight = 4.f;
+
+	struct Environment
+	{
+		float3 cameraForward;
+		float3 sunDirection;
+		float weatherTransition = 1.f;
+		bool interior = false;
+		bool reflections = false;  // whether the reflections target is in use
+	};
+
+	struct Plan
+	{
+		bool reset = false;  // captureFaces then holds every face and the capture shader clears them
+		uint target = 0;
+		eastl::fixed_vector<uint, FaceCount, false> captureFaces;
+		eastl::fixed_vector<uint, FaceCount, false> inferFaces;                                  // of target
+		eastl::fixed_vector<std::pair<uint, uint>, FaceCount * MipCount, false> prefilterMips;  // face and mip of target
+	};
+
+	/**
+	 * Ask for the capture to be cleared, callable from any thread.
+	 *
+	 * @param a_immediate Clear on the next update, otherwise wait until requests stop for ResetSettleTime
+	 */
+	void RequestReset(bool a_immediate);
+
+	Plan Update(const Environment& a_environment, std::chrono::steady_clock::time_point a_now, uint a_facesPerFrame, uint a_mipsPerFrame);
+
+	// world direction captured by a face, mirrors GetSamplingVector in UpdateCubemapCS
+	static float3 GetCaptureDirection(uint a_face);
+
+private:
+	bool ConsumeReset(std::chrono::steady_clock::time_point a_now);
+	bool EnvironmentChanged(const Environment& a_environment);
+	void MarkAllStale();
+
+	std::atomic<bool> immediateReset = true;
+	std::atomic<bool> deferredReset = false;
+	std::atomic<std::chrono::steady_clock::rep> lastResetRequest = 0;
+
+	std::array<uint, FaceCount> captureAge{};                            // updates since last captured
+	std::array<std::array<bool, FaceCount>, TargetCount> inferPending{};  // captured since last inferred
+	std::array<std::array<uint, FaceCount>, TargetCount> nextPrefilterMip{};
+	uint nextTarget = 0;
+
+	std::optional<Environment> reference;  // environment when the faces were last all marked stale
+};
@@ -0,0 +1,70 @@
+#include "Features/DynamicCubemaps/PrefilterSamples.h"
+
+#include <numbers>
+
+namespace PrefilterSamples
+{
+	// Van der Corput radical inverse, see http://holger.dammertz.org/stuff/notes_HammersleyOnHemisphere.html
+	static float RadicalInverse(uint a_bits)
+	{
+		a_bits = (a_bits << 16u) | (a_bits >> 16u);
+		a_bits = ((a_bits & 0x55555555u) << 1u) | ((a_bits & 0xAAAAAAAAu) >> 1u);
+		a_bits = ((a_bits & 0x33333333u) << 2u) | ((a_bits & 0xCCCCCCCCu) >> 2u);
+		a_bits = ((a_bits & 0x0F0F0F0Fu) << 4u) | ((a_bits & 0xF0F0F0F0u) >> 4u);
+		a_bits = ((a_bits & 0x00FF00FFu) << 8u) | ((a_bits & 0xFF00FF00u) >> 8u);
+		return float(a_bits) * 2.3283064365386963e-10f;
+	}
+
+	static float NdfGGX(float a_cosLh, float a_roughness)
+	{
+		float alpha = a_roughness * a_roughness;
+		float alphaSq = alpha * alpha;
+
+		float denom = (a_cosLh * a_cosLh) * (alphaSq - 1.0f) + 1.0f;
+		return alphaSq / (std::numbers::pi_v<float> * denom * denom);
+	}
+
+	float GetRoughness(uint a_mip, uint a_mipCount)
+	{
+		return a_mip / std::max(float(a_mipCount - 1), 1.0f);
+	}
+
+	Table Generate(uint a_inputSize, uint a_mipCount)
+	{
+		Table table{};
+
+		// solid angle of a texel of mip 0
+		float wt = 4.0f * std::numbers::pi_v<float> / (6.0f * a_inputSize * a_inputSize);
+
+		for (uint mip = 1; mip < std::min(a_mipCount, MaxMips + 1); mip++) {
+			float roughness = GetRoughness(mip, a_mipCount);
+			float alpha = roughness * roughness;
+
+			auto& count = table.mips[mip - 1].count;
+			for (uint i = 0; i < SampleCount; i++) {
+				// Hammersley point importance sampled against the GGX NDF
+				float u1 = float(i) / SampleCount;
+				float u2 = RadicalInverse(i);
+
+				float cosTheta = std::sqrt((1.0f - u2) / (1.0f + (alpha * alpha - 1.0f) * u2));
+				float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+				float phi = 2.0f * std::numbers::pi_v<float> * u1;
+
+				// reflecting the normal around the half vector, cos(Li) = 2 cos(Lh)^2 - 1
+				float cosLi = 2.0f * cosTheta * cosTheta - 1.0f;
+				if (cosLi <= 0.0f)
+					continue;
+
+				// mipmap filtered importance sampling, https://developer.nvidia.com/gpugems/GPUGems3/gpugems3_ch20.html
+				float pdf = NdfGGX(cosTheta, roughness) * 0.25f;
+				float ws = 1.0f / (SampleCount * pdf);
+				float sourceMip = std::max(0.5f * std::log2(ws / wt) + 1.0f, 0.0f);
+
+				table.samples[(mip - 1) * SampleCount + count] = { sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta, sourceMip };
+				count++;
+			}
+		}
+
+		return table;
+	}
+}
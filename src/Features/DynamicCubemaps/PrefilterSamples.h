@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * GGX importance samples for prefiltering the dynamic cubemap, generated once on the CPU.
+ * With view = normal the tangent space half vector and source mip of a sample only depend on roughness, and samples
+ * facing away from the normal are dropped here instead of per texel. The shader weights each sample by its cos(Li).
+ */
+namespace PrefilterSamples
+{
+	static constexpr uint SampleCount = 16;
+	static constexpr uint MaxMips = 7;  // prefiltered levels, mip 0 is copied as is
+
+	// matches SpecularSampleTable in SpecularIrradianceCS
+	struct alignas(16) Table
+	{
+		float4 samples[MaxMips * SampleCount];  // tangent space half vector, source mip
+		struct
+		{
+			uint count;
+			uint pad0[3];
+		} mips[MaxMips];
+	};
+
+	/**
+	 * @param a_inputSize Face size of mip 0 of the source cubemap
+	 * @param a_mipCount Mip levels of the output, including mip 0
+	 */
+	Table Generate(uint a_inputSize, uint a_mipCount);
+
+	float GetRoughness(uint a_mip, uint a_mipCount);
+}
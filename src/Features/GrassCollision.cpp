@@ -5,7 +5,9 @@
 
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(
 	GrassCollision::Settings,
-	EnableGrassCollision)
+	EnableGrassCollision,
+	Mode,
+	TrailDuration)
 
 void GrassCollision::DrawSettings()
 {
@@ -15,96 +17,87 @@ void GrassCollision::DrawSettings()
 			ImGui::Text("Allows player collision to modify grass position.");
 		}
 
+		{
+			static const char* comboOptions[] = { "Direct", "Displacement Field" };
+			ImGui::Combo("Mode", (int*)&settings.Mode, comboOptions, 2);
+			if (auto _tt = Util::HoverTooltipWrapper()) {
+				ImGui::Text(
+					"Direct tests every grass vertex against every collision. "
+					"Displacement Field draws collisions into a texture around the camera that grass reads once, "
+					"which costs the same for any number of actors and leaves trails behind.");
+			}
+		}
+
+		if (settings.Mode == (uint)CollisionMode::Field) {
+			ImGui::SliderFloat("Trail Duration", &settings.TrailDuration, 0.0f, 10.0f, "%.1f s");
+			if (auto _tt = Util::HoverTooltipWrapper()) {
+				ImGui::Text("How long bent grass takes to recover once nothing touches it.");
+			}
+		}
+
 		ImGui::TreePop();
 	}
 	if (ImGui::TreeNodeEx("Statistics", ImGuiTreeNodeFlags_DefaultOpen)) {
 		ImGui::Text(std::format("Active/Total Actors : {}/{}", activeActorCount, totalActorCount).c_str());
 		ImGui::Text(std::format("Total Collisions : {}", currentCollisionCount).c_str());
+		ImGui::Text(std::format("Candidates In Range : {}", candidateCount).c_str());
+		ImGui::Text(std::format("Cached Shape Bounds : {}", shapeBounds.size()).c_str());
 		ImGui::TreePop();
 	}
 }
 
-static bool GetShapeBound(RE::NiAVObject* a_node, RE::NiPoint3& centerPos, float& radius)
+static float GetShapeRadius(const RE::hkpShape* a_shape)
 {
-	RE::bhkNiCollisionObject* Colliedobj = nullptr;
-	if (a_node->collisionObject)
-		Colliedobj = a_node->collisionObject->AsBhkNiCollisionObject();
+	float upExtent = a_shape->GetMaximumProjection(RE::hkVector4{ 0.0f, 0.0f, 1.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
+	float downExtent = a_shape->GetMaximumProjection(RE::hkVector4{ 0.0f, 0.0f, -1.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
+	auto z_extent = (upExtent + downExtent) / 2.0f;
 
-	if (!Colliedobj)
-		return false;
+	float forwardExtent = a_shape->GetMaximumProjection(RE::hkVector4{ 0.0f, 1.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
+	float backwardExtent = a_shape->GetMaximumProjection(RE::hkVector4{ 0.0f, -1.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
+	auto y_extent = (forwardExtent + backwardExtent) / 2.0f;
 
-	RE::bhkRigidBody* bhkRigid = Colliedobj->body.get() ? Colliedobj->body.get()->AsBhkRigidBody() : nullptr;
-	RE::hkpRigidBody* hkpRigid = bhkRigid ? skyrim_cast<RE::hkpRigidBody*>(bhkRigid->referencedObject.get()) : nullptr;
-	if (bhkRigid && hkpRigid) {
-		RE::hkVector4 massCenter;
-		bhkRigid->GetCenterOfMassWorld(massCenter);
-		float massTrans[4];
-		_mm_store_ps(massTrans, massCenter.quad);
-		centerPos = RE::NiPoint3(massTrans[0], massTrans[1], massTrans[2]) * RE::bhkWorld::GetWorldScaleInverse();
-
-		const RE::hkpShape* shape = hkpRigid->collidable.GetShape();
-		if (shape) {
-			float upExtent = shape->GetMaximumProjection(RE::hkVector4{ 0.0f, 0.0f, 1.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			float downExtent = shape->GetMaximumProjection(RE::hkVector4{ 0.0f, 0.0f, -1.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			auto z_extent = (upExtent + downExtent) / 2.0f;
-
-			float forwardExtent = shape->GetMaximumProjection(RE::hkVector4{ 0.0f, 1.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			float backwardExtent = shape->GetMaximumProjection(RE::hkVector4{ 0.0f, -1.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			auto y_extent = (forwardExtent + backwardExtent) / 2.0f;
-
-			float leftExtent = shape->GetMaximumProjection(RE::hkVector4{ 1.0f, 0.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			float rightExtent = shape->GetMaximumProjection(RE::hkVector4{ -1.0f, 0.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			auto x_extent = (leftExtent + rightExtent) / 2.0f;
-
-			radius = sqrtf(x_extent * x_extent + y_extent * y_extent + z_extent * z_extent);
-
-			return true;
-		}
-	}
+	float leftExtent = a_shape->GetMaximumProjection(RE::hkVector4{ 1.0f, 0.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
+	float rightExtent = a_shape->GetMaximumProjection(RE::hkVector4{ -1.0f, 0.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
+	auto x_extent = (leftExtent + rightExtent) / 2.0f;
 
-	return false;
+	return sqrtf(x_extent * x_extent + y_extent * y_extent + z_extent * z_extent);
 }
 
-static bool GetShapeBound(RE::bhkNiCollisionObject* Colliedobj, RE::NiPoint3& centerPos, float& radius)
+bool GrassCollision::GetShapeBound(RE::bhkNiCollisionObject* a_object, RE::NiPoint3& a_centre, float& a_radius)
 {
-	if (!Colliedobj)
+	if (!a_object)
 		return false;
 
-	RE::bhkRigidBody* bhkRigid = Colliedobj->body.get() ? Colliedobj->body.get()->AsBhkRigidBody() : nullptr;
+	RE::bhkRigidBody* bhkRigid = a_object->body.get() ? a_object->body.get()->AsBhkRigidBody() : nullptr;
 	RE::hkpRigidBody* hkpRigid = bhkRigid ? skyrim_cast<RE::hkpRigidBody*>(bhkRigid->referencedObject.get()) : nullptr;
-	if (bhkRigid && hkpRigid) {
-		RE::hkVector4 massCenter;
-		bhkRigid->GetCenterOfMassWorld(massCenter);
-		float massTrans[4];
-		_mm_store_ps(massTrans, massCenter.quad);
-		centerPos = RE::NiPoint3(massTrans[0], massTrans[1], massTrans[2]) * RE::bhkWorld::GetWorldScaleInverse();
-
-		const RE::hkpShape* shape = hkpRigid->collidable.GetShape();
-		if (shape) {
-			float upExtent = shape->GetMaximumProjection(RE::hkVector4{ 0.0f, 0.0f, 1.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			float downExtent = shape->GetMaximumProjection(RE::hkVector4{ 0.0f, 0.0f, -1.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			auto z_extent = (upExtent + downExtent) / 2.0f;
-
-			float forwardExtent = shape->GetMaximumProjection(RE::hkVector4{ 0.0f, 1.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			float backwardExtent = shape->GetMaximumProjection(RE::hkVector4{ 0.0f, -1.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			auto y_extent = (forwardExtent + backwardExtent) / 2.0f;
-
-			float leftExtent = shape->GetMaximumProjection(RE::hkVector4{ 1.0f, 0.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			float rightExtent = shape->GetMaximumProjection(RE::hkVector4{ -1.0f, 0.0f, 0.0f, 0.0f }) * RE::bhkWorld::GetWorldScaleInverse();
-			auto x_extent = (leftExtent + rightExtent) / 2.0f;
-
-			radius = sqrtf(x_extent * x_extent + y_extent * y_extent + z_extent * z_extent);
-
-			return true;
-		}
-	}
+	if (!bhkRigid || !hkpRigid)
+		return false;
 
-	return false;
+	const RE::hkpShape* shape = hkpRigid->collidable.GetShape();
+	if (!shape)
+		return false;
+
+	RE::hkVector4 massCenter;
+	bhkRigid->GetCenterOfMassWorld(massCenter);
+	float massTrans[4];
+	_mm_store_ps(massTrans, massCenter.quad);
+	a_centre = RE::NiPoint3(massTrans[0], massTrans[1], massTrans[2]) * RE::bhkWorld::GetWorldScaleInverse();
+
+	// The projections are along the axes of the shape itself, so the radius holds for as long as the shape does
+	auto [bound, inserted] = shapeBounds.try_emplace(shape);
+	if (inserted)
+		bound->second.radius = GetShapeRadius(shape);
+	bound->second.lastVisit = visit;
+
+	a_radius = bound->second.radius;
+	return true;
 }
 
 void GrassCollision::UpdateCollisions(PerFrame& perFrameData)
 {
 	actorList.clear();
+	candidates.clear();
+	visit++;
 
 	// Actor query code from po3 under MIT
 	// https://github.com/powerof3/PapyrusExtenderSSE/blob/7a73b47bc87331bec4e16f5f42f2dbc98b66c3a7/include/Papyrus/Functions/Faction.h#L24C7-L46
@@ -127,12 +120,11 @@ void GrassCollision::UpdateCollisions(PerFrame& perFrameData)
 
 	RE::NiPoint3 cameraPosition = Util::GetAverageEyePosition();
 
+	// Gather everything in range first, crowds can have more shapes than fit and the nearest ones matter most
 	for (const auto actor : actorList) {
-		if (currentCollisionCount == 256)
-			break;
 		if (auto root = actor->Get3D(false)) {
 			auto position = actor->GetPosition();
-			if (cameraPosition.GetDistance(position) > 1024)  // Check against distance
+			if (cameraPosition.GetDistance(position) > MaxDistance)  // Check against distance
 				continue;
 
 			activeActorCount++;
@@ -141,27 +133,90 @@ void GrassCollision::UpdateCollisions(PerFrame& perFrameData)
 				float radius;
 				if (GetShapeBound(a_object, centerPos, radius)) {
 					radius *= 2.0f;
-					CollisionData data{};
-					RE::NiPoint3 eyePosition{};
-					for (int eyeIndex = 0; eyeIndex < eyeCount; eyeIndex++) {
-						eyePosition = Util::GetEyePosition(eyeIndex);
-						data.centre[eyeIndex].x = centerPos.x - eyePosition.x;
-						data.centre[eyeIndex].y = centerPos.y - eyePosition.y;
-						data.centre[eyeIndex].z = centerPos.z - eyePosition.z;
-					}
-					data.centre[0].w = radius;
-					perFrameData.collisionData[currentCollisionCount] = data;
-					currentCollisionCount++;
-					if (currentCollisionCount == 256)
-						return RE::BSVisit::BSVisitControl::kStop;
+					float distance = std::max(cameraPosition.GetDistance(centerPos) - radius, 0.0f);
+					if (distance <= MaxDistance)
+						candidates.push_back({ float3{ centerPos.x, centerPos.y, centerPos.z }, radius, distance * distance });
 				}
 				return RE::BSVisit::BSVisitControl::kContinue;
 			});
 		}
 	}
+
+	// Shapes that were not visited may be freed, their address could come back as another shape
+	for (auto bound = shapeBounds.begin(); bound != shapeBounds.end();) {
+		if (bound->second.lastVisit != visit)
+			bound = shapeBounds.erase(bound);
+		else
+			++bound;
+	}
+
+	candidateCount = (uint)candidates.size();
+	SelectNearestCandidates(candidates, MaxCollisions);
+
+	RE::NiPoint3 eyePositions[2];
+	for (int eyeIndex = 0; eyeIndex < eyeCount; eyeIndex++)
+		eyePositions[eyeIndex] = Util::GetEyePosition(eyeIndex);
+
+	for (const auto& candidate : candidates) {
+		CollisionData data{};
+		for (int eyeIndex = 0; eyeIndex < eyeCount; eyeIndex++) {
+			data.centre[eyeIndex].x = candidate.centre.x - eyePositions[eyeIndex].x;
+			data.centre[eyeIndex].y = candidate.centre.y - eyePositions[eyeIndex].y;
+			data.centre[eyeIndex].z = candidate.centre.z - eyePositions[eyeIndex].z;
+		}
+		data.centre[0].w = candidate.radius;
+		perFrameData.collisionData[currentCollisionCount++] = data;
+	}
 	perFrameData.numCollisions = currentCollisionCount;
 }
 
+void GrassCollision::UpdateField(const PerFrame& a_perFrame)
+{
+	auto shader = GetUpdateFieldCS();
+	if (!shader)
+		return;
+
+	auto eyePosNI = Util::GetEyePosition(0);
+	auto eyePosition = float3{ eyePosNI.x, eyePosNI.y, eyePosNI.z };
+	auto cameraPosNI = Util::GetAverageEyePosition();
+	field.Update({ cameraPosNI.x, cameraPosNI.y, cameraPosNI.z });
+
+	auto& origin = field.GetOrigin();
+	auto& previousOrigin = field.GetPreviousOrigin();
+
+	FieldCB fieldData{
+		.Origin = { origin[0], origin[1] },
+		.PreviousOrigin = { previousOrigin[0], previousOrigin[1] },
+		.OriginOffset = field.GetOriginOffset(eyePosition),
+		.Decay = GrassDisplacementField::GetDecay(RE::GetSecondsSinceLastFrame(), settings.TrailDuration),
+		.EyeHeight = eyePosition.z
+	};
+	fieldCB->Update(fieldData);
+
+	auto& context = State::GetSingleton()->context;
+
+	// the field is bound to the vertex shader from the previous frame
+	ID3D11ShaderResourceView* nullView = nullptr;
+	context->VSSetShaderResources(8, 1, &nullView);
+
+	ID3D11Buffer* buffers[2] = { fieldCB->CB(), perFrame->CB() };
+	context->CSSetConstantBuffers(0, 1, buffers);
+	context->CSSetConstantBuffers(5, 1, buffers + 1);
+
+	ID3D11UnorderedAccessView* uav = displacementField->uav.get();
+	context->CSSetUnorderedAccessViews(0, 1, &uav, nullptr);
+
+	context->CSSetShader(shader, nullptr, 0);
+	context->Dispatch(GrassDisplacementField::Resolution / 8, GrassDisplacementField::Resolution / 8, 1);
+
+	buffers[0] = nullptr;
+	uav = nullptr;
+	context->CSSetConstantBuffers(0, 1, buffers);
+	context->CSSetConstantBuffers(5, 1, buffers);
+	context->CSSetUnorderedAccessViews(0, 1, &uav, nullptr);
+	context->CSSetShader(nullptr, nullptr, 0);
+}
+
 void GrassCollision::Update()
 {
 	if (updatePerFrame) {
@@ -169,13 +224,31 @@ void GrassCollision::Update()
 
 		perFrameData.numCollisions = 0;
 		currentCollisionCount = 0;
+		candidateCount = 0;
 		totalActorCount = 0;
 		activeActorCount = 0;
 
 		if (settings.EnableGrassCollision)
 			UpdateCollisions(perFrameData);
 
-		perFrame->Update(perFrameData);
+		bool useField = settings.EnableGrassCollision && settings.Mode == (uint)CollisionMode::Field;
+		if (useField) {
+			perFrameData.useField = true;
+			perFrameData.fieldSize = GrassDisplacementField::Size;
+			for (int eyeIndex = 0; eyeIndex < eyeCount; eyeIndex++) {
+				auto eyePosNI = Util::GetEyePosition(eyeIndex);
+				auto eyePosition = float3{ eyePosNI.x, eyePosNI.y, eyePosNI.z };
+				auto offset = GrassDisplacementField::GetTextureOffset(eyePosition);
+				perFrameData.fieldOffset[eyeIndex] = { offset.x, offset.y, eyePosition.z, 0.0f };
+			}
+		} else {
+			field.Reset();
+		}
+
+		perFrame->UpdateIfChanged(perFrameData);
+
+		if (useField)
+			UpdateField(perFrameData);
 
 		updatePerFrame = false;
 	}
@@ -187,6 +260,12 @@ void GrassCollision::Update()
 		ID3D11Buffer* buffers[1];
 		buffers[0] = perFrame->CB();
 		context->VSSetConstantBuffers(5, ARRAYSIZE(buffers), buffers);
+
+		ID3D11ShaderResourceView* views[1] = { displacementField->srv.get() };
+		context->VSSetShaderResources(8, ARRAYSIZE(views), views);
+
+		ID3D11SamplerState* samplers[1] = { fieldSampler.get() };
+		context->VSSetSamplers(8, ARRAYSIZE(samplers), samplers);
 	}
 }
 
@@ -213,6 +292,52 @@ void GrassCollision::PostPostLoad()
 void GrassCollision::SetupResources()
 {
 	perFrame = new ConstantBuffer(ConstantBufferDesc<PerFrame>());
+	fieldCB = new ConstantBuffer(ConstantBufferDesc<FieldCB>());
+
+	auto& device = State::GetSingleton()->device;
+
+	{
+		D3D11_TEXTURE2D_DESC texDesc{
+			.Width = GrassDisplacementField::Resolution,
+			.Height = GrassDisplacementField::Resolution,
+			.MipLevels = 1,
+			.ArraySize = 1,
+			.Format = DXGI_FORMAT_R32G32B32A32_FLOAT,
+			.SampleDesc = { 1, 0 },
+			.Usage = D3D11_USAGE_DEFAULT,
+			.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS,
+			.CPUAccessFlags = 0,
+			.MiscFlags = 0
+		};
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {
+			.Format = texDesc.Format,
+			.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D,
+			.Texture2D = { .MostDetailedMip = 0, .MipLevels = 1 }
+		};
+		D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {
+			.Format = texDesc.Format,
+			.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D,
+			.Texture2D = { .MipSlice = 0 }
+		};
+
+		displacementField = new Texture2D(texDesc);
+		displacementField->CreateSRV(srvDesc);
+		displacementField->CreateUAV(uavDesc);
+	}
+
+	{
+		// wrapping lets the field scroll without moving texels
+		D3D11_SAMPLER_DESC samplerDesc = {
+			.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
+			.AddressU = D3D11_TEXTURE_ADDRESS_WRAP,
+			.AddressV = D3D11_TEXTURE_ADDRESS_WRAP,
+			.AddressW = D3D11_TEXTURE_ADDRESS_WRAP,
+			.MaxAnisotropy = 1,
+			.MinLOD = 0,
+			.MaxLOD = D3D11_FLOAT32_MAX
+		};
+		DX::ThrowIfFailed(device->CreateSamplerState(&samplerDesc, fieldSampler.put()));
+	}
 }
 
 void GrassCollision::Reset()
@@ -228,4 +353,24 @@ bool GrassCollision::HasShaderDefine(RE::BSShader::Type shaderType)
 	default:
 		return false;
 	}
-}
\ No newline at end of file
+}
+
+void GrassCollision::ClearShaderCache()
+{
+	if (updateFieldCS) {
+		updateFieldCS->Release();
+		updateFieldCS = nullptr;
+	}
+}
+
+ID3D11ComputeShader* GrassCollision::GetUpdateFieldCS()
+{
+	if (!updateFieldCS) {
+		logger::debug("Compiling UpdateFieldCS");
+		static const auto resolution = std::to_string(GrassDisplacementField::Resolution);
+		static const auto cellSize = std::format("{:.1f}", GrassDisplacementField::CellSize);
+		updateFieldCS = (ID3D11ComputeShader*)Util::CompileShader(L"Data\\Shaders\\GrassCollision\\UpdateFieldCS.hlsl",
+			{ { "FIELD_RESOLUTION", resolution.c_str() }, { "FIELD_CELL_SIZE", cellSize.c_str() } }, "cs_5_0");
+	}
+	return updateFieldCS;
+}
@@ -2,6 +2,8 @@
 
 #include "Buffer.h"
 #include "Feature.h"
+#include "Features/GrassCollision/Candidates.h"
+#include "Features/GrassCollision/DisplacementField.h"
 
 struct GrassCollision : Feature
 {
@@ -17,9 +19,17 @@ struct GrassCollision : Feature
 
 	bool HasShaderDefine(RE::BSShader::Type shaderType) override;
 
+	enum class CollisionMode : uint
+	{
+		Direct,  // every grass vertex tests every collision
+		Field    // collisions are splatted into a displacement field that grass samples once
+	};
+
 	struct Settings
 	{
 		bool EnableGrassCollision = 1;
+		uint Mode = (uint)CollisionMode::Direct;
+		float TrailDuration = 2.0f;  // seconds for field displacement to fade
 	};
 
 	struct alignas(16) CollisionData
@@ -27,32 +37,70 @@ struct GrassCollision : Feature
 		float4 centre[2];
 	};
 
+	static constexpr uint MaxCollisions = 256;
+	static constexpr float MaxDistance = 1024.0f;  // from the camera, beyond it grass is not bent
+
 	struct alignas(16) PerFrame
 	{
-		CollisionData collisionData[256];
+		CollisionData collisionData[MaxCollisions];
 		uint numCollisions;
-		uint pad0[3];
+		uint useField;
+		float fieldSize;
+		float pad0;
+		float4 fieldOffset[2];  // xy wrap a position relative to the eye onto the field, z is the eye height
+	};
+
+	struct alignas(16) FieldCB
+	{
+		int32_t Origin[2];
+		int32_t PreviousOrigin[2];
+		float2 OriginOffset;
+		float Decay;
+		float EyeHeight;
 	};
 
+	// Radius from the six GetMaximumProjection calls of a shape, dropped once the shape is no longer visited
+	struct ShapeBound
+	{
+		float radius;
+		uint32_t lastVisit;
+	};
+
+	ankerl::unordered_dense::map<const RE::hkpShape*, ShapeBound> shapeBounds;
+	uint32_t visit = 0;
+	std::vector<GrassCollisionCandidate> candidates;
+
 	std::uint32_t totalActorCount = 0;
 	std::uint32_t activeActorCount = 0;
 	std::uint32_t currentCollisionCount = 0;
 	std::vector<RE::Actor*> actorList{};
 	std::uint32_t colllisionCount = 0;
+	std::uint32_t candidateCount = 0;
 
 	Settings settings;
 
 	bool updatePerFrame = false;
 	ConstantBuffer* perFrame = nullptr;
+
+	GrassDisplacementField field;
+	Texture2D* displacementField = nullptr;
+	ConstantBuffer* fieldCB = nullptr;
+	winrt::com_ptr<ID3D11SamplerState> fieldSampler;
+	ID3D11ComputeShader* updateFieldCS = nullptr;
 	int eyeCount = !REL::Module::IsVR() ? 1 : 2;
 
 	virtual void SetupResources() override;
 	virtual void Reset() override;
+	virtual void ClearShaderCache() override;
 
 	virtual void DrawSettings() override;
+	bool GetShapeBound(RE::bhkNiCollisionObject* a_object, RE::NiPoint3& a_centre, float& a_radius);
 	void UpdateCollisions(PerFrame& perFrame);
+	void UpdateField(const PerFrame& a_perFrame);
 	void Update();
 
+	ID3D11ComputeShader* GetUpdateFieldCS();
+
 	virtual void LoadSettings(json& o_json) override;
 	virtual void SaveSettings(json& o_json) override;
 
@@ -0,0 +1,10 @@
+#include "Features/GrassCollision/Candidates.h"
+
+void SelectNearestCandidates(std::vector<GrassCollisionCandidate>& a_candidates, uint a_maxCount)
+{
+	if (a_candidates.size() <= a_maxCount)
+		return;
+
+	std::ranges::nth_element(a_candidates, a_candidates.begin() + a_maxCount, {}, &GrassCollisionCandidate::distanceSquared);
+	a_candidates.resize(a_maxCount);
+}
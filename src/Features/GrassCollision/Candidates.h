@@ -0,0 +1,12 @@
+#pragma once
+
+// A collision shape within MaxDistance of the camera
+struct GrassCollisionCandidate
+{
+	float3 centre;
+	float radius;
+	float distanceSquared;  // to the camera
+};
+
+// Keeps the a_maxCount candidates nearest to the camera, in no particular order
+void SelectNearestCandidates(std::vector<GrassCollisionCandidate>& a_candidates, uint a_maxCount);
@@ -0,0 +1,43 @@
+#include "Features/GrassCollision/DisplacementField.h"
+
+void GrassDisplacementField::Update(const float3& a_camera)
+{
+	auto centre = GetCell(a_camera.x, a_camera.y);
+	Cell newOrigin = { centre[0] - Resolution / 2, centre[1] - Resolution / 2 };
+
+	// a window a full width away shares no cells, so the first update clears the whole field
+	previousOrigin = valid ? origin : Cell{ newOrigin[0] + Resolution, newOrigin[1] + Resolution };
+	origin = newOrigin;
+	valid = true;
+}
+
+float2 GrassDisplacementField::GetOriginOffset(const float3& a_eye) const
+{
+	// in double, cells far from the world origin are too coarse in float before the eye is subtracted
+	return {
+		(float)((double)origin[0] * CellSize - a_eye.x),
+		(float)((double)origin[1] * CellSize - a_eye.y)
+	};
+}
+
+GrassDisplacementField::Cell GrassDisplacementField::GetCell(float a_x, float a_y)
+{
+	return { (int32_t)std::floor(a_x / CellSize), (int32_t)std::floor(a_y / CellSize) };
+}
+
+float2 GrassDisplacementField::GetTextureOffset(const float3& a_eye)
+{
+	// the sampler wraps, so only the eye position modulo the field size matters and it stays small
+	auto wrap = [](float a_value) {
+		float offset = std::fmod(a_value, Size);
+		return offset < 0.0f ? offset + Size : offset;
+	};
+	return { wrap(a_eye.x), wrap(a_eye.y) };
+}
+
+float GrassDisplacementField::GetDecay(float a_seconds, float a_duration)
+{
+	if (a_duration <= 0.0f)
+		return 0.0f;
+	return std::exp(-std::max(a_seconds, 0.0f) / a_duration);
+}
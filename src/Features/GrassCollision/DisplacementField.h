@@ -0,0 +1,47 @@
+#pragma once
+
+// Window of world cells around the camera that UpdateFieldCS wraps onto the displacement field texture
+class GrassDisplacementField
+{
+public:
+	static constexpr int32_t Resolution = 256;
+	static constexpr float CellSize = 8.0f;  // world units
+	static constexpr float Size = Resolution * CellSize;
+
+	using Cell = std::array<int32_t, 2>;
+
+	void Update(const float3& a_camera);
+	void Reset() { valid = false; }
+
+	/**
+	 * @return First cell of the window, the one at the lowest x and y
+	 */
+	const Cell& GetOrigin() const { return origin; }
+
+	/**
+	 * @return First cell of the window before the last update, nothing is kept from it after a reset
+	 */
+	const Cell& GetPreviousOrigin() const { return previousOrigin; }
+
+	/**
+	 * @return Position of the first cell's corner relative to the eye
+	 */
+	float2 GetOriginOffset(const float3& a_eye) const;
+
+	static Cell GetCell(float a_x, float a_y);
+
+	/**
+	 * @return Offset that, added to a position relative to the eye and divided by Size, gives the wrapped texture coordinate
+	 */
+	static float2 GetTextureOffset(const float3& a_eye);
+
+	/**
+	 * @return Fraction of the displacement kept after a_seconds, so that it fades out over a_duration
+	 */
+	static float GetDecay(float a_seconds, float a_duration);
+
+private:
+	Cell origin{};
+	Cell previousOrigin{};
+	bool valid = false;
+};
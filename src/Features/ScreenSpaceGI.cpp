@@ -15,6 +15,8 @@ NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(
 	EnableTemporalDenoiser,
 	NumSlices,
 	NumSteps,
+	AdaptiveQuality,
+	TargetMs,
 	DepthMIPSamplingOffset,
 	EffectRadius,
 	EffectFalloffRange,
@@ -180,6 +182,19 @@ void ScreenSpaceGI::DrawSettings()
 	if (auto _tt = Util::HoverTooltipWrapper())
 		ImGui::Text("Shading only half the pixels per frame. Cheaper but has more ghosting, and takes twice as long to converge.");
 
+	recompileFlag |= ImGui::Checkbox("Adaptive Quality", &settings.AdaptiveQuality);
+	if (auto _tt = Util::HoverTooltipWrapper())
+		ImGui::Text(
+			"Lowers blur passes, shading rate, slices and steps below the settings above while GI takes longer than the budget.\n"
+			"Without GPU timestamps the quality is held where it is.");
+
+	{
+		auto _ = DisableGuard(!settings.AdaptiveQuality);
+		ImGui::Indent();
+		ImGui::SliderFloat("GPU Budget", &settings.TargetMs, .5f, 8.f, "%.1f ms");
+		ImGui::Unindent();
+	}
+
 	///////////////////////////////
 	ImGui::SeparatorText("Visual");
 
@@ -325,6 +340,16 @@ void ScreenSpaceGI::DrawSettings()
 	///////////////////////////////
 	ImGui::SeparatorText("Debug");
 
+	if (settings.AdaptiveQuality) {
+		auto& quality = governor.GetQuality();
+		ImGui::Text("Quality Level: %u / %u", governor.GetLevel() + 1, governor.GetLevelCount());
+		ImGui::Text("Slices: %u, Steps: %u, Blur Passes: %u, Shading Rate: 1/%u", quality.numSlices, quality.numSteps, quality.blurPasses, quality.updateInterval);
+		if (gpuTimer.IsValid())
+			ImGui::Text("Average Time: %.2f ms", governor.GetAverageMs());
+		else
+			ImGui::Text("Average Time: unavailable, quality is held");
+	}
+
 	if (ImGui::TreeNode("Buffer Viewer")) {
 		auto deferred = Deferred::GetSingleton();
 
@@ -362,6 +387,7 @@ void ScreenSpaceGI::SetupResources()
 	logger::debug("Creating buffers...");
 	{
 		ssgiCB = eastl::make_unique<ConstantBuffer>(ConstantBufferDesc<SSGICB>());
+		gpuTimer.Create(device);
 	}
 
 	logger::debug("Creating textures...");
@@ -537,8 +563,8 @@ void ScreenSpaceGI::CompileComputeShaders()
 	for (auto& info : shaderInfos) {
 		if (REL::Module::IsVR())
 			info.defines.push_back({ "VR", "" });
-		if (settings.HalfRate)
-			info.defines.push_back({ "HALF_RATE", "" });
+		if (settings.HalfRate || settings.AdaptiveQuality)
+			info.defines.push_back({ "INTERLEAVED", "" });
 		if (settings.EnableTemporalDenoiser)
 			info.defines.push_back({ "TEMPORAL_DENOISER", "" });
 		if (settings.UseBitmask)
@@ -565,63 +591,59 @@ bool ScreenSpaceGI::ShadersOK()
 	return texNoise && prefilterDepthsCompute && radianceDisoccCompute && giCompute && blurCompute;
 }
 
-void ScreenSpaceGI::UpdateSB()
+QualityGovernor::Quality ScreenSpaceGI::UpdateQuality()
 {
-	auto viewport = RE::BSGraphics::State::GetSingleton();
-
-	float2 res = { (float)texRadiance->desc.Width, (float)texRadiance->desc.Height };
-	float2 dynres = Util::ConvertToDynamic(res);
-	dynres = { floor(dynres.x), floor(dynres.y) };
-
-	static float4x4 prevInvView[2] = {};
+	QualityGovernor::Quality ceiling{
+		.numSlices = settings.NumSlices,
+		.numSteps = settings.NumSteps,
+		.blurPasses = settings.EnableBlur ? settings.BlurPasses : 1,
+		.updateInterval = settings.HalfRate ? 2u : 1u
+	};
+	if (!settings.AdaptiveQuality)
+		return ceiling;
+
+	// without timestamps nothing measures GI alone, frame time would blame it for any bottleneck
+	governor.SetCeiling(ceiling);
+	if (gpuTimer.IsValid()) {
+		if (auto ms = gpuTimer.Resolve(State::GetSingleton()->context))
+			governor.Update(*ms, settings.TargetMs);
+	}
+	return governor.GetQuality();
+}
 
-	SSGICB data;
+void ScreenSpaceGI::UpdateSB(const QualityGovernor::Quality& quality)
+{
+	SSGICB data{};
 	{
-		for (int eyeIndex = 0; eyeIndex < (1 + REL::Module::IsVR()); ++eyeIndex) {
-			auto eye = Util::GetCameraData(eyeIndex);
-
-			data.PrevInvViewMat[eyeIndex] = prevInvView[eyeIndex];
-			data.NDCToViewMul[eyeIndex] = { 2.0f / eye.projMat(0, 0), -2.0f / eye.projMat(1, 1) };
-			data.NDCToViewAdd[eyeIndex] = { -1.0f / eye.projMat(0, 0), 1.0f / eye.projMat(1, 1) };
-			if (REL::Module::IsVR())
-				data.NDCToViewMul[eyeIndex].x *= 2;
-
-			prevInvView[eyeIndex] = eye.viewMat.Invert();
-		}
-
-		data.TexDim = res;
-		data.RcpTexDim = float2(1.0f) / res;
-		data.FrameDim = dynres;
-		data.RcpFrameDim = float2(1.0f) / dynres;
-		data.FrameIndex = viewport->frameCount;
-
-		data.NumSlices = settings.NumSlices;
-		data.NumSteps = settings.NumSteps;
+		data.NumSlices = quality.numSlices;
+		data.NumSteps = quality.numSteps;
 		data.DepthMIPSamplingOffset = settings.DepthMIPSamplingOffset;
+		data.UpdateInterval = quality.updateInterval;
 
 		data.EffectRadius = settings.EffectRadius;
 		data.EffectFalloffRange = settings.EffectFalloffRange;
 		data.ThinOccluderCompensation = settings.ThinOccluderCompensation;
 		data.Thickness = settings.Thickness;
+
 		data.DepthFadeRange = settings.DepthFadeRange;
 		data.DepthFadeScaleConst = 1 / (settings.DepthFadeRange.y - settings.DepthFadeRange.x);
-
 		data.BackfaceStrength = settings.BackfaceStrength;
+
 		data.GIBounceFade = settings.GIBounceFade;
 		data.GIDistanceCompensation = settings.GIDistanceCompensation;
 		data.GICompensationMaxDist = settings.EffectRadius;
-
 		data.AOPower = settings.AOPower;
-		data.GIStrength = settings.GIStrength;
 
+		data.GIStrength = settings.GIStrength;
 		data.DepthDisocclusion = settings.DepthDisocclusion;
 		data.NormalDisocclusion = settings.NormalDisocclusion;
 		data.MaxAccumFrames = settings.MaxAccumFrames;
+
 		data.BlurRadius = settings.BlurRadius;
 		data.DistanceNormalisation = settings.DistanceNormalisation;
 	}
 
-	ssgiCB->Update(data);
+	ssgiCB->UpdateIfChanged(data);
 }
 
 void ScreenSpaceGI::DrawSSGI(Texture2D* srcPrevAmbient)
@@ -644,7 +666,8 @@ void ScreenSpaceGI::DrawSSGI(Texture2D* srcPrevAmbient)
 	if (recompileFlag)
 		ClearShaderCache();
 
-	UpdateSB();
+	auto quality = UpdateQuality();
+	UpdateSB(quality);
 
 	//////////////////////////////////////////////////////
 
@@ -670,6 +693,9 @@ void ScreenSpaceGI::DrawSSGI(Texture2D* srcPrevAmbient)
 
 	//////////////////////////////////////////////////////
 
+	if (settings.AdaptiveQuality)
+		gpuTimer.Begin(context);
+
 	context->CSSetConstantBuffers(1, 1, &cb);
 	context->CSSetSamplers(0, (uint)samplers.size(), samplers.data());
 
@@ -729,7 +755,9 @@ void ScreenSpaceGI::DrawSSGI(Texture2D* srcPrevAmbient)
 		context->CSSetShaderResources(0, (uint)srvs.size(), srvs.data());
 		context->CSSetUnorderedAccessViews(0, (uint)uavs.size(), uavs.data(), nullptr);
 		context->CSSetShader(giCompute.get(), nullptr, 0);
-		context->Dispatch((resolution[0] + 7u) >> 3, (resolution[1] + 7u) >> 3, 1);
+		// each interleaved column range has to be covered whole
+		uint rangeWidth = (resolution[0] + quality.updateInterval - 1) / quality.updateInterval;
+		context->Dispatch((rangeWidth * quality.updateInterval + 7u) >> 3, (resolution[1] + 7u) >> 3, 1);
 
 		inputGITexIdx = !inputGITexIdx;
 		lastFrameGITexIdx = inputGITexIdx;
@@ -737,7 +765,7 @@ void ScreenSpaceGI::DrawSSGI(Texture2D* srcPrevAmbient)
 
 	// blur
 	if (settings.EnableBlur) {
-		for (uint i = 0; i < settings.BlurPasses; i++) {
+		for (uint i = 0; i < quality.blurPasses; i++) {
 			resetViews();
 			srvs.at(0) = texGI[inputGITexIdx]->srv.get();
 			srvs.at(1) = texAccumFrames[lastFrameAccumTexIdx]->srv.get();
@@ -760,6 +788,9 @@ void ScreenSpaceGI::DrawSSGI(Texture2D* srcPrevAmbient)
 
 	outputGIIdx = inputGITexIdx;
 
+	if (settings.AdaptiveQuality)
+		gpuTimer.End(context);
+
 	// cleanup
 	resetViews();
 
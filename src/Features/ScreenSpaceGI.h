@@ -3,6 +3,9 @@
 #include "Buffer.h"
 #include "Feature.h"
 
+#include "Features/ScreenSpaceGI/GPUTimer.h"
+#include "Features/ScreenSpaceGI/QualityGovernor.h"
+
 struct ScreenSpaceGI : Feature
 {
 	static ScreenSpaceGI* GetSingleton()
@@ -35,7 +38,8 @@ struct ScreenSpaceGI : Feature
 	bool ShadersOK();
 
 	void DrawSSGI(Texture2D* srcPrevAmbient);
-	void UpdateSB();
+	void UpdateSB(const QualityGovernor::Quality& quality);
+	QualityGovernor::Quality UpdateQuality();
 
 	//////////////////////////////////////////////////////////////////////////////////
 
@@ -51,6 +55,8 @@ struct ScreenSpaceGI : Feature
 		uint NumSlices = 2;
 		uint NumSteps = 4;
 		bool HalfRate = true;
+		bool AdaptiveQuality = false;
+		float TargetMs = 2.f;
 		float DepthMIPSamplingOffset = 3.3f;
 		// visual
 		float EffectRadius = 500.f;
@@ -78,37 +84,29 @@ struct ScreenSpaceGI : Feature
 		float DistanceNormalisation = 2.f;
 	} settings;
 
+	// view and resolution constants come from State::SharedViewCB, this only changes with settings
 	struct alignas(16) SSGICB
 	{
-		float4x4 PrevInvViewMat[2];
-		float2 NDCToViewMul[2];
-		float2 NDCToViewAdd[2];
-
-		float2 TexDim;
-		float2 RcpTexDim;  //
-		float2 FrameDim;
-		float2 RcpFrameDim;  //
-		uint FrameIndex;
-
 		uint NumSlices;
 		uint NumSteps;
-		float DepthMIPSamplingOffset;  //
+		float DepthMIPSamplingOffset;
+		uint UpdateInterval;  //
 
 		float EffectRadius;
 		float EffectFalloffRange;
 		float ThinOccluderCompensation;
 		float Thickness;  //
+
 		float2 DepthFadeRange;
 		float DepthFadeScaleConst;
-
 		float BackfaceStrength;  //
+
 		float GIBounceFade;
 		float GIDistanceCompensation;
 		float GICompensationMaxDist;
-
 		float AOPower;  //
-		float GIStrength;
 
+		float GIStrength;
 		float DepthDisocclusion;
 		float NormalDisocclusion;
 		uint MaxAccumFrames;  //
@@ -120,6 +118,9 @@ struct ScreenSpaceGI : Feature
 	};
 	eastl::unique_ptr<ConstantBuffer> ssgiCB;
 
+	QualityGovernor governor;
+	GPUTimer gpuTimer;
+
 	eastl::unique_ptr<Texture2D> texNoise = nullptr;
 	eastl::unique_ptr<Texture2D> texWorkingDepth = nullptr;
 	winrt::com_ptr<ID3D11UnorderedAccessView> uavWorkingDepth[5] = { nullptr };
@@ -0,0 +1,73 @@
+#include "Features/ScreenSpaceGI/GPUTimer.h"
+
+void GPUTimer::Create(ID3D11Device* a_device)
+{
+	valid = false;
+
+	D3D11_QUERY_DESC disjointDesc{ .Query = D3D11_QUERY_TIMESTAMP_DISJOINT, .MiscFlags = 0 };
+	D3D11_QUERY_DESC timestampDesc{ .Query = D3D11_QUERY_TIMESTAMP, .MiscFlags = 0 };
+	for (auto& set : sets) {
+		set = {};
+		if (FAILED(a_device->CreateQuery(&disjointDesc, set.disjoint.put())) ||
+			FAILED(a_device->CreateQuery(&timestampDesc, set.begin.put())) ||
+			FAILED(a_device->CreateQuery(&timestampDesc, set.end.put()))) {
+			logger::warn("Timestamp queries unavailable, falling back to frame time");
+			return;
+		}
+	}
+
+	current = 0;
+	timing = false;
+	valid = true;
+}
+
+void GPUTimer::Begin(ID3D11DeviceContext* a_context)
+{
+	auto& set = sets[current];
+	if (!valid || set.pending)
+		return;
+
+	a_context->Begin(set.disjoint.get());
+	a_context->End(set.begin.get());
+	timing = true;
+}
+
+void GPUTimer::End(ID3D11DeviceContext* a_context)
+{
+	if (!timing)
+		return;
+
+	auto& set = sets[current];
+	a_context->End(set.end.get());
+	a_context->End(set.disjoint.get());
+	set.pending = true;
+	timing = false;
+
+	current = (current + 1) % Latency;
+}
+
+std::optional<float> GPUTimer::Resolve(ID3D11DeviceContext* a_context)
+{
+	if (!valid)
+		return std::nullopt;
+
+	// oldest set first, it is the one written next
+	std::optional<float> result;
+	for (uint i = 0; i < Latency; i++) {
+		auto& set = sets[(current + i) % Latency];
+		if (!set.pending)
+			continue;
+
+		D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+		UINT64 begin, end;
+		if (a_context->GetData(set.disjoint.get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+			a_context->GetData(set.begin.get(), &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+			a_context->GetData(set.end.get(), &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+			break;
+
+		set.pending = false;
+		if (!disjoint.Disjoint && disjoint.Frequency > 0 && end >= begin)
+			result = (float)((double)(end - begin) * 1e3 / (double)disjoint.Frequency);
+	}
+	return result;
+}
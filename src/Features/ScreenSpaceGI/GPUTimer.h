@@ -0,0 +1,33 @@
+#pragma once
+
+// Times GPU work with timestamp queries, read Latency frames late so the CPU never waits on the GPU
+class GPUTimer
+{
+public:
+	static constexpr uint Latency = 4;  // query sets in flight
+
+	void Create(ID3D11Device* a_device);
+	bool IsValid() const { return valid; }
+
+	void Begin(ID3D11DeviceContext* a_context);
+	void End(ID3D11DeviceContext* a_context);
+
+	/**
+	 * @return Milliseconds of the newest range that finished since the last call, if any
+	 */
+	std::optional<float> Resolve(ID3D11DeviceContext* a_context);
+
+private:
+	struct QuerySet
+	{
+		winrt::com_ptr<ID3D11Query> disjoint;
+		winrt::com_ptr<ID3D11Query> begin;
+		winrt::com_ptr<ID3D11Query> end;
+		bool pending = false;
+	};
+
+	std::array<QuerySet, Latency> sets;
+	uint current = 0;
+	bool timing = false;
+	bool valid = false;
+};
@@ -0,0 +1,88 @@
+#include "Features/ScreenSpaceGI/QualityGovernor.h"
+
+void QualityGovernor::SetCeiling(const Quality& a_ceiling)
+{
+	if (levels.back() == a_ceiling)
+		return;
+
+	// walk down from the ceiling, the first rule that still applies gives the next cheaper level
+	levels = { a_ceiling };
+	for (Quality quality = a_ceiling;;) {
+		if (quality.blurPasses > 1)
+			quality.blurPasses--;
+		else if (quality.updateInterval < 2)
+			quality.updateInterval = 2;
+		else if (quality.numSlices > 2)
+			quality.numSlices--;
+		else if (quality.numSteps > 4)
+			quality.numSteps--;
+		else if (quality.updateInterval < MaxUpdateInterval)
+			quality.updateInterval = MaxUpdateInterval;
+		else if (quality.numSlices > 1)
+			quality.numSlices--;
+		else if (quality.numSteps > 2)
+			quality.numSteps--;
+		else
+			break;
+		levels.push_back(quality);
+	}
+	std::reverse(levels.begin(), levels.end());
+
+	Reset();
+}
+
+void QualityGovernor::Reset()
+{
+	level = (uint)levels.size() - 1;
+	position = (float)level;
+	averageMs = 0.f;
+	integral = 0.f;
+	previousError = 0.f;
+	samplesSinceChange = 0;
+	overBudgetLevel = UINT_MAX;
+	overBudgetMs = 0.f;
+	samplesSinceOverBudget = 0;
+}
+
+const QualityGovernor::Quality& QualityGovernor::Update(float a_ms, float a_targetMs)
+{
+	a_targetMs = std::max(a_targetMs, 1e-2f);
+	averageMs = averageMs > 0.f ? std::lerp(averageMs, a_ms, Smoothing) : a_ms;
+	samplesSinceOverBudget++;
+
+	if (++samplesSinceChange < SettleSamples)
+		return levels[level];
+
+	// positive error is headroom and raises the quality
+	float error = (a_targetMs - averageMs) / a_targetMs;
+	bool nextOverBudget = level + 1 == overBudgetLevel && overBudgetMs > a_targetMs && samplesSinceOverBudget < RetrySamples;
+	float maxPosition = nextOverBudget ? (float)level : (float)levels.size() - 1;
+
+	// no windup while the position is pinned at either end
+	bool pinned = (position <= 0.f && error < 0.f) || (position >= maxPosition && error > 0.f);
+	if (!pinned)
+		integral = std::clamp(integral + error, -MaxIntegral, MaxIntegral);
+
+	float output = Kp * error + Ki * integral + Kd * (error - previousError);
+	previousError = error;
+	position = std::clamp(position + output, 0.f, maxPosition);
+
+	uint newLevel = level;
+	if (position >= level + .5f + Hysteresis)
+		newLevel = level + 1;
+	else if (level > 0 && position <= level - .5f - Hysteresis)
+		newLevel = level - 1;
+
+	if (newLevel != level) {
+		if (newLevel < level) {
+			overBudgetLevel = level;
+			overBudgetMs = averageMs;
+			samplesSinceOverBudget = 0;
+		}
+		level = newLevel;
+		samplesSinceChange = 0;
+		integral = 0.f;
+	}
+
+	return levels[level];
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+ * Picks the screen space GI quality level that keeps its measured GPU time within a budget.
+ * A PID controller moves a position along levels below the user settings, the level follows with hysteresis.
+ */
+class QualityGovernor
+{
+public:
+	static constexpr uint MaxUpdateInterval = 4;  // shade one in this many pixels per frame at most, the rest is temporal history
+	static constexpr uint SettleSamples = 8;      // ignore measurements right after a change, they lag a few frames
+	static constexpr float Hysteresis = .35f;     // levels the position has to go past the current one before it changes
+	static constexpr uint RetrySamples = 600;     // before going back up to a level that was left for being over budget
+
+	static constexpr float Kp = .6f;
+	static constexpr float Ki = .15f;
+	static constexpr float Kd = .1f;
+	static constexpr float MaxIntegral = 4.f;
+	static constexpr float Smoothing = .2f;  // weight of a new sample in the moving average
+
+	struct Quality
+	{
+		uint numSlices = 2;
+		uint numSteps = 4;
+		uint blurPasses = 1;
+		uint updateInterval = 1;
+
+		bool operator==(const Quality&) const = default;
+	};
+
+	/**
+	 * Rebuild the levels below a new highest quality, starting again from the top.
+	 */
+	void SetCeiling(const Quality& a_ceiling);
+
+	/**
+	 * Feed one measurement and get the quality for the next frame.
+	 *
+	 * @param a_ms GPU time of the last measured frame
+	 * @param a_targetMs Budget for that time
+	 */
+	const Quality& Update(float a_ms, float a_targetMs);
+
+	void Reset();
+
+	const Quality& GetQuality() const { return levels[level]; }
+	uint GetLevel() const { return level; }
+	uint GetLevelCount() const { return (uint)levels.size(); }
+	float GetAverageMs() const { return averageMs; }
+
+private:
+	std::vector<Quality> levels{ Quality{} };  // cheapest first
+	uint level = 0;
+	float position = 0.f;
+
+	float averageMs = 0.f;
+	float integral = 0.f;
+	float previousError = 0.f;
+	uint samplesSinceChange = 0;
+
+	// a budget between two levels would otherwise make the headroom of the lower one climb back up forever
+	uint overBudgetLevel = UINT_MAX;
+	float overBudgetMs = 0.f;
+	uint samplesSinceOverBudget = 0;
+};
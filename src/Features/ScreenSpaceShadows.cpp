@@ -4,11 +4,6 @@
 #include "State.h"
 #include "Util.h"
 
-#pragma warning(push)
-#pragma warning(disable: 4838 4244)
-#include "ScreenSpaceShadows/bend_sss_cpu.h"
-#pragma warning(pop)
-
 using RE::RENDER_TARGETS;
 
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(
@@ -29,6 +24,9 @@ void ScreenSpaceShadows::DrawSettings()
 		ImGui::SliderFloat("BilinearThreshold", &bendSettings.BilinearThreshold, 0.02f, 1.0f);
 		ImGui::SliderFloat("ShadowContrast", &bendSettings.ShadowContrast, 0.0f, 4.0f);
 
+		if (State::GetSingleton()->IsDeveloperMode())
+			ImGui::Text("Dispatch list rebuilds: %u", dispatchCache[0].GetRebuildCount() + dispatchCache[1].GetRebuildCount());
+
 		ImGui::Spacing();
 		ImGui::Spacing();
 		ImGui::TreePop();
@@ -98,12 +96,6 @@ void ScreenSpaceShadows::DrawShadows()
 	auto& directionNi = dirLight->GetWorldDirection();
 	float3 light = { directionNi.x, directionNi.y, directionNi.z };
 	light.Normalize();
-	float4 lightProjection = float4(-light.x, -light.y, -light.z, 0.0f);
-
-	Matrix viewProjMat = Util::GetCameraData(0).viewProjMat;
-
-	lightProjection = DirectX::SimpleMath::Vector4::Transform(lightProjection, viewProjMat);
-	float lightProjectionF[4] = { lightProjection.x, lightProjection.y, lightProjection.z, lightProjection.w };
 
 	int viewportSize[2] = { (int)state->screenSize.x, (int)state->screenSize.y };
 
@@ -123,24 +115,20 @@ void ScreenSpaceShadows::DrawShadows()
 
 	context->CSSetSamplers(0, 1, &pointBorderSampler);
 
-	auto buffer = raymarchCB->CB();
-	context->CSSetConstantBuffers(1, 1, &buffer);
-
-	context->CSSetShader(GetComputeRaymarch(), nullptr, 0);
+	uint eyeCount = REL::Module::IsVR() ? 2 : 1;
+	for (uint eyeIndex = 0; eyeIndex < eyeCount; eyeIndex++) {
+		float4 lightProjection = float4(-light.x, -light.y, -light.z, 0.0f);
+		lightProjection = DirectX::SimpleMath::Vector4::Transform(lightProjection, Util::GetCameraData(eyeIndex).viewProjMat);
+		float lightProjectionF[4] = { lightProjection.x, lightProjection.y, lightProjection.z, lightProjection.w };
 
-	auto dispatchList = Bend::BuildDispatchList(lightProjectionF, viewportSize, minRenderBounds, maxRenderBounds);
-
-	for (int i = 0; i < dispatchList.DispatchCount; i++) {
-		auto dispatchData = dispatchList.Dispatch[i];
+		auto& layout = dispatchCache[eyeIndex].Update(lightProjectionF, viewportSize, minRenderBounds, maxRenderBounds);
+		if (!layout.groupCount)
+			continue;
 
 		RaymarchCB data{};
-		data.LightCoordinate[0] = dispatchList.LightCoordinate_Shader[0];
-		data.LightCoordinate[1] = dispatchList.LightCoordinate_Shader[1];
-		data.LightCoordinate[2] = dispatchList.LightCoordinate_Shader[2];
-		data.LightCoordinate[3] = dispatchList.LightCoordinate_Shader[3];
-
-		data.WaveOffset[0] = dispatchData.WaveOffset_Shader[0];
-		data.WaveOffset[1] = dispatchData.WaveOffset_Shader[1];
+		std::copy_n(layout.lightCoordinate, 4, data.LightCoordinate);
+		std::copy_n(&layout.dispatches[0][0], 4 * BendDispatchCache::MaxDispatches, &data.Dispatches[0][0]);
+		data.DispatchCount = layout.dispatchCount;
 
 		data.FarDepthValue = 1.0f;
 		data.NearDepthValue = 0.0f;
@@ -150,48 +138,15 @@ void ScreenSpaceShadows::DrawShadows()
 
 		data.settings = bendSettings;
 
-		raymarchCB->Update(data);
-
-		context->Dispatch(dispatchData.WaveCount[0], dispatchData.WaveCount[1], dispatchData.WaveCount[2]);
-	}
-
-	if (REL::Module::IsVR()) {
-		lightProjection = float4(-light.x, -light.y, -light.z, 0.0f);
+		raymarchCB[eyeIndex]->UpdateIfChanged(data);
 
-		viewProjMat = Util::GetCameraData(1).viewProjMat;
+		auto buffer = raymarchCB[eyeIndex]->CB();
+		context->CSSetConstantBuffers(1, 1, &buffer);
 
-		lightProjection = DirectX::SimpleMath::Vector4::Transform(lightProjection, viewProjMat);
+		context->CSSetShader(eyeIndex ? GetComputeRaymarchRight() : GetComputeRaymarch(), nullptr, 0);
 
-		float lightProjectionRightF[4] = { lightProjection.x, lightProjection.y, lightProjection.z, lightProjection.w };
-
-		context->CSSetShader(GetComputeRaymarchRight(), nullptr, 0);
-
-		dispatchList = Bend::BuildDispatchList(lightProjectionRightF, viewportSize, minRenderBounds, maxRenderBounds);
-
-		for (int i = 0; i < dispatchList.DispatchCount; i++) {
-			auto dispatchData = dispatchList.Dispatch[i];
-
-			RaymarchCB data{};
-			data.LightCoordinate[0] = dispatchList.LightCoordinate_Shader[0];
-			data.LightCoordinate[1] = dispatchList.LightCoordinate_Shader[1];
-			data.LightCoordinate[2] = dispatchList.LightCoordinate_Shader[2];
-			data.LightCoordinate[3] = dispatchList.LightCoordinate_Shader[3];
-
-			data.WaveOffset[0] = dispatchData.WaveOffset_Shader[0];
-			data.WaveOffset[1] = dispatchData.WaveOffset_Shader[1];
-
-			data.FarDepthValue = 1.0f;
-			data.NearDepthValue = 0.0f;
-
-			data.InvDepthTextureSize[0] = 1.0f / (float)viewportSize[0];
-			data.InvDepthTextureSize[1] = 1.0f / (float)viewportSize[1];
-
-			data.settings = bendSettings;
-
-			raymarchCB->Update(data);
-
-			context->Dispatch(dispatchData.WaveCount[0], dispatchData.WaveCount[1], dispatchData.WaveCount[2]);
-		}
+		// All dispatches of the list in one, the shader finds its own from the group index
+		context->Dispatch(BendDispatchCache::WaveSize, layout.groupCount, 1);
 	}
 
 	ID3D11ShaderResourceView* views[1]{ nullptr };
@@ -205,7 +160,7 @@ void ScreenSpaceShadows::DrawShadows()
 	ID3D11SamplerState* sampler = nullptr;
 	context->CSSetSamplers(0, 1, &sampler);
 
-	buffer = nullptr;
+	ID3D11Buffer* buffer = nullptr;
 	context->CSSetConstantBuffers(1, 1, &buffer);
 }
 
@@ -245,7 +200,8 @@ bool ScreenSpaceShadows::HasShaderDefine(RE::BSShader::Type)
 
 void ScreenSpaceShadows::SetupResources()
 {
-	raymarchCB = new ConstantBuffer(ConstantBufferDesc<RaymarchCB>());
+	raymarchCB[0] = new ConstantBuffer(ConstantBufferDesc<RaymarchCB>());
+	raymarchCB[1] = new ConstantBuffer(ConstantBufferDesc<RaymarchCB>());
 
 	{
 		auto& device = State::GetSingleton()->device;
@@ -2,6 +2,7 @@
 
 #include "Buffer.h"
 #include "Feature.h"
+#include "Features/ScreenSpaceShadows/DispatchCache.h"
 
 struct ScreenSpaceShadows : Feature
 {
@@ -30,25 +31,30 @@ struct ScreenSpaceShadows : Feature
 
 	struct alignas(16) RaymarchCB
 	{
-		// Runtime data returned from BuildDispatchList():
-		float LightCoordinate[4];  // Values stored in DispatchList::LightCoordinate_Shader by BuildDispatchList()
-		int WaveOffset[2];         // Values stored in DispatchData::WaveOffset_Shader by BuildDispatchList()
-
-		// Renderer Specific Values:
-		float FarDepthValue;   // Set to the Depth Buffer Value for the far clip plane, as determined by renderer projection matrix setup (typically 0).
-		float NearDepthValue;  // Set to the Depth Buffer Value for the near clip plane, as determined by renderer projection matrix setup (typically 1).
+		// Runtime data from BendDispatchCache:
+		float LightCoordinate[4];                               // Values stored in DispatchList::LightCoordinate_Shader by BuildDispatchList()
+		int Dispatches[BendDispatchCache::MaxDispatches][4];  // BendDispatchCache::Layout::dispatches, one per dispatch of BuildDispatchList()
 
 		// Sampling data:
 		float InvDepthTextureSize[2];  // Inverse of the texture dimensions for 'DepthTexture' (used to convert from pixel coordinates to UVs)
 									   // If 'PointBorderSampler' is an Unnormalized sampler, then this value can be hard-coded to 1.
 									   // The 'USE_HALF_PIXEL_OFFSET' macro might need to be defined if sampling at exact pixel coordinates isn't precise (e.g., if odd patterns appear in the shadow).
 
+		// Renderer Specific Values:
+		float FarDepthValue;   // Set to the Depth Buffer Value for the far clip plane, as determined by renderer projection matrix setup (typically 0).
+		float NearDepthValue;  // Set to the Depth Buffer Value for the near clip plane, as determined by renderer projection matrix setup (typically 1).
+
+		uint DispatchCount;
+		uint pad0[3];
+
 		BendSettings settings;
 	};
 
 	ID3D11SamplerState* pointBorderSampler = nullptr;
 
-	ConstantBuffer* raymarchCB = nullptr;
+	// One per eye, each is rebuilt and uploaded only when its light moves to another pixel or the view changes
+	BendDispatchCache dispatchCache[2];
+	ConstantBuffer* raymarchCB[2] = { nullptr, nullptr };
 	ID3D11ComputeShader* raymarchCS = nullptr;
 	ID3D11ComputeShader* raymarchRightCS = nullptr;
 
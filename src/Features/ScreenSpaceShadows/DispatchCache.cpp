@@ -0,0 +1,59 @@
+#include "Features/ScreenSpaceShadows/DispatchCache.h"
+
+#pragma warning(push)
+#pragma warning(disable: 4838 4244)
+#include "Features/ScreenSpaceShadows/bend_sss_cpu.h"
+#pragma warning(pop)
+
+void BendDispatchCache::GetLightCoordinate(const float a_lightProjection[4], const int a_viewportSize[2], float o_lightCoordinate[4])
+{
+	// Mirrors the start of Bend::BuildDispatchList, including its limit for lights far off screen
+	float xy_light_w = a_lightProjection[3];
+	float FP_limit = 0.000002f * (float)WaveSize;
+
+	if (xy_light_w >= 0 && xy_light_w < FP_limit)
+		xy_light_w = FP_limit;
+	else if (xy_light_w < 0 && xy_light_w > -FP_limit)
+		xy_light_w = -FP_limit;
+
+	o_lightCoordinate[0] = ((a_lightProjection[0] / xy_light_w) * +0.5f + 0.5f) * (float)a_viewportSize[0];
+	o_lightCoordinate[1] = ((a_lightProjection[1] / xy_light_w) * -0.5f + 0.5f) * (float)a_viewportSize[1];
+	o_lightCoordinate[2] = a_lightProjection[3] == 0 ? 0 : (a_lightProjection[2] / a_lightProjection[3]);
+	o_lightCoordinate[3] = a_lightProjection[3] > 0 ? 1.0f : -1.0f;
+}
+
+const BendDispatchCache::Layout& BendDispatchCache::Update(const float a_lightProjection[4], const int a_viewportSize[2], const int a_minRenderBounds[2], const int a_maxRenderBounds[2])
+{
+	GetLightCoordinate(a_lightProjection, a_viewportSize, layout.lightCoordinate);
+
+	Key newKey{
+		{ (int)(layout.lightCoordinate[0] + 0.5f), (int)(layout.lightCoordinate[1] + 0.5f) },
+		{ a_viewportSize[0], a_viewportSize[1] },
+		{ a_minRenderBounds[0], a_minRenderBounds[1] },
+		{ a_maxRenderBounds[0], a_maxRenderBounds[1] }
+	};
+
+	if (key == newKey)
+		return layout;
+
+	key = newKey;
+	rebuildCount++;
+
+	float lightProjection[4] = { a_lightProjection[0], a_lightProjection[1], a_lightProjection[2], a_lightProjection[3] };
+	auto dispatchList = Bend::BuildDispatchList(lightProjection, newKey.viewportSize, newKey.minRenderBounds, newKey.maxRenderBounds, false, WaveSize);
+
+	// Every dispatch is WaveSize groups wide, so they stack along y as one dispatch
+	layout.dispatchCount = 0;
+	layout.groupCount = 0;
+	for (int i = 0; i < dispatchList.DispatchCount; i++) {
+		auto& dispatchData = dispatchList.Dispatch[i];
+		auto& dispatch = layout.dispatches[layout.dispatchCount++];
+		dispatch[0] = dispatchData.WaveOffset_Shader[0];
+		dispatch[1] = dispatchData.WaveOffset_Shader[1];
+		dispatch[2] = (int)layout.groupCount;
+		dispatch[3] = dispatchData.WaveCount[1];
+		layout.groupCount += dispatchData.WaveCount[1] * dispatchData.WaveCount[2];
+	}
+
+	return layout;
+}
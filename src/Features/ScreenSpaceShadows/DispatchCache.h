@@ -0,0 +1,41 @@
+#pragma once
+
+// Bend dispatches of one view merged into one, rebuilt only when the light pixel, viewport or render bounds change
+class BendDispatchCache
+{
+public:
+	static constexpr uint MaxDispatches = 8;  // most BuildDispatchList returns
+	static constexpr int WaveSize = 64;
+
+	struct Layout
+	{
+		float lightCoordinate[4];
+		int dispatches[MaxDispatches][4];  // wave offset in xy, first merged group in z, groups along y in w
+		uint dispatchCount = 0;
+		uint groupCount = 0;  // groups along y of the merged dispatch, along x there are always WaveSize
+	};
+
+	const Layout& Update(const float a_lightProjection[4], const int a_viewportSize[2], const int a_minRenderBounds[2], const int a_maxRenderBounds[2]);
+
+	/**
+	 * Same light coordinate as BuildDispatchList, without building the dispatches
+	 */
+	static void GetLightCoordinate(const float a_lightProjection[4], const int a_viewportSize[2], float o_lightCoordinate[4]);
+
+	uint GetRebuildCount() const { return rebuildCount; }
+
+private:
+	struct Key
+	{
+		int lightXY[2];
+		int viewportSize[2];
+		int minRenderBounds[2];
+		int maxRenderBounds[2];
+
+		bool operator==(const Key&) const = default;
+	};
+
+	std::optional<Key> key;
+	Layout layout;
+	uint rebuildCount = 0;
+};
@@ -7,7 +7,8 @@ NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(
 	MinDiffuseVisibility,
 	DiffuseBrightness,
 	MinSpecularVisibility,
-	SpecularBrightness)
+	SpecularBrightness,
+	ProbeUpdateBudget)
 
 void Skylighting::LoadSettings(json& o_json)
 {
@@ -40,6 +41,12 @@ void Skylighting::DrawSettings()
 	ImGui::SliderFloat("Diffuse Brightness", &settings.DiffuseBrightness, 0, 10, "%.1f");
 	ImGui::SliderFloat("Specular Min Visibility", &settings.MinSpecularVisibility, 0, 1, "%.2f");
 	ImGui::SliderFloat("Specular Brightness", &settings.SpecularBrightness, 0, 10, "%.1f");
+
+	ImGui::SliderInt("Probe Update Budget", (int*)&settings.ProbeUpdateBudget, 16, 2048);
+	if (auto _tt = Util::HoverTooltipWrapper())
+		ImGui::Text(
+			"Number of 8x8x8 probe bricks refreshed per frame, besides those uncovered by camera movement.\n"
+			"Lower is faster, higher converges quicker after the occlusion changes.");
 }
 
 ID3D11PixelShader* Skylighting::GetFoliagePS()
@@ -128,6 +135,21 @@ void Skylighting::SetupResources()
 		texAccumFramesArray->CreateUAV(uavDesc);
 	}
 
+	{
+		probeScheduler.Resize(probeArrayDims);
+		const uint numBricks = probeScheduler.GetBrickCount();
+
+		D3D11_BUFFER_DESC sbDesc = StructuredBufferDesc<uint>(numBricks, false, true);
+		probeBrickList = eastl::make_unique<Buffer>(sbDesc);
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+		srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+		srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+		srvDesc.Buffer.FirstElement = 0;
+		srvDesc.Buffer.NumElements = numBricks;
+		probeBrickList->CreateSRV(srvDesc);
+	}
+
 	{
 		D3D11_SAMPLER_DESC samplerDesc = {
 			.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT,
@@ -188,6 +210,8 @@ void Skylighting::Prepass()
 {
 	auto& context = State::GetSingleton()->context;
 
+	occlusionScheduler.Update(RE::GetSecondsSinceLastFrame());
+
 	{
 		static float3 prevCellID = { 0, 0, 0 };
 
@@ -215,6 +239,7 @@ void Skylighting::Prepass()
 			.ValidMargin = { (int)cellIDDiff.x, (int)cellIDDiff.y, (int)cellIDDiff.z },
 			.MixParams = { settings.MinDiffuseVisibility, settings.DiffuseBrightness, settings.MinSpecularVisibility, settings.SpecularBrightness },
 			.DirectionalDiffuse = settings.DirectionalDiffuse,
+			.OcclusionPosOffset = occlusionScheduler.GetOffsetSinceCapture(eyePos),
 		};
 
 		skylightingCB->Update(cbData);
@@ -222,19 +247,35 @@ void Skylighting::Prepass()
 		prevCellID = cellID;
 	}
 
-	std::array<ID3D11ShaderResourceView*, 1> srvs = { texOcclusion->srv.get() };
+	// newly exposed slabs must be rebuilt this frame while ValidMargin describes them, the rest is budgeted
+	probeScheduler.Expose(cbData.ArrayOrigin, cbData.ValidMargin);
+	const ProbeBrickScheduler::Frame frame{
+		.arrayOrigin = { cbData.ArrayOrigin[0], cbData.ArrayOrigin[1], cbData.ArrayOrigin[2] },
+		.captureOffset = cbData.PosOffset + cbData.OcclusionPosOffset,
+		.occlusionViewProj = std::bit_cast<DirectX::XMFLOAT4X4>(cbData.OcclusionViewProj),
+	};
+	const auto& bricks = probeScheduler.Schedule(frame, occlusionCaptureIndex, settings.ProbeUpdateBudget);
+	if (!bricks.empty()) {
+		D3D11_MAPPED_SUBRESOURCE mapped;
+		DX::ThrowIfFailed(context->Map(probeBrickList->resource.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+		size_t bytes = sizeof(uint) * bricks.size();
+		memcpy_s(mapped.pData, bytes, bricks.data(), bytes);
+		context->Unmap(probeBrickList->resource.get(), 0);
+	}
+
+	std::array<ID3D11ShaderResourceView*, 2> srvs = { texOcclusion->srv.get(), probeBrickList->srv.get() };
 	std::array<ID3D11UnorderedAccessView*, 2> uavs = { texProbeArray->uav.get(), texAccumFramesArray->uav.get() };
 	std::array<ID3D11SamplerState*, 1> samplers = { pointClampSampler.get() };
 	auto cb = skylightingCB->CB();
 
 	// update probe array
-	{
+	if (!bricks.empty()) {
 		context->CSSetConstantBuffers(1, 1, &cb);
 		context->CSSetSamplers(0, (uint)samplers.size(), samplers.data());
 		context->CSSetShaderResources(0, (uint)srvs.size(), srvs.data());
 		context->CSSetUnorderedAccessViews(0, (uint)uavs.size(), uavs.data(), nullptr);
 		context->CSSetShader(probeUpdateCompute.get(), nullptr, 0);
-		context->Dispatch((probeArrayDims[0] + 7u) >> 3, (probeArrayDims[1] + 7u) >> 3, probeArrayDims[2]);
+		context->Dispatch((uint)bricks.size(), 1, ProbeBrickScheduler::BrickSize);
 	}
 
 	// reset
@@ -258,6 +299,37 @@ void Skylighting::Prepass()
 	}
 }
 
+RE::BSEventNotifyControl CellAttachDetachEventHandler::ProcessEvent(const RE::TESCellAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESCellAttachDetachEvent>*)
+{
+	// the set of occluders changed, the precipitation occlusion has to be captured again.
+	// This fires once per reference while a cell streams in, ShouldCapture waits until the burst settles.
+	if (a_event && a_event->reference)
+		Skylighting::GetSingleton()->occlusionScheduler.OnGeometryChanged();
+	return RE::BSEventNotifyControl::kContinue;
+}
+
+bool CellAttachDetachEventHandler::Register()
+{
+	static CellAttachDetachEventHandler singleton;
+	auto scripts = RE::ScriptEventSourceHolder::GetSingleton();
+
+	if (!scripts) {
+		logger::error("Script event source not found");
+		return false;
+	}
+
+	scripts->GetEventSource<RE::TESCellAttachDetachEvent>()->AddEventSink(&singleton);
+
+	logger::info("Registered {}", typeid(singleton).name());
+
+	return true;
+}
+
+void Skylighting::DataLoaded()
+{
+	CellAttachDetachEventHandler::Register();
+}
+
 void Skylighting::PostPostLoad()
 {
 	logger::info("[SKYLIGHTING] Hooking BSLightingShaderProperty::GetPrecipitationOcclusionMapRenderPassesImp");
@@ -275,6 +347,11 @@ struct BSParticleShaderRainEmitter
 	char _pad_8[4056];
 };
 
+void Skylighting::OcclusionEmitterDeleter::operator()(BSParticleShaderRainEmitter* a_emitter) const
+{
+	delete a_emitter;
+}
+
 enum class ShaderTechnique
 {
 	// Sky
@@ -443,9 +520,19 @@ struct RenderPassArray
 		return newPass;
 	}
 
+	/**
+	 * Whether the list already holds exactly this single pass, e.g. from the previous capture.
+	 */
+	bool HasSinglePass(RE::BSShader* shader, RE::BSShaderProperty* property, RE::BSGeometry* geometry, uint32_t technique) const
+	{
+		return head != nullptr && head->next == nullptr && head->shader == shader && head->shaderProperty == property &&
+		       head->geometry == geometry && head->passEnum == technique && head->numLights == 0;
+	}
+
 	RE::BSRenderPass* head;  // 00
 	uint64_t unk08;          // 08
 };
+static_assert(sizeof(RenderPassArray) == 0x10);
 
 class BSBatchRenderer
 {
@@ -514,29 +601,35 @@ void* Skylighting::BSLightingShaderProperty_GetPrecipitationOcclusionMapRenderPa
 
 	auto* precipitationOcclusionMapRenderPassList = reinterpret_cast<RenderPassArray*>(&property->unk0C8);
 
-	precipitationOcclusionMapRenderPassList->Clear();
+	bool skip;
 	if (GetSingleton()->inOcclusion && !GetSingleton()->renderTrees) {
-		if (property->flags.any(kSkinned) && property->flags.none(kTreeAnim))
-			return precipitationOcclusionMapRenderPassList;
+		skip = property->flags.any(kSkinned) && property->flags.none(kTreeAnim);
 	} else {
-		if (property->flags.any(kSkinned))
-			return precipitationOcclusionMapRenderPassList;
+		skip = property->flags.any(kSkinned);
 	}
 
-	if (property->flags.any(kZBufferWrite) && property->flags.none(kRefraction, kTempRefraction, kMultiTextureLandscape, kNoLODLandBlend, kLODLandscape, kEyeReflect, kDecal, kDynamicDecal, kAnisotropicLighting) && !(property->flags.any(kSkinned) && property->flags.none(kTreeAnim))) {
+	if (!skip && property->flags.any(kZBufferWrite) && property->flags.none(kRefraction, kTempRefraction, kMultiTextureLandscape, kNoLODLandBlend, kLODLandscape, kEyeReflect, kDecal, kDynamicDecal, kAnisotropicLighting) && !(property->flags.any(kSkinned) && property->flags.none(kTreeAnim))) {
 		if (geometry->worldBound.radius > GetSingleton()->boundSize) {
 			stl::enumeration<BSUtilityShader::Flags> technique;
 			technique.set(RenderDepth);
 
-			auto pass = precipitationOcclusionMapRenderPassList->EmplacePass(
-				BSUtilityShader::GetSingleton(),
-				property,
-				geometry,
-				technique.underlying() + static_cast<uint32_t>(ShaderTechnique::UtilityGeneralStart));
-			if (property->flags.any(kTreeAnim))
-				pass->accumulationHint = 11;
+			const auto shader = BSUtilityShader::GetSingleton();
+			const uint32_t passTechnique = technique.underlying() + static_cast<uint32_t>(ShaderTechnique::UtilityGeneralStart);
+			const bool treeAnim = property->flags.any(kTreeAnim);
+
+			// keep the pass from the previous capture instead of returning it to the pool and allocating an identical one
+			auto pass = precipitationOcclusionMapRenderPassList->head;
+			if (!precipitationOcclusionMapRenderPassList->HasSinglePass(shader, property, geometry, passTechnique) || (pass->accumulationHint == 11) != treeAnim) {
+				precipitationOcclusionMapRenderPassList->Clear();
+				pass = precipitationOcclusionMapRenderPassList->EmplacePass(shader, property, geometry, passTechnique);
+				if (treeAnim)
+					pass->accumulationHint = 11;
+			}
+			return precipitationOcclusionMapRenderPassList;
 		}
 	}
+
+	precipitationOcclusionMapRenderPassList->Clear();
 	return precipitationOcclusionMapRenderPassList;
 }
 
@@ -575,11 +668,11 @@ void Skylighting::Main_Precipitation_RenderOcclusion::thunk()
 		{
 			doPrecip = true;
 
-			std::chrono::time_point<std::chrono::system_clock> currentTimer = std::chrono::system_clock::now();
-			auto timePassed = std::chrono::duration_cast<std::chrono::milliseconds>(currentTimer - singleton->lastUpdateTimer).count();
+			auto eyePosNI = Util::GetEyePosition(0);
+			auto eyePos = float3{ eyePosNI.x, eyePosNI.y, eyePosNI.z };
 
-			if (timePassed >= (1000.0f / 30.0f)) {
-				singleton->lastUpdateTimer = currentTimer;
+			if (singleton->occlusionScheduler.ShouldCapture(eyePos, singleton->occlusionDistance, singleton->probeScheduler.GetPendingBricks() > 0)) {
+				singleton->occlusionScheduler.OnCapture(eyePos);
 
 				auto renderer = RE::BSGraphics::Renderer::GetSingleton();
 				auto& precipitation = renderer->GetDepthStencilData().depthStencils[RE::RENDER_TARGETS_DEPTHSTENCIL::kPRECIPITATION_OCCLUSION_MAP];
@@ -633,16 +726,17 @@ void Skylighting::Main_Precipitation_RenderOcclusion::thunk()
 				Precipitation_SetupMask(precip);
 				Precipitation_SetupMask(precip);  // Calling setup twice fixes an issue when it is raining
 
-				BSParticleShaderRainEmitter* rain = new BSParticleShaderRainEmitter;
-				Precipitation_RenderMask(precip, rain);
+				if (!singleton->occlusionEmitter)
+					singleton->occlusionEmitter.reset(new BSParticleShaderRainEmitter{});
+				Precipitation_RenderMask(precip, singleton->occlusionEmitter.get());
 				singleton->inOcclusion = false;
-				RE::BSParticleShaderCubeEmitter* cube = (RE::BSParticleShaderCubeEmitter*)rain;
+				RE::BSParticleShaderCubeEmitter* cube = (RE::BSParticleShaderCubeEmitter*)singleton->occlusionEmitter.get();
 
 				singleton->OcclusionDir = -float4{ PrecipitationShaderDirectionF.x, PrecipitationShaderDirectionF.y, PrecipitationShaderDirectionF.z, 0 };
 				singleton->OcclusionTransform = cube->occlusionProjection;
+				singleton->occlusionCaptureIndex++;
 
 				cube = nullptr;
-				delete rain;
 
 				PrecipitationShaderCubeSize = originalPrecipitationShaderCubeSize;
 				precip->lastCubeSize = originaLastCubeSize;
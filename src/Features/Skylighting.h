@@ -2,9 +2,20 @@
 
 #include "Buffer.h"
 #include "Feature.h"
+#include "Features/Skylighting/OcclusionCaptureScheduler.h"
+#include "Features/Skylighting/ProbeBrickScheduler.h"
 #include "State.h"
 #include "Util.h"
 
+struct BSParticleShaderRainEmitter;
+
+class CellAttachDetachEventHandler : public RE::BSTEventSink<RE::TESCellAttachDetachEvent>
+{
+public:
+	virtual RE::BSEventNotifyControl ProcessEvent(const RE::TESCellAttachDetachEvent* a_event, RE::BSTEventSource<RE::TESCellAttachDetachEvent>* a_eventSource);
+	static bool Register();
+};
+
 struct Skylighting : Feature
 {
 	static Skylighting* GetSingleton()
@@ -34,6 +45,7 @@ struct Skylighting : Feature
 	virtual void Prepass() override;
 
 	virtual void PostPostLoad() override;
+	virtual void DataLoaded() override;
 
 	ID3D11PixelShader* GetFoliagePS();
 	void SkylightingShaderHacks();  // referenced in State.cpp
@@ -48,6 +60,7 @@ struct Skylighting : Feature
 		float DiffuseBrightness = 3;
 		float MinSpecularVisibility = 0;
 		float SpecularBrightness = 4;
+		uint ProbeUpdateBudget = 256;  // bricks refreshed per frame on top of the ones exposed by camera movement
 	} settings;
 
 	struct SkylightingCB
@@ -63,7 +76,7 @@ struct Skylighting : Feature
 		float4 MixParams;  // x: min diffuse visibility, y: diffuse mult, z: min specular visibility, w: specular mult
 
 		uint DirectionalDiffuse;
-		float3 _pad1;
+		float3 OcclusionPosOffset;  // camera movement since texOcclusion was captured
 	} cbData;
 	static_assert(sizeof(SkylightingCB) % 16 == 0);
 	eastl::unique_ptr<ConstantBuffer> skylightingCB = nullptr;
@@ -74,6 +87,8 @@ struct Skylighting : Feature
 	Texture3D* texProbeArray = nullptr;
 	Texture3D* texAccumFramesArray = nullptr;
 
+	eastl::unique_ptr<Buffer> probeBrickList = nullptr;
+
 	winrt::com_ptr<ID3D11ComputeShader> probeUpdateCompute = nullptr;
 
 	ID3D11PixelShader* foliagePixelShader = nullptr;
@@ -91,7 +106,17 @@ struct Skylighting : Feature
 	REX::W32::XMFLOAT4X4 OcclusionTransform;
 	float4 OcclusionDir;
 
-	std::chrono::time_point<std::chrono::system_clock> lastUpdateTimer = std::chrono::system_clock::now();
+	struct OcclusionEmitterDeleter
+	{
+		void operator()(BSParticleShaderRainEmitter* a_emitter) const;
+	};
+
+	uint occlusionCaptureIndex = 0;                                                        // incremented whenever texOcclusion is re-rendered
+	std::unique_ptr<BSParticleShaderRainEmitter, OcclusionEmitterDeleter> occlusionEmitter;  // reused by every capture
+
+	OcclusionCaptureScheduler occlusionScheduler;
+
+	ProbeBrickScheduler probeScheduler;
 
 	//////////////////////////////////////////////////////////////////////////////////
 
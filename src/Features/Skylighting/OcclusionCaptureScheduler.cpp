@@ -0,0 +1,45 @@
+#include "Features/Skylighting/OcclusionCaptureScheduler.h"
+
+void OcclusionCaptureScheduler::Update(float a_deltaTime)
+{
+	sinceCapture += a_deltaTime;
+	if (geometryChangeRequested.exchange(false)) {
+		// cells stream in over several frames, wait for the burst of attach/detach events to settle
+		geometryChanged = true;
+		sinceGeometryChange = 0;
+	} else {
+		sinceGeometryChange += a_deltaTime;
+	}
+}
+
+bool OcclusionCaptureScheduler::ShouldCapture(const float3& a_eyePos, float a_extent, bool a_probesPending) const
+{
+	if (sinceCapture < 1.f / MaxCaptureRate)
+		return false;
+	if (!hasCapture)
+		return true;
+	if (geometryChanged && sinceGeometryChange >= GeometrySettleTime)
+		return true;
+	if ((a_eyePos - captureEyePos).Length() > a_extent * MoveThreshold)
+		return true;
+	// each capture is jittered, converging probes need new ones but not at the full rate
+	return a_probesPending && sinceCapture >= 1.f / ConvergenceCaptureRate;
+}
+
+void OcclusionCaptureScheduler::OnCapture(const float3& a_eyePos)
+{
+	sinceCapture = 0;
+	captureEyePos = a_eyePos;
+	hasCapture = true;
+	geometryChanged = false;
+}
+
+void OcclusionCaptureScheduler::OnGeometryChanged()
+{
+	geometryChangeRequested = true;
+}
+
+float3 OcclusionCaptureScheduler::GetOffsetSinceCapture(const float3& a_eyePos) const
+{
+	return hasCapture ? a_eyePos - captureEyePos : float3{ 0, 0, 0 };
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+
+/**
+ * Decides when the skylighting occlusion map is re-rendered. Otherwise the previous capture is reused,
+ * re-projected by the camera movement since it was taken. Time is the game's frame time accumulated by Update.
+ */
+class OcclusionCaptureScheduler
+{
+public:
+	static constexpr float MaxCaptureRate = 30.f;         // per second
+	static constexpr float ConvergenceCaptureRate = 8.f;  // per second, while probes still accumulate
+	static constexpr float GeometrySettleTime = 0.25f;    // seconds without attach/detach before recapturing
+	static constexpr float MoveThreshold = 1.f / 16.f;    // fraction of the capture extent
+
+	// once per frame, with RE::GetSecondsSinceLastFrame()
+	void Update(float a_deltaTime);
+
+	bool ShouldCapture(const float3& a_eyePos, float a_extent, bool a_probesPending) const;
+	void OnCapture(const float3& a_eyePos);
+
+	// the set of occluders changed, callable from any thread
+	void OnGeometryChanged();
+
+	// camera movement since the last capture, zero before the first one
+	float3 GetOffsetSinceCapture(const float3& a_eyePos) const;
+
+private:
+	float sinceCapture = std::numeric_limits<float>::infinity();
+	float sinceGeometryChange = 0;
+	float3 captureEyePos{};
+	bool hasCapture = false;
+	bool geometryChanged = false;                       // since the last capture
+	std::atomic<bool> geometryChangeRequested = false;  // by OnGeometryChanged, taken by Update
+};
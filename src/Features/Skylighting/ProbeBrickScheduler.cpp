@@ -0,0 +1,152 @@
+#include "Features/Skylighting/ProbeBrickScheduler.h"
+
+void ProbeBrickScheduler::Resize(const uint (&a_probeDims)[3])
+{
+	for (uint axis = 0; axis < 3; ++axis) {
+		probeDims[axis] = a_probeDims[axis];
+		brickDims[axis] = (a_probeDims[axis] + BrickSize - 1) / BrickSize;
+		exposedSlabs[axis].assign(brickDims[axis], true);  // everything starts invalid
+	}
+	const uint numBricks = brickDims[0] * brickDims[1] * brickDims[2];
+	updateCount.assign(numBricks, 0);
+	lastCapture.assign(numBricks, 0);
+	candidates.reserve(numBricks);
+	brickList.reserve(numBricks);
+}
+
+void ProbeBrickScheduler::Expose(const uint (&a_arrayOrigin)[4], const int (&a_validMargin)[4])
+{
+	for (uint axis = 0; axis < 3; ++axis) {
+		const int margin = a_validMargin[axis];
+		const uint dim = probeDims[axis];
+		if ((uint)std::abs(margin) >= dim) {
+			std::fill(exposedSlabs[axis].begin(), exposedSlabs[axis].end(), true);
+			continue;
+		}
+
+		// cells [0, margin) or (dim - 1 + margin, dim - 1] are invalid, see updateProbes.cs.hlsl
+		const uint firstCell = margin > 0 ? 0 : dim + margin;
+		const uint numCells = (uint)std::abs(margin);
+		for (uint i = 0; i < numCells; ++i) {
+			const uint texel = (firstCell + i + a_arrayOrigin[axis]) % dim;
+			exposedSlabs[axis][texel / BrickSize] = true;
+		}
+	}
+}
+
+bool ProbeBrickScheduler::IsInCapture(const uint (&a_brick)[3], const Frame& a_frame) const
+{
+	// probe centres covered by the brick along each axis, split in two where the brick wraps around the array
+	const float offset[3] = { a_frame.captureOffset.x, a_frame.captureOffset.y, a_frame.captureOffset.z };
+	std::pair<float, float> ranges[3][2];
+	uint numRanges[3];
+	for (uint axis = 0; axis < 3; ++axis) {
+		const uint dim = probeDims[axis];
+		const uint first = a_brick[axis] * BrickSize;
+		const uint count = std::min(BrickSize, dim - first);
+		const uint firstCell = (first - a_frame.arrayOrigin[axis]) % dim;  // see cellID in updateProbes.cs.hlsl
+		auto centre = [&](uint cell) {
+			return ((float)cell + 0.5f - (float)(dim / 2)) / (float)dim * ProbeArraySize[axis] + offset[axis];
+		};
+		if (firstCell + count <= dim) {
+			ranges[axis][0] = { centre(firstCell), centre(firstCell + count - 1) };
+			numRanges[axis] = 1;
+		} else {
+			ranges[axis][0] = { centre(firstCell), centre(dim - 1) };
+			ranges[axis][1] = { centre(0), centre(firstCell + count - 1 - dim) };
+			numRanges[axis] = 2;
+		}
+	}
+
+	// the capture is orthographic, so the corners of each box bound its projection
+	const auto& viewProj = a_frame.occlusionViewProj;
+	for (uint i = 0; i < numRanges[0]; ++i) {
+		for (uint j = 0; j < numRanges[1]; ++j) {
+			for (uint k = 0; k < numRanges[2]; ++k) {
+				float2 minOS = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+				float2 maxOS = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+				for (uint corner = 0; corner < 8; ++corner) {
+					const float3 position = {
+						corner & 1 ? ranges[0][i].second : ranges[0][i].first,
+						corner & 2 ? ranges[1][j].second : ranges[1][j].first,
+						corner & 4 ? ranges[2][k].second : ranges[2][k].first
+					};
+					// row_major OcclusionViewProj times a column vector, as in updateProbes.cs.hlsl
+					const float2 positionOS = {
+						viewProj._11 * position.x + viewProj._12 * position.y + viewProj._13 * position.z + viewProj._14,
+						viewProj._21 * position.x + viewProj._22 * position.y + viewProj._23 * position.z + viewProj._24
+					};
+					minOS = { std::min(minOS.x, positionOS.x), std::min(minOS.y, positionOS.y) };
+					maxOS = { std::max(maxOS.x, positionOS.x), std::max(maxOS.y, positionOS.y) };
+				}
+				if (minOS.x < 1 && maxOS.x > -1 && minOS.y < 1 && maxOS.y > -1)
+					return true;
+			}
+		}
+	}
+	return false;
+}
+
+const std::vector<uint>& ProbeBrickScheduler::Schedule(const Frame& a_frame, uint a_captureIndex, uint a_budget)
+{
+	brickList.clear();
+	candidates.clear();
+	pendingBricks = 0;
+
+	// the camera sits in the centre cell of the array
+	uint cameraBrick[3];
+	for (uint axis = 0; axis < 3; ++axis)
+		cameraBrick[axis] = ((probeDims[axis] / 2 + a_frame.arrayOrigin[axis]) % probeDims[axis]) / BrickSize;
+
+	auto wrappedDistance = [&](uint axis, uint brick) {
+		const uint d = brick > cameraBrick[axis] ? brick - cameraBrick[axis] : cameraBrick[axis] - brick;
+		return std::min(d, brickDims[axis] - d);
+	};
+
+	uint index = 0;
+	for (uint z = 0; z < brickDims[2]; ++z) {
+		for (uint y = 0; y < brickDims[1]; ++y) {
+			for (uint x = 0; x < brickDims[0]; ++x, ++index) {
+				const uint packed = x | (y << 8) | (z << 16);
+				const bool inCapture = IsInCapture({ x, y, z }, a_frame);
+				if (exposedSlabs[0][x] || exposedSlabs[1][y] || exposedSlabs[2][z]) {
+					// always dispatched, updateProbes resets the invalid probes outside the capture
+					updateCount[index] = 1;
+					lastCapture[index] = a_captureIndex;
+					brickList.push_back(packed);
+					if (inCapture)
+						pendingBricks++;
+					continue;
+				}
+				if (updateCount[index] >= FadeInThreshold)
+					continue;  // converged
+				if (!inCapture)
+					continue;  // nothing to accumulate until a capture covers it
+				pendingBricks++;
+				if (lastCapture[index] == a_captureIndex)
+					continue;  // nothing new to accumulate
+
+				const uint distance = std::max({ wrappedDistance(0, x), wrappedDistance(1, y), wrappedDistance(2, z) });
+				const float priority = (float)(a_captureIndex - lastCapture[index]) / (1.f + (float)distance);
+				candidates.push_back({ priority, index });
+			}
+		}
+	}
+
+	for (auto& slabs : exposedSlabs)
+		std::fill(slabs.begin(), slabs.end(), false);
+
+	const size_t budget = std::min<size_t>(a_budget, candidates.size());
+	std::nth_element(candidates.begin(), candidates.begin() + budget, candidates.end(),
+		[](const auto& a, const auto& b) { return a.first > b.first; });
+	for (size_t i = 0; i < budget; ++i) {
+		const uint brickIndex = candidates[i].second;
+		const uint x = brickIndex % brickDims[0];
+		const uint y = (brickIndex / brickDims[0]) % brickDims[1];
+		const uint z = brickIndex / (brickDims[0] * brickDims[1]);
+		updateCount[brickIndex]++;
+		lastCapture[brickIndex] = a_captureIndex;
+		brickList.push_back(x | (y << 8) | (z << 16));
+	}
+	return brickList;
+}
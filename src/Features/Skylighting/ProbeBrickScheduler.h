@@ -0,0 +1,50 @@
+#pragma once
+
+/**
+ * Chooses which bricks of the skylighting probe array updateProbes refreshes each frame.
+ * Bricks containing probes newly exposed by camera movement are always updated,
+ * the rest share a budget ordered by distance to the camera and by how many occlusion captures they missed.
+ * Bricks outside the last occlusion capture are skipped, updateProbes can not accumulate them.
+ */
+class ProbeBrickScheduler
+{
+public:
+	static constexpr uint BrickSize = 8;
+	static constexpr uint8_t FadeInThreshold = 64;                                  // same as updateProbes.cs.hlsl, probes stop accumulating after this many updates
+	static constexpr std::array<float, 3> ProbeArraySize = { 10000, 10000, 5000 };  // same as ARRAY_SIZE in updateProbes.cs.hlsl
+
+	// the parts of SkylightingCB that place the probe array in the occlusion capture
+	struct Frame
+	{
+		uint arrayOrigin[3];
+		float3 captureOffset;                   // PosOffset + OcclusionPosOffset
+		DirectX::XMFLOAT4X4 occlusionViewProj;  // row_major, as in updateProbes.cs.hlsl
+	};
+
+	void Resize(const uint (&a_probeDims)[3]);
+
+	// mark the bricks of the texels ValidMargin invalidates, see updateProbes.cs.hlsl
+	void Expose(const uint (&a_arrayOrigin)[4], const int (&a_validMargin)[4]);
+
+	/**
+	 * @return Bricks to dispatch this frame, packed x | y << 8 | z << 16
+	 */
+	const std::vector<uint>& Schedule(const Frame& a_frame, uint a_captureIndex, uint a_budget);
+
+	bool IsInCapture(const uint (&a_brick)[3], const Frame& a_frame) const;
+
+	uint GetBrickCount() const { return brickDims[0] * brickDims[1] * brickDims[2]; }
+
+	// bricks inside the capture which have not converged yet, as of the last Schedule
+	uint GetPendingBricks() const { return pendingBricks; }
+
+private:
+	uint probeDims[3] = {};
+	uint brickDims[3] = {};
+	std::array<std::vector<bool>, 3> exposedSlabs;  // per axis, bricks overlapping newly exposed texels
+	std::vector<uint8_t> updateCount;              // updates since the brick was last exposed
+	std::vector<uint> lastCapture;                 // occlusion capture the brick was last updated with
+	std::vector<std::pair<float, uint>> candidates;
+	std::vector<uint> brickList;
+	uint pendingBricks = 0;
+};
@@ -2,6 +2,7 @@
 #include "SubsurfaceScattering.h"
 
 #include "Deferred.h"
+#include "Features/SubsurfaceScattering/TileClassification.h"
 #include "Features/TerrainBlending.h"
 #include "ShaderCache.h"
 #include "State.h"
@@ -35,8 +36,8 @@ void SubsurfaceScattering::DrawSettings()
 				ImGui::Text("Blur radius relative to depth.");
 			}
 
-			updateKernels = updateKernels || ImGui::ColorEdit3("Strength", (float*)&settings.BaseProfile.Strength);
-			updateKernels = updateKernels || ImGui::ColorEdit3("Falloff", (float*)&settings.BaseProfile.Falloff);
+			ImGui::ColorEdit3("Strength", (float*)&settings.BaseProfile.Strength);
+			ImGui::ColorEdit3("Falloff", (float*)&settings.BaseProfile.Falloff);
 
 			ImGui::TreePop();
 		}
@@ -52,8 +53,8 @@ void SubsurfaceScattering::DrawSettings()
 				ImGui::Text("Blur radius relative to depth.");
 			}
 
-			updateKernels = updateKernels || ImGui::ColorEdit3("Strength", (float*)&settings.HumanProfile.Strength);
-			updateKernels = updateKernels || ImGui::ColorEdit3("Falloff", (float*)&settings.HumanProfile.Falloff);
+			ImGui::ColorEdit3("Strength", (float*)&settings.HumanProfile.Strength);
+			ImGui::ColorEdit3("Falloff", (float*)&settings.HumanProfile.Falloff);
 
 			ImGui::TreePop();
 		}
@@ -65,99 +66,6 @@ void SubsurfaceScattering::DrawSettings()
 	}
 }
 
-float3 SubsurfaceScattering::Gaussian(DiffusionProfile& a_profile, float variance, float r)
-{
-	/**
-     * We use a falloff to modulate the shape of the profile. Big falloffs
-     * spreads the shape making it wider, while small falloffs make it
-     * narrower.
-     */
-	float falloff[3] = { a_profile.Falloff.x, a_profile.Falloff.y, a_profile.Falloff.z };
-	float g[3];
-	for (int i = 0; i < 3; i++) {
-		float rr = r / (0.001f + falloff[i]);
-		g[i] = exp((-(rr * rr)) / (2.0f * variance)) / (2.0f * 3.14f * variance);
-	}
-	return float3(g[0], g[1], g[2]);
-}
-
-float3 SubsurfaceScattering::Profile(DiffusionProfile& a_profile, float r)
-{
-	/**
-     * We used the red channel of the original skin profile defined in
-     * [d'Eon07] for all three channels. We noticed it can be used for green
-     * and blue channels (scaled using the falloff parameter) without
-     * introducing noticeable differences and allowing for total control over
-     * the profile. For example, it allows to create blue SSS gradients, which
-     * could be useful in case of rendering blue creatures.
-     */
-	return  // 0.233f * gaussian(0.0064f, r) + /* We consider this one to be directly bounced light, accounted by the strength parameter (see @STRENGTH) */
-		0.100f * Gaussian(a_profile, 0.0484f, r) +
-		0.118f * Gaussian(a_profile, 0.187f, r) +
-		0.113f * Gaussian(a_profile, 0.567f, r) +
-		0.358f * Gaussian(a_profile, 1.99f, r) +
-		0.078f * Gaussian(a_profile, 7.41f, r);
-}
-
-void SubsurfaceScattering::CalculateKernel(DiffusionProfile& a_profile, Kernel& kernel)
-{
-	uint nSamples = SSSS_N_SAMPLES;
-
-	const float RANGE = nSamples > 20 ? 3.0f : 2.0f;
-	const float EXPONENT = 2.0f;
-
-	// Calculate the offsets:
-	float step = 2.0f * RANGE / (nSamples - 1);
-	for (uint i = 0; i < nSamples; i++) {
-		float o = -RANGE + float(i) * step;
-		float sign = o < 0.0f ? -1.0f : 1.0f;
-		kernel.Sample[i].w = RANGE * sign * abs(pow(o, EXPONENT)) / pow(RANGE, EXPONENT);
-	}
-
-	// Calculate the weights:
-	for (uint i = 0; i < nSamples; i++) {
-		float w0 = i > 0 ? abs(kernel.Sample[i].w - kernel.Sample[i - 1].w) : 0.0f;
-		float w1 = i < nSamples - 1 ? abs(kernel.Sample[i].w - kernel.Sample[i + 1].w) : 0.0f;
-		float area = (w0 + w1) / 2.0f;
-		float3 t = area * Profile(a_profile, kernel.Sample[i].w);
-		kernel.Sample[i].x = t.x;
-		kernel.Sample[i].y = t.y;
-		kernel.Sample[i].z = t.z;
-	}
-
-	// We want the offset 0.0 to come first:
-	float4 t = kernel.Sample[nSamples / 2];
-	for (uint i = nSamples / 2; i > 0; i--)
-		kernel.Sample[i] = kernel.Sample[i - 1];
-	kernel.Sample[0] = t;
-
-	// Calculate the sum of the weights, we will need to normalize them below:
-	float3 sum = float3(0.0f, 0.0f, 0.0f);
-	for (uint i = 0; i < nSamples; i++)
-		sum += float3(kernel.Sample[i]);
-
-	// Normalize the weights:
-	for (uint i = 0; i < nSamples; i++) {
-		kernel.Sample[i].x /= sum.x;
-		kernel.Sample[i].y /= sum.y;
-		kernel.Sample[i].z /= sum.z;
-	}
-
-	// Tweak them using the desired strength. The first one is:
-	//     lerp(1.0, kernel[0].rgb, strength)
-	kernel.Sample[0].x = (1.0f - a_profile.Strength.x) * 1.0f + a_profile.Strength.x * kernel.Sample[0].x;
-	kernel.Sample[0].y = (1.0f - a_profile.Strength.y) * 1.0f + a_profile.Strength.y * kernel.Sample[0].y;
-	kernel.Sample[0].z = (1.0f - a_profile.Strength.z) * 1.0f + a_profile.Strength.z * kernel.Sample[0].z;
-
-	// The others:
-	//     lerp(0.0, kernel[0].rgb, strength)
-	for (uint i = 1; i < nSamples; i++) {
-		kernel.Sample[i].x *= a_profile.Strength.x;
-		kernel.Sample[i].y *= a_profile.Strength.y;
-		kernel.Sample[i].z *= a_profile.Strength.z;
-	}
-}
-
 void SubsurfaceScattering::DrawSSS()
 {
 	if (!validMaterials)
@@ -168,46 +76,81 @@ void SubsurfaceScattering::DrawSSS()
 	auto dispatchCount = Util::GetScreenDispatchCount();
 
 	{
-		auto cameraData = Util::GetCameraData(0);
-
-		blurCBData.SSSS_FOVY = atan(1.0f / cameraData.projMat.m[0][0]) * 2.0f * (180.0f / 3.14159265359f);
-
-		blurCBData.BaseProfile = { settings.BaseProfile.BlurRadius, settings.BaseProfile.Thickness, 0, 0 };
-		blurCBData.HumanProfile = { settings.HumanProfile.BlurRadius, settings.HumanProfile.Thickness, 0, 0 };
+		// Cached, so settings edits and loads are picked up without tracking them
+		for (uint i = 0; i < ProfileCount; i++) {
+			auto& profile = GetProfile((Profile)i);
+			blurCBData.Kernels[i] = kernelCache.Get(profile.Falloff, profile.Strength);
+			blurCBData.Profiles[i] = { profile.BlurRadius, profile.Thickness, 0, 0 };
+		}
 
-		blurCB->Update(blurCBData);
+		blurCB->UpdateIfChanged(blurCBData);
 	}
 
 	auto renderer = RE::BSGraphics::Renderer::GetSingleton();
 	auto& context = State::GetSingleton()->context;
 
+	auto main = renderer->GetRuntimeData().renderTargets[RE::RENDER_TARGETS::kMAIN];
+	auto depth = renderer->GetDepthStencilData().depthStencils[RE::RENDER_TARGETS_DEPTHSTENCIL::kPOST_ZPREPASS_COPY];
+	auto mask = renderer->GetRuntimeData().renderTargets[MASKS];
+
+	auto terrainBlending = TerrainBlending::GetSingleton();
+	auto depthSRV = terrainBlending->loaded ? terrainBlending->blendedDepthTexture16->srv.get() : depth.depthSRV;
+
 	{
 		ID3D11Buffer* buffer[1] = { blurCB->CB() };
 		context->CSSetConstantBuffers(1, 1, buffer);
+	}
 
-		auto main = renderer->GetRuntimeData().renderTargets[RE::RENDER_TARGETS::kMAIN];
+	// Tile classification
+	{
+		UINT clear[4] = { 0, 0, 0, 0 };
+		context->ClearUnorderedAccessViewUint(indirectArgs->uav.get(), clear);
+		context->ClearUnorderedAccessViewUint(tileMask->uav.get(), clear);
+
+		ID3D11ShaderResourceView* views[2] = { mask.SRV, depthSRV };
+		context->CSSetShaderResources(0, 2, views);
+
+		ID3D11UnorderedAccessView* uavs[3] = { indirectArgs->uav.get(), verticalTiles->uav.get(), tileMask->uav.get() };
+		context->CSSetUnorderedAccessViews(0, 3, uavs, nullptr);
+
+		context->CSSetShader(GetComputeShaderClassifyTiles(), nullptr, 0);
+		context->Dispatch(dispatchCount.x, dispatchCount.y, 1);
+
+		uavs[1] = horizontalTiles->uav.get();
+		context->CSSetUnorderedAccessViews(0, 3, uavs, nullptr);
+
+		context->CSSetShader(GetComputeShaderListReachedTiles(), nullptr, 0);
+		context->Dispatch((tileMask->desc.Width + 7) / 8, (tileMask->desc.Height + 7) / 8, 1);
 
-		auto depth = renderer->GetDepthStencilData().depthStencils[RE::RENDER_TARGETS_DEPTHSTENCIL::kPOST_ZPREPASS_COPY];
-		auto mask = renderer->GetRuntimeData().renderTargets[MASKS];
+		context->CSSetShader(GetComputeShaderPrepareTileArgs(), nullptr, 0);
+		context->Dispatch(1, 1, 1);
 
+		views[0] = views[1] = nullptr;
+		context->CSSetShaderResources(0, 2, views);
+
+		uavs[0] = uavs[1] = uavs[2] = nullptr;
+		context->CSSetUnorderedAccessViews(0, 3, uavs, nullptr);
+	}
+
+	{
 		ID3D11UnorderedAccessView* uav = blurHorizontalTemp->uav.get();
 		context->CSSetUnorderedAccessViews(0, 1, &uav, nullptr);
 
-		auto terrainBlending = TerrainBlending::GetSingleton();
-
-		ID3D11ShaderResourceView* views[3];
+		ID3D11ShaderResourceView* views[5];
 		views[0] = main.SRV;
-		views[1] = terrainBlending->loaded ? terrainBlending->blendedDepthTexture16->srv.get() : depth.depthSRV,
+		views[1] = depthSRV;
 		views[2] = mask.SRV;
+		views[3] = horizontalTiles->srv.get();
+		views[4] = indirectArgs->srv.get();
 
-		context->CSSetShaderResources(0, 3, views);
+		context->CSSetShaderResources(0, 5, views);
 
 		// Horizontal pass to temporary texture
 		{
 			auto shader = GetComputeShaderHorizontalBlur();
 			context->CSSetShader(shader, nullptr, 0);
 
-			context->Dispatch(dispatchCount.x, dispatchCount.y, 1);
+			context->DispatchIndirect(indirectArgs->resource.get(), SSSTiles::HorizontalArgs);
 		}
 
 		uav = nullptr;
@@ -216,7 +159,8 @@ void SubsurfaceScattering::DrawSSS()
 		// Vertical pass to main texture
 		{
 			views[0] = blurHorizontalTemp->srv.get();
-			context->CSSetShaderResources(0, 1, views);
+			views[3] = verticalTiles->srv.get();
+			context->CSSetShaderResources(0, 5, views);
 
 			ID3D11UnorderedAccessView* uavs[1] = { main.UAV };
 			context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
@@ -224,15 +168,15 @@ void SubsurfaceScattering::DrawSSS()
 			auto shader = GetComputeShaderVerticalBlur();
 			context->CSSetShader(shader, nullptr, 0);
 
-			context->Dispatch(dispatchCount.x, dispatchCount.y, 1);
+			context->DispatchIndirect(indirectArgs->resource.get(), SSSTiles::VerticalArgs);
 		}
 	}
 
 	ID3D11Buffer* buffer = nullptr;
 	context->CSSetConstantBuffers(1, 1, &buffer);
 
-	ID3D11ShaderResourceView* views[3]{ nullptr, nullptr, nullptr };
-	context->CSSetShaderResources(0, 3, views);
+	ID3D11ShaderResourceView* views[5]{ nullptr, nullptr, nullptr, nullptr, nullptr };
+	context->CSSetShaderResources(0, 5, views);
 
 	ID3D11UnorderedAccessView* uavs[1]{ nullptr };
 	context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
@@ -282,6 +226,60 @@ void SubsurfaceScattering::SetupResources()
 		D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
 		main.UAV->GetDesc(&uavDesc);
 		blurHorizontalTemp->CreateUAV(uavDesc);
+
+		uint tilesX = (texDesc.Width + 7) / 8;
+		uint tilesY = (texDesc.Height + 7) / 8;
+
+		texDesc.Width = tilesX;
+		texDesc.Height = tilesY;
+		texDesc.MipLevels = 1;
+		texDesc.Format = DXGI_FORMAT_R8_UINT;
+		texDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+		texDesc.MiscFlags = 0;
+
+		srvDesc = { .Format = texDesc.Format, .ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D, .Texture2D = { .MostDetailedMip = 0, .MipLevels = 1 } };
+		uavDesc = { .Format = texDesc.Format, .ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D, .Texture2D = { .MipSlice = 0 } };
+
+		tileMask = new Texture2D(texDesc);
+		tileMask->CreateSRV(srvDesc);
+		tileMask->CreateUAV(uavDesc);
+
+		srvDesc = { .Format = DXGI_FORMAT_UNKNOWN, .ViewDimension = D3D11_SRV_DIMENSION_BUFFER, .Buffer = { .FirstElement = 0, .NumElements = tilesX * tilesY } };
+		uavDesc = { .Format = DXGI_FORMAT_UNKNOWN, .ViewDimension = D3D11_UAV_DIMENSION_BUFFER, .Buffer = { .FirstElement = 0, .NumElements = tilesX * tilesY, .Flags = 0 } };
+
+		horizontalTiles = std::make_unique<Buffer>(StructuredBufferDesc<uint>(tilesX * tilesY));
+		horizontalTiles->CreateSRV(srvDesc);
+		horizontalTiles->CreateUAV(uavDesc);
+
+		verticalTiles = std::make_unique<Buffer>(StructuredBufferDesc<uint>(tilesX * tilesY));
+		verticalTiles->CreateSRV(srvDesc);
+		verticalTiles->CreateUAV(uavDesc);
+	}
+
+	{
+		D3D11_BUFFER_DESC argsDesc{
+			.ByteWidth = SSSTiles::ArgsSize,
+			.Usage = D3D11_USAGE_DEFAULT,
+			.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS,
+			.CPUAccessFlags = 0,
+			.MiscFlags = D3D11_RESOURCE_MISC_DRAWINDIRECT_ARGS | D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS,
+			.StructureByteStride = 0
+		};
+		indirectArgs = std::make_unique<Buffer>(argsDesc);
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{
+			.Format = DXGI_FORMAT_R32_TYPELESS,
+			.ViewDimension = D3D11_SRV_DIMENSION_BUFFEREX,
+			.BufferEx = { .FirstElement = 0, .NumElements = SSSTiles::ArgsSize / 4, .Flags = D3D11_BUFFEREX_SRV_FLAG_RAW }
+		};
+		indirectArgs->CreateSRV(srvDesc);
+
+		D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc{
+			.Format = DXGI_FORMAT_R32_TYPELESS,
+			.ViewDimension = D3D11_UAV_DIMENSION_BUFFER,
+			.Buffer = { .FirstElement = 0, .NumElements = SSSTiles::ArgsSize / 4, .Flags = D3D11_BUFFER_UAV_FLAG_RAW }
+		};
+		indirectArgs->CreateUAV(uavDesc);
 	}
 }
 
@@ -289,12 +287,6 @@ void SubsurfaceScattering::Reset()
 {
 	auto& shaderManager = RE::BSShaderManager::State::GetSingleton();
 	shaderManager.characterLightEnabled = SIE::ShaderCache::Instance().IsEnabled() ? settings.EnableCharacterLighting : true;
-
-	if (updateKernels) {
-		updateKernels = false;
-		CalculateKernel(settings.BaseProfile, blurCBData.BaseKernel);
-		CalculateKernel(settings.HumanProfile, blurCBData.HumanKernel);
-	}
 }
 
 void SubsurfaceScattering::RestoreDefaultSettings()
@@ -322,6 +314,45 @@ void SubsurfaceScattering::ClearShaderCache()
 		verticalSSBlur->Release();
 		verticalSSBlur = nullptr;
 	}
+	if (classifyTilesCS) {
+		classifyTilesCS->Release();
+		classifyTilesCS = nullptr;
+	}
+	if (listReachedTilesCS) {
+		listReachedTilesCS->Release();
+		listReachedTilesCS = nullptr;
+	}
+	if (prepareTileArgsCS) {
+		prepareTileArgsCS->Release();
+		prepareTileArgsCS = nullptr;
+	}
+}
+
+ID3D11ComputeShader* SubsurfaceScattering::GetComputeShaderClassifyTiles()
+{
+	if (!classifyTilesCS) {
+		logger::debug("Compiling classifyTilesCS");
+		classifyTilesCS = (ID3D11ComputeShader*)Util::CompileShader(L"Data\\Shaders\\SubsurfaceScattering\\ClassifyTilesCS.hlsl", {}, "cs_5_0");
+	}
+	return classifyTilesCS;
+}
+
+ID3D11ComputeShader* SubsurfaceScattering::GetComputeShaderListReachedTiles()
+{
+	if (!listReachedTilesCS) {
+		logger::debug("Compiling listReachedTilesCS");
+		listReachedTilesCS = (ID3D11ComputeShader*)Util::CompileShader(L"Data\\Shaders\\SubsurfaceScattering\\ClassifyTilesCS.hlsl", { { "LIST_REACHED", "" } }, "cs_5_0");
+	}
+	return listReachedTilesCS;
+}
+
+ID3D11ComputeShader* SubsurfaceScattering::GetComputeShaderPrepareTileArgs()
+{
+	if (!prepareTileArgsCS) {
+		logger::debug("Compiling prepareTileArgsCS");
+		prepareTileArgsCS = (ID3D11ComputeShader*)Util::CompileShader(L"Data\\Shaders\\SubsurfaceScattering\\ClassifyTilesCS.hlsl", { { "PREPARE_ARGS", "" } }, "cs_5_0");
+	}
+	return prepareTileArgsCS;
 }
 
 ID3D11ComputeShader* SubsurfaceScattering::GetComputeShaderHorizontalBlur()
@@ -2,8 +2,7 @@
 
 #include "Buffer.h"
 #include "Feature.h"
-
-#define SSSS_N_SAMPLES 21
+#include "Features/SubsurfaceScattering/KernelCache.h"
 
 struct SubsurfaceScattering : Feature
 {
@@ -31,24 +30,29 @@ public:
 
 	Settings settings;
 
-	struct alignas(16) Kernel
+	// Blurred in the same pass, picked per pixel by GetProfileIndex in SeparableSSSCS
+	enum class Profile : uint
 	{
-		float4 Sample[SSSS_N_SAMPLES];
+		Base,
+		Human,
+		Count
 	};
 
+	static constexpr uint ProfileCount = (uint)Profile::Count;
+
+	const DiffusionProfile& GetProfile(Profile a_profile) const { return a_profile == Profile::Human ? settings.HumanProfile : settings.BaseProfile; }
+
 	struct alignas(16) BlurCB
 	{
-		Kernel BaseKernel;
-		Kernel HumanKernel;
-		float4 BaseProfile;
-		float4 HumanProfile;
-		float SSSS_FOVY;
-		uint pad[3];
+		SSSKernel Kernels[ProfileCount];
+		float4 Profiles[ProfileCount];  // blur radius and thickness in xy
 	};
 
 	ConstantBuffer* blurCB = nullptr;
 	BlurCB blurCBData{};
 
+	SSSKernelCache kernelCache;
+
 	struct PerPass
 	{
 		uint IsBeastRace;
@@ -57,11 +61,19 @@ public:
 	std::unique_ptr<Buffer> perPass = nullptr;
 
 	bool validMaterial = true;
-	bool updateKernels = true;
 	bool validMaterials = false;
 
 	Texture2D* blurHorizontalTemp = nullptr;
 
+	// 8x8 tiles the blur passes run on, see ClassifyTilesCS
+	std::unique_ptr<Buffer> indirectArgs = nullptr;
+	std::unique_ptr<Buffer> horizontalTiles = nullptr;
+	std::unique_ptr<Buffer> verticalTiles = nullptr;
+	Texture2D* tileMask = nullptr;
+
+	ID3D11ComputeShader* classifyTilesCS = nullptr;
+	ID3D11ComputeShader* listReachedTilesCS = nullptr;
+	ID3D11ComputeShader* prepareTileArgsCS = nullptr;
 	ID3D11ComputeShader* horizontalSSBlur = nullptr;
 	ID3D11ComputeShader* verticalSSBlur = nullptr;
 
@@ -77,16 +89,15 @@ public:
 
 	virtual void DrawSettings() override;
 
-	float3 Gaussian(DiffusionProfile& a_profile, float variance, float r);
-	float3 Profile(DiffusionProfile& a_profile, float r);
-	void CalculateKernel(DiffusionProfile& a_profile, Kernel& kernel);
-
 	void DrawSSS();
 
 	virtual void LoadSettings(json& o_json) override;
 	virtual void SaveSettings(json& o_json) override;
 
 	virtual void ClearShaderCache() override;
+	ID3D11ComputeShader* GetComputeShaderClassifyTiles();
+	ID3D11ComputeShader* GetComputeShaderListReachedTiles();
+	ID3D11ComputeShader* GetComputeShaderPrepareTileArgs();
 	ID3D11ComputeShader* GetComputeShaderHorizontalBlur();
 	ID3D11ComputeShader* GetComputeShaderVerticalBlur();
 
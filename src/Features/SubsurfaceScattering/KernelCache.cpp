@@ -0,0 +1,105 @@
+#include "Features/SubsurfaceScattering/KernelCache.h"
+
+using namespace DirectX;
+
+namespace
+{
+	/**
+     * We used the red channel of the original skin profile defined in
+     * [d'Eon07] for all three channels. We noticed it can be used for green
+     * and blue channels (scaled using the falloff parameter) without
+     * introducing noticeable differences and allowing for total control over
+     * the profile. For example, it allows to create blue SSS gradients, which
+     * could be useful in case of rendering blue creatures.
+     *
+     * One lane per channel, the gaussians share everything but the falloff.
+     */
+	XMVECTOR XM_CALLCONV Profile(FXMVECTOR a_falloff, float a_r)
+	{
+		// 0.233f * gaussian(0.0064f, r) is directly bounced light, accounted by the strength parameter
+		constexpr std::pair<float, float> gaussians[] = {
+			{ 0.100f, 0.0484f },
+			{ 0.118f, 0.187f },
+			{ 0.113f, 0.567f },
+			{ 0.358f, 1.99f },
+			{ 0.078f, 7.41f },
+		};
+
+		/**
+         * We use a falloff to modulate the shape of the profile. Big falloffs
+         * spreads the shape making it wider, while small falloffs make it
+         * narrower.
+         */
+		XMVECTOR rr = XMVectorDivide(XMVectorReplicate(a_r), XMVectorAdd(a_falloff, XMVectorReplicate(0.001f)));
+		XMVECTOR rr2 = XMVectorMultiply(rr, rr);
+
+		XMVECTOR result = XMVectorZero();
+		for (auto [weight, variance] : gaussians) {
+			XMVECTOR g = XMVectorExpE(XMVectorScale(rr2, -1.0f / (2.0f * variance)));
+			result = XMVectorMultiplyAdd(g, XMVectorReplicate(weight / (2.0f * 3.14f * variance)), result);
+		}
+		return result;
+	}
+}
+
+const SSSKernel& SSSKernelCache::Get(const float3& a_falloff, const float3& a_strength)
+{
+	auto match = std::ranges::find_if(entries, [&](const Entry& a_entry) {
+		return a_entry.falloff == a_falloff && a_entry.strength == a_strength;
+	});
+	if (match != entries.end())
+		return match->kernel;
+
+	if (entries.size() >= MaxEntries)
+		entries.erase(entries.begin());
+
+	entries.push_back({ a_falloff, a_strength, {} });
+	auto& entry = entries.back();
+	Calculate(a_falloff, a_strength, entry.kernel);
+	return entry.kernel;
+}
+
+void SSSKernelCache::Calculate(const float3& a_falloff, const float3& a_strength, SSSKernel& o_kernel)
+{
+	constexpr uint nSamples = SSSS_N_SAMPLES;
+	constexpr uint centre = nSamples / 2;
+
+	constexpr float RANGE = nSamples > 20 ? 3.0f : 2.0f;
+	constexpr float EXPONENT = 2.0f;
+
+	// Calculate the offsets:
+	float offsets[nSamples];
+	float step = 2.0f * RANGE / (nSamples - 1);
+	for (uint i = 0; i < nSamples; i++) {
+		float o = -RANGE + float(i) * step;
+		float sign = o < 0.0f ? -1.0f : 1.0f;
+		offsets[i] = RANGE * sign * std::abs(std::pow(o, EXPONENT)) / std::pow(RANGE, EXPONENT);
+	}
+
+	// Calculate the weights, and their sum to normalize them below:
+	XMVECTOR falloff = XMLoadFloat3(&a_falloff);
+	XMVECTOR weights[nSamples];
+	XMVECTOR sum = XMVectorZero();
+	for (uint i = 0; i < nSamples; i++) {
+		float w0 = i > 0 ? std::abs(offsets[i] - offsets[i - 1]) : 0.0f;
+		float w1 = i < nSamples - 1 ? std::abs(offsets[i] - offsets[i + 1]) : 0.0f;
+		float area = (w0 + w1) / 2.0f;
+		weights[i] = XMVectorScale(Profile(falloff, offsets[i]), area);
+		sum = XMVectorAdd(sum, weights[i]);
+	}
+
+	XMVECTOR rcpSum = XMVectorReciprocal(sum);
+	XMVECTOR strength = XMLoadFloat3(&a_strength);
+
+	// We want the offset 0.0 to come first, the negative offsets shift up by one:
+	for (uint i = 0; i < nSamples; i++) {
+		uint source = i == 0 ? centre : (i <= centre ? i - 1 : i);
+		XMVECTOR weight = XMVectorMultiply(weights[source], rcpSum);
+
+		// Tweak them using the desired strength, lerp(1.0, kernel[0].rgb, strength) for the first one
+		// and lerp(0.0, kernel[i].rgb, strength) for the others
+		weight = i == 0 ? XMVectorLerpV(XMVectorSplatOne(), weight, strength) : XMVectorMultiply(weight, strength);
+
+		XMStoreFloat4(&o_kernel.Sample[i], XMVectorSetW(weight, offsets[source]));
+	}
+}
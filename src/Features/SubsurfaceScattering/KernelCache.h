@@ -0,0 +1,32 @@
+#pragma once
+
+#define SSSS_N_SAMPLES 21
+
+struct alignas(16) SSSKernel
+{
+	float4 Sample[SSSS_N_SAMPLES];  // weights in rgb, offset in a, the centre sample first
+};
+
+// Separable SSS kernels keyed by falloff and strength, the only inputs that shape them, oldest dropped past MaxEntries
+class SSSKernelCache
+{
+public:
+	static constexpr uint MaxEntries = 16;
+
+	/**
+	 * @return Kernel for the profile, valid until the next call
+	 */
+	const SSSKernel& Get(const float3& a_falloff, const float3& a_strength);
+
+	static void Calculate(const float3& a_falloff, const float3& a_strength, SSSKernel& o_kernel);
+
+private:
+	struct Entry
+	{
+		float3 falloff;
+		float3 strength;
+		SSSKernel kernel;
+	};
+
+	std::vector<Entry> entries;  // oldest first
+};
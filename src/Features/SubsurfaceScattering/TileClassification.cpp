@@ -0,0 +1,54 @@
+#include "Features/SubsurfaceScattering/TileClassification.h"
+
+namespace SSSTiles
+{
+	std::array<uint, 3> GetDispatchArgs(uint a_tileCount)
+	{
+		return { std::min(a_tileCount, MaxGroupsPerDimension), (a_tileCount + MaxGroupsPerDimension - 1) / MaxGroupsPerDimension, 1 };
+	}
+
+	float GetBlurReach(float a_screenDepth, float a_sssAmount, float a_blurRadius, float a_projScale, float a_bufferHeight)
+	{
+		return a_projScale / a_screenDepth * a_bufferHeight * a_sssAmount * a_blurRadius;
+	}
+
+	Classification Classify(uint a_width, uint a_height, std::span<const float> a_sssAmount, std::span<const float> a_reach)
+	{
+		Classification result;
+		result.tilesX = (a_width + TileSize - 1) / TileSize;
+		result.tilesY = (a_height + TileSize - 1) / TileSize;
+		result.vertical.resize(result.tilesX * result.tilesY);
+		result.horizontal.resize(result.tilesX * result.tilesY);
+
+		for (uint tileY = 0; tileY < result.tilesY; tileY++) {
+			for (uint tileX = 0; tileX < result.tilesX; tileX++) {
+				bool hasSSS = false;
+				float maxReach = 0;
+				for (uint y = tileY * TileSize; y < std::min((tileY + 1) * TileSize, a_height); y++) {
+					for (uint x = tileX * TileSize; x < std::min((tileX + 1) * TileSize, a_width); x++) {
+						if (a_sssAmount[y * a_width + x] > 0) {
+							hasSSS = true;
+							maxReach = std::max(maxReach, std::min(a_reach[y * a_width + x], float(a_width + a_height)));
+						}
+					}
+				}
+				if (!hasSSS)
+					continue;
+
+				result.vertical[tileY * result.tilesX + tileX] = true;
+
+				int reach = (int)std::ceil(maxReach);
+				int minX = int(tileX * TileSize), minY = int(tileY * TileSize);
+				uint loX = std::max(minX - reach, 0) / TileSize;
+				uint loY = std::max(minY - reach, 0) / TileSize;
+				uint hiX = std::min(minX + int(TileSize - 1) + reach, int(a_width) - 1) / TileSize;
+				uint hiY = std::min(minY + int(TileSize - 1) + reach, int(a_height) - 1) / TileSize;
+				for (uint y = loY; y <= hiY; y++)
+					for (uint x = loX; x <= hiX; x++)
+						result.horizontal[y * result.tilesX + x] = true;
+			}
+		}
+
+		return result;
+	}
+}
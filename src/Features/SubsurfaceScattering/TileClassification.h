@@ -0,0 +1,40 @@
+#pragma once
+
+// CPU side of SSSCommon.hlsli, with a reference of ClassifyTilesCS to check which tiles the blur passes cover
+namespace SSSTiles
+{
+	static constexpr uint TileSize = 8;
+	static constexpr uint MaxGroupsPerDimension = 65535;  // D3D11_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION
+
+	// byte offsets in the indirect argument buffer
+	static constexpr uint HorizontalArgs = 0;
+	static constexpr uint VerticalArgs = 12;
+	static constexpr uint HorizontalCount = 24;
+	static constexpr uint VerticalCount = 28;
+	static constexpr uint ArgsSize = 32;
+
+	// thread group counts covering a tile list, mirrors StoreArgs in ClassifyTilesCS
+	std::array<uint, 3> GetDispatchArgs(uint a_tileCount);
+
+	// list index of a thread group, mirrors SeparableSSSCS
+	inline uint GetTileIndex(uint a_groupX, uint a_groupY) { return a_groupX + a_groupY * MaxGroupsPerDimension; }
+
+	// mirrors GetBlurReach in SSSCommon.hlsli
+	float GetBlurReach(float a_screenDepth, float a_sssAmount, float a_blurRadius, float a_projScale, float a_bufferHeight);
+
+	struct Classification
+	{
+		uint tilesX = 0;
+		uint tilesY = 0;
+		std::vector<bool> vertical;    // tiles holding SSS pixels
+		std::vector<bool> horizontal;  // tiles the vertical samples of those can read
+	};
+
+	/**
+	 * Mirrors ClassifyTilesCS over a whole frame.
+	 *
+	 * @param a_sssAmount Per pixel, row by row
+	 * @param a_reach GetBlurReach of each pixel
+	 */
+	Classification Classify(uint a_width, uint a_height, std::span<const float> a_sssAmount, std::span<const float> a_reach);
+}
@@ -21,22 +21,13 @@ ID3D11VertexShader* TerrainBlending::GetTerrainOffsetVertexShader()
 	return terrainOffsetVertexShader;
 }
 
-ID3D11ComputeShader* TerrainBlending::GetDepthBlendShader()
+ID3D11ComputeShader* TerrainBlending::GetBlendPrepassShader()
 {
-	if (!depthBlendShader) {
-		logger::debug("Compiling DepthBlend.hlsl");
-		depthBlendShader = (ID3D11ComputeShader*)Util::CompileShader(L"Data\\Shaders\\TerrainBlending\\DepthBlend.hlsl", {}, "cs_5_0");
+	if (!blendPrepassShader) {
+		logger::debug("Compiling BlendPrepass.hlsl");
+		blendPrepassShader = (ID3D11ComputeShader*)Util::CompileShader(L"Data\\Shaders\\TerrainBlending\\BlendPrepass.hlsl", {}, "cs_5_0");
 	}
-	return depthBlendShader;
-}
-
-ID3D11ComputeShader* TerrainBlending::GetDepthFixShader()
-{
-	if (!depthFixShader) {
-		logger::debug("Compiling DepthFix.hlsl");
-		depthFixShader = (ID3D11ComputeShader*)Util::CompileShader(L"Data\\Shaders\\TerrainBlending\\DepthFix.hlsl", {}, "cs_5_0");
-	}
-	return depthFixShader;
+	return blendPrepassShader;
 }
 
 void TerrainBlending::SetupResources()
@@ -239,34 +230,25 @@ void TerrainBlending::BlendPrepassDepths()
 
 	auto dispatchCount = Util::GetScreenDispatchCount();
 
-	{
-		ID3D11ShaderResourceView* views[2] = { depthSRVBackup, terrainDepth.depthSRV };
-		context->CSSetShaderResources(0, ARRAYSIZE(views), views);
-
-		ID3D11UnorderedAccessView* uavs[2] = { blendedDepthTexture->uav.get(), blendedDepthTexture16->uav.get() };
-		context->CSSetUnorderedAccessViews(0, ARRAYSIZE(uavs), uavs, nullptr);
-
-		context->CSSetShader(GetDepthBlendShader(), nullptr, 0);
-
-		context->Dispatch(dispatchCount.x, dispatchCount.y, 1);
-	}
-
-	{
-		ID3D11ShaderResourceView* views[2] = { depthSRVBackup, terrainDepthTexture->srv.get() };
-		context->CSSetShaderResources(0, ARRAYSIZE(views), views);
+	// Blends the depths and finds what was drawn after terrain in one pass, tiles without terrain skip the second part
+	ID3D11ShaderResourceView* views[3] = { depthSRVBackup, terrainDepth.depthSRV, terrainDepthTexture->srv.get() };
+	context->CSSetShaderResources(0, ARRAYSIZE(views), views);
 
-		ID3D11UnorderedAccessView* uavs[2] = { terrainOffsetTexture->uav.get(), nullptr };
-		context->CSSetUnorderedAccessViews(0, ARRAYSIZE(uavs), uavs, nullptr);
+	ID3D11UnorderedAccessView* uavs[3] = { blendedDepthTexture->uav.get(), blendedDepthTexture16->uav.get(), terrainOffsetTexture->uav.get() };
+	context->CSSetUnorderedAccessViews(0, ARRAYSIZE(uavs), uavs, nullptr);
 
-		context->CSSetShader(GetDepthFixShader(), nullptr, 0);
+	context->CSSetShader(GetBlendPrepassShader(), nullptr, 0);
 
-		context->Dispatch(dispatchCount.x, dispatchCount.y, 1);
-	}
+	context->Dispatch(dispatchCount.x, dispatchCount.y, 1);
 
-	ID3D11ShaderResourceView* views[2] = { nullptr, nullptr };
+	views[0] = nullptr;
+	views[1] = nullptr;
+	views[2] = nullptr;
 	context->CSSetShaderResources(0, ARRAYSIZE(views), views);
 
-	ID3D11UnorderedAccessView* uavs[2] = { nullptr, nullptr };
+	uavs[0] = nullptr;
+	uavs[1] = nullptr;
+	uavs[2] = nullptr;
 	context->CSSetUnorderedAccessViews(0, ARRAYSIZE(uavs), uavs, nullptr);
 
 	ID3D11ComputeShader* shader = nullptr;
@@ -295,12 +277,8 @@ void TerrainBlending::ClearShaderCache()
 		terrainOffsetVertexShader->Release();
 		terrainOffsetVertexShader = nullptr;
 	}
-	if (depthBlendShader) {
-		depthBlendShader->Release();
-		depthBlendShader = nullptr;
-	}
-	if (depthFixShader) {
-		depthFixShader->Release();
-		depthFixShader = nullptr;
+	if (blendPrepassShader) {
+		blendPrepassShader->Release();
+		blendPrepassShader = nullptr;
 	}
 }
@@ -26,8 +26,7 @@ public:
 	ID3D11VertexShader* terrainVertexShader = nullptr;
 	ID3D11VertexShader* terrainOffsetVertexShader = nullptr;
 
-	ID3D11ComputeShader* GetDepthBlendShader();
-	ID3D11ComputeShader* GetDepthFixShader();
+	ID3D11ComputeShader* GetBlendPrepassShader();
 
 	virtual void PostPostLoad() override;
 
@@ -61,8 +60,7 @@ public:
 	ID3D11ShaderResourceView* depthSRVBackup = nullptr;
 	ID3D11ShaderResourceView* prepassSRVBackup = nullptr;
 
-	ID3D11ComputeShader* depthBlendShader = nullptr;
-	ID3D11ComputeShader* depthFixShader = nullptr;
+	ID3D11ComputeShader* blendPrepassShader = nullptr;
 
 	virtual void ClearShaderCache() override;
 
@@ -0,0 +1,41 @@
+#include "Features/TerrainBlending/BlendPrepass.h"
+
+namespace TerrainBlendPrepass
+{
+	Result Run(uint a_width, uint a_height, const Depths& a_depths, bool a_earlyOut)
+	{
+		Result result;
+		result.tilesX = (a_width + TileSize - 1) / TileSize;
+		result.tilesY = (a_height + TileSize - 1) / TileSize;
+		result.tileHasTerrain.resize(result.tilesX * result.tilesY);
+		result.blendedDepth.resize(a_width * a_height);
+		result.terrainOffset.resize(a_width * a_height);
+
+		// threads past the screen edge load 0 and count as terrain, they only keep a tile from skipping
+		for (uint y = 0; y < result.tilesY * TileSize; y++) {
+			for (uint x = 0; x < result.tilesX * TileSize; x++) {
+				bool inside = x < a_width && y < a_height;
+				if (!inside || a_depths.terrain[y * a_width + x] < 1.0f)
+					result.tileHasTerrain[(y / TileSize) * result.tilesX + x / TileSize] = true;
+			}
+		}
+
+		for (uint y = 0; y < a_height; y++) {
+			for (uint x = 0; x < a_width; x++) {
+				uint pixel = y * a_width + x;
+				float mainDepth = a_depths.main[pixel];
+
+				result.blendedDepth[pixel] = std::min(mainDepth, a_depths.terrain[pixel]);
+
+				float fixedDepth = mainDepth;
+				if (!a_earlyOut || result.tileHasTerrain[(y / TileSize) * result.tilesX + x / TileSize]) {
+					if (mainDepth < a_depths.mainAfterTerrain[pixel])
+						fixedDepth = 1.0f;
+				}
+				result.terrainOffset[pixel] = fixedDepth;
+			}
+		}
+
+		return result;
+	}
+}
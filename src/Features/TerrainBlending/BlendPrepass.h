@@ -0,0 +1,29 @@
+#pragma once
+
+// CPU reference of BlendPrepass.hlsl, to check that its tile early-out leaves every pixel terrain reads unchanged
+namespace TerrainBlendPrepass
+{
+	static constexpr uint TileSize = 8;
+
+	struct Depths
+	{
+		std::span<const float> main;
+		std::span<const float> terrain;  // cleared to 1 every frame
+		std::span<const float> mainAfterTerrain;
+	};
+
+	struct Result
+	{
+		uint tilesX = 0;
+		uint tilesY = 0;
+		std::vector<bool> tileHasTerrain;
+		std::vector<float> blendedDepth;
+		std::vector<float> terrainOffset;
+	};
+
+	/**
+	 * @param a_depths Per pixel, row by row
+	 * @param a_earlyOut False gives the separate DepthBlend and DepthFix passes BlendPrepass replaced
+	 */
+	Result Run(uint a_width, uint a_height, const Depths& a_depths, bool a_earlyOut);
+}
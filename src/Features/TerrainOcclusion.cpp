@@ -2,10 +2,12 @@
 #include "Menu.h"
 
 #include "Deferred.h"
+#include "Features/TerrainOcclusion/PrecomputeTiles.h"
 #include "State.h"
 #include "Util.h"
 
 #include <filesystem>
+#include <fstream>
 
 #include <DirectXTex.h>
 #include <pystring/pystring.h>
@@ -76,6 +78,30 @@ void TerrainOcclusion::DrawSettings()
 	// 	}
 	// }
 
+	if (ImGui::CollapsingHeader("Cache")) {
+		ImGui::Text(fmt::format("Cached worldspaces: {}", occlusionCache.GetWorldspaceCount()).c_str());
+		ImGui::Text(fmt::format("Sun directions seen: {}", occlusionCache.GetVisitedSunBuckets().size()).c_str());
+
+		if (IsBaking()) {
+			ImGui::Text(fmt::format("Baking {} ({} left)", bakeQueue.front(), bakeQueue.size()).c_str());
+			if (ImGui::Button("Cancel Bake", { -1, 0 }))
+				bakeQueue.clear();
+		} else {
+			if (ImGui::Button("Bake All Height Maps", { -1, 0 }))
+				StartBake();
+			if (auto _tt = Util::HoverTooltipWrapper())
+				ImGui::Text(
+					"Precomputes occlusion of every height map, and terrain shadows for every sun direction seen so far, so they only need to be loaded in game.\n"
+					"Terrain shadows and AO of the current worldspace are unavailable while baking.");
+
+			// an in-flight write would recreate files right after they are removed
+			ImGui::BeginDisabled(IsCacheWritePending());
+			if (ImGui::Button("Clear Cache", { -1, 0 }))
+				occlusionCache.Clear();
+			ImGui::EndDisabled();
+		}
+	}
+
 	if (ImGui::CollapsingHeader("Debug")) {
 		std::string curr_worldspace = "N/A";
 		std::string curr_worldspace_name = "N/A";
@@ -89,6 +115,8 @@ void TerrainOcclusion::DrawSettings()
 		}
 		ImGui::Text(fmt::format("Current worldspace: {} ({})", curr_worldspace, curr_worldspace_name).c_str());
 		ImGui::Text(fmt::format("Has height map: {}", heightmaps.contains(curr_worldspace)).c_str());
+		ImGui::Text(fmt::format("Loading height map: {}", pendingHeightmap.valid()).c_str());
+		ImGui::Text(fmt::format("Pending precompute tiles: {}", pendingTiles.size()).c_str());
 
 		ImGui::Separator();
 
@@ -177,6 +205,9 @@ void TerrainOcclusion::SetupResources()
 		}
 	}
 
+	logger::debug("Loading occlusion cache index...");
+	occlusionCache.Load();
+
 	logger::debug("Creating structured buffers...");
 	{
 		D3D11_BUFFER_DESC sbDesc{};
@@ -229,7 +260,8 @@ bool TerrainOcclusion::IsHeightMapReady()
 
 TerrainOcclusion::PerFrame TerrainOcclusion::GetCommonBufferData()
 {
-	bool isHeightmapReady = IsHeightMapReady();
+	// the occlusion and normalised height are filled tile by tile, keep the effects off until every tile is done
+	bool isHeightmapReady = IsHeightMapReady() && IsPrecomputeDone();
 
 	PerFrame data = {
 		.EnableTerrainShadow = settings.EnableTerrainShadow && isHeightmapReady,
@@ -252,78 +284,210 @@ TerrainOcclusion::PerFrame TerrainOcclusion::GetCommonBufferData()
 	return data;
 }
 
-void TerrainOcclusion::LoadHeightmap()
+static std::unique_ptr<Texture2D> CreateHeightmapTexture(const DirectX::ScratchImage& a_image, bool a_unorderedAccess)
 {
-	auto tes = RE::TES::GetSingleton();
-	if (!tes)
-		return;
-	auto worldspace = tes->GetRuntimeData2().worldSpace;
-	if (!worldspace)
-		return;
-	std::string worldspace_name = worldspace->GetFormEditorID();
-	if (!heightmaps.contains(worldspace_name))  // no height map for that, but we don't remove cache
-		return;
-	if (cachedHeightmap && cachedHeightmap->worldspace == worldspace_name)  // already cached
-		return;
+	auto device = reinterpret_cast<ID3D11Device*>(RE::BSGraphics::Renderer::GetSingleton()->GetRuntimeData().forwarder);
+
+	ID3D11Resource* pResource = nullptr;
+	DX::ThrowIfFailed(DirectX::CreateTextureEx(device,
+		a_image.GetImages(), a_image.GetImageCount(), a_image.GetMetadata(),
+		D3D11_USAGE_DEFAULT,
+		D3D11_BIND_SHADER_RESOURCE | (a_unorderedAccess ? D3D11_BIND_UNORDERED_ACCESS : 0),
+		0, 0, DirectX::CREATETEX_DEFAULT, &pResource));
+
+	auto texture = std::make_unique<Texture2D>(reinterpret_cast<ID3D11Texture2D*>(pResource));
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {
+		.Format = texture->desc.Format,
+		.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D,
+		.Texture2D = {
+			.MostDetailedMip = 0,
+			.MipLevels = 1 }
+	};
+	texture->CreateSRV(srvDesc);
 
-	auto& device = State::GetSingleton()->device;
+	if (a_unorderedAccess) {
+		D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {
+			.Format = texture->desc.Format,
+			.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D,
+			.Texture2D = { .MipSlice = 0 }
+		};
+		texture->CreateUAV(uavDesc);
+	}
 
-	logger::debug("Loading height map...");
-	{
-		auto& target_heightmap = heightmaps[worldspace_name];
+	return texture;
+}
+
+// Runs on a std::async worker and reads and decodes the whole height map at once, it is a single DDS image with no
+// tiled layout to stream from. Only the precompute is spread over frames, see SchedulePrecomputeTiles.
+TerrainOcclusion::HeightMapLoad TerrainOcclusion::LoadHeightmapAsync(HeightMapMetadata* a_heightmap, Settings a_settings)
+{
+	HeightMapLoad result{ .heightmap = a_heightmap };
+
+	try {
+		std::filesystem::path path{ a_heightmap->dir };
+		path /= a_heightmap->filename;
+
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) {
+			logger::error("Failed to open {}", a_heightmap->filename);
+			return result;
+		}
+		std::vector<char> bytes(file.tellg());
+		file.seekg(0);
+		file.read(bytes.data(), bytes.size());
+
+		result.cacheKey = OcclusionCache::MakeKey({ bytes.data(), bytes.size() },
+			{ .aoDistance = a_settings.AoDistance, .sliceCount = a_settings.SliceCount, .sampleCount = a_settings.SampleCount },
+			a_settings.ShadowSofteningRadiusAngle);
+		if (occlusionCache.Validate(a_heightmap->worldspace, result.cacheKey))
+			occlusionCache.Save();
 
 		DirectX::ScratchImage image;
-		try {
-			std::filesystem::path path{ target_heightmap.dir };
-			path /= target_heightmap.filename;
+		DX::ThrowIfFailed(DirectX::LoadFromDDSMemory(bytes.data(), bytes.size(), DirectX::DDS_FLAGS_NONE, nullptr, image));
+		result.texHeightMap = CreateHeightmapTexture(image, false);
+
+		if (occlusionCache.HasOcclusion(a_heightmap->worldspace, result.cacheKey)) {
+			auto occlusionPath = occlusionCache.GetOcclusionPath(a_heightmap->worldspace, result.cacheKey, "AO");
+			auto heightPath = occlusionCache.GetOcclusionPath(a_heightmap->worldspace, result.cacheKey, "NormalisedHeight");
+			DirectX::ScratchImage occlusionImage, heightImage;
+			if (SUCCEEDED(DirectX::LoadFromDDSFile(occlusionPath.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, occlusionImage)) &&
+				SUCCEEDED(DirectX::LoadFromDDSFile(heightPath.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, heightImage)) &&
+				occlusionImage.GetMetadata().width == image.GetMetadata().width &&
+				occlusionImage.GetMetadata().height == image.GetMetadata().height &&
+				heightImage.GetMetadata().width == image.GetMetadata().width &&
+				heightImage.GetMetadata().height == image.GetMetadata().height) {
+				result.texOcclusion = CreateHeightmapTexture(occlusionImage, true);
+				result.texNormalisedHeight = CreateHeightmapTexture(heightImage, true);
+			} else {
+				logger::warn("Ignoring unreadable occlusion cache for {}", a_heightmap->worldspace);
+			}
+		}
+	} catch (const DX::com_exception& e) {
+		logger::error("{}", e.what());
+		result.texHeightMap = nullptr;
+		result.texOcclusion = nullptr;
+		result.texNormalisedHeight = nullptr;
+	}
 
-			DX::ThrowIfFailed(LoadFromDDSFile(path.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, image));
-		} catch (const DX::com_exception& e) {
-			logger::error("{}", e.what());
+	return result;
+}
+
+void TerrainOcclusion::LoadHeightmap()
+{
+	if (pendingHeightmap.valid()) {
+		if (pendingHeightmap.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
 			return;
-		}
+		ApplyHeightmap(pendingHeightmap.get());
+	}
 
-		ID3D11Resource* pResource = nullptr;
-		try {
-			DX::ThrowIfFailed(CreateTexture(device,
-				image.GetImages(), image.GetImageCount(),
-				image.GetMetadata(), &pResource));
-		} catch (const DX::com_exception& e) {
-			logger::error("{}", e.what());
+	std::string worldspace_name;
+	if (IsBaking()) {
+		worldspace_name = bakeQueue.front();
+		if (pendingWorldspace == worldspace_name) {  // failed to load, skip it
+			bakeQueue.pop_front();
 			return;
 		}
+	} else {
+		auto tes = RE::TES::GetSingleton();
+		if (!tes)
+			return;
+		auto worldspace = tes->GetRuntimeData2().worldSpace;
+		if (!worldspace)
+			return;
+		worldspace_name = worldspace->GetFormEditorID();
+		if (pendingWorldspace == worldspace_name)  // failed to load before
+			return;
+	}
+	if (!heightmaps.contains(worldspace_name))  // no height map for that, but we don't remove cache
+		return;
+	if (cachedHeightmap && cachedHeightmap->worldspace == worldspace_name)  // already cached
+		return;
 
-		texHeightMap.release();
-		texHeightMap = std::make_unique<Texture2D>(reinterpret_cast<ID3D11Texture2D*>(pResource));
+	logger::debug("Loading height map...");
+	pendingWorldspace = worldspace_name;
+	pendingHeightmap = std::async(std::launch::async, &TerrainOcclusion::LoadHeightmapAsync, this, &heightmaps[worldspace_name], settings);
+}
 
-		D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {
-			.Format = texHeightMap->desc.Format,
-			.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D,
-			.Texture2D = {
-				.MostDetailedMip = 0,
-				.MipLevels = 1 }
-		};
-		texHeightMap->CreateSRV(srvDesc);
+void TerrainOcclusion::ApplyHeightmap(HeightMapLoad&& a_load)
+{
+	if (!a_load.texHeightMap)
+		return;
 
-		cachedHeightmap = &heightmaps[worldspace_name];
-	}
+	// the worldspace may have changed again while this was loading, the next LoadHeightmap call picks that up
+	texHeightMap = std::move(a_load.texHeightMap);
+	cachedHeightmap = a_load.heightmap;
+	cacheKey = a_load.cacheKey;
+	pendingWorldspace.clear();
+
+	D3D11_TEXTURE2D_DESC texDesc = {
+		.Width = texHeightMap->desc.Width,
+		.Height = texHeightMap->desc.Height,
+		.MipLevels = 1,
+		.ArraySize = 1,
+		.Format = DXGI_FORMAT_R16G16_FLOAT,
+		.SampleDesc = { .Count = 1 },
+		.Usage = D3D11_USAGE_DEFAULT,
+		.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS
+	};
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {
+		.Format = texDesc.Format,
+		.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D,
+		.Texture2D = {
+			.MostDetailedMip = 0,
+			.MipLevels = 1 }
+	};
+	D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {
+		.Format = texDesc.Format,
+		.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D,
+		.Texture2D = { .MipSlice = 0 }
+	};
+	texShadowHeight = std::make_unique<Texture2D>(texDesc);
+	texShadowHeight->CreateSRV(srvDesc);
+	texShadowHeight->CreateUAV(uavDesc);
 
+	pendingShadowLoad = {};  // belongs to the previous height map
 	shadowUpdateIdx = 0;
-	needPrecompute = true;
+	shadowBucket = UINT_MAX;
+	shadowComplete = false;
+	shadowCacheable = false;
+
+	if (a_load.texOcclusion && a_load.texNormalisedHeight) {
+		logger::info("Loaded cached occlusion for {}", cachedHeightmap->worldspace);
+		texOcclusion = std::move(a_load.texOcclusion);
+		texNormalisedHeight = std::move(a_load.texNormalisedHeight);
+		pendingTiles.clear();
+		needPrecompute = false;
+	} else {
+		texOcclusion = nullptr;
+		texNormalisedHeight = nullptr;
+		needPrecompute = true;
+	}
+}
+
+void TerrainOcclusion::SchedulePrecomputeTiles()
+{
+	// tile under the player, so the terrain in view is done first
+	float2 playerUV = { .5f, .5f };
+	if (auto player = RE::PlayerCharacter::GetSingleton()) {
+		auto position = player->GetPosition();
+		playerUV = {
+			(position.x - cachedHeightmap->pos0.x) / (cachedHeightmap->pos1.x - cachedHeightmap->pos0.x),
+			(position.y - cachedHeightmap->pos0.y) / (cachedHeightmap->pos1.y - cachedHeightmap->pos0.y)
+		};
+	}
+	pendingTiles = PrecomputeTiles::Order(texHeightMap->desc.Width, texHeightMap->desc.Height, PrecomputeTileSize, playerUV);
 }
 
 void TerrainOcclusion::Precompute()
 {
-	if (!cachedHeightmap)
+	if (!cachedHeightmap || !texHeightMap)
 		return;
 
 	auto& context = State::GetSingleton()->context;
 
-	logger::info("Creating occlusion texture...");
-	{
-		texOcclusion.release();
-		texNormalisedHeight.release();
-		texShadowHeight.release();
+	if (!texOcclusion) {
+		logger::info("Creating occlusion texture...");
 
 		D3D11_TEXTURE2D_DESC texDesc = {
 			.Width = texHeightMap->desc.Width,
@@ -357,27 +521,10 @@ void TerrainOcclusion::Precompute()
 		texNormalisedHeight->CreateSRV(srvDesc);
 		texNormalisedHeight->CreateUAV(uavDesc);
 
-		texDesc.Format = srvDesc.Format = uavDesc.Format = DXGI_FORMAT_R16G16_FLOAT;
-		texShadowHeight = std::make_unique<Texture2D>(texDesc);
-		texShadowHeight->CreateSRV(srvDesc);
-		texShadowHeight->CreateUAV(uavDesc);
-	}
-
-	{
-		AOGenBuffer data = {
-			.AoDistance = settings.AoDistance * 4096.f,
-			.SliceCount = settings.SliceCount,
-			.SampleCount = settings.SampleCount,
-			.pos0 = cachedHeightmap->pos0,
-			.pos1 = cachedHeightmap->pos1,
-			.zRange = cachedHeightmap->zRange
-		};
-
-		D3D11_MAPPED_SUBRESOURCE mapped;
-		DX::ThrowIfFailed(context->Map(aoGenBuffer->resource.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
-		size_t bytes = sizeof(AOGenBuffer);
-		memcpy_s(mapped.pData, bytes, &data, bytes);
-		context->Unmap(aoGenBuffer->resource.get(), 0);
+		SchedulePrecomputeTiles();
+	} else if (pendingTiles.empty()) {
+		// forced regeneration
+		SchedulePrecomputeTiles();
 	}
 
 	/* ---- BACKUP ---- */
@@ -396,7 +543,6 @@ void TerrainOcclusion::Precompute()
 	context->CSGetSamplers(0, ARRAYSIZE(old.samplers), old.samplers);
 
 	/* ---- DISPATCH ---- */
-	logger::info("Precomputation...");
 	newer.srvs[0] = aoGenBuffer->srv.get();
 	newer.srvs[1] = texHeightMap->srv.get();
 	newer.uavs[0] = texOcclusion->uav.get();
@@ -406,7 +552,31 @@ void TerrainOcclusion::Precompute()
 	context->CSSetShaderResources(0, ARRAYSIZE(newer.srvs), newer.srvs);
 	context->CSSetUnorderedAccessViews(0, ARRAYSIZE(newer.uavs), newer.uavs, nullptr);
 	context->CSSetShader(occlusionProgram.get(), nullptr, 0);
-	context->Dispatch(((texOcclusion->desc.Width - 1) >> 5) + 1, ((texOcclusion->desc.Height - 1) >> 5) + 1, 1);
+
+	// spread over frames, a whole height map at full quality stalls the GPU for seconds
+	uint tileCount = IsBaking() ? PrecomputeBakeTilesPerFrame : PrecomputeTilesPerFrame;
+	for (uint i = 0; i < tileCount && !pendingTiles.empty(); ++i) {
+		auto [tileX, tileY] = pendingTiles.back();
+		pendingTiles.pop_back();
+
+		AOGenBuffer data = {
+			.AoDistance = settings.AoDistance * 4096.f,
+			.SliceCount = settings.SliceCount,
+			.SampleCount = settings.SampleCount,
+			.pos0 = cachedHeightmap->pos0,
+			.pos1 = cachedHeightmap->pos1,
+			.zRange = cachedHeightmap->zRange,
+			.tileOffset = { tileX * PrecomputeTileSize, tileY * PrecomputeTileSize }
+		};
+
+		D3D11_MAPPED_SUBRESOURCE mapped;
+		DX::ThrowIfFailed(context->Map(aoGenBuffer->resource.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+		size_t bytes = sizeof(AOGenBuffer);
+		memcpy_s(mapped.pData, bytes, &data, bytes);
+		context->Unmap(aoGenBuffer->resource.get(), 0);
+
+		context->Dispatch(PrecomputeTileSize >> 5, PrecomputeTileSize >> 5, 1);
+	}
 
 	/* ---- RESTORE ---- */
 	context->CSSetShaderResources(0, ARRAYSIZE(old.srvs), old.srvs);
@@ -414,76 +584,268 @@ void TerrainOcclusion::Precompute()
 	context->CSSetUnorderedAccessViews(0, ARRAYSIZE(old.uavs), old.uavs, nullptr);
 	context->CSSetSamplers(0, ARRAYSIZE(old.samplers), old.samplers);
 
-	needPrecompute = false;
+	if (pendingTiles.empty()) {
+		logger::info("Precomputed occlusion for {}", cachedHeightmap->worldspace);
+		needPrecompute = false;
+		WriteOcclusionCache();
+	}
 }
 
-void TerrainOcclusion::UpdateShadow()
+void TerrainOcclusion::WriteCacheTextures(std::vector<std::pair<Texture2D*, std::filesystem::path>> a_textures, std::function<void()> a_onWritten)
+{
+	auto& context = State::GetSingleton()->context;
+
+	// dropped results are recomputed the next time they are needed
+	if (queuedCacheWrites.size() >= MaxQueuedCacheWrites) {
+		logger::warn("Skipping cache write of {}, too many writes queued", a_textures.front().second.string());
+		return;
+	}
+
+	CacheWrite write{ .onWritten = std::move(a_onWritten) };
+	for (auto& [texture, path] : a_textures) {
+		D3D11_TEXTURE2D_DESC desc = texture->desc;
+		desc.Usage = D3D11_USAGE_STAGING;
+		desc.BindFlags = 0;
+		desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+		desc.MiscFlags = 0;
+		try {
+			write.staging.emplace_back(std::make_unique<Texture2D>(desc), path);
+		} catch (const DX::com_exception& e) {
+			logger::warn("Failed to create readback texture for {}: {}", path.string(), e.what());
+			return;
+		}
+		context->CopyResource(write.staging.back().first->resource.get(), texture->resource.get());
+	}
+
+	queuedCacheWrites.push_back(std::move(write));
+}
+
+void TerrainOcclusion::FlushCacheWrites()
 {
-	if (!IsHeightMapReady())
+	for (auto& write : queuedCacheWrites)
+		write.frames++;
+
+	// assigning over a running std::async future would block on its destructor
+	if (pendingCacheWrite.valid()) {
+		if (pendingCacheWrite.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return;
+		pendingCacheWrite.get();
+	}
+	if (queuedCacheWrites.empty() || queuedCacheWrites.front().frames < CacheReadbackDelayFrames)
 		return;
 
+	auto& context = State::GetSingleton()->context;
+	auto& write = queuedCacheWrites.front();
+	while (write.images.size() < write.staging.size()) {
+		auto& texture = write.staging[write.images.size()].first;
+		auto& desc = texture->desc;
+
+		// the copy should have finished by now, if not try again next frame rather than stall
+		D3D11_MAPPED_SUBRESOURCE mapped;
+		HRESULT hr = context->Map(texture->resource.get(), 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+		if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+			return;
+
+		auto image = std::make_shared<DirectX::ScratchImage>();
+		if (FAILED(hr) || FAILED(image->Initialize2D(desc.Format, desc.Width, desc.Height, 1, 1))) {
+			if (SUCCEEDED(hr))
+				context->Unmap(texture->resource.get(), 0);
+			logger::warn("Failed to read back {}", write.staging[write.images.size()].second.string());
+			queuedCacheWrites.pop_front();
+			return;
+		}
+
+		auto dst = image->GetImages();
+		auto rowSize = std::min(dst->rowPitch, (size_t)mapped.RowPitch);
+		for (size_t row = 0; row < dst->height; row++)
+			std::memcpy(dst->pixels + row * dst->rowPitch, static_cast<const uint8_t*>(mapped.pData) + row * mapped.RowPitch, rowSize);
+		context->Unmap(texture->resource.get(), 0);
+
+		write.images.push_back(std::move(image));
+	}
+
+	std::vector<std::pair<std::shared_ptr<DirectX::ScratchImage>, std::filesystem::path>> images;
+	for (size_t i = 0; i < write.images.size(); i++)
+		images.emplace_back(std::move(write.images[i]), std::move(write.staging[i].second));
+	auto onWritten = std::move(write.onWritten);
+	queuedCacheWrites.pop_front();
+
+	pendingCacheWrite = std::async(std::launch::async, [images = std::move(images), onWritten = std::move(onWritten)]() {
+		std::error_code ec;
+		for (auto& [image, path] : images) {
+			std::filesystem::create_directories(path.parent_path(), ec);
+			if (FAILED(DirectX::SaveToDDSFile(image->GetImages(), image->GetImageCount(), image->GetMetadata(), DirectX::DDS_FLAGS_NONE, path.c_str()))) {
+				logger::warn("Failed to write {}", path.string());
+				for (auto& [_, writtenPath] : images)
+					std::filesystem::remove(writtenPath, ec);
+				return;
+			}
+		}
+		onWritten();
+	});
+}
+
+void TerrainOcclusion::WriteOcclusionCache()
+{
+	auto worldspace = cachedHeightmap->worldspace;
+	auto key = cacheKey;
+	WriteCacheTextures(
+		{ { texOcclusion.get(), occlusionCache.GetOcclusionPath(worldspace, key, "AO") },
+			{ texNormalisedHeight.get(), occlusionCache.GetOcclusionPath(worldspace, key, "NormalisedHeight") } },
+		[this, worldspace, key]() {
+			occlusionCache.AddOcclusion(worldspace, key);
+			occlusionCache.Save();
+		});
+}
+
+void TerrainOcclusion::WriteShadowCache()
+{
+	auto worldspace = cachedHeightmap->worldspace;
+	auto key = cacheKey;
+	auto bucket = shadowBucket;
+	WriteCacheTextures(
+		{ { texShadowHeight.get(), occlusionCache.GetShadowPath(worldspace, key, bucket) } },
+		[this, worldspace, key, bucket]() {
+			occlusionCache.AddShadow(worldspace, key, bucket);
+			occlusionCache.Save();
+		});
+}
+
+bool TerrainOcclusion::BeginShadowSweep()
+{
 	// don't forget to change NTHREADS in shader!
 	constexpr uint updateLength = 128u;
 	constexpr uint logUpdateLength = std::bit_width(128u) - 1;  // integer log2, https://stackoverflow.com/questions/994593/how-to-do-an-integer-log2-in-c
 
-	auto& context = State::GetSingleton()->context;
-	auto accumulator = RE::BSGraphics::BSShaderAccumulator::GetCurrentAccumulator();
-	auto sunLight = skyrim_cast<RE::NiDirectionalLight*>(accumulator->GetRuntimeData().activeShadowSceneNode->GetRuntimeData().sunLight->light.get());
-	if (!sunLight)
-		return;
+	auto& worldspace = cachedHeightmap->worldspace;
+
+	if (pendingShadowLoad.valid()) {
+		if (pendingShadowLoad.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return false;
+		if (auto texture = pendingShadowLoad.get()) {
+			texShadowHeight = std::move(texture);
+			shadowBucket = pendingShadowBucket;
+			shadowComplete = true;
+		} else {
+			occlusionCache.RemoveShadow(worldspace, pendingShadowBucket);
+			occlusionCache.Save();
+		}
+	}
+
+	auto shadowSettingsHash = OcclusionCache::GetShadowSettingsHash(settings.ShadowSofteningRadiusAngle);
+	if (shadowSettingsHash != cacheKey.shadowSettingsHash) {
+		cacheKey.shadowSettingsHash = shadowSettingsHash;
+		if (occlusionCache.Validate(worldspace, cacheKey))
+			occlusionCache.Save();
+		shadowComplete = false;
+	}
+
+	uint bucket;
+	if (IsBaking()) {
+		// one sweep in flight to disk at a time, the next bucket is only known once it is written
+		if (IsCacheWritePending())
+			return false;
+		auto it = std::find_if(bakeSunBuckets.begin(), bakeSunBuckets.end(), [&](uint b) { return !occlusionCache.HasShadow(worldspace, cacheKey, b); });
+		if (it == bakeSunBuckets.end())
+			return false;
+		bucket = *it;
+	} else {
+		auto accumulator = RE::BSGraphics::BSShaderAccumulator::GetCurrentAccumulator();
+		auto sunLight = skyrim_cast<RE::NiDirectionalLight*>(accumulator->GetRuntimeData().activeShadowSceneNode->GetRuntimeData().sunLight->light.get());
+		if (!sunLight)
+			return false;
+		auto direction = sunLight->GetWorldDirection();
+		bucket = OcclusionCache::GetSunBucket({ direction.x, direction.y, direction.z });
+	}
+
+	// the height map is static, a finished sweep only goes stale when the sun changes bucket
+	if (bucket == shadowBucket && shadowComplete)
+		return false;
+
+	if (!IsBaking() && occlusionCache.HasShadow(worldspace, cacheKey, bucket)) {
+		auto path = occlusionCache.GetShadowPath(worldspace, cacheKey, bucket);
+		auto width = texShadowHeight->desc.Width;
+		auto height = texShadowHeight->desc.Height;
+		pendingShadowBucket = bucket;
+		pendingShadowLoad = std::async(std::launch::async, [path, width, height]() -> std::unique_ptr<Texture2D> {
+			DirectX::ScratchImage image;
+			if (FAILED(DirectX::LoadFromDDSFile(path.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, image)) ||
+				image.GetMetadata().width != width || image.GetMetadata().height != height) {
+				logger::warn("Ignoring unreadable shadow cache {}", path.string());
+				return nullptr;
+			}
+			try {
+				return CreateHeightmapTexture(image, true);
+			} catch (const DX::com_exception& e) {
+				logger::error("{}", e.what());
+				return nullptr;
+			}
+		});
+		return false;
+	}
+
+	shadowBucket = bucket;
+	shadowComplete = false;
+	// only a bake writes shadows to disk, in game the bucket is remembered for the next bake
+	shadowCacheable = IsBaking() && IsPrecomputeDone();
 
 	/* ---- UPDATE CB ---- */
 	uint width = texNormalisedHeight->desc.Width;
 	uint height = texNormalisedHeight->desc.Height;
 
-	// only update direction at the start of each cycle
-	static uint edgePxCoord;
-	static int signDir;
-	static uint maxUpdates;
-	if (shadowUpdateIdx == 0) {
-		auto direction = sunLight->GetWorldDirection();
-		float3 dirLightDir = { direction.x, direction.y, direction.z };
-		if (dirLightDir.z > 0)
-			dirLightDir = -dirLightDir;
-
-		// in UV
-		float3 invScale = cachedHeightmap->pos1 - cachedHeightmap->pos0;
-		invScale.z = cachedHeightmap->zRange.y - cachedHeightmap->zRange.x;
-		float3 dirLightPxDir = dirLightDir / invScale;
-		dirLightPxDir.x *= width;
-		dirLightPxDir.y *= height;
-
-		float stepMult;
-		if (abs(dirLightPxDir.x) >= abs(dirLightPxDir.y)) {
-			stepMult = 1.f / abs(dirLightPxDir.x);
-			edgePxCoord = dirLightPxDir.x > 0 ? 0 : (width - 1);
-			signDir = dirLightPxDir.x > 0 ? 1 : -1;
-			maxUpdates = (width + updateLength - 1) >> logUpdateLength;
-		} else {
-			stepMult = 1.f / abs(dirLightPxDir.y);
-			edgePxCoord = dirLightPxDir.y > 0 ? 0 : height - 1;
-			signDir = dirLightPxDir.y > 0 ? 1 : -1;
-			maxUpdates = (height + updateLength - 1) >> logUpdateLength;
-		}
-		dirLightPxDir *= stepMult;
+	float3 dirLightDir = OcclusionCache::GetSunBucketDirection(bucket);
+
+	// in UV
+	float3 invScale = cachedHeightmap->pos1 - cachedHeightmap->pos0;
+	invScale.z = cachedHeightmap->zRange.y - cachedHeightmap->zRange.x;
+	float3 dirLightPxDir = dirLightDir / invScale;
+	dirLightPxDir.x *= width;
+	dirLightPxDir.y *= height;
+
+	float stepMult;
+	if (abs(dirLightPxDir.x) >= abs(dirLightPxDir.y)) {
+		stepMult = 1.f / abs(dirLightPxDir.x);
+		shadowEdgePxCoord = dirLightPxDir.x > 0 ? 0 : (width - 1);
+		shadowSignDir = dirLightPxDir.x > 0 ? 1 : -1;
+		shadowMaxUpdates = (width + updateLength - 1) >> logUpdateLength;
+	} else {
+		stepMult = 1.f / abs(dirLightPxDir.y);
+		shadowEdgePxCoord = dirLightPxDir.y > 0 ? 0 : height - 1;
+		shadowSignDir = dirLightPxDir.y > 0 ? 1 : -1;
+		shadowMaxUpdates = (height + updateLength - 1) >> logUpdateLength;
+	}
+	dirLightPxDir *= stepMult;
 
-		shadowUpdateCBData.LightPxDir = { dirLightPxDir.x, dirLightPxDir.y };
+	shadowUpdateCBData.LightPxDir = { dirLightPxDir.x, dirLightPxDir.y };
 
-		// soft shadow angles
-		float lenUV = float2{ dirLightDir.x, dirLightDir.y }.Length();
-		float dirLightAngle = atan2(-dirLightDir.z, lenUV);
-		float upperAngle = std::max(0.f, dirLightAngle - settings.ShadowSofteningRadiusAngle);
-		float lowerAngle = std::min(RE::NI_HALF_PI - 1e-2f, dirLightAngle + settings.ShadowSofteningRadiusAngle);
+	// soft shadow angles
+	float lenUV = float2{ dirLightDir.x, dirLightDir.y }.Length();
+	float dirLightAngle = atan2(-dirLightDir.z, lenUV);
+	float upperAngle = std::max(0.f, dirLightAngle - settings.ShadowSofteningRadiusAngle);
+	float lowerAngle = std::min(RE::NI_HALF_PI - 1e-2f, dirLightAngle + settings.ShadowSofteningRadiusAngle);
 
-		shadowUpdateCBData.LightDeltaZ = -(lenUV / invScale.z * stepMult) * float2{ std::tan(upperAngle), std::tan(lowerAngle) };
-	}
+	shadowUpdateCBData.LightDeltaZ = -(lenUV / invScale.z * stepMult) * float2{ std::tan(upperAngle), std::tan(lowerAngle) };
+	shadowUpdateCBData.PxSize = { 1.f / width, 1.f / height };
 
-	shadowUpdateCBData.StartPxCoord = edgePxCoord + signDir * shadowUpdateIdx * updateLength;
-	shadowUpdateCBData.PxSize = { 1.f / texNormalisedHeight->desc.Width, 1.f / texNormalisedHeight->desc.Height };
+	return true;
+}
 
-	shadowUpdateCB->Update(shadowUpdateCBData);
+void TerrainOcclusion::UpdateShadow()
+{
+	if (!cachedHeightmap || !texNormalisedHeight || (!IsBaking() && !IsHeightMapReady()))
+		return;
+	// normalised height is still being written tile by tile
+	if (!IsPrecomputeDone())
+		return;
 
-	shadowUpdateIdx = (shadowUpdateIdx + 1) % maxUpdates;
+	// don't forget to change NTHREADS in shader!
+	constexpr uint updateLength = 128u;
+
+	// only update direction at the start of each cycle
+	if (shadowUpdateIdx == 0 && !BeginShadowSweep())
+		return;
+
+	auto& context = State::GetSingleton()->context;
 
 	/* ---- BACKUP ---- */
 	struct ShaderState
@@ -503,26 +865,86 @@ void TerrainOcclusion::UpdateShadow()
 	context->CSSetUnorderedAccessViews(0, ARRAYSIZE(newer.uavs), newer.uavs, nullptr);
 	context->CSSetConstantBuffers(1, 1, &newer.buffer);
 	context->CSSetShader(shadowUpdateProgram.get(), nullptr, 0);
-	context->Dispatch(abs(shadowUpdateCBData.LightPxDir.x) >= abs(shadowUpdateCBData.LightPxDir.y) ? height : width, 1, 1);
+
+	// baking sweeps a whole sun direction per frame
+	do {
+		shadowUpdateCBData.StartPxCoord = shadowEdgePxCoord + shadowSignDir * shadowUpdateIdx * updateLength;
+		shadowUpdateCB->Update(shadowUpdateCBData);
+
+		context->Dispatch(abs(shadowUpdateCBData.LightPxDir.x) >= abs(shadowUpdateCBData.LightPxDir.y) ? texNormalisedHeight->desc.Height : texNormalisedHeight->desc.Width, 1, 1);
+
+		shadowUpdateIdx = (shadowUpdateIdx + 1) % shadowMaxUpdates;
+	} while (IsBaking() && shadowUpdateIdx != 0);
 
 	/* ---- RESTORE ---- */
 	context->CSSetShaderResources(0, ARRAYSIZE(old.srvs), old.srvs);
 	context->CSSetShader(old.shader, nullptr, 0);
 	context->CSSetUnorderedAccessViews(0, ARRAYSIZE(old.uavs), old.uavs, nullptr);
 	context->CSSetConstantBuffers(1, 1, &old.buffer);
+
+	if (shadowUpdateIdx == 0) {
+		shadowComplete = true;
+		if (shadowCacheable)
+			WriteShadowCache();
+		else if (occlusionCache.AddVisitedSunBucket(shadowBucket))
+			occlusionCache.Save();
+	}
 }
 
-void TerrainOcclusion::Prepass()
+void TerrainOcclusion::StartBake()
 {
-	LoadHeightmap();
+	bakeQueue.clear();
+	for (auto& [worldspace, _] : heightmaps)
+		bakeQueue.push_back(worldspace);
+
+	// the sun follows the same path everywhere, directions seen so far are the ones worth baking
+	bakeSunBuckets = occlusionCache.GetVisitedSunBuckets();
+	if (shadowBucket != UINT_MAX && std::find(bakeSunBuckets.begin(), bakeSunBuckets.end(), shadowBucket) == bakeSunBuckets.end())
+		bakeSunBuckets.push_back(shadowBucket);
+
+	logger::info("Baking terrain occlusion for {} height maps and {} sun directions", bakeQueue.size(), bakeSunBuckets.size());
+}
 
-	if (!settings.EnableTerrainShadow && !settings.EnableTerrainAO)
+void TerrainOcclusion::UpdateBake()
+{
+	if (!IsBaking() || !cachedHeightmap || cachedHeightmap->worldspace != bakeQueue.front())
+		return;
+	if (needPrecompute || pendingShadowLoad.valid())
 		return;
 
-	if (needPrecompute)
-		Precompute();
-	if (settings.EnableTerrainShadow)
-		UpdateShadow();
+	// results only count once they are on disk
+	if (IsCacheWritePending())
+		return;
+	if (!occlusionCache.HasOcclusion(cachedHeightmap->worldspace, cacheKey))
+		return;
+	for (auto bucket : bakeSunBuckets)
+		if (!occlusionCache.HasShadow(cachedHeightmap->worldspace, cacheKey, bucket))
+			return;
+
+	logger::info("Baked terrain occlusion for {}", cachedHeightmap->worldspace);
+	bakeQueue.pop_front();
+}
+
+void TerrainOcclusion::Prepass()
+{
+	LoadHeightmap();
+	FlushCacheWrites();
+
+	if (IsBaking()) {
+		if (needPrecompute)
+			Precompute();
+		else
+			UpdateShadow();
+		UpdateBake();
+	} else {
+		if (!settings.EnableTerrainShadow && !settings.EnableTerrainAO)
+			return;
+
+		if (needPrecompute)
+			Precompute();
+		if (settings.EnableTerrainShadow)
+			UpdateShadow();
+	}
 
 	{
 		auto context = State::GetSingleton()->context;
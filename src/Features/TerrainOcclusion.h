@@ -2,6 +2,14 @@
 
 #include "Buffer.h"
 #include "Feature.h"
+#include "Features/TerrainOcclusion/OcclusionCache.h"
+
+#include <future>
+
+namespace DirectX
+{
+	class ScratchImage;
+}
 
 struct TerrainOcclusion : public Feature
 {
@@ -43,6 +51,11 @@ struct TerrainOcclusion : public Feature
 	bool needPrecompute = false;
 	uint shadowUpdateIdx = 0;
 
+	static constexpr uint PrecomputeTileSize = 256;  // in px, multiple of the AOGen group size
+	static constexpr uint PrecomputeTilesPerFrame = 1;
+	static constexpr uint PrecomputeBakeTilesPerFrame = 8;
+	std::vector<std::pair<uint, uint>> pendingTiles;  // tile coordinates, nearest to the player last
+
 	struct HeightMapMetadata
 	{
 		std::wstring dir;
@@ -54,6 +67,47 @@ struct TerrainOcclusion : public Feature
 	std::unordered_map<std::string, HeightMapMetadata> heightmaps;
 	HeightMapMetadata* cachedHeightmap;
 
+	// decoded off the render thread, occlusion textures are only present when found in the disk cache
+	struct HeightMapLoad
+	{
+		HeightMapMetadata* heightmap = nullptr;
+		OcclusionCache::Key cacheKey;
+		std::unique_ptr<Texture2D> texHeightMap = nullptr;
+		std::unique_ptr<Texture2D> texOcclusion = nullptr;
+		std::unique_ptr<Texture2D> texNormalisedHeight = nullptr;
+	};
+	std::future<HeightMapLoad> pendingHeightmap;
+	std::string pendingWorldspace;
+	OcclusionCache occlusionCache{ L"Data\\textures\\heightmaps\\Cache" };
+	OcclusionCache::Key cacheKey;  // of the loaded height map and the settings its results were generated with
+	// results are copied to staging textures and mapped a few frames later so the render thread never waits on the GPU,
+	// then encoded and written one at a time off the render thread
+	static constexpr uint CacheReadbackDelayFrames = 3;
+	static constexpr size_t MaxQueuedCacheWrites = 2;  // an occlusion result and a shadow sweep
+	struct CacheWrite
+	{
+		std::vector<std::pair<std::unique_ptr<Texture2D>, std::filesystem::path>> staging;
+		std::vector<std::shared_ptr<DirectX::ScratchImage>> images;  // filled as each staging texture is mapped
+		std::function<void()> onWritten;
+		uint frames = 0;  // since the copy
+	};
+	std::deque<CacheWrite> queuedCacheWrites;
+	std::future<void> pendingCacheWrite;
+
+	// shadow sweeps run with a quantized sun direction, so a finished sweep stays valid until the sun changes bucket
+	uint shadowBucket = UINT_MAX;
+	bool shadowComplete = false;
+	bool shadowCacheable = false;  // sweep started on a finished precompute while baking, so its result goes to disk
+	uint shadowEdgePxCoord = 0;
+	int shadowSignDir = 1;
+	uint shadowMaxUpdates = 1;
+	std::future<std::unique_ptr<Texture2D>> pendingShadowLoad;
+	uint pendingShadowBucket = UINT_MAX;
+
+	// worldspaces left to bake, front is the one currently loaded
+	std::deque<std::string> bakeQueue;
+	std::vector<uint> bakeSunBuckets;
+
 	struct AOGenBuffer
 	{
 		float AoDistance;  // in game unit
@@ -63,6 +117,8 @@ struct TerrainOcclusion : public Feature
 		float3 pos0;
 		float3 pos1;
 		float2 zRange;
+
+		uint tileOffset[2];  // in px
 	};
 	std::unique_ptr<Buffer> aoGenBuffer = nullptr;
 
@@ -108,6 +164,7 @@ struct TerrainOcclusion : public Feature
 	std::unique_ptr<Texture2D> texShadowHeight = nullptr;
 
 	bool IsHeightMapReady();
+	bool IsPrecomputeDone() const { return !needPrecompute && pendingTiles.empty(); }
 
 	virtual void SetupResources() override;
 	void CompileComputeShaders();
@@ -116,8 +173,21 @@ struct TerrainOcclusion : public Feature
 
 	virtual void Prepass() override;
 	void LoadHeightmap();
+	HeightMapLoad LoadHeightmapAsync(HeightMapMetadata* a_heightmap, Settings a_settings);
+	void ApplyHeightmap(HeightMapLoad&& a_load);
 	void Precompute();
+	void SchedulePrecomputeTiles();
+	void WriteOcclusionCache();
+	bool BeginShadowSweep();
 	void UpdateShadow();
+	void WriteShadowCache();
+	void WriteCacheTextures(std::vector<std::pair<Texture2D*, std::filesystem::path>> a_textures, std::function<void()> a_onWritten);
+	void FlushCacheWrites();
+	bool IsCacheWritePending() const { return pendingCacheWrite.valid() || !queuedCacheWrites.empty(); }
+
+	bool IsBaking() { return !bakeQueue.empty(); }
+	void StartBake();
+	void UpdateBake();
 
 	virtual void LoadSettings(json& o_json) override;
 	virtual void SaveSettings(json& o_json) override;
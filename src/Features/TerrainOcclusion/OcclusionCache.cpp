@@ -0,0 +1,241 @@
+#include "Features/TerrainOcclusion/OcclusionCache.h"
+
+#include <fstream>
+#include <numbers>
+
+OcclusionCache::Key OcclusionCache::MakeKey(std::string_view a_heightmap, const OcclusionSettings& a_occlusion, float a_shadowSofteningRadiusAngle)
+{
+	static_assert(sizeof(OcclusionSettings) == 12, "hashed as raw bytes, must not hold padding");
+	return {
+		.heightmapHash = ankerl::unordered_dense::hash<std::string_view>{}(a_heightmap),
+		.occlusionSettingsHash = Hash(a_occlusion),
+		.shadowSettingsHash = GetShadowSettingsHash(a_shadowSofteningRadiusAngle)
+	};
+}
+
+void OcclusionCache::Load()
+{
+	std::scoped_lock lock{ mutex };
+
+	entries.clear();
+	visitedSunBuckets.clear();
+
+	std::ifstream file(dir / "index.json");
+	if (!file.is_open())
+		return;
+
+	try {
+		json index = json::parse(file);
+		if (index.value("Version", 0u) != AlgorithmVersion) {
+			logger::info("Terrain occlusion cache outdated, clearing");
+			file.close();
+			std::error_code ec;
+			std::filesystem::remove_all(dir, ec);
+			return;
+		}
+
+		visitedSunBuckets = index["Sun Buckets"].get<std::set<uint>>();
+		for (auto& [worldspace, value] : index["Worldspaces"].items()) {
+			Entry entry;
+			entry.key.heightmapHash = value["Height Map Hash"];
+			entry.key.occlusionSettingsHash = value["Occlusion Settings Hash"];
+			entry.key.shadowSettingsHash = value["Shadow Settings Hash"];
+			entry.hasOcclusion = value["Has Occlusion"];
+			entry.shadowBuckets = value["Shadow Buckets"].get<std::set<uint>>();
+			entries[worldspace] = std::move(entry);
+		}
+	} catch (const std::exception& e) {
+		logger::warn("Failed to parse terrain occlusion cache index: {}", e.what());
+		entries.clear();
+		visitedSunBuckets.clear();
+	}
+}
+
+void OcclusionCache::Save()
+{
+	std::scoped_lock lock{ mutex };
+
+	json index;
+	index["Version"] = AlgorithmVersion;
+	index["Sun Buckets"] = visitedSunBuckets;
+	index["Worldspaces"] = json::object();
+	for (auto& [worldspace, entry] : entries) {
+		index["Worldspaces"][worldspace] = {
+			{ "Height Map Hash", entry.key.heightmapHash },
+			{ "Occlusion Settings Hash", entry.key.occlusionSettingsHash },
+			{ "Shadow Settings Hash", entry.key.shadowSettingsHash },
+			{ "Has Occlusion", entry.hasOcclusion },
+			{ "Shadow Buckets", entry.shadowBuckets }
+		};
+	}
+
+	std::error_code ec;
+	std::filesystem::create_directories(dir, ec);
+	std::ofstream file(dir / "index.json");
+	if (!file.is_open()) {
+		logger::warn("Failed to write terrain occlusion cache index");
+		return;
+	}
+	file << index.dump(1);
+}
+
+void OcclusionCache::Clear()
+{
+	std::scoped_lock lock{ mutex };
+
+	entries.clear();
+	visitedSunBuckets.clear();
+
+	std::error_code ec;
+	std::filesystem::remove_all(dir, ec);
+	if (ec)
+		logger::warn("Failed to clear terrain occlusion cache: {}", ec.message());
+}
+
+bool OcclusionCache::Validate(const std::string& a_worldspace, const Key& a_key)
+{
+	std::scoped_lock lock{ mutex };
+
+	auto it = entries.find(a_worldspace);
+	if (it == entries.end()) {
+		entries[a_worldspace] = { .key = a_key };
+		return true;
+	}
+
+	auto& entry = it->second;
+	bool heightmapChanged = entry.key.heightmapHash != a_key.heightmapHash;
+	bool occlusionChanged = heightmapChanged || entry.key.occlusionSettingsHash != a_key.occlusionSettingsHash;
+	bool shadowChanged = heightmapChanged || entry.key.shadowSettingsHash != a_key.shadowSettingsHash;
+	if (!occlusionChanged && !shadowChanged)
+		return false;
+
+	RemoveFiles(a_worldspace, entry, occlusionChanged, shadowChanged);
+	if (occlusionChanged)
+		entry.hasOcclusion = false;
+	if (shadowChanged)
+		entry.shadowBuckets.clear();
+	entry.key = a_key;
+	return true;
+}
+
+bool OcclusionCache::HasOcclusion(const std::string& a_worldspace, const Key& a_key)
+{
+	std::scoped_lock lock{ mutex };
+
+	auto it = entries.find(a_worldspace);
+	return it != entries.end() && it->second.hasOcclusion &&
+	       it->second.key.heightmapHash == a_key.heightmapHash &&
+	       it->second.key.occlusionSettingsHash == a_key.occlusionSettingsHash;
+}
+
+bool OcclusionCache::HasShadow(const std::string& a_worldspace, const Key& a_key, uint a_bucket)
+{
+	std::scoped_lock lock{ mutex };
+
+	auto it = entries.find(a_worldspace);
+	return it != entries.end() && it->second.shadowBuckets.contains(a_bucket) &&
+	       it->second.key.heightmapHash == a_key.heightmapHash &&
+	       it->second.key.shadowSettingsHash == a_key.shadowSettingsHash;
+}
+
+void OcclusionCache::AddOcclusion(const std::string& a_worldspace, const Key& a_key)
+{
+	std::scoped_lock lock{ mutex };
+
+	// results of a superseded key finishing late are dropped
+	auto it = entries.find(a_worldspace);
+	if (it == entries.end() || it->second.key.heightmapHash != a_key.heightmapHash || it->second.key.occlusionSettingsHash != a_key.occlusionSettingsHash)
+		return;
+	it->second.hasOcclusion = true;
+}
+
+void OcclusionCache::AddShadow(const std::string& a_worldspace, const Key& a_key, uint a_bucket)
+{
+	std::scoped_lock lock{ mutex };
+
+	visitedSunBuckets.insert(a_bucket);
+
+	auto it = entries.find(a_worldspace);
+	if (it == entries.end() || it->second.key.heightmapHash != a_key.heightmapHash || it->second.key.shadowSettingsHash != a_key.shadowSettingsHash)
+		return;
+	it->second.shadowBuckets.insert(a_bucket);
+}
+
+bool OcclusionCache::AddVisitedSunBucket(uint a_bucket)
+{
+	std::scoped_lock lock{ mutex };
+
+	return visitedSunBuckets.insert(a_bucket).second;
+}
+
+void OcclusionCache::RemoveShadow(const std::string& a_worldspace, uint a_bucket)
+{
+	std::scoped_lock lock{ mutex };
+
+	auto it = entries.find(a_worldspace);
+	if (it == entries.end())
+		return;
+
+	std::error_code ec;
+	std::filesystem::remove(GetShadowPath(a_worldspace, it->second.key, a_bucket), ec);
+	it->second.shadowBuckets.erase(a_bucket);
+}
+
+size_t OcclusionCache::GetWorldspaceCount()
+{
+	std::scoped_lock lock{ mutex };
+	return entries.size();
+}
+
+std::vector<uint> OcclusionCache::GetVisitedSunBuckets()
+{
+	std::scoped_lock lock{ mutex };
+	return { visitedSunBuckets.begin(), visitedSunBuckets.end() };
+}
+
+std::filesystem::path OcclusionCache::GetOcclusionPath(const std::string& a_worldspace, const Key& a_key, std::string_view a_type) const
+{
+	return dir / std::format("{}.{}.{:016X}{:016X}.dds", a_worldspace, a_type, a_key.heightmapHash, a_key.occlusionSettingsHash);
+}
+
+std::filesystem::path OcclusionCache::GetShadowPath(const std::string& a_worldspace, const Key& a_key, uint a_bucket) const
+{
+	return dir / std::format("{}.Shadow{}.{:016X}{:016X}.dds", a_worldspace, a_bucket, a_key.heightmapHash, a_key.shadowSettingsHash);
+}
+
+void OcclusionCache::RemoveFiles(const std::string& a_worldspace, const Entry& a_entry, bool a_occlusion, bool a_shadows)
+{
+	std::error_code ec;
+	if (a_occlusion && a_entry.hasOcclusion) {
+		std::filesystem::remove(GetOcclusionPath(a_worldspace, a_entry.key, "AO"), ec);
+		std::filesystem::remove(GetOcclusionPath(a_worldspace, a_entry.key, "NormalisedHeight"), ec);
+	}
+	if (a_shadows)
+		for (auto bucket : a_entry.shadowBuckets)
+			std::filesystem::remove(GetShadowPath(a_worldspace, a_entry.key, bucket), ec);
+}
+
+uint OcclusionCache::GetSunBucket(float3 a_direction)
+{
+	a_direction.Normalize();
+	if (a_direction.z > 0)
+		a_direction = -a_direction;
+
+	float azimuth = std::atan2(a_direction.y, a_direction.x) + std::numbers::pi_v<float>;  // [0, 2pi]
+	float elevation = std::asin(std::clamp(-a_direction.z, 0.f, 1.f));                    // [0, pi/2]
+
+	uint azimuthIdx = std::min((uint)(azimuth / (2 * std::numbers::pi_v<float>) * SunAzimuthBuckets), SunAzimuthBuckets - 1);
+	uint elevationIdx = std::min((uint)(elevation / (.5f * std::numbers::pi_v<float>) * SunElevationBuckets), SunElevationBuckets - 1);
+	return elevationIdx * SunAzimuthBuckets + azimuthIdx;
+}
+
+float3 OcclusionCache::GetSunBucketDirection(uint a_bucket)
+{
+	uint azimuthIdx = a_bucket % SunAzimuthBuckets;
+	uint elevationIdx = a_bucket / SunAzimuthBuckets;
+
+	float azimuth = (azimuthIdx + .5f) / SunAzimuthBuckets * 2 * std::numbers::pi_v<float> - std::numbers::pi_v<float>;
+	float elevation = (elevationIdx + .5f) / SunElevationBuckets * .5f * std::numbers::pi_v<float>;
+
+	return { std::cos(elevation) * std::cos(azimuth), std::cos(elevation) * std::sin(azimuth), -std::sin(elevation) };
+}
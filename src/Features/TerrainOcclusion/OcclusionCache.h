@@ -0,0 +1,104 @@
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <set>
+
+/**
+ * Index of precomputed terrain occlusion stored on disk.
+ * One entry per worldspace, results generated from anything else are deleted by Validate.
+ */
+class OcclusionCache
+{
+public:
+	static constexpr uint32_t AlgorithmVersion = 2;  // bump whenever AOGen or ShadowUpdate output or the sun buckets change
+
+	// sun directions are quantized so one finished shadow sweep serves every direction in its bucket
+	// ~2.8 degrees per bucket, close to the default soft shadow radius so the jump between sweeps stays inside the penumbra
+	static constexpr uint SunAzimuthBuckets = 128;
+	static constexpr uint SunElevationBuckets = 32;
+	static constexpr uint SunBucketCount = SunAzimuthBuckets * SunElevationBuckets;
+
+	struct Key
+	{
+		uint64_t heightmapHash = 0;
+		uint64_t occlusionSettingsHash = 0;  // settings read by AOGen
+		uint64_t shadowSettingsHash = 0;     // settings read by ShadowUpdate
+	};
+
+	// settings read by AOGen
+	struct OcclusionSettings
+	{
+		float aoDistance;
+		uint sliceCount;
+		uint sampleCount;
+	};
+
+	/**
+	 * Key of a height map and the settings its results are generated with.
+	 *
+	 * @param a_heightmap Bytes of the height map file, results follow its content rather than its name
+	 */
+	static Key MakeKey(std::string_view a_heightmap, const OcclusionSettings& a_occlusion, float a_shadowSofteningRadiusAngle);
+
+	// ShadowUpdate reads only the softening radius
+	static uint64_t GetShadowSettingsHash(float a_shadowSofteningRadiusAngle) { return Hash(a_shadowSofteningRadiusAngle); }
+
+	explicit OcclusionCache(std::filesystem::path a_dir) :
+		dir(std::move(a_dir)) {}
+
+	void Load();
+	void Save();
+	void Clear();
+
+	/**
+	 * Make the entry of a worldspace match a key, deleting results it invalidates.
+	 *
+	 * @return Whether the index changed and should be saved
+	 */
+	bool Validate(const std::string& a_worldspace, const Key& a_key);
+
+	bool HasOcclusion(const std::string& a_worldspace, const Key& a_key);
+	bool HasShadow(const std::string& a_worldspace, const Key& a_key, uint a_bucket);
+	void AddOcclusion(const std::string& a_worldspace, const Key& a_key);
+	void AddShadow(const std::string& a_worldspace, const Key& a_key, uint a_bucket);
+	void RemoveShadow(const std::string& a_worldspace, uint a_bucket);
+
+	/**
+	 * Record a sun direction seen in game, the ones a bake writes shadows for.
+	 *
+	 * @return Whether it is new and the index should be saved
+	 */
+	bool AddVisitedSunBucket(uint a_bucket);
+
+	size_t GetWorldspaceCount();
+	std::vector<uint> GetVisitedSunBuckets();  // sun path is the same in every worldspace
+
+	std::filesystem::path GetOcclusionPath(const std::string& a_worldspace, const Key& a_key, std::string_view a_type) const;
+	std::filesystem::path GetShadowPath(const std::string& a_worldspace, const Key& a_key, uint a_bucket) const;
+
+	template <class T>
+	static uint64_t Hash(const T& a_value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		return ankerl::unordered_dense::hash<std::string_view>{}({ reinterpret_cast<const char*>(&a_value), sizeof(T) });
+	}
+
+	static uint GetSunBucket(float3 a_direction);
+	static float3 GetSunBucketDirection(uint a_bucket);
+
+private:
+	struct Entry
+	{
+		Key key;
+		bool hasOcclusion = false;
+		std::set<uint> shadowBuckets;
+	};
+
+	void RemoveFiles(const std::string& a_worldspace, const Entry& a_entry, bool a_occlusion, bool a_shadows);
+
+	std::filesystem::path dir;
+	std::mutex mutex;
+	std::unordered_map<std::string, Entry> entries;
+	std::set<uint> visitedSunBuckets;
+};
@@ -0,0 +1,26 @@
+#include "Features/TerrainOcclusion/PrecomputeTiles.h"
+
+namespace PrecomputeTiles
+{
+	std::vector<std::pair<uint, uint>> Order(uint a_width, uint a_height, uint a_tileSize, float2 a_playerUV)
+	{
+		const uint tilesX = (a_width + a_tileSize - 1) / a_tileSize;
+		const uint tilesY = (a_height + a_tileSize - 1) / a_tileSize;
+		const float playerX = std::clamp(a_playerUV.x, 0.f, 1.f) * tilesX;
+		const float playerY = std::clamp(a_playerUV.y, 0.f, 1.f) * tilesY;
+
+		std::vector<std::pair<uint, uint>> tiles;
+		tiles.reserve(tilesX * tilesY);
+		for (uint y = 0; y < tilesY; ++y)
+			for (uint x = 0; x < tilesX; ++x)
+				tiles.emplace_back(x, y);
+
+		auto distance = [&](const std::pair<uint, uint>& tile) {
+			const float dx = tile.first + .5f - playerX;
+			const float dy = tile.second + .5f - playerY;
+			return dx * dx + dy * dy;
+		};
+		std::ranges::sort(tiles, [&](const auto& a, const auto& b) { return distance(a) > distance(b); });
+		return tiles;
+	}
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Order in which TerrainOcclusion spreads AOGen over a height map, a few tiles per frame
+namespace PrecomputeTiles
+{
+	/**
+	 * Every tile covering a height map, the edge ones partial, ordered so the tiles nearest to the player come last
+	 * and are popped first.
+	 *
+	 * @param a_playerUV Player position over the height map, clamped to it
+	 */
+	std::vector<std::pair<uint, uint>> Order(uint a_width, uint a_height, uint a_tileSize, float2 a_playerUV);
+}
@@ -88,28 +88,38 @@ void hk_BSShader_LoadShaders(RE::BSShader* shader, std::uintptr_t stream)
 	auto& shaderCache = SIE::ShaderCache::Instance();
 
 	if (shaderCache.IsDiskCache() || shaderCache.IsDump()) {
+		std::vector<uint32_t> vertexDescriptors;
+		std::vector<uint32_t> pixelDescriptors;
 		for (const auto& entry : shader->vertexShaders) {
 			if (entry->shader && shaderCache.IsDump()) {
 				auto& bytecode = GetShaderBytecode(entry->shader);
 				DumpShader((REX::BSShader*)shader, entry, bytecode);
 			}
-			auto vertexShaderDesriptor = entry->id;
+			auto vertexShaderDescriptor = entry->id;
 			auto pixelShaderDescriptor = entry->id;
-			State::GetSingleton()->ModifyShaderLookup(*shader, vertexShaderDesriptor, pixelShaderDescriptor);
-			shaderCache.GetVertexShader(*shader, vertexShaderDesriptor);
+			State::GetSingleton()->ModifyShaderLookup(*shader, vertexShaderDescriptor, pixelShaderDescriptor);
+			vertexDescriptors.push_back(vertexShaderDescriptor);
 		}
 		for (const auto& entry : shader->pixelShaders) {
 			if (entry->shader && shaderCache.IsDump()) {
 				auto& bytecode = GetShaderBytecode(entry->shader);
 				DumpShader((REX::BSShader*)shader, entry, bytecode);
 			}
-			auto vertexShaderDesriptor = entry->id;
+			auto vertexShaderDescriptor = entry->id;
 			auto pixelShaderDescriptor = entry->id;
-			State::GetSingleton()->ModifyShaderLookup(*shader, vertexShaderDesriptor, pixelShaderDescriptor);
-			shaderCache.GetPixelShader(*shader, pixelShaderDescriptor);
-			State::GetSingleton()->ModifyShaderLookup(*shader, vertexShaderDesriptor, pixelShaderDescriptor, true);
-			shaderCache.GetPixelShader(*shader, pixelShaderDescriptor);
+			State::GetSingleton()->ModifyShaderLookup(*shader, vertexShaderDescriptor, pixelShaderDescriptor);
+			pixelDescriptors.push_back(pixelShaderDescriptor);
+			State::GetSingleton()->ModifyShaderLookup(*shader, vertexShaderDescriptor, pixelShaderDescriptor, true);
+			pixelDescriptors.push_back(pixelShaderDescriptor);
 		}
+
+		// load every cached permutation up front in parallel, the lookups below then only hit the lookup tables
+		shaderCache.WarmLoadShaders(*shader, vertexDescriptors, pixelDescriptors);
+
+		for (auto descriptor : vertexDescriptors)
+			shaderCache.GetVertexShader(*shader, descriptor);
+		for (auto descriptor : pixelDescriptors)
+			shaderCache.GetPixelShader(*shader, descriptor);
 	}
 	BSShaderHooks::hk_LoadShaders((REX::BSShader*)shader, stream);
 };
@@ -347,6 +347,41 @@ void Menu::DrawSettings()
 					"The more threads the faster compilation will finish but may make the system unresponsive. ");
 			}
 
+			const char* codecs[] = {
+				"None",
+				"Fast (LZ4)",
+				"Small (LZ4 HC)"
+			};
+			int codec = static_cast<int>(shaderCache.GetDiskCacheCodec());
+			if (ImGui::Combo("Disk Cache Compression", &codec, codecs, IM_ARRAYSIZE(codecs))) {
+				shaderCache.SetDiskCacheCodec(static_cast<SIE::ShaderCacheEntry::Codec>(codec));
+			}
+			if (auto _tt = Util::HoverTooltipWrapper()) {
+				ImGui::Text(
+					"Compression of shaders saved to the disk cache. "
+					"Fast keeps saving cheap and loads quicker from slow disks. "
+					"Small takes longer to save but makes the cache smaller and loads just as fast. "
+					"Applies to newly saved shaders; clear the disk cache to recompress existing ones. ");
+			}
+
+			const char* gbufferLayouts[] = {
+				"Wide",
+				"Compact"
+			};
+			// only the saved setting changes, the targets keep the layout they were created with
+			auto& gbufferLayout = Deferred::GetSingleton()->gbufferLayout;
+			int layout = static_cast<int>(gbufferLayout);
+			if (ImGui::Combo("G-Buffer Layout", &layout, gbufferLayouts, IM_ARRAYSIZE(gbufferLayouts))) {
+				gbufferLayout = static_cast<Deferred::GBufferLayout>(layout);
+			}
+			if (auto _tt = Util::HoverTooltipWrapper()) {
+				ImGui::Text(
+					"Storage of the deferred render targets. "
+					"Compact stores reflectance and snow parameters in 16 bits and skips reflectance without Dynamic Cubemaps, "
+					"saving bandwidth at high resolutions for slightly coarser reflection tint. "
+					"Requires a restart. ");
+			}
+
 			if (ImGui::SliderInt("Test Interval", reinterpret_cast<int*>(&testInterval), 0, 10)) {
 				if (testInterval == 0) {
 					inTestMode = false;
@@ -405,6 +440,8 @@ void Menu::DrawSettings()
 			}
 			if (ImGui::TreeNodeEx("Statistics", ImGuiTreeNodeFlags_DefaultOpen)) {
 				ImGui::Text(std::format("Shader Compiler : {}", shaderCache.GetShaderStatsString()).c_str());
+				if (auto vrs = VariableRateShading::GetSingleton(); vrs->vrsActive)
+					ImGui::Text(std::format("Variable Rate Shading Transitions : {} per frame", vrs->transitionCache.GetTransitions()).c_str());
 				ImGui::TreePop();
 			}
 			ImGui::Checkbox("Extended Frame Annotations", &State::GetSingleton()->extendedFrameAnnotations);
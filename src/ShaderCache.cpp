@@ -4,6 +4,7 @@
 
 #include <d3d11.h>
 #include <d3dcompiler.h>
+#include <execution>
 #include <fmt/std.h>
 #include <wrl/client.h>
 
@@ -12,6 +13,7 @@
 #include "State.h"
 
 #include "Features/DynamicCubemaps.h"
+#include "ShaderTools/ShaderFlagDefines.h"
 
 namespace SIE
 {
@@ -47,11 +49,54 @@ namespace SIE
 			return nullptr;
 		}
 
+		/** @brief Content hash of a blob, used to find permutations with identical source or bytecode. */
+		static uint64_t GetBlobHash(ID3DBlob& blob)
+		{
+			return ankerl::unordered_dense::hash<std::string_view>{}(
+				std::string_view(static_cast<const char*>(blob.GetBufferPointer()), blob.GetBufferSize()));
+		}
+
 		uint32_t GetTechnique(uint32_t descriptor)
 		{
 			return 0x3F & (descriptor >> 24);
 		}
 
+		// the descriptor flag tables write ShaderMacro, which has the layout of D3D_SHADER_MACRO
+		static_assert(sizeof(ShaderMacro) == sizeof(D3D_SHADER_MACRO) && offsetof(ShaderMacro, Definition) == offsetof(D3D_SHADER_MACRO, Definition));
+
+		static ShaderMacro* AsShaderMacros(D3D_SHADER_MACRO* a_defines)
+		{
+			return reinterpret_cast<ShaderMacro*>(a_defines);
+		}
+
+		/**
+		@brief Append the defines of all loaded features which apply to a shader type.
+		The list is rebuilt only when the shader defines generation changes, i.e. when features are (re)loaded.
+		*/
+		static void AppendFeatureDefines(RE::BSShader::Type type, D3D_SHADER_MACRO* defines, int& lastIndex)
+		{
+			static std::mutex featureDefinesMutex;
+			static std::array<std::pair<uint32_t, std::vector<D3D_SHADER_MACRO>>, static_cast<size_t>(RE::BSShader::Type::Total)> featureDefines{};
+
+			const auto generation = ShaderCache::Instance().GetShaderDefinesGeneration();
+
+			std::lock_guard lockGuard(featureDefinesMutex);
+			auto& [cachedGeneration, typeDefines] = featureDefines[static_cast<size_t>(type)];
+			if (cachedGeneration != generation) {
+				typeDefines.clear();
+				for (auto* feature : Feature::GetFeatureList()) {
+					if (feature->loaded && feature->HasShaderDefine(type)) {
+						typeDefines.push_back({ feature->GetShaderDefineName().data(), nullptr });
+					}
+				}
+				cachedGeneration = generation;
+			}
+
+			for (const auto& define : typeDefines) {
+				defines[lastIndex++] = define;
+			}
+		}
+
 		static void GetLightingShaderDefines(uint32_t descriptor,
 			D3D_SHADER_MACRO* defines)
 		{
@@ -70,11 +115,7 @@ namespace SIE
 				defines[lastIndex++] = { "DEFERRED", nullptr };
 			}
 
-			for (auto* feature : Feature::GetFeatureList()) {
-				if (feature->loaded && feature->HasShaderDefine(RE::BSShader::Type::Lighting)) {
-					defines[lastIndex++] = { feature->GetShaderDefineName().data(), nullptr };
-				}
-			}
+			AppendFeatureDefines(RE::BSShader::Type::Lighting, defines, lastIndex);
 
 			VanillaGetLightingShaderDefines(descriptor, defines + lastIndex);
 		}
@@ -88,35 +129,17 @@ namespace SIE
 				defines[lastIndex++] = { "FLARE", nullptr };
 			}
 
-			for (auto* feature : Feature::GetFeatureList()) {
-				if (feature->loaded && feature->HasShaderDefine(RE::BSShader::Type::BloodSplatter)) {
-					defines[lastIndex++] = { feature->GetShaderDefineName().data(), nullptr };
-				}
-			}
+			AppendFeatureDefines(RE::BSShader::Type::BloodSplatter, defines, lastIndex);
 
 			defines[lastIndex] = { nullptr, nullptr };
 		}
 
 		static void GetDistantTreeShaderDefines(uint32_t descriptor, D3D_SHADER_MACRO* defines)
 		{
-			const auto technique = descriptor & 1;
 			int lastIndex = 0;
-			if (technique == static_cast<uint32_t>(ShaderCache::DistantTreeShaderTechniques::Depth)) {
-				defines[lastIndex++] = { "RENDER_DEPTH", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::DistantTreeShaderFlags::AlphaTest)) {
-				defines[lastIndex++] = { "DO_ALPHA_TEST", nullptr };
-			}
 
-			if (descriptor & static_cast<uint32_t>(ShaderCache::DistantTreeShaderFlags::Deferred)) {
-				defines[lastIndex++] = { "DEFERRED", nullptr };
-			}
-
-			for (auto* feature : Feature::GetFeatureList()) {
-				if (feature->loaded && feature->HasShaderDefine(RE::BSShader::Type::DistantTree)) {
-					defines[lastIndex++] = { feature->GetShaderDefineName().data(), nullptr };
-				}
-			}
+			AppendDistantTreeShaderDescriptorDefines(descriptor, AsShaderMacros(defines), lastIndex);
+			AppendFeatureDefines(RE::BSShader::Type::DistantTree, defines, lastIndex);
 
 			defines[lastIndex] = { nullptr, nullptr };
 		}
@@ -188,31 +211,17 @@ namespace SIE
 				defines[lastIndex++] = { "DEFERRED", nullptr };
 			}
 
-			for (auto* feature : Feature::GetFeatureList()) {
-				if (feature->loaded && feature->HasShaderDefine(RE::BSShader::Type::Sky)) {
-					defines[lastIndex++] = { feature->GetShaderDefineName().data(), nullptr };
-				}
-			}
+			AppendFeatureDefines(RE::BSShader::Type::Sky, defines, lastIndex);
 
 			defines[lastIndex] = { nullptr, nullptr };
 		}
 
 		static void GetGrassShaderDefines(uint32_t descriptor, D3D_SHADER_MACRO* defines)
 		{
-			const auto technique = descriptor & 0b1111;
 			int lastIndex = 0;
-			if (technique == static_cast<uint32_t>(ShaderCache::GrassShaderTechniques::RenderDepth)) {
-				defines[lastIndex++] = { "RENDER_DEPTH", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::GrassShaderFlags::AlphaTest)) {
-				defines[lastIndex++] = { "DO_ALPHA_TEST", nullptr };
-			}
 
-			for (auto* feature : Feature::GetFeatureList()) {
-				if (feature->loaded && feature->HasShaderDefine(RE::BSShader::Type::Grass)) {
-					defines[lastIndex++] = { feature->GetShaderDefineName().data(), nullptr };
-				}
-			}
+			AppendGrassShaderDescriptorDefines(descriptor, AsShaderMacros(defines), lastIndex);
+			AppendFeatureDefines(RE::BSShader::Type::Grass, defines, lastIndex);
 
 			defines[lastIndex] = { nullptr, nullptr };
 		}
@@ -254,373 +263,38 @@ namespace SIE
 				}
 			}
 
-			for (auto* feature : Feature::GetFeatureList()) {
-				if (feature->loaded && feature->HasShaderDefine(RE::BSShader::Type::Particle)) {
-					defines[lastIndex++] = { feature->GetShaderDefineName().data(), nullptr };
-				}
-			}
+			AppendFeatureDefines(RE::BSShader::Type::Particle, defines, lastIndex);
 
 			defines[lastIndex] = { nullptr, nullptr };
 		}
 
 		static void GetEffectShaderDefines(uint32_t descriptor, D3D_SHADER_MACRO* defines)
 		{
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Vc)) {
-				defines[0] = { "VC", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::TexCoord)) {
-				defines[0] = { "TEXCOORD", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::TexCoordIndex)) {
-				defines[0] = { "TEXCOORD_INDEX", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Skinned)) {
-				defines[0] = { "SKINNED", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Normals)) {
-				defines[0] = { "NORMALS", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::BinormalTangent)) {
-				defines[0] = { "BINORMAL_TANGENT", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Texture)) {
-				defines[0] = { "TEXTURE", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::IndexedTexture)) {
-				defines[0] = { "INDEXED_TEXTURE", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Falloff)) {
-				defines[0] = { "FALLOFF", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::AddBlend)) {
-				defines[0] = { "ADDBLEND", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::MultBlend)) {
-				defines[0] = { "MULTBLEND", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Particles)) {
-				defines[0] = { "PARTICLES", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::StripParticles)) {
-				defines[0] = { "STRIP_PARTICLES", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Blood)) {
-				defines[0] = { "BLOOD", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Membrane)) {
-				defines[0] = { "MEMBRANE", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Lighting)) {
-				defines[0] = { "LIGHTING", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::ProjectedUv)) {
-				defines[0] = { "PROJECTED_UV", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Soft)) {
-				defines[0] = { "SOFT", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::GrayscaleToColor)) {
-				defines[0] = { "GRAYSCALE_TO_COLOR", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::GrayscaleToAlpha)) {
-				defines[0] = { "GRAYSCALE_TO_ALPHA", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::IgnoreTexAlpha)) {
-				defines[0] = { "IGNORE_TEX_ALPHA", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::MultBlendDecal)) {
-				defines[0] = { "MULTBLEND_DECAL", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::AlphaTest)) {
-				defines[0] = { "ALPHA_TEST", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::SkyObject)) {
-				defines[0] = { "SKY_OBJECT", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::MsnSpuSkinned)) {
-				defines[0] = { "MSN_SPU_SKINNED", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::MotionVectorsNormals)) {
-				defines[0] = { "MOTIONVECTORS_NORMALS", nullptr };
-				++defines;
-			}
-
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Deferred)) {
-				defines[0] = { "DEFERRED", nullptr };
-				++defines;
-			}
+			int lastIndex = 0;
 
-			for (auto* feature : Feature::GetFeatureList()) {
-				if (feature->loaded && feature->HasShaderDefine(RE::BSShader::Type::Effect)) {
-					defines[0] = { feature->GetShaderDefineName().data(), nullptr };
-					++defines;
-				}
-			}
+			AppendEffectShaderDescriptorDefines(descriptor, AsShaderMacros(defines), lastIndex);
+			AppendFeatureDefines(RE::BSShader::Type::Effect, defines, lastIndex);
 
-			defines[0] = { nullptr, nullptr };
+			defines[lastIndex] = { nullptr, nullptr };
 		}
 
 		static void GetWaterShaderDefines(uint32_t descriptor, D3D_SHADER_MACRO* defines)
 		{
 			int lastIndex = 0;
-			defines[lastIndex++] = { "WATER", nullptr };
-			defines[lastIndex++] = { "FOG", nullptr };
 
-			if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Vc)) {
-				defines[lastIndex++] = { "VC", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::NormalTexCoord)) {
-				defines[lastIndex++] = { "NORMAL_TEXCOORD", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Reflections)) {
-				defines[lastIndex++] = { "REFLECTIONS", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Refractions)) {
-				defines[lastIndex++] = { "REFRACTIONS", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Depth)) {
-				defines[lastIndex++] = { "DEPTH", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Interior)) {
-				defines[lastIndex++] = { "INTERIOR", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Wading)) {
-				defines[lastIndex++] = { "WADING", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::VertexAlphaDepth)) {
-				defines[lastIndex++] = { "VERTEX_ALPHA_DEPTH", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Cubemap)) {
-				defines[lastIndex++] = { "CUBEMAP", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Flowmap)) {
-				defines[lastIndex++] = { "FLOWMAP", nullptr };
-			}
-			if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::BlendNormals)) {
-				defines[lastIndex++] = { "BLEND_NORMALS", nullptr };
-			}
-
-			const auto technique = (descriptor >> 11) & 0xF;
-			if (technique == static_cast<uint32_t>(ShaderCache::WaterShaderTechniques::Underwater)) {
-				defines[lastIndex++] = { "UNDERWATER", nullptr };
-			} else if (technique == static_cast<uint32_t>(ShaderCache::WaterShaderTechniques::Lod)) {
-				defines[lastIndex++] = { "LOD", nullptr };
-			} else if (technique == static_cast<uint32_t>(ShaderCache::WaterShaderTechniques::Stencil)) {
-				defines[lastIndex++] = { "STENCIL", nullptr };
-			} else if (technique == static_cast<uint32_t>(ShaderCache::WaterShaderTechniques::Simple)) {
-				defines[lastIndex++] = { "SIMPLE", nullptr };
-			} else if (technique < 8) {
-				static constexpr std::array<const char*, 8> numLightDefines = { { "0", "1", "2", "3", "4",
-					"5", "6", "7" } };
-				defines[lastIndex++] = { "SPECULAR", nullptr };
-				defines[lastIndex++] = { "NUM_SPECULAR_LIGHTS", numLightDefines[technique] };
-			}
-
-			for (auto* feature : Feature::GetFeatureList()) {
-				if (feature->loaded && feature->HasShaderDefine(RE::BSShader::Type::Water)) {
-					defines[lastIndex++] = { feature->GetShaderDefineName().data(), nullptr };
-				}
-			}
+			AppendWaterShaderDescriptorDefines(descriptor, AsShaderMacros(defines), lastIndex);
+			AppendFeatureDefines(RE::BSShader::Type::Water, defines, lastIndex);
 
 			defines[lastIndex] = { nullptr, nullptr };
 		}
 
 		static void GetUtilityShaderDefines(uint32_t descriptor, D3D_SHADER_MACRO* defines)
 		{
-			using enum ShaderCache::UtilityShaderFlags;
-
-			if (descriptor & static_cast<uint32_t>(Vc)) {
-				defines[0] = { "VC", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(Texture)) {
-				defines[0] = { "TEXTURE", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(Skinned)) {
-				defines[0] = { "SKINNED", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(Normals)) {
-				defines[0] = { "NORMALS", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(AlphaTest)) {
-				defines[0] = { "ALPHA_TEST", nullptr };
-				++defines;
-			}
-
-			if (descriptor & static_cast<uint32_t>(LodLandscape)) {
-				if (descriptor &
-					(static_cast<uint32_t>(RenderShadowmask) |
-						static_cast<uint32_t>(RenderShadowmaskSpot))) {
-					defines[0] = { "FOCUS_SHADOW", nullptr };
-				} else {
-					defines[0] = { "LOD_LANDSCAPE", nullptr };
-				}
-				++defines;
-			}
-
-			if ((descriptor & static_cast<uint32_t>(RenderNormal)) &&
-				!(descriptor & static_cast<uint32_t>(RenderNormalClear))) {
-				defines[0] = { "RENDER_NORMAL", nullptr };
-				++defines;
-			} else if (!(descriptor & static_cast<uint32_t>(RenderNormal)) &&
-					   (descriptor & static_cast<uint32_t>(RenderNormalClear))) {
-				defines[0] = { "RENDER_NORMAL_CLEAR", nullptr };
-				++defines;
-			} else if ((descriptor & static_cast<uint32_t>(RenderNormal)) &&
-					   (descriptor & static_cast<uint32_t>(RenderNormalClear))) {
-				defines[0] = { "STENCIL_ABOVE_WATER", nullptr };
-				++defines;
-			}
-
-			if (descriptor & static_cast<uint32_t>(RenderNormalFalloff)) {
-				defines[0] = { "RENDER_NORMAL_FALLOFF", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(RenderNormalClamp)) {
-				defines[0] = { "RENDER_NORMAL_CLAMP", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(RenderDepth)) {
-				defines[0] = { "RENDER_DEPTH", nullptr };
-				++defines;
-			}
-
-			if (descriptor & static_cast<uint32_t>(OpaqueEffect)) {
-				defines[0] = { "OPAQUE_EFFECT", nullptr };
-				++defines;
-				if (!(descriptor & static_cast<uint32_t>(RenderShadowmap)) &&
-					(descriptor & static_cast<uint32_t>(AdditionalAlphaMask))) {
-					defines[0] = { "ADDITIONAL_ALPHA_MASK", nullptr };
-					++defines;
-				}
-				if (descriptor & static_cast<uint32_t>(GrayscaleToAlpha)) {
-					defines[0] = { "GRAYSCALE_TO_ALPHA", nullptr };
-					++defines;
-				}
-			} else {
-				if (descriptor & static_cast<uint32_t>(RenderShadowmap)) {
-					defines[0] = { "RENDER_SHADOWMAP", nullptr };
-					++defines;
-					if (descriptor & static_cast<uint32_t>(RenderShadowmapPb)) {
-						defines[0] = { "RENDER_SHADOWMAP_PB", nullptr };
-						++defines;
-					}
-				} else if (descriptor &
-						   static_cast<uint32_t>(AdditionalAlphaMask)) {
-					defines[0] = { "ADDITIONAL_ALPHA_MASK", nullptr };
-					++defines;
-				}
-				if (descriptor & static_cast<uint32_t>(RenderShadowmapClamped)) {
-					defines[0] = { "RENDER_SHADOWMAP_CLAMPED", nullptr };
-					++defines;
-				}
-			}
-
-			if (descriptor & static_cast<uint32_t>(GrayscaleMask)) {
-				defines[0] = { "GRAYSCALE_MASK", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(RenderShadowmask)) {
-				defines[0] = { "RENDER_SHADOWMASK", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(RenderShadowmaskSpot)) {
-				defines[0] = { "RENDER_SHADOWMASKSPOT", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(RenderShadowmaskPb)) {
-				defines[0] = { "RENDER_SHADOWMASKPB", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(RenderShadowmaskDpb)) {
-				defines[0] = { "RENDER_SHADOWMASKDPB", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(RenderBaseTexture)) {
-				defines[0] = { "RENDER_BASE_TEXTURE", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(TreeAnim)) {
-				defines[0] = { "TREE_ANIM", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(LodObject)) {
-				defines[0] = { "LOD_OBJECT", nullptr };
-				++defines;
-			}
-			if (descriptor & static_cast<uint32_t>(LocalMapFogOfWar)) {
-				defines[0] = { "LOCALMAP_FOGOFWAR", nullptr };
-				++defines;
-			}
-
-			if (descriptor & (static_cast<uint32_t>(RenderShadowmask) |
-								 static_cast<uint32_t>(RenderShadowmaskDpb) |
-								 static_cast<uint32_t>(RenderShadowmaskPb) |
-								 static_cast<uint32_t>(RenderShadowmaskSpot))) {
-				static constexpr std::array<const char*, 5> shadowFilters = { { "0", "1", "2",
-					"3", "4" } };
-				const size_t shadowFilterIndex = std::clamp((descriptor >> 17) & 0b111, 0u, 4u);
-				defines[0] = { "SHADOWFILTER", shadowFilters[shadowFilterIndex] };
-				++defines;
-			} else if ((!(descriptor & static_cast<uint32_t>(OpaqueEffect)) &&
-						   (descriptor &
-							   static_cast<uint32_t>(RenderShadowmap))) ||
-					   (descriptor & static_cast<uint32_t>(RenderDepth))) {
-				if (descriptor & static_cast<uint32_t>(DepthWriteDecals)) {
-					defines[0] = { "DEPTH_WRITE_DECALS", nullptr };
-					++defines;
-				}
-			} else {
-				if (descriptor & (static_cast<uint32_t>(DepthWriteDecals) |
-									 static_cast<uint32_t>(DebugColor))) {
-					defines[0] = { "DEBUG_COLOR", nullptr };
-					++defines;
-				}
-				if (descriptor & static_cast<uint32_t>(DebugShadowSplit)) {
-					defines[0] = { "DEBUG_SHADOWSPLIT", nullptr };
-					++defines;
-				}
-			}
+			int lastIndex = 0;
 
-			defines[0] = { "SHADOWSPLITCOUNT", "3" };
-			++defines;
+			AppendUtilityShaderDescriptorDefines(descriptor, AsShaderMacros(defines), lastIndex);
 
-			if ((descriptor & 0x14000) != 0x14000 &&
-				((descriptor & 0x20004000) == 0x4000 || (descriptor & 0x1E02000) == 0x2000) &&
-				!(descriptor & 0x80) && (descriptor & 0x14000) != 0x10000) {
-				defines[0] = { "NO_PIXEL_SHADER", nullptr };
-				++defines;
-			}
-
-			defines[0] = { nullptr, nullptr };
+			defines[lastIndex] = { nullptr, nullptr };
 		}
 
 		static void GetShaderDefines(RE::BSShader::Type type, uint32_t descriptor,
@@ -997,13 +671,14 @@ namespace SIE
 					 (0b1111ull << (4 * attribute + 4)));
 		}
 
-		template <size_t MaxOffsetsSize>
 		static void ReflectConstantBuffers(ID3D11ShaderReflection& reflector,
-			std::array<size_t, 3>& bufferSizes,
-			std::array<int8_t, MaxOffsetsSize>& constantOffsets,
-			uint64_t& vertexDesc,
+			ShaderReflection& reflection,
 			ShaderClass shaderClass, RE::BSShader::Type shaderType, uint32_t descriptor)
 		{
+			auto& bufferSizes = reflection.bufferSizes;
+			auto& constantOffsets = reflection.constantOffsets;
+			auto& vertexDesc = reflection.vertexDesc;
+
 			D3D11_SHADER_DESC desc;
 			if (FAILED(reflector.GetDesc(&desc))) {
 				logger::error("Failed to get shader descriptor for {} shader {}::{}",
@@ -1068,7 +743,7 @@ namespace SIE
 			}
 
 			auto mapBufferConsts =
-				[&](const char* bufferName, size_t& bufferSize) {
+				[&](const char* bufferName, uint32_t& bufferSize) {
 					auto bufferReflector = reflector.GetConstantBufferByName(bufferName);
 					if (bufferReflector == nullptr) {
 						logger::trace("Buffer {} not found for {} shader {}::{}",
@@ -1118,6 +793,34 @@ namespace SIE
 			mapBufferConsts("PerGeometry", bufferSizes[2]);
 		}
 
+		static bool ReflectShader(ID3DBlob& shaderData, ShaderReflection& reflection,
+			ShaderClass shaderClass, RE::BSShader::Type shaderType, uint32_t descriptor)
+		{
+			reflection = {};
+			Microsoft::WRL::ComPtr<ID3D11ShaderReflection> reflector;
+			const auto reflectionResult = D3DReflect(shaderData.GetBufferPointer(), shaderData.GetBufferSize(),
+				IID_PPV_ARGS(&reflector));
+			if (FAILED(reflectionResult)) {
+				logger::error("Failed to reflect {} shader {}::{}", magic_enum::enum_name(shaderClass),
+					magic_enum::enum_name(shaderType), descriptor);
+				return false;
+			}
+			ReflectConstantBuffers(*reflector.Get(), reflection, shaderClass, shaderType, descriptor);
+			return true;
+		}
+
+		/**
+		@brief Get the reflection of a blob, from the cache if it was loaded from disk or compiled this session.
+		*/
+		static ShaderReflection GetShaderReflection(ID3DBlob& shaderData,
+			ShaderClass shaderClass, RE::BSShader::Type shaderType, uint32_t descriptor)
+		{
+			ShaderReflection reflection{};
+			if (!ShaderCache::Instance().GetBlobReflection(shaderClass, shaderType, GetBlobHash(shaderData), reflection))
+				ReflectShader(shaderData, reflection, shaderClass, shaderType, descriptor);
+			return reflection;
+		}
+
 		std::wstring GetDiskPath(const std::string_view& name, uint32_t descriptor, ShaderClass shaderClass)
 		{
 			switch (shaderClass) {
@@ -1129,16 +832,80 @@ namespace SIE
 			return std::format(L"Data/ShaderCache/{}/{:X}.cso", std::wstring(name.begin(), name.end()), descriptor);
 		}
 
+		std::wstring GetBytecodePath(const std::string_view& name, uint64_t hash, ShaderClass shaderClass)
+		{
+			switch (shaderClass) {
+			case ShaderClass::Pixel:
+				return std::format(L"Data/ShaderCache/{}/Bytecode/{:016X}.pso", std::wstring(name.begin(), name.end()), hash);
+			case ShaderClass::Vertex:
+				return std::format(L"Data/ShaderCache/{}/Bytecode/{:016X}.vso", std::wstring(name.begin(), name.end()), hash);
+			}
+			return std::format(L"Data/ShaderCache/{}/Bytecode/{:016X}.cso", std::wstring(name.begin(), name.end()), hash);
+		}
+
+		/**
+		@brief Read the bytecode hash a descriptor entry links to.
+		@param a_path Path of the descriptor entry from GetDiskPath
+		@param a_hash The hash of the linked bytecode
+		@return Whether the entry could be read
+		*/
+		static bool ReadDiskCacheLink(const std::wstring& a_path, uint64_t& a_hash)
+		{
+			std::ifstream file(a_path, std::ios::binary);
+			return file.read(reinterpret_cast<char*>(&a_hash), sizeof(a_hash)) && file.gcount() == sizeof(a_hash);
+		}
+
+		static bool WriteDiskCacheLink(const std::wstring& a_path, uint64_t a_hash)
+		{
+			std::ofstream file(a_path, std::ios::binary | std::ios::trunc);
+			return (bool)file.write(reinterpret_cast<const char*>(&a_hash), sizeof(a_hash));
+		}
+
+		/**
+		@brief Read a bytecode entry written by WriteDiskCacheEntry.
+		@param a_path Path of the entry from GetBytecodePath
+		@param a_reflection The reflection stored with the bytecode
+		@param a_blob A new blob holding the bytecode
+		@return Whether the entry could be read; entries from older formats fail and are recompiled
+		*/
+		static bool ReadDiskCacheEntry(const std::wstring& a_path, ShaderReflection& a_reflection, ID3DBlob*& a_blob)
+		{
+			std::ifstream file(a_path, std::ios::binary | std::ios::ate);
+			if (!file)
+				return false;
+			std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			if (!file.read(reinterpret_cast<char*>(data.data()), data.size()))
+				return false;
+
+			ShaderCacheEntry::Header header{};
+			if (!ShaderCacheEntry::ReadHeader(data, header, a_reflection))
+				return false;
+			if (FAILED(D3DCreateBlob(header.bytecodeSize, &a_blob)))
+				return false;
+			// decompress straight into the blob
+			return ShaderCacheEntry::ReadBytecode(data, header,
+				{ static_cast<uint8_t*>(a_blob->GetBufferPointer()), a_blob->GetBufferSize() });
+		}
+
+		static bool WriteDiskCacheEntry(const std::wstring& a_path, const ShaderReflection& a_reflection, ID3DBlob& a_blob)
+		{
+			const auto data = ShaderCacheEntry::Write(a_reflection,
+				{ static_cast<const uint8_t*>(a_blob.GetBufferPointer()), a_blob.GetBufferSize() },
+				ShaderCache::Instance().GetDiskCacheCodec());
+			std::ofstream file(a_path, std::ios::binary | std::ios::trunc);
+			return (bool)file.write(reinterpret_cast<const char*>(data.data()), data.size());
+		}
+
 		static std::string GetShaderString(ShaderClass shaderClass, const RE::BSShader& shader, uint32_t descriptor, bool hashkey)
 		{
 			auto sourceShaderFile = shader.fxpFilename;
-			std::array<D3D_SHADER_MACRO, 64> defines{};
-			SIE::SShaderCache::GetShaderDefines(shader.shaderType.get(), descriptor, &defines[0]);
+			const auto defines = ShaderCache::Instance().GetCachedShaderDefines(shader.shaderType.get(), descriptor);
 			std::string result;
 			if (hashkey)  // generate hashkey so don't include descriptor
-				result = fmt::format("{}:{}:{}", sourceShaderFile, magic_enum::enum_name(shaderClass), SIE::SShaderCache::MergeDefinesString(defines, true));
+				result = fmt::format("{}:{}:{}", sourceShaderFile, magic_enum::enum_name(shaderClass), defines->string);
 			else
-				result = fmt::format("{}:{}:{:X}:{}", sourceShaderFile, magic_enum::enum_name(shaderClass), descriptor, SIE::SShaderCache::MergeDefinesString(defines, true));
+				result = fmt::format("{}:{}:{:X}:{}", sourceShaderFile, magic_enum::enum_name(shaderClass), descriptor, defines->string);
 			return result;
 		}
 
@@ -1151,6 +918,52 @@ namespace SIE
 			return type;
 		}
 
+		/**
+		@brief Load a shader from the disk cache, registering its bytecode and reflection with the cache.
+		@return The blob, or nullptr if there is no valid entry for the descriptor
+		*/
+		static ID3DBlob* LoadShaderFromDisk(ShaderClass shaderClass, const RE::BSShader& shader, uint32_t descriptor)
+		{
+			auto& cache = ShaderCache::Instance();
+			const auto type = shader.shaderType.get();
+			auto diskPath = GetDiskPath(shader.fxpFilename, descriptor, shaderClass);
+			if (!std::filesystem::exists(diskPath))
+				return nullptr;
+
+			ID3DBlob* shaderBlob = nullptr;
+
+			// check build time of cache
+			auto diskCacheTime = cache.UseFileWatcher() ? std::chrono::clock_cast<std::chrono::system_clock>(std::filesystem::last_write_time(diskPath)) : system_clock::now();
+			uint64_t bytecodeHash = 0;
+			if (cache.ShaderModifiedSince(shader.fxpFilename, diskCacheTime)) {
+				logger::debug("Diskcached shader {} older than {}", SIE::SShaderCache::GetShaderString(shaderClass, shader, descriptor, true), std::format("{:%Y%m%d%H%M}", diskCacheTime));
+			} else if (!ReadDiskCacheLink(diskPath, bytecodeHash)) {
+				logger::error("Failed to load {} shader {}::{}", magic_enum::enum_name(shaderClass), magic_enum::enum_name(type), descriptor);
+			} else if (auto sharedBlob = cache.GetDeduplicatedBlob(shaderClass, type, bytecodeHash)) {
+				// another permutation already loaded identical bytecode
+				logger::debug("Loaded shader from {} using shared bytecode {:016X}", std::filesystem::path(diskPath).string(), bytecodeHash);
+				cache.AddCompletedShader(shaderClass, shader, descriptor, sharedBlob);
+				return sharedBlob;
+			} else {
+				auto bytecodePath = GetBytecodePath(shader.fxpFilename, bytecodeHash, shaderClass);
+				ShaderReflection reflection{};
+				if (!ReadDiskCacheEntry(bytecodePath, reflection, shaderBlob) || GetBlobHash(*shaderBlob) != bytecodeHash) {
+					logger::error("Failed to load {} shader {}::{}", magic_enum::enum_name(shaderClass), magic_enum::enum_name(type), descriptor);
+
+					if (shaderBlob != nullptr) {
+						shaderBlob->Release();
+						shaderBlob = nullptr;
+					}
+				} else {
+					logger::debug("Loaded shader from {}", std::filesystem::path(bytecodePath).string());
+					shaderBlob = cache.DeduplicateBlob(shaderClass, type, bytecodeHash, shaderBlob, reflection);
+					cache.AddCompletedShader(shaderClass, shader, descriptor, shaderBlob);
+					return shaderBlob;
+				}
+			}
+			return nullptr;
+		}
+
 		static ID3DBlob* CompileShader(ShaderClass shaderClass, const RE::BSShader& shader, uint32_t descriptor, bool useDiskCache)
 		{
 			// check hashmap
@@ -1167,27 +980,9 @@ namespace SIE
 
 			// check diskcache
 			auto diskPath = GetDiskPath(shader.fxpFilename, descriptor, shaderClass);
-
-			if (useDiskCache && std::filesystem::exists(diskPath)) {
-				// check build time of cache
-				auto diskCacheTime = cache.UseFileWatcher() ? std::chrono::clock_cast<std::chrono::system_clock>(std::filesystem::last_write_time(diskPath)) : system_clock::now();
-				if (cache.ShaderModifiedSince(shader.fxpFilename, diskCacheTime)) {
-					logger::debug("Diskcached shader {} older than {}", SIE::SShaderCache::GetShaderString(shaderClass, shader, descriptor, true), std::format("{:%Y%m%d%H%M}", diskCacheTime));
-				} else if (FAILED(D3DReadFileToBlob(diskPath.c_str(), &shaderBlob))) {
-					logger::error("Failed to load {} shader {}::{}", magic_enum::enum_name(shaderClass), magic_enum::enum_name(type), descriptor);
-
-					if (shaderBlob != nullptr) {
-						shaderBlob->Release();
-					}
-				} else {
-					std::string str;
-					std::transform(diskPath.begin(), diskPath.end(), std::back_inserter(str), [](wchar_t c) {
-						return (char)c;
-					});
-					logger::debug("Loaded shader from {}", str);
-					cache.AddCompletedShader(shaderClass, shader, descriptor, shaderBlob);
-					return shaderBlob;
-				}
+			if (useDiskCache) {
+				if (auto diskBlob = LoadShaderFromDisk(shaderClass, shader, descriptor))
+					return diskBlob;
 			}
 
 			// prepare preprocessor defines
@@ -1209,8 +1004,12 @@ namespace SIE
 				for (unsigned int i = 0; i < shaderDefines->size(); i++)
 					defines[lastIndex++] = { shaderDefines->at(i).first.c_str(), shaderDefines->at(i).second.c_str() };
 			}
+			for (const auto& define : cache.GetCachedShaderDefines(type, descriptor)->macros) {
+				if (define.Name == nullptr)
+					break;
+				defines[lastIndex++] = define;
+			}
 			defines[lastIndex] = { nullptr, nullptr };  // do final entry
-			GetShaderDefines(type, descriptor, &defines[lastIndex]);
 
 			const std::wstring path = GetShaderPath(shader.fxpFilename);
 
@@ -1222,13 +1021,39 @@ namespace SIE
 				logger::error("Failed to compile {} shader {}::{}: {} does not exist", magic_enum::enum_name(shaderClass), magic_enum::enum_name(type), descriptor, strPath);
 				return nullptr;
 			}
+
+			// preprocess first so permutations which expand to the same source skip compilation entirely
+			// developer mode compiles from file to keep source level debug info
+			Microsoft::WRL::ComPtr<ID3DBlob> preprocessedBlob;
+			uint64_t sourceHash = 0;
+			if (!State::GetSingleton()->IsDeveloperMode()) {
+				Microsoft::WRL::ComPtr<ID3DBlob> sourceBlob;
+				if (SUCCEEDED(D3DReadFileToBlob(path.c_str(), &sourceBlob)) &&
+					SUCCEEDED(D3DPreprocess(sourceBlob->GetBufferPointer(), sourceBlob->GetBufferSize(), strPath.c_str(), defines.data(),
+						D3D_COMPILE_STANDARD_FILE_INCLUDE, &preprocessedBlob, nullptr))) {
+					sourceHash = GetBlobHash(*preprocessedBlob.Get());
+					if (auto sharedBlob = cache.GetDeduplicatedBlobForSource(shaderClass, type, sourceHash)) {
+						logger::debug("Skipping compilation of {}:{}:{:X}; preprocessed source matches an existing permutation", magic_enum::enum_name(type), magic_enum::enum_name(shaderClass), descriptor);
+						if (useDiskCache)
+							WriteDiskCacheLink(diskPath, GetBlobHash(*sharedBlob));
+						cache.AddCompletedShader(shaderClass, shader, descriptor, sharedBlob);
+						return sharedBlob;
+					}
+				} else {
+					preprocessedBlob.Reset();  // let the compiler report the error below
+				}
+			}
+
 			logger::debug("Compiling {} {}:{}:{:X} to {}", strPath, magic_enum::enum_name(type), magic_enum::enum_name(shaderClass), descriptor, MergeDefinesString(defines));
 
 			// compile shaders
 			ID3DBlob* errorBlob = nullptr;
 			const uint32_t flags = !State::GetSingleton()->IsDeveloperMode() ? D3DCOMPILE_OPTIMIZATION_LEVEL3 : D3DCOMPILE_DEBUG;
-			const HRESULT compileResult = D3DCompileFromFile(path.c_str(), defines.data(), D3D_COMPILE_STANDARD_FILE_INCLUDE, "main",
-				GetShaderProfile(shaderClass), flags, 0, &shaderBlob, &errorBlob);
+			const HRESULT compileResult = preprocessedBlob ?
+			                                  D3DCompile(preprocessedBlob->GetBufferPointer(), preprocessedBlob->GetBufferSize(), strPath.c_str(), nullptr, nullptr, "main",
+												  GetShaderProfile(shaderClass), flags, 0, &shaderBlob, &errorBlob) :
+			                                  D3DCompileFromFile(path.c_str(), defines.data(), D3D_COMPILE_STANDARD_FILE_INCLUDE, "main",
+												  GetShaderProfile(shaderClass), flags, 0, &shaderBlob, &errorBlob);
 
 			if (FAILED(compileResult)) {
 				if (errorBlob != nullptr) {
@@ -1265,9 +1090,19 @@ namespace SIE
 				strippedShaderBlob->Release();
 			}
 
+			// reflect once here; the result is stored with the bytecode so cache hits skip D3DReflect
+			ShaderReflection reflection{};
+			ReflectShader(*shaderBlob, reflection, shaderClass, type, descriptor);
+
+			// share identical bytecode between permutations
+			const uint64_t bytecodeHash = GetBlobHash(*shaderBlob);
+			shaderBlob = cache.DeduplicateBlob(shaderClass, type, bytecodeHash, shaderBlob, reflection);
+			if (preprocessedBlob)
+				cache.AddSourceHash(shaderClass, type, sourceHash, bytecodeHash, shaderBlob);
+
 			// save shader to disk
 			if (useDiskCache) {
-				auto directoryPath = std::format("Data/ShaderCache/{}", shader.fxpFilename);
+				auto directoryPath = std::format("Data/ShaderCache/{}/Bytecode", shader.fxpFilename);
 				if (!std::filesystem::is_directory(directoryPath)) {
 					try {
 						std::filesystem::create_directories(directoryPath);
@@ -1276,27 +1111,42 @@ namespace SIE
 					}
 				}
 
-				const HRESULT saveResult = D3DWriteBlobToFile(shaderBlob, diskPath.c_str(), true);
-				if (FAILED(saveResult)) {
-					std::string str;
-					std::transform(diskPath.begin(), diskPath.end(), std::back_inserter(str), [](wchar_t c) {
-						return (char)c;
-					});
-					logger::error("Failed to save shader to {}", str);
+				// identical bytecode is only stored once; the descriptor entry links to it
+				auto bytecodePath = GetBytecodePath(shader.fxpFilename, bytecodeHash, shaderClass);
+				bool saved = std::filesystem::exists(bytecodePath) || WriteDiskCacheEntry(bytecodePath, reflection, *shaderBlob);
+				saved = saved && WriteDiskCacheLink(diskPath, bytecodeHash);
+				if (!saved) {
+					logger::error("Failed to save shader to {}", std::filesystem::path(diskPath).string());
 				} else {
-					std::string str;
-					std::transform(diskPath.begin(), diskPath.end(), std::back_inserter(str), [](wchar_t c) {
-						return (char)c;
-					});
-					logger::debug("Saved shader to {}", str);
+					logger::debug("Saved shader to {}", std::filesystem::path(diskPath).string());
 				}
 			}
 			cache.AddCompletedShader(shaderClass, shader, descriptor, shaderBlob);
 			return shaderBlob;
 		}
 
+		template <class Shader>
+		static void SetupConstantBuffers(Shader& shader, const ShaderReflection& reflection,
+			ID3D11Buffer** perTechniqueBuffersArray, ID3D11Buffer** perMaterialBuffersArray,
+			ID3D11Buffer** perGeometryBuffersArray, void* bufferData)
+		{
+			static_assert(std::tuple_size_v<decltype(shader.constantTable)> <= ShaderReflection::MaxConstants);
+			std::copy_n(reflection.constantOffsets.begin(), shader.constantTable.size(), shader.constantTable.begin());
+
+			ID3D11Buffer** const buffersArrays[] = { perTechniqueBuffersArray, perMaterialBuffersArray, perGeometryBuffersArray };
+			for (size_t i = 0; i < reflection.bufferSizes.size(); ++i) {
+				if (reflection.bufferSizes[i] != 0) {
+					shader.constantBuffers[i].buffer =
+						(REX::W32::ID3D11Buffer*)buffersArrays[i][reflection.bufferSizes[i]];
+				} else {
+					shader.constantBuffers[i].buffer = nullptr;
+					shader.constantBuffers[i].data = bufferData;
+				}
+			}
+		}
+
 		std::unique_ptr<RE::BSGraphics::VertexShader> CreateVertexShader(ID3DBlob& shaderData,
-			RE::BSShader::Type type, uint32_t descriptor)
+			const ShaderReflection& reflection, RE::BSShader::Type type, uint32_t descriptor)
 		{
 			static const auto device = REL::Relocation<ID3D11Device**>(RE::Offset::D3D11Device);
 			static const auto perTechniqueBuffersArray =
@@ -1315,50 +1165,15 @@ namespace SIE
 			std::unique_ptr<RE::BSGraphics::VertexShader> newShader{ shaderPtr };
 			newShader->byteCodeSize = (uint32_t)shaderData.GetBufferSize();
 			newShader->id = descriptor;
-			newShader->shaderDesc = 0;
-
-			Microsoft::WRL::ComPtr<ID3D11ShaderReflection> reflector;
-			const auto reflectionResult = D3DReflect(shaderData.GetBufferPointer(), shaderData.GetBufferSize(),
-				IID_PPV_ARGS(&reflector));
-			if (FAILED(reflectionResult)) {
-				logger::error("Failed to reflect vertex shader {}::{}", magic_enum::enum_name(type),
-					descriptor);
-			} else {
-				std::array<size_t, 3> bufferSizes = { 0, 0, 0 };
-#pragma warning(push)
-#pragma warning(disable: 4244)
-				std::fill(newShader->constantTable.begin(), newShader->constantTable.end(), 0);
-#pragma warning(pop)
-				ReflectConstantBuffers(*reflector.Get(), bufferSizes, newShader->constantTable, newShader->shaderDesc,
-					ShaderClass::Vertex, type, descriptor);
-				if (bufferSizes[0] != 0) {
-					newShader->constantBuffers[0].buffer =
-						(REX::W32::ID3D11Buffer*)perTechniqueBuffersArray.get()[bufferSizes[0]];
-				} else {
-					newShader->constantBuffers[0].buffer = nullptr;
-					newShader->constantBuffers[0].data = bufferData.get();
-				}
-				if (bufferSizes[1] != 0) {
-					newShader->constantBuffers[1].buffer =
-						(REX::W32::ID3D11Buffer*)perMaterialBuffersArray.get()[bufferSizes[1]];
-				} else {
-					newShader->constantBuffers[1].buffer = nullptr;
-					newShader->constantBuffers[1].data = bufferData.get();
-				}
-				if (bufferSizes[2] != 0) {
-					newShader->constantBuffers[2].buffer =
-						(REX::W32::ID3D11Buffer*)perGeometryBuffersArray.get()[bufferSizes[2]];
-				} else {
-					newShader->constantBuffers[2].buffer = nullptr;
-					newShader->constantBuffers[2].data = bufferData.get();
-				}
-			}
+			newShader->shaderDesc = reflection.vertexDesc;
+			SetupConstantBuffers(*newShader, reflection, perTechniqueBuffersArray.get(),
+				perMaterialBuffersArray.get(), perGeometryBuffersArray.get(), bufferData.get());
 
 			return newShader;
 		}
 
 		std::unique_ptr<RE::BSGraphics::PixelShader> CreatePixelShader(ID3DBlob& shaderData,
-			RE::BSShader::Type type, uint32_t descriptor)
+			const ShaderReflection& reflection, RE::BSShader::Type type, uint32_t descriptor)
 		{
 			static const auto device = REL::Relocation<ID3D11Device**>(RE::Offset::D3D11Device);
 			static const auto perTechniqueBuffersArray =
@@ -1371,62 +1186,31 @@ namespace SIE
 
 			auto newShader = std::make_unique<RE::BSGraphics::PixelShader>();
 			newShader->id = descriptor;
-
-			Microsoft::WRL::ComPtr<ID3D11ShaderReflection> reflector;
-			const auto reflectionResult = D3DReflect(shaderData.GetBufferPointer(),
-				shaderData.GetBufferSize(), IID_PPV_ARGS(&reflector));
-			if (FAILED(reflectionResult)) {
-				logger::error("Failed to reflect vertex shader {}::{}", magic_enum::enum_name(type),
-					descriptor);
-			} else {
-				std::array<size_t, 3> bufferSizes = { 0, 0, 0 };
-#pragma warning(push)
-#pragma warning(disable: 4244)
-				std::fill(newShader->constantTable.begin(), newShader->constantTable.end(), 0);
-#pragma warning(pop)
-				uint64_t dummy;
-				ReflectConstantBuffers(*reflector.Get(), bufferSizes, newShader->constantTable,
-					dummy,
-					ShaderClass::Pixel, type, descriptor);
-				if (bufferSizes[0] != 0) {
-					newShader->constantBuffers[0].buffer =
-						(REX::W32::ID3D11Buffer*)perTechniqueBuffersArray.get()[bufferSizes[0]];
-				} else {
-					newShader->constantBuffers[0].buffer = nullptr;
-					newShader->constantBuffers[0].data = bufferData.get();
-				}
-				if (bufferSizes[1] != 0) {
-					newShader->constantBuffers[1].buffer =
-						(REX::W32::ID3D11Buffer*)perMaterialBuffersArray.get()[bufferSizes[1]];
-				} else {
-					newShader->constantBuffers[1].buffer = nullptr;
-					newShader->constantBuffers[1].data = bufferData.get();
-				}
-				if (bufferSizes[2] != 0) {
-					newShader->constantBuffers[2].buffer =
-						(REX::W32::ID3D11Buffer*)perGeometryBuffersArray.get()[bufferSizes[2]];
-				} else {
-					newShader->constantBuffers[2].buffer = nullptr;
-					newShader->constantBuffers[2].data = bufferData.get();
-				}
-			}
+			SetupConstantBuffers(*newShader, reflection, perTechniqueBuffersArray.get(),
+				perMaterialBuffersArray.get(), perGeometryBuffersArray.get(), bufferData.get());
 
 			return newShader;
 		}
 	}
 
-	RE::BSGraphics::VertexShader* ShaderCache::GetVertexShader(const RE::BSShader& shader,
-		uint32_t descriptor)
+	bool ShaderCache::IsReplacementEnabled(ShaderClass shaderClass, const RE::BSShader& shader, uint32_t descriptor)
 	{
 		if (shader.shaderType.get() == RE::BSShader::Type::Effect) {
 			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Lighting)) {
 			} else {
-				return nullptr;
+				return false;
 			}
 		}
 
 		auto state = State::GetSingleton();
-		if (!((ShaderCache::IsSupportedShader(shader) || state->IsDeveloperMode() && state->IsShaderEnabled(shader)) && state->enableVShaders)) {
+		const bool classEnabled = shaderClass == ShaderClass::Vertex ? state->enableVShaders : state->enablePShaders;
+		return (ShaderCache::IsSupportedShader(shader) || state->IsDeveloperMode() && state->IsShaderEnabled(shader)) && classEnabled;
+	}
+
+	RE::BSGraphics::VertexShader* ShaderCache::GetVertexShader(const RE::BSShader& shader,
+		uint32_t descriptor)
+	{
+		if (!IsReplacementEnabled(ShaderClass::Vertex, shader, descriptor)) {
 			return nullptr;
 		}
 
@@ -1460,15 +1244,7 @@ namespace SIE
 	RE::BSGraphics::PixelShader* ShaderCache::GetPixelShader(const RE::BSShader& shader,
 		uint32_t descriptor)
 	{
-		if (shader.shaderType.get() == RE::BSShader::Type::Effect) {
-			if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Lighting)) {
-			} else {
-				return nullptr;
-			}
-		}
-
-		auto state = State::GetSingleton();
-		if (!((ShaderCache::IsSupportedShader(shader) || state->IsDeveloperMode() && state->IsShaderEnabled(shader)) && state->enablePShaders)) {
+		if (!IsReplacementEnabled(ShaderClass::Pixel, shader, descriptor)) {
 			return nullptr;
 		}
 
@@ -1515,6 +1291,8 @@ namespace SIE
 				}
 				shaders.clear();
 			}
+			for (auto& shaders : vertexShadersByHash)
+				shaders.clear();
 		}
 		std::lock_guard lockGuardP(pixelShadersMutex);
 		{
@@ -1524,8 +1302,17 @@ namespace SIE
 				}
 				shaders.clear();
 			}
+			for (auto& shaders : pixelShadersByHash)
+				shaders.clear();
+		}
+		{
+			std::lock_guard lockGuard(blobIndicesMutex);
+			for (auto& typeIndices : blobIndices)
+				for (auto& index : typeIndices)
+					index.Clear();
 		}
 		compilationSet.Clear();
+		InvalidateShaderDefines();
 		std::unique_lock lock{ mapMutex };
 		shaderMap.clear();
 	}
@@ -1539,6 +1326,7 @@ namespace SIE
 				shader->shader->Release();
 			}
 			vertexShaders[static_cast<size_t>(a_type)].clear();
+			vertexShadersByHash[static_cast<size_t>(a_type)].clear();
 		}
 		std::lock_guard lockGuardP(pixelShadersMutex);
 		{
@@ -1546,6 +1334,12 @@ namespace SIE
 				shader->shader->Release();
 			}
 			pixelShaders[static_cast<size_t>(a_type)].clear();
+			pixelShadersByHash[static_cast<size_t>(a_type)].clear();
+		}
+		{
+			std::lock_guard lockGuard(blobIndicesMutex);
+			for (auto& index : blobIndices[static_cast<size_t>(a_type)])
+				index.Clear();
 		}
 		compilationSet.Clear();
 	}
@@ -1599,6 +1393,53 @@ namespace SIE
 		return ShaderCompilationTask::Status::Pending;
 	}
 
+	ID3DBlob* ShaderCache::DeduplicateBlob(ShaderClass a_class, RE::BSShader::Type a_type, uint64_t a_hash, ID3DBlob* a_blob, const ShaderReflection& a_reflection)
+	{
+		std::lock_guard lockGuard(blobIndicesMutex);
+		auto& index = blobIndices[static_cast<size_t>(a_type)][static_cast<size_t>(a_class)];
+		auto sharedBlob = index.Add(a_hash, a_blob, a_reflection);
+		if (sharedBlob != a_blob) {
+			logger::debug("Sharing {} bytecode {:016X} for {}", magic_enum::enum_name(a_class), a_hash, magic_enum::enum_name(a_type));
+			a_blob->Release();
+			compilationSet.duplicateTasks++;
+		} else if (index.Find(a_hash)->blob != a_blob) {
+			logger::warn("{} bytecode {:016X} for {} differs from the bytecode with the same hash, not sharing it", magic_enum::enum_name(a_class), a_hash, magic_enum::enum_name(a_type));
+		}
+		return sharedBlob;
+	}
+
+	ID3DBlob* ShaderCache::GetDeduplicatedBlob(ShaderClass a_class, RE::BSShader::Type a_type, uint64_t a_hash)
+	{
+		std::lock_guard lockGuard(blobIndicesMutex);
+		auto entry = blobIndices[static_cast<size_t>(a_type)][static_cast<size_t>(a_class)].Find(a_hash);
+		return entry ? entry->blob : nullptr;
+	}
+
+	bool ShaderCache::GetBlobReflection(ShaderClass a_class, RE::BSShader::Type a_type, uint64_t a_hash, ShaderReflection& a_reflection)
+	{
+		std::lock_guard lockGuard(blobIndicesMutex);
+		auto entry = blobIndices[static_cast<size_t>(a_type)][static_cast<size_t>(a_class)].Find(a_hash);
+		if (!entry)
+			return false;
+		a_reflection = entry->reflection;
+		return true;
+	}
+
+	void ShaderCache::AddSourceHash(ShaderClass a_class, RE::BSShader::Type a_type, uint64_t a_sourceHash, uint64_t a_bytecodeHash, ID3DBlob* a_blob)
+	{
+		std::lock_guard lockGuard(blobIndicesMutex);
+		blobIndices[static_cast<size_t>(a_type)][static_cast<size_t>(a_class)].AddSource(a_sourceHash, a_bytecodeHash, a_blob);
+	}
+
+	ID3DBlob* ShaderCache::GetDeduplicatedBlobForSource(ShaderClass a_class, RE::BSShader::Type a_type, uint64_t a_sourceHash)
+	{
+		std::lock_guard lockGuard(blobIndicesMutex);
+		auto blob = blobIndices[static_cast<size_t>(a_type)][static_cast<size_t>(a_class)].FindForSource(a_sourceHash);
+		if (blob)
+			compilationSet.duplicateTasks++;
+		return blob;
+	}
+
 	std::string ShaderCache::GetShaderStatsString(bool a_timeOnly)
 	{
 		return compilationSet.GetStatsString(a_timeOnly);
@@ -1665,6 +1506,16 @@ namespace SIE
 		isDiskCache = value;
 	}
 
+	ShaderCacheEntry::Codec ShaderCache::GetDiskCacheCodec() const
+	{
+		return diskCacheCodec;
+	}
+
+	void ShaderCache::SetDiskCacheCodec(ShaderCacheEntry::Codec value)
+	{
+		diskCacheCodec = value < ShaderCacheEntry::Codec::Total ? value : ShaderCacheEntry::Codec::None;
+	}
+
 	void ShaderCache::DeleteDiskCache()
 	{
 		std::scoped_lock lock{ compilationSet.compilationMutex };
@@ -1801,11 +1652,24 @@ namespace SIE
 				SShaderCache::CompileShader(ShaderClass::Vertex, shader, descriptor, isDiskCache)) {
 			static const auto device = REL::Relocation<ID3D11Device**>(RE::Offset::D3D11Device);
 
-			auto newShader = SShaderCache::CreateVertexShader(*shaderBlob, shader.shaderType.get(),
+			const auto reflection = SShaderCache::GetShaderReflection(*shaderBlob, ShaderClass::Vertex,
+				shader.shaderType.get(), descriptor);
+			auto newShader = SShaderCache::CreateVertexShader(*shaderBlob, reflection, shader.shaderType.get(),
 				descriptor);
+			const auto bytecodeHash = SShaderCache::GetBlobHash(*shaderBlob);
 
 			std::lock_guard lockGuard(vertexShadersMutex);
 
+			// permutations with identical bytecode share one D3D object
+			auto& sharedShader = vertexShadersByHash[static_cast<size_t>(shader.shaderType.get())][bytecodeHash];
+			if (sharedShader) {
+				sharedShader->AddRef();
+				newShader->shader = reinterpret_cast<REX::W32::ID3D11VertexShader*>(sharedShader);
+				return vertexShaders[static_cast<size_t>(shader.shaderType.get())]
+				    .insert_or_assign(descriptor, std::move(newShader))
+				    .first->second.get();
+			}
+
 			const auto result = (*device)->CreateVertexShader(shaderBlob->GetBufferPointer(),
 				newShader->byteCodeSize, nullptr, reinterpret_cast<ID3D11VertexShader**>(&newShader->shader));
 			if (FAILED(result)) {
@@ -1815,6 +1679,7 @@ namespace SIE
 					newShader->shader->Release();
 				}
 			} else {
+				sharedShader = reinterpret_cast<ID3D11VertexShader*>(newShader->shader);
 				return vertexShaders[static_cast<size_t>(shader.shaderType.get())]
 				    .insert_or_assign(descriptor, std::move(newShader))
 				    .first->second.get();
@@ -1830,10 +1695,24 @@ namespace SIE
 				SShaderCache::CompileShader(ShaderClass::Pixel, shader, descriptor, isDiskCache)) {
 			static const auto device = REL::Relocation<ID3D11Device**>(RE::Offset::D3D11Device);
 
-			auto newShader = SShaderCache::CreatePixelShader(*shaderBlob, shader.shaderType.get(),
+			const auto reflection = SShaderCache::GetShaderReflection(*shaderBlob, ShaderClass::Pixel,
+				shader.shaderType.get(), descriptor);
+			auto newShader = SShaderCache::CreatePixelShader(*shaderBlob, reflection, shader.shaderType.get(),
 				descriptor);
+			const auto bytecodeHash = SShaderCache::GetBlobHash(*shaderBlob);
 
 			std::lock_guard lockGuard(pixelShadersMutex);
+
+			// permutations with identical bytecode share one D3D object
+			auto& sharedShader = pixelShadersByHash[static_cast<size_t>(shader.shaderType.get())][bytecodeHash];
+			if (sharedShader) {
+				sharedShader->AddRef();
+				newShader->shader = reinterpret_cast<REX::W32::ID3D11PixelShader*>(sharedShader);
+				return pixelShaders[static_cast<size_t>(shader.shaderType.get())]
+				    .insert_or_assign(descriptor, std::move(newShader))
+				    .first->second.get();
+			}
+
 			const auto result = (*device)->CreatePixelShader(shaderBlob->GetBufferPointer(),
 				shaderBlob->GetBufferSize(), nullptr, reinterpret_cast<ID3D11PixelShader**>(&newShader->shader));
 			if (FAILED(result)) {
@@ -1844,6 +1723,7 @@ namespace SIE
 					newShader->shader->Release();
 				}
 			} else {
+				sharedShader = reinterpret_cast<ID3D11PixelShader*>(newShader->shader);
 				return pixelShaders[static_cast<size_t>(shader.shaderType.get())]
 				    .insert_or_assign(descriptor, std::move(newShader))
 				    .first->second.get();
@@ -1852,12 +1732,207 @@ namespace SIE
 		return nullptr;
 	}
 
+	// disk cache entries of one shader onto the game's device
+	class ShaderCache::DiskWarmLoadBackend : public WarmLoadBackend<ID3DBlob, ID3D11DeviceChild>
+	{
+	public:
+		DiskWarmLoadBackend(ShaderCache& a_cache, const RE::BSShader& a_shader) :
+			cache(a_cache), shader(a_shader) {}
+
+		bool IsLoadable(ShaderClass a_class, uint32_t a_descriptor) override
+		{
+			if (!cache.IsReplacementEnabled(a_class, shader, a_descriptor))
+				return false;
+			const auto type = static_cast<size_t>(shader.shaderType.get());
+			if (a_class == ShaderClass::Vertex) {
+				std::lock_guard lockGuard(cache.vertexShadersMutex);
+				if (cache.vertexShaders[type].find(a_descriptor) != cache.vertexShaders[type].end())
+					return false;
+			} else {
+				std::lock_guard lockGuard(cache.pixelShadersMutex);
+				if (cache.pixelShaders[type].find(a_descriptor) != cache.pixelShaders[type].end())
+					return false;
+			}
+			return std::filesystem::exists(SShaderCache::GetDiskPath(shader.fxpFilename, a_descriptor, a_class));
+		}
+
+		std::string GetKey(ShaderClass a_class, uint32_t a_descriptor) override
+		{
+			return SShaderCache::GetShaderString(a_class, shader, a_descriptor, true);
+		}
+
+		ID3DBlob* Load(ShaderClass a_class, uint32_t a_descriptor, uint64_t& o_hash) override
+		{
+			// the loader registers each blob with its reflection
+			auto blob = SShaderCache::LoadShaderFromDisk(a_class, shader, a_descriptor);
+			if (blob)
+				o_hash = SShaderCache::GetBlobHash(*blob);
+			return blob;
+		}
+
+		bool HasObject(ShaderClass a_class, uint64_t a_hash) override
+		{
+			const auto type = static_cast<size_t>(shader.shaderType.get());
+			if (a_class == ShaderClass::Vertex) {
+				std::lock_guard lockGuard(cache.vertexShadersMutex);
+				return cache.vertexShadersByHash[type].contains(a_hash);
+			}
+			std::lock_guard lockGuard(cache.pixelShadersMutex);
+			return cache.pixelShadersByHash[type].contains(a_hash);
+		}
+
+		ID3D11DeviceChild* Create(ShaderClass a_class, ID3DBlob& a_blob) override
+		{
+			static const auto device = REL::Relocation<ID3D11Device**>(RE::Offset::D3D11Device);
+			HRESULT result;
+			ID3D11DeviceChild* object = nullptr;
+			if (a_class == ShaderClass::Vertex) {
+				ID3D11VertexShader* vertexShader = nullptr;
+				result = (*device)->CreateVertexShader(a_blob.GetBufferPointer(), a_blob.GetBufferSize(), nullptr, &vertexShader);
+				object = vertexShader;
+			} else {
+				ID3D11PixelShader* pixelShader = nullptr;
+				result = (*device)->CreatePixelShader(a_blob.GetBufferPointer(), a_blob.GetBufferSize(), nullptr, &pixelShader);
+				object = pixelShader;
+			}
+			if (FAILED(result) && object != nullptr) {
+				object->Release();
+				object = nullptr;
+			}
+			return object;
+		}
+
+		void Release(ID3D11DeviceChild& a_object) override
+		{
+			a_object.Release();
+		}
+
+	private:
+		ShaderCache& cache;
+		const RE::BSShader& shader;
+	};
+
+	void ShaderCache::WarmLoadShaders(const RE::BSShader& shader, std::span<const uint32_t> vertexDescriptors,
+		std::span<const uint32_t> pixelDescriptors)
+	{
+		if (!IsDiskCache())
+			return;
+
+		const auto type = shader.shaderType.get();
+		const auto startTime = high_resolution_clock::now();
+
+		DiskWarmLoadBackend backend(*this, shader);
+		WarmLoad<ID3DBlob, ID3D11DeviceChild> warmLoad(backend);
+
+		// descriptors which have a disk cache entry and are not loaded yet
+		const std::string_view blocked = blockedKeyIndex != -1 ? std::string_view(blockedKey) : std::string_view();
+		warmLoad.Enumerate(ShaderClass::Vertex, vertexDescriptors, blocked);
+		warmLoad.Enumerate(ShaderClass::Pixel, pixelDescriptors, blocked);
+		if (warmLoad.GetEntries().empty())
+			return;
+
+		// Not on compilationPool: its threads are held by the compilation manager and tasks which may load shaders
+		// themselves, so waiting on it from here can deadlock.
+		warmLoad.Load();
+
+		// device creation is free threaded, so the D3D objects are created in parallel as well
+		warmLoad.Create(ShaderClass::Vertex);
+		warmLoad.Create(ShaderClass::Pixel);
+		PublishWarmLoadedShaders<ShaderClass::Vertex>(type, warmLoad);
+		PublishWarmLoadedShaders<ShaderClass::Pixel>(type, warmLoad);
+
+		logger::debug("Warm loaded {} {} shaders in {} ms", warmLoad.GetEntries().size(), magic_enum::enum_name(type),
+			duration_cast<std::chrono::milliseconds>(high_resolution_clock::now() - startTime).count());
+	}
+
+	template <ShaderClass Class>
+	void ShaderCache::PublishWarmLoadedShaders(RE::BSShader::Type a_type, WarmLoad<ID3DBlob, ID3D11DeviceChild>& a_warmLoad)
+	{
+		using D3DShader = std::conditional_t<Class == ShaderClass::Vertex, ID3D11VertexShader, ID3D11PixelShader>;
+		auto& mutex = Class == ShaderClass::Vertex ? vertexShadersMutex : pixelShadersMutex;
+		auto& shadersByHash = [this]() -> auto& {
+			if constexpr (Class == ShaderClass::Vertex)
+				return vertexShadersByHash;
+			else
+				return pixelShadersByHash;
+		}()[static_cast<size_t>(a_type)];
+
+		// publish everything under a single lock, objects not taken here are released with a_warmLoad
+		std::lock_guard lockGuard(mutex);
+		for (const auto& entry : a_warmLoad.GetEntries()) {
+			if (entry.shaderClass != Class || !entry.blob)
+				continue;
+			if constexpr (Class == ShaderClass::Vertex) {
+				if (vertexShaders[static_cast<size_t>(a_type)].find(entry.descriptor) != vertexShaders[static_cast<size_t>(a_type)].end())
+					continue;  // compiled asynchronously meanwhile
+			} else {
+				if (pixelShaders[static_cast<size_t>(a_type)].find(entry.descriptor) != pixelShaders[static_cast<size_t>(a_type)].end())
+					continue;
+			}
+
+			auto& sharedShader = shadersByHash[entry.hash];
+			if (sharedShader) {
+				sharedShader->AddRef();
+			} else if (auto object = a_warmLoad.TakeObject(Class, entry.hash)) {
+				sharedShader = static_cast<D3DShader*>(object);
+			} else {
+				shadersByHash.erase(entry.hash);
+				logger::error("Failed to create {} shader {}::{}", magic_enum::enum_name(Class),
+					magic_enum::enum_name(a_type), entry.descriptor);
+				continue;
+			}
+
+			const auto reflection = SShaderCache::GetShaderReflection(*entry.blob, Class, a_type, entry.descriptor);
+			if constexpr (Class == ShaderClass::Vertex) {
+				auto newShader = SShaderCache::CreateVertexShader(*entry.blob, reflection, a_type, entry.descriptor);
+				newShader->shader = reinterpret_cast<REX::W32::ID3D11VertexShader*>(sharedShader);
+				vertexShaders[static_cast<size_t>(a_type)].insert_or_assign(entry.descriptor, std::move(newShader));
+			} else {
+				auto newShader = SShaderCache::CreatePixelShader(*entry.blob, reflection, a_type, entry.descriptor);
+				newShader->shader = reinterpret_cast<REX::W32::ID3D11PixelShader*>(sharedShader);
+				pixelShaders[static_cast<size_t>(a_type)].insert_or_assign(entry.descriptor, std::move(newShader));
+			}
+		}
+	}
+
 	std::string ShaderCache::GetDefinesString(RE::BSShader::Type enumType, uint32_t descriptor)
 	{
-		std::array<D3D_SHADER_MACRO, 64> defines{};
-		SIE::SShaderCache::GetShaderDefines(enumType, descriptor, &defines[0]);
+		return Instance().GetCachedShaderDefines(enumType, descriptor)->string;
+	}
+
+	std::shared_ptr<const ShaderDefines> ShaderCache::GetCachedShaderDefines(RE::BSShader::Type a_type, uint32_t a_descriptor)
+	{
+		auto& typeCache = shaderDefinesCache[static_cast<size_t>(a_type)];
+		{
+			std::shared_lock lock{ shaderDefinesMutex };
+			auto it = typeCache.find(a_descriptor);
+			if (it != typeCache.end())
+				return it->second;
+		}
+
+		const uint32_t generation = shaderDefinesGeneration;
+		auto newDefines = std::make_shared<ShaderDefines>();
+		SIE::SShaderCache::GetShaderDefines(a_type, a_descriptor, newDefines->macros.data());
+		auto sortedMacros = newDefines->macros;
+		newDefines->string = SIE::SShaderCache::MergeDefinesString(sortedMacros, true);
 
-		return SIE::SShaderCache::MergeDefinesString(defines, true);
+		std::unique_lock lock{ shaderDefinesMutex };
+		if (generation != shaderDefinesGeneration)  // invalidated while generating; don't memoize stale defines
+			return newDefines;
+		return typeCache.try_emplace(a_descriptor, std::move(newDefines)).first->second;
+	}
+
+	void ShaderCache::InvalidateShaderDefines()
+	{
+		std::unique_lock lock{ shaderDefinesMutex };
+		for (auto& typeCache : shaderDefinesCache)
+			typeCache.clear();
+		shaderDefinesGeneration++;
+	}
+
+	uint32_t ShaderCache::GetShaderDefinesGeneration() const
+	{
+		return shaderDefinesGeneration;
 	}
 
 	uint64_t ShaderCache::GetCachedHitTasks()
@@ -2037,7 +2112,7 @@ namespace SIE
 		processedTasks.insert(task);
 		tasksInProgress.erase(task);
 		conditionVariable.notify_one();
-		DynamicCubemaps::GetSingleton()->resetCapture = true;
+		DynamicCubemaps::GetSingleton()->scheduler.RequestReset(false);
 	}
 
 	void CompilationSet::Clear()
@@ -2050,6 +2125,7 @@ namespace SIE
 		completedTasks = 0;
 		failedTasks = 0;
 		cacheHitTasks = 0;
+		duplicateTasks = 0;
 		lastReset = high_resolution_clock::now();
 		lastCalculation = high_resolution_clock::now();
 		totalMs = (double)duration_cast<std::chrono::milliseconds>(lastReset - lastReset).count();
@@ -2081,11 +2157,12 @@ namespace SIE
 			return fmt::format("{}/{}",
 				GetHumanTime(totalMs),
 				GetHumanTime(GetEta() + totalMs));
-		return fmt::format("{}/{} (successful/total)\tfailed: {}\tcachehits: {}\nElapsed/Estimated Time: {}/{}",
+		return fmt::format("{}/{} (successful/total)\tfailed: {}\tcachehits: {}\tduplicates: {}\nElapsed/Estimated Time: {}/{}",
 			(std::uint64_t)completedTasks,
 			(std::uint64_t)totalTasks,
 			(std::uint64_t)failedTasks,
 			(std::uint64_t)cacheHitTasks,
+			(std::uint64_t)duplicateTasks,
 			GetHumanTime(totalMs),
 			GetHumanTime(GetEta() + totalMs));
 	}
@@ -2,27 +2,26 @@
 
 #include <RE/B/BSShader.h>
 
+#include <d3d11.h>
+
 #include "BS_thread_pool.hpp"
+#include "ShaderTools/BlobIndex.h"
+#include "ShaderTools/ShaderCacheEntry.h"
+#include "ShaderTools/ShaderDescriptors.h"
+#include "ShaderTools/WarmLoad.h"
 #include "efsw/efsw.hpp"
 #include <chrono>
 #include <condition_variable>
+#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 
-static constexpr REL::Version SHADER_CACHE_VERSION = { 0, 0, 0, 20 };
+static constexpr REL::Version SHADER_CACHE_VERSION = { 0, 0, 0, 22 };
 
 using namespace std::chrono;
 
 namespace SIE
 {
-	enum class ShaderClass
-	{
-		Vertex,
-		Pixel,
-		Compute,
-		Total,
-	};
-
 	class ShaderCompilationTask
 	{
 	public:
@@ -73,6 +72,7 @@ namespace SIE
 		std::atomic<uint64_t> totalTasks = 0;
 		std::atomic<uint64_t> failedTasks = 0;
 		std::atomic<uint64_t> cacheHitTasks = 0;  // number of compiles of a previously seen shader combo
+		std::atomic<uint64_t> duplicateTasks = 0;  // number of compiles which produced bytecode identical to another permutation
 		std::mutex compilationMutex;
 
 	private:
@@ -85,6 +85,12 @@ namespace SIE
 		double totalMs = (double)duration_cast<std::chrono::milliseconds>(lastReset - lastReset).count();
 	};
 
+	struct ShaderDefines
+	{
+		std::array<D3D_SHADER_MACRO, 64> macros{};  // null terminated
+		std::string string;                         // sorted, as used in shader keys
+	};
+
 	struct ShaderCacheResult
 	{
 		ID3DBlob* blob;
@@ -143,6 +149,9 @@ namespace SIE
 
 		bool IsDiskCache() const;
 		void SetDiskCache(bool value);
+		ShaderCacheEntry::Codec GetDiskCacheCodec() const;
+		/** @brief Codec for newly written disk cache entries. Existing entries keep their codec until rebuilt. */
+		void SetDiskCacheCodec(ShaderCacheEntry::Codec value);
 		void DeleteDiskCache();
 		void ValidateDiskCache();
 		void WriteDiskCacheInfo();
@@ -172,6 +181,21 @@ namespace SIE
 		ID3DBlob* GetCompletedShader(const SIE::ShaderCompilationTask& a_task);
 		ID3DBlob* GetCompletedShader(ShaderClass shaderClass, const RE::BSShader& shader, uint32_t descriptor);
 		ShaderCompilationTask::Status GetShaderStatus(const std::string& a_key);
+
+		/** @brief Register a blob by the hash of its bytecode so identical permutations share it.
+		@param  a_hash Content hash of a_blob
+		@param  a_blob Newly created blob; released if a blob with the same bytes is already registered
+		@param  a_reflection Reflection of a_blob, kept so creating shader objects does not need D3DReflect
+		@return The shared blob, or a_blob when a_hash is registered for other bytes
+		*/
+		ID3DBlob* DeduplicateBlob(ShaderClass a_class, RE::BSShader::Type a_type, uint64_t a_hash, ID3DBlob* a_blob, const ShaderReflection& a_reflection);
+		ID3DBlob* GetDeduplicatedBlob(ShaderClass a_class, RE::BSShader::Type a_type, uint64_t a_hash);
+		bool GetBlobReflection(ShaderClass a_class, RE::BSShader::Type a_type, uint64_t a_hash, ShaderReflection& a_reflection);
+		/** @brief Remember which bytecode a preprocessed source produced so later permutations can skip compilation.
+		@param  a_blob The blob DeduplicateBlob returned, the source is only remembered when it is the one shared for a_bytecodeHash
+		*/
+		void AddSourceHash(ShaderClass a_class, RE::BSShader::Type a_type, uint64_t a_sourceHash, uint64_t a_bytecodeHash, ID3DBlob* a_blob);
+		ID3DBlob* GetDeduplicatedBlobForSource(ShaderClass a_class, RE::BSShader::Type a_type, uint64_t a_sourceHash);
 		std::string GetShaderStatsString(bool a_timeOnly = false);
 
 		RE::BSGraphics::VertexShader* GetVertexShader(const RE::BSShader& shader, uint32_t descriptor);
@@ -183,8 +207,29 @@ namespace SIE
 		RE::BSGraphics::PixelShader* MakeAndAddPixelShader(const RE::BSShader& shader,
 			uint32_t descriptor);
 
+		/** @brief Load all disk cached permutations of a shader in parallel.
+		Entries are read and parsed concurrently, D3D objects are created once per unique bytecode,
+		and the results are published to the lookup tables under a single lock. Blocked descriptors and
+		descriptors without a valid entry are left for GetVertexShader/GetPixelShader to handle as usual.
+		@param  shader The shader being loaded
+		@param  vertexDescriptors Vertex descriptors to load, after ModifyShaderLookup
+		@param  pixelDescriptors Pixel descriptors to load, after ModifyShaderLookup
+		*/
+		void WarmLoadShaders(const RE::BSShader& shader, std::span<const uint32_t> vertexDescriptors,
+			std::span<const uint32_t> pixelDescriptors);
+
 		static std::string GetDefinesString(RE::BSShader::Type enumType, uint32_t descriptor);
 
+		/** @brief Get the preprocessor defines for a descriptor, generating them on first use.
+		@param  a_type The type of shader
+		@param  a_descriptor The shader descriptor
+		@return Shared immutable defines, valid for as long as the caller holds the pointer
+		*/
+		std::shared_ptr<const ShaderDefines> GetCachedShaderDefines(RE::BSShader::Type a_type, uint32_t a_descriptor);
+		/** @brief Drop all memoized defines, e.g. after the set of loaded features changed. */
+		void InvalidateShaderDefines();
+		uint32_t GetShaderDefinesGeneration() const;
+
 		uint64_t GetCachedHitTasks();
 		uint64_t GetCompletedTasks();
 		uint64_t GetFailedTasks();
@@ -204,195 +249,19 @@ namespace SIE
 		bool backgroundCompilation = false;
 		bool menuLoaded = false;
 
-		enum class LightingShaderTechniques
-		{
-			None = 0,
-			Envmap = 1,
-			Glowmap = 2,
-			Parallax = 3,
-			Facegen = 4,
-			FacegenRGBTint = 5,
-			Hair = 6,
-			ParallaxOcc = 7,
-			MTLand = 8,
-			LODLand = 9,
-			Snow = 10,  // unused
-			MultilayerParallax = 11,
-			TreeAnim = 12,
-			LODObjects = 13,
-			MultiIndexSparkle = 14,
-			LODObjectHD = 15,
-			Eye = 16,
-			Cloud = 17,  // unused
-			LODLandNoise = 18,
-			MTLandLODBlend = 19,
-			Outline = 20,
-		};
-
-		enum class LightingShaderFlags
-		{
-			VC = 1 << 0,
-			Skinned = 1 << 1,
-			ModelSpaceNormals = 1 << 2,
-			// flags 3 to 8 are unused by vanilla
-			// Community Shaders start
-			Deferred = 1 << 4,
-			// Community Shaders end
-			Specular = 1 << 9,
-			SoftLighting = 1 << 10,
-			RimLighting = 1 << 11,
-			BackLighting = 1 << 12,
-			ShadowDir = 1 << 13,
-			DefShadow = 1 << 14,
-			ProjectedUV = 1 << 15,
-			AnisoLighting = 1 << 16,
-			AmbientSpecular = 1 << 17,
-			WorldMap = 1 << 18,
-			BaseObjectIsSnow = 1 << 19,
-			DoAlphaTest = 1 << 20,
-			Snow = 1 << 21,
-			CharacterLight = 1 << 22,
-			AdditionalAlphaMask = 1 << 23
-		};
-
-		enum class BloodSplatterShaderTechniques
-		{
-			Splatter = 0,
-			Flare = 1,
-		};
-
-		enum class DistantTreeShaderTechniques
-		{
-			DistantTreeBlock = 0,
-			Depth = 1,
-		};
-
-		enum class DistantTreeShaderFlags
-		{
-			Deferred = 1 << 8,
-			AlphaTest = 1 << 16,
-		};
-
-		enum class SkyShaderTechniques
-		{
-			SunOcclude = 0,
-			SunGlare = 1,
-			MoonAndStarsMask = 2,
-			Stars = 3,
-			Clouds = 4,
-			CloudsLerp = 5,
-			CloudsFade = 6,
-			Texture = 7,
-			Sky = 8,
-		};
-
-		enum class GrassShaderTechniques
-		{
-			RenderDepth = 8,
-		};
-
-		enum class GrassShaderFlags
-		{
-			AlphaTest = 0x10000,
-		};
-
-		enum class ParticleShaderTechniques
-		{
-			Particles = 0,
-			ParticlesGryColor = 1,
-			ParticlesGryAlpha = 2,
-			ParticlesGryColorAlpha = 3,
-			EnvCubeSnow = 4,
-			EnvCubeRain = 5,
-		};
-
-		enum class WaterShaderTechniques
-		{
-			Underwater = 8,
-			Lod = 9,
-			Stencil = 10,
-			Simple = 11,
-		};
-
-		enum class WaterShaderFlags
-		{
-			Vc = 1 << 0,
-			NormalTexCoord = 1 << 1,
-			Reflections = 1 << 2,
-			Refractions = 1 << 3,
-			Depth = 1 << 4,
-			Interior = 1 << 5,
-			Wading = 1 << 6,
-			VertexAlphaDepth = 1 << 7,
-			Cubemap = 1 << 8,
-			Flowmap = 1 << 9,
-			BlendNormals = 1 << 10,
-		};
-
-		enum class EffectShaderFlags
-		{
-			Vc = 1 << 0,
-			TexCoord = 1 << 1,
-			TexCoordIndex = 1 << 2,
-			Skinned = 1 << 3,
-			Normals = 1 << 4,
-			BinormalTangent = 1 << 5,
-			Texture = 1 << 6,
-			IndexedTexture = 1 << 7,
-			Falloff = 1 << 8,
-			AddBlend = 1 << 10,
-			MultBlend = 1 << 11,
-			Particles = 1 << 12,
-			StripParticles = 1 << 13,
-			Blood = 1 << 14,
-			Membrane = 1 << 15,
-			Lighting = 1 << 16,
-			ProjectedUv = 1 << 17,
-			Soft = 1 << 18,
-			GrayscaleToColor = 1 << 19,
-			GrayscaleToAlpha = 1 << 20,
-			IgnoreTexAlpha = 1 << 21,
-			MultBlendDecal = 1 << 22,
-			AlphaTest = 1 << 23,
-			SkyObject = 1 << 24,
-			MsnSpuSkinned = 1 << 25,
-			MotionVectorsNormals = 1 << 26,
-			Deferred = 1 << 27
-		};
-
-		enum class UtilityShaderFlags : uint64_t
-		{
-			Vc = 1 << 0,
-			Texture = 1 << 1,
-			Skinned = 1 << 2,
-			Normals = 1 << 3,
-			BinormalTangent = 1 << 4,
-			AlphaTest = 1 << 7,
-			LodLandscape = 1 << 8,
-			RenderNormal = 1 << 9,
-			RenderNormalFalloff = 1 << 10,
-			RenderNormalClamp = 1 << 11,
-			RenderNormalClear = 1 << 12,
-			RenderDepth = 1 << 13,
-			RenderShadowmap = 1 << 14,
-			RenderShadowmapClamped = 1 << 15,
-			GrayscaleToAlpha = 1 << 15,
-			RenderShadowmapPb = 1 << 16,
-			AdditionalAlphaMask = 1 << 16,
-			DepthWriteDecals = 1 << 17,
-			DebugShadowSplit = 1 << 18,
-			DebugColor = 1 << 19,
-			GrayscaleMask = 1 << 20,
-			RenderShadowmask = 1 << 21,
-			RenderShadowmaskSpot = 1 << 22,
-			RenderShadowmaskPb = 1 << 23,
-			RenderShadowmaskDpb = 1 << 24,
-			RenderBaseTexture = 1 << 25,
-			TreeAnim = 1 << 26,
-			LodObject = 1 << 27,
-			LocalMapFogOfWar = 1 << 28,
-			OpaqueEffect = 1 << 29,
-		};
+		using LightingShaderTechniques = ShaderDescriptors::LightingShaderTechniques;
+		using LightingShaderFlags = ShaderDescriptors::LightingShaderFlags;
+		using BloodSplatterShaderTechniques = ShaderDescriptors::BloodSplatterShaderTechniques;
+		using DistantTreeShaderTechniques = ShaderDescriptors::DistantTreeShaderTechniques;
+		using DistantTreeShaderFlags = ShaderDescriptors::DistantTreeShaderFlags;
+		using SkyShaderTechniques = ShaderDescriptors::SkyShaderTechniques;
+		using GrassShaderTechniques = ShaderDescriptors::GrassShaderTechniques;
+		using GrassShaderFlags = ShaderDescriptors::GrassShaderFlags;
+		using ParticleShaderTechniques = ShaderDescriptors::ParticleShaderTechniques;
+		using WaterShaderTechniques = ShaderDescriptors::WaterShaderTechniques;
+		using WaterShaderFlags = ShaderDescriptors::WaterShaderFlags;
+		using EffectShaderFlags = ShaderDescriptors::EffectShaderFlags;
+		using UtilityShaderFlags = ShaderDescriptors::UtilityShaderFlags;
 
 		uint blockedKeyIndex = (uint)-1;  // index in shaderMap; negative value indicates disabled
 		std::string blockedKey = "";
@@ -402,6 +271,11 @@ namespace SIE
 		ShaderCache();
 		void ManageCompilationSet(std::stop_token stoken);
 		void ProcessCompilationSet(std::stop_token stoken, SIE::ShaderCompilationTask task);
+		bool IsReplacementEnabled(ShaderClass shaderClass, const RE::BSShader& shader, uint32_t descriptor);
+
+		class DiskWarmLoadBackend;
+		template <ShaderClass Class>
+		void PublishWarmLoadedShaders(RE::BSShader::Type a_type, WarmLoad<ID3DBlob, ID3D11DeviceChild>& a_warmLoad);
 
 		~ShaderCache();
 
@@ -414,6 +288,7 @@ namespace SIE
 
 		bool isEnabled = true;
 		bool isDiskCache = true;
+		std::atomic<ShaderCacheEntry::Codec> diskCacheCodec = ShaderCacheEntry::Codec::LZ4;
 		bool isAsync = true;
 		bool isDump = false;
 		bool hideError = false;
@@ -428,6 +303,22 @@ namespace SIE
 		std::unordered_map<std::string, system_clock::time_point> modifiedShaderMap{};  // hashmap when a shader source file last modified
 		std::mutex modifiedMapMutex;
 
+		// deduplication of identical permutations, keyed by content hash
+		template <class T>
+		using PerShaderClassArray = std::array<std::array<T, static_cast<size_t>(ShaderClass::Total)>,
+			static_cast<size_t>(RE::BSShader::Type::Total)>;
+		PerShaderClassArray<BlobIndex<ID3DBlob>> blobIndices;
+		std::mutex blobIndicesMutex;
+		// not owning, each descriptor entry holds its own reference; guarded by the shaders mutexes
+		std::array<ankerl::unordered_dense::map<uint64_t, ID3D11VertexShader*>, static_cast<size_t>(RE::BSShader::Type::Total)> vertexShadersByHash;
+		std::array<ankerl::unordered_dense::map<uint64_t, ID3D11PixelShader*>, static_cast<size_t>(RE::BSShader::Type::Total)> pixelShadersByHash;
+
+		std::array<ankerl::unordered_dense::map<uint32_t, std::shared_ptr<const ShaderDefines>>,
+			static_cast<size_t>(RE::BSShader::Type::Total)>
+			shaderDefinesCache;
+		std::shared_mutex shaderDefinesMutex;
+		std::atomic<uint32_t> shaderDefinesGeneration = 1;  // bumped whenever feature defines may have changed
+
 		// efsw file watcher
 		efsw::FileWatcher* fileWatcher = nullptr;
 		efsw::WatchID watchID;
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "ShaderTools/ShaderCacheEntry.h"
+
+namespace SIE
+{
+	/**
+	 * Blobs of one shader type and class by the hash of their bytecode, so identical permutations share one blob.
+	 * A hash only shares a blob when the bytes match. Blob has GetBufferPointer and GetBufferSize like ID3DBlob.
+	 */
+	template <class Blob>
+	class BlobIndex
+	{
+	public:
+		struct Entry
+		{
+			Blob* blob;
+			ShaderReflection reflection;
+		};
+
+		/**
+		 * @return The registered blob with the bytes of a_blob, or a_blob when it is new or its hash belongs to other bytes
+		 */
+		Blob* Add(uint64_t a_hash, Blob* a_blob, const ShaderReflection& a_reflection)
+		{
+			auto [it, inserted] = blobs.try_emplace(a_hash, Entry{ a_blob, a_reflection });
+			if (inserted || SameBytes(*it->second.blob, *a_blob))
+				return it->second.blob;
+			return a_blob;
+		}
+
+		const Entry* Find(uint64_t a_hash) const
+		{
+			auto it = blobs.find(a_hash);
+			return it != blobs.end() ? &it->second : nullptr;
+		}
+
+		/**
+		 * Remember the bytecode a preprocessed source compiled to, so later permutations can skip compilation.
+		 * Kept only when a_blob, as returned by Add, is the blob registered for a_bytecodeHash.
+		 */
+		void AddSource(uint64_t a_sourceHash, uint64_t a_bytecodeHash, const Blob* a_blob)
+		{
+			auto entry = Find(a_bytecodeHash);
+			if (entry && entry->blob == a_blob)
+				bytecodeHashBySource.insert_or_assign(a_sourceHash, a_bytecodeHash);
+		}
+
+		Blob* FindForSource(uint64_t a_sourceHash) const
+		{
+			auto it = bytecodeHashBySource.find(a_sourceHash);
+			if (it == bytecodeHashBySource.end())
+				return nullptr;
+			auto entry = Find(it->second);
+			return entry ? entry->blob : nullptr;
+		}
+
+		void Clear()
+		{
+			blobs.clear();
+			bytecodeHashBySource.clear();
+		}
+
+	private:
+		static bool SameBytes(Blob& a_first, Blob& a_second)
+		{
+			return &a_first == &a_second ||
+			       (a_first.GetBufferSize() == a_second.GetBufferSize() &&
+					   std::memcmp(a_first.GetBufferPointer(), a_second.GetBufferPointer(), a_first.GetBufferSize()) == 0);
+		}
+
+		ankerl::unordered_dense::map<uint64_t, Entry> blobs;
+		ankerl::unordered_dense::map<uint64_t, uint64_t> bytecodeHashBySource;
+	};
+}
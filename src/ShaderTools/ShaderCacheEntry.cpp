@@ -0,0 +1,84 @@
+#include "ShaderCacheEntry.h"
+
+#include <lz4.h>
+#include <lz4hc.h>
+
+namespace SIE::ShaderCacheEntry
+{
+	static constexpr size_t PayloadOffset = sizeof(Header) + sizeof(ShaderReflection);
+
+	std::vector<uint8_t> Write(const ShaderReflection& a_reflection, std::span<const uint8_t> a_bytecode, Codec a_codec)
+	{
+		Header header{};
+		header.bytecodeSize = static_cast<uint32_t>(a_bytecode.size());
+		header.codec = a_codec;
+
+		std::vector<uint8_t> result;
+		if (a_codec == Codec::None) {
+			result.resize(PayloadOffset + a_bytecode.size());
+			memcpy(result.data() + PayloadOffset, a_bytecode.data(), a_bytecode.size());
+		} else {
+			const auto source = reinterpret_cast<const char*>(a_bytecode.data());
+			const auto sourceSize = static_cast<int>(a_bytecode.size());
+			result.resize(PayloadOffset + LZ4_compressBound(sourceSize));
+			const auto destination = reinterpret_cast<char*>(result.data() + PayloadOffset);
+			const auto capacity = static_cast<int>(result.size() - PayloadOffset);
+			const int compressedSize = a_codec == Codec::LZ4HC ?
+			                               LZ4_compress_HC(source, destination, sourceSize, capacity, LZ4HC_CLEVEL_DEFAULT) :
+			                               LZ4_compress_default(source, destination, sourceSize, capacity);
+			if (compressedSize <= 0 || static_cast<size_t>(compressedSize) >= a_bytecode.size()) {
+				// incompressible, store as is
+				return Write(a_reflection, a_bytecode, Codec::None);
+			}
+			result.resize(PayloadOffset + compressedSize);
+		}
+
+		memcpy(result.data(), &header, sizeof(Header));
+		memcpy(result.data() + sizeof(Header), &a_reflection, sizeof(ShaderReflection));
+		return result;
+	}
+
+	bool ReadHeader(std::span<const uint8_t> a_data, Header& a_header, ShaderReflection& a_reflection)
+	{
+		if (a_data.size() < PayloadOffset)
+			return false;
+
+		memcpy(&a_header, a_data.data(), sizeof(Header));
+		if (a_header.magic != Magic || a_header.formatVersion != FormatVersion || a_header.codec >= Codec::Total)
+			return false;
+
+		if (a_header.bytecodeSize > MaxBytecodeSize)
+			return false;
+
+		// Write only compresses bytecode that gets smaller
+		const size_t payloadSize = a_data.size() - PayloadOffset;
+		if (a_header.codec == Codec::None) {
+			if (payloadSize != a_header.bytecodeSize)
+				return false;
+		} else if (payloadSize == 0 || payloadSize >= a_header.bytecodeSize || a_header.bytecodeSize > payloadSize * MaxCompressionRatio) {
+			return false;
+		}
+
+		memcpy(&a_reflection, a_data.data() + sizeof(Header), sizeof(ShaderReflection));
+		return true;
+	}
+
+	bool ReadBytecode(std::span<const uint8_t> a_data, const Header& a_header, std::span<uint8_t> a_bytecode)
+	{
+		if (a_bytecode.size() != a_header.bytecodeSize)
+			return false;
+
+		const auto payload = a_data.subspan(PayloadOffset);
+		if (a_header.codec == Codec::None) {
+			if (payload.size() != a_bytecode.size())
+				return false;
+			memcpy(a_bytecode.data(), payload.data(), payload.size());
+			return true;
+		}
+
+		// LZ4 and LZ4HC share the block format
+		const int decompressedSize = LZ4_decompress_safe(reinterpret_cast<const char*>(payload.data()),
+			reinterpret_cast<char*>(a_bytecode.data()), static_cast<int>(payload.size()), static_cast<int>(a_bytecode.size()));
+		return decompressedSize == static_cast<int>(a_bytecode.size());
+	}
+}
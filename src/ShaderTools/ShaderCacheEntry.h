@@ -0,0 +1,70 @@
+#pragma once
+
+namespace SIE
+{
+	/**
+	 * Reflected data needed to set up a BSGraphics shader without running D3DReflect.
+	 */
+	struct ShaderReflection
+	{
+		static constexpr size_t MaxConstants = 64;
+
+		std::array<uint32_t, 3> bufferSizes{};  // PerTechnique, PerMaterial, PerGeometry sizes in 16 byte registers
+		std::array<int8_t, MaxConstants> constantOffsets{};
+		uint32_t pad0 = 0;  // explicit so the bytes written to disk are deterministic
+		uint64_t vertexDesc = 0;  // input layout derived from the vertex shader input signature
+	};
+	static_assert(std::is_trivially_copyable_v<ShaderReflection>);
+	static_assert(sizeof(ShaderReflection) == 88);
+
+	/**
+	 * On disk format of a bytecode entry in the shader disk cache.
+	 * Header, ShaderReflection, then the stripped bytecode, compressed with the codec in the header.
+	 */
+	namespace ShaderCacheEntry
+	{
+		static constexpr uint32_t Magic = 0x43535343;  // "CSSC"
+		static constexpr uint32_t FormatVersion = 1;
+		static constexpr uint32_t MaxBytecodeSize = 16 << 20;  // far above any shader, bounds the blob a corrupt header allocates
+		static constexpr uint32_t MaxCompressionRatio = 255;   // of the LZ4 block format, each byte of payload decodes to at most 255
+
+		enum class Codec : uint32_t
+		{
+			None = 0,
+			LZ4 = 1,    // fast compression and decompression
+			LZ4HC = 2,  // slower compression for smaller entries, decompresses as fast as LZ4
+			Total
+		};
+
+		struct Header
+		{
+			uint32_t magic = Magic;
+			uint32_t formatVersion = FormatVersion;
+			uint32_t bytecodeSize = 0;  // uncompressed
+			Codec codec = Codec::None;
+		};
+		static_assert(sizeof(Header) == 16);
+
+		std::vector<uint8_t> Write(const ShaderReflection& a_reflection, std::span<const uint8_t> a_bytecode, Codec a_codec = Codec::None);
+
+		/**
+		 * Parse the header and reflection of an entry.
+		 * 
+		 * @param a_data The full entry as read from disk
+		 * @param a_header Receives the header, bytecodeSize is the size ReadBytecode needs
+		 * @param a_reflection Receives the stored reflection
+		 * @return Whether the entry is valid for this format version and its payload can decode to bytecodeSize
+		 */
+		bool ReadHeader(std::span<const uint8_t> a_data, Header& a_header, ShaderReflection& a_reflection);
+
+		/**
+		 * Decompress the bytecode of an entry.
+		 * 
+		 * @param a_data The full entry as read from disk
+		 * @param a_header The header from ReadHeader
+		 * @param a_bytecode Destination of exactly a_header.bytecodeSize bytes
+		 * @return Whether the payload decoded to the expected size
+		 */
+		bool ReadBytecode(std::span<const uint8_t> a_data, const Header& a_header, std::span<uint8_t> a_bytecode);
+	}
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+namespace SIE
+{
+	enum class ShaderClass
+	{
+		Vertex,
+		Pixel,
+		Compute,
+		Total,
+	};
+
+	// Technique and flag bits of the shader descriptors, by shader type
+	struct ShaderDescriptors
+	{
+		enum class LightingShaderTechniques
+		{
+			None = 0,
+			Envmap = 1,
+			Glowmap = 2,
+			Parallax = 3,
+			Facegen = 4,
+			FacegenRGBTint = 5,
+			Hair = 6,
+			ParallaxOcc = 7,
+			MTLand = 8,
+			LODLand = 9,
+			Snow = 10,  // unused
+			MultilayerParallax = 11,
+			TreeAnim = 12,
+			LODObjects = 13,
+			MultiIndexSparkle = 14,
+			LODObjectHD = 15,
+			Eye = 16,
+			Cloud = 17,  // unused
+			LODLandNoise = 18,
+			MTLandLODBlend = 19,
+			Outline = 20,
+		};
+
+		enum class LightingShaderFlags
+		{
+			VC = 1 << 0,
+			Skinned = 1 << 1,
+			ModelSpaceNormals = 1 << 2,
+			// flags 3 to 8 are unused by vanilla
+			// Community Shaders start
+			Deferred = 1 << 4,
+			// Community Shaders end
+			Specular = 1 << 9,
+			SoftLighting = 1 << 10,
+			RimLighting = 1 << 11,
+			BackLighting = 1 << 12,
+			ShadowDir = 1 << 13,
+			DefShadow = 1 << 14,
+			ProjectedUV = 1 << 15,
+			AnisoLighting = 1 << 16,
+			AmbientSpecular = 1 << 17,
+			WorldMap = 1 << 18,
+			BaseObjectIsSnow = 1 << 19,
+			DoAlphaTest = 1 << 20,
+			Snow = 1 << 21,
+			CharacterLight = 1 << 22,
+			AdditionalAlphaMask = 1 << 23
+		};
+
+		enum class BloodSplatterShaderTechniques
+		{
+			Splatter = 0,
+			Flare = 1,
+		};
+
+		enum class DistantTreeShaderTechniques
+		{
+			DistantTreeBlock = 0,
+			Depth = 1,
+		};
+
+		enum class DistantTreeShaderFlags
+		{
+			Deferred = 1 << 8,
+			AlphaTest = 1 << 16,
+		};
+
+		enum class SkyShaderTechniques
+		{
+			SunOcclude = 0,
+			SunGlare = 1,
+			MoonAndStarsMask = 2,
+			Stars = 3,
+			Clouds = 4,
+			CloudsLerp = 5,
+			CloudsFade = 6,
+			Texture = 7,
+			Sky = 8,
+		};
+
+		enum class GrassShaderTechniques
+		{
+			RenderDepth = 8,
+		};
+
+		enum class GrassShaderFlags
+		{
+			AlphaTest = 0x10000,
+		};
+
+		enum class ParticleShaderTechniques
+		{
+			Particles = 0,
+			ParticlesGryColor = 1,
+			ParticlesGryAlpha = 2,
+			ParticlesGryColorAlpha = 3,
+			EnvCubeSnow = 4,
+			EnvCubeRain = 5,
+		};
+
+		enum class WaterShaderTechniques
+		{
+			Underwater = 8,
+			Lod = 9,
+			Stencil = 10,
+			Simple = 11,
+		};
+
+		enum class WaterShaderFlags
+		{
+			Vc = 1 << 0,
+			NormalTexCoord = 1 << 1,
+			Reflections = 1 << 2,
+			Refractions = 1 << 3,
+			Depth = 1 << 4,
+			Interior = 1 << 5,
+			Wading = 1 << 6,
+			VertexAlphaDepth = 1 << 7,
+			Cubemap = 1 << 8,
+			Flowmap = 1 << 9,
+			BlendNormals = 1 << 10,
+		};
+
+		enum class EffectShaderFlags
+		{
+			Vc = 1 << 0,
+			TexCoord = 1 << 1,
+			TexCoordIndex = 1 << 2,
+			Skinned = 1 << 3,
+			Normals = 1 << 4,
+			BinormalTangent = 1 << 5,
+			Texture = 1 << 6,
+			IndexedTexture = 1 << 7,
+			Falloff = 1 << 8,
+			AddBlend = 1 << 10,
+			MultBlend = 1 << 11,
+			Particles = 1 << 12,
+			StripParticles = 1 << 13,
+			Blood = 1 << 14,
+			Membrane = 1 << 15,
+			Lighting = 1 << 16,
+			ProjectedUv = 1 << 17,
+			Soft = 1 << 18,
+			GrayscaleToColor = 1 << 19,
+			GrayscaleToAlpha = 1 << 20,
+			IgnoreTexAlpha = 1 << 21,
+			MultBlendDecal = 1 << 22,
+			AlphaTest = 1 << 23,
+			SkyObject = 1 << 24,
+			MsnSpuSkinned = 1 << 25,
+			MotionVectorsNormals = 1 << 26,
+			Deferred = 1 << 27
+		};
+
+		enum class UtilityShaderFlags : uint64_t
+		{
+			Vc = 1 << 0,
+			Texture = 1 << 1,
+			Skinned = 1 << 2,
+			Normals = 1 << 3,
+			BinormalTangent = 1 << 4,
+			AlphaTest = 1 << 7,
+			LodLandscape = 1 << 8,
+			RenderNormal = 1 << 9,
+			RenderNormalFalloff = 1 << 10,
+			RenderNormalClamp = 1 << 11,
+			RenderNormalClear = 1 << 12,
+			RenderDepth = 1 << 13,
+			RenderShadowmap = 1 << 14,
+			RenderShadowmapClamped = 1 << 15,
+			GrayscaleToAlpha = 1 << 15,
+			RenderShadowmapPb = 1 << 16,
+			AdditionalAlphaMask = 1 << 16,
+			DepthWriteDecals = 1 << 17,
+			DebugShadowSplit = 1 << 18,
+			DebugColor = 1 << 19,
+			GrayscaleMask = 1 << 20,
+			RenderShadowmask = 1 << 21,
+			RenderShadowmaskSpot = 1 << 22,
+			RenderShadowmaskPb = 1 << 23,
+			RenderShadowmaskDpb = 1 << 24,
+			RenderBaseTexture = 1 << 25,
+			TreeAnim = 1 << 26,
+			LodObject = 1 << 27,
+			LocalMapFogOfWar = 1 << 28,
+			OpaqueEffect = 1 << 29,
+		};
+	};
+}
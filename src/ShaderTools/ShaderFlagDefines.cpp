@@ -0,0 +1,232 @@
+#include "ShaderFlagDefines.h"
+
+#include "ShaderDescriptors.h"
+
+namespace SIE::SShaderCache
+{
+	static constexpr std::array DistantTreeShaderFlagDefines = {
+		MakeFlagDefine(ShaderDescriptors::DistantTreeShaderFlags::AlphaTest, "DO_ALPHA_TEST"),
+		MakeFlagDefine(ShaderDescriptors::DistantTreeShaderFlags::Deferred, "DEFERRED"),
+	};
+
+	static constexpr std::array GrassShaderFlagDefines = {
+		MakeFlagDefine(ShaderDescriptors::GrassShaderFlags::AlphaTest, "DO_ALPHA_TEST"),
+	};
+
+	static constexpr std::array EffectShaderFlagDefines = {
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::Vc, "VC"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::TexCoord, "TEXCOORD"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::TexCoordIndex, "TEXCOORD_INDEX"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::Skinned, "SKINNED"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::Normals, "NORMALS"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::BinormalTangent, "BINORMAL_TANGENT"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::Texture, "TEXTURE"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::IndexedTexture, "INDEXED_TEXTURE"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::Falloff, "FALLOFF"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::AddBlend, "ADDBLEND"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::MultBlend, "MULTBLEND"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::Particles, "PARTICLES"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::StripParticles, "STRIP_PARTICLES"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::Blood, "BLOOD"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::Membrane, "MEMBRANE"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::Lighting, "LIGHTING"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::ProjectedUv, "PROJECTED_UV"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::Soft, "SOFT"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::GrayscaleToColor, "GRAYSCALE_TO_COLOR"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::GrayscaleToAlpha, "GRAYSCALE_TO_ALPHA"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::IgnoreTexAlpha, "IGNORE_TEX_ALPHA"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::MultBlendDecal, "MULTBLEND_DECAL"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::AlphaTest, "ALPHA_TEST"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::SkyObject, "SKY_OBJECT"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::MsnSpuSkinned, "MSN_SPU_SKINNED"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::MotionVectorsNormals, "MOTIONVECTORS_NORMALS"),
+		MakeFlagDefine(ShaderDescriptors::EffectShaderFlags::Deferred, "DEFERRED"),
+	};
+
+	static constexpr std::array WaterShaderFlagDefines = {
+		MakeFlagDefine(ShaderDescriptors::WaterShaderFlags::Vc, "VC"),
+		MakeFlagDefine(ShaderDescriptors::WaterShaderFlags::NormalTexCoord, "NORMAL_TEXCOORD"),
+		MakeFlagDefine(ShaderDescriptors::WaterShaderFlags::Reflections, "REFLECTIONS"),
+		MakeFlagDefine(ShaderDescriptors::WaterShaderFlags::Refractions, "REFRACTIONS"),
+		MakeFlagDefine(ShaderDescriptors::WaterShaderFlags::Depth, "DEPTH"),
+		MakeFlagDefine(ShaderDescriptors::WaterShaderFlags::Interior, "INTERIOR"),
+		MakeFlagDefine(ShaderDescriptors::WaterShaderFlags::Wading, "WADING"),
+		MakeFlagDefine(ShaderDescriptors::WaterShaderFlags::VertexAlphaDepth, "VERTEX_ALPHA_DEPTH"),
+		MakeFlagDefine(ShaderDescriptors::WaterShaderFlags::Cubemap, "CUBEMAP"),
+		MakeFlagDefine(ShaderDescriptors::WaterShaderFlags::Flowmap, "FLOWMAP"),
+		MakeFlagDefine(ShaderDescriptors::WaterShaderFlags::BlendNormals, "BLEND_NORMALS"),
+	};
+
+	static constexpr std::array UtilityShaderVertexFlagDefines = {
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::Vc, "VC"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::Texture, "TEXTURE"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::Skinned, "SKINNED"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::Normals, "NORMALS"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::AlphaTest, "ALPHA_TEST"),
+	};
+
+	static constexpr std::array UtilityShaderRenderFlagDefines = {
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::RenderNormalFalloff, "RENDER_NORMAL_FALLOFF"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::RenderNormalClamp, "RENDER_NORMAL_CLAMP"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::RenderDepth, "RENDER_DEPTH"),
+	};
+
+	static constexpr std::array UtilityShaderMaskFlagDefines = {
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::GrayscaleMask, "GRAYSCALE_MASK"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::RenderShadowmask, "RENDER_SHADOWMASK"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::RenderShadowmaskSpot, "RENDER_SHADOWMASKSPOT"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::RenderShadowmaskPb, "RENDER_SHADOWMASKPB"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::RenderShadowmaskDpb, "RENDER_SHADOWMASKDPB"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::RenderBaseTexture, "RENDER_BASE_TEXTURE"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::TreeAnim, "TREE_ANIM"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::LodObject, "LOD_OBJECT"),
+		MakeFlagDefine(ShaderDescriptors::UtilityShaderFlags::LocalMapFogOfWar, "LOCALMAP_FOGOFWAR"),
+	};
+
+	void AppendFlagDefines(uint32_t descriptor, std::span<const FlagDefine> table, ShaderMacro* defines, int& lastIndex)
+	{
+		for (const auto& define : table) {
+			if (descriptor & define.mask) {
+				defines[lastIndex++] = { define.name, nullptr };
+			}
+		}
+	}
+
+	void AppendDistantTreeShaderDescriptorDefines(uint32_t descriptor, ShaderMacro* defines, int& lastIndex)
+	{
+		const auto technique = descriptor & 1;
+		if (technique == static_cast<uint32_t>(ShaderDescriptors::DistantTreeShaderTechniques::Depth)) {
+			defines[lastIndex++] = { "RENDER_DEPTH", nullptr };
+		}
+
+		AppendFlagDefines(descriptor, DistantTreeShaderFlagDefines, defines, lastIndex);
+	}
+
+	void AppendGrassShaderDescriptorDefines(uint32_t descriptor, ShaderMacro* defines, int& lastIndex)
+	{
+		const auto technique = descriptor & 0b1111;
+		if (technique == static_cast<uint32_t>(ShaderDescriptors::GrassShaderTechniques::RenderDepth)) {
+			defines[lastIndex++] = { "RENDER_DEPTH", nullptr };
+		}
+
+		AppendFlagDefines(descriptor, GrassShaderFlagDefines, defines, lastIndex);
+	}
+
+	void AppendEffectShaderDescriptorDefines(uint32_t descriptor, ShaderMacro* defines, int& lastIndex)
+	{
+		AppendFlagDefines(descriptor, EffectShaderFlagDefines, defines, lastIndex);
+	}
+
+	void AppendWaterShaderDescriptorDefines(uint32_t descriptor, ShaderMacro* defines, int& lastIndex)
+	{
+		defines[lastIndex++] = { "WATER", nullptr };
+		defines[lastIndex++] = { "FOG", nullptr };
+
+		AppendFlagDefines(descriptor, WaterShaderFlagDefines, defines, lastIndex);
+
+		const auto technique = (descriptor >> 11) & 0xF;
+		if (technique == static_cast<uint32_t>(ShaderDescriptors::WaterShaderTechniques::Underwater)) {
+			defines[lastIndex++] = { "UNDERWATER", nullptr };
+		} else if (technique == static_cast<uint32_t>(ShaderDescriptors::WaterShaderTechniques::Lod)) {
+			defines[lastIndex++] = { "LOD", nullptr };
+		} else if (technique == static_cast<uint32_t>(ShaderDescriptors::WaterShaderTechniques::Stencil)) {
+			defines[lastIndex++] = { "STENCIL", nullptr };
+		} else if (technique == static_cast<uint32_t>(ShaderDescriptors::WaterShaderTechniques::Simple)) {
+			defines[lastIndex++] = { "SIMPLE", nullptr };
+		} else if (technique < 8) {
+			static constexpr std::array<const char*, 8> numLightDefines = { { "0", "1", "2", "3", "4",
+				"5", "6", "7" } };
+			defines[lastIndex++] = { "SPECULAR", nullptr };
+			defines[lastIndex++] = { "NUM_SPECULAR_LIGHTS", numLightDefines[technique] };
+		}
+	}
+
+	void AppendUtilityShaderDescriptorDefines(uint32_t descriptor, ShaderMacro* defines, int& lastIndex)
+	{
+		using enum ShaderDescriptors::UtilityShaderFlags;
+
+		AppendFlagDefines(descriptor, UtilityShaderVertexFlagDefines, defines, lastIndex);
+
+		if (descriptor & static_cast<uint32_t>(LodLandscape)) {
+			if (descriptor &
+				(static_cast<uint32_t>(RenderShadowmask) |
+					static_cast<uint32_t>(RenderShadowmaskSpot))) {
+				defines[lastIndex++] = { "FOCUS_SHADOW", nullptr };
+			} else {
+				defines[lastIndex++] = { "LOD_LANDSCAPE", nullptr };
+			}
+		}
+
+		if ((descriptor & static_cast<uint32_t>(RenderNormal)) &&
+			!(descriptor & static_cast<uint32_t>(RenderNormalClear))) {
+			defines[lastIndex++] = { "RENDER_NORMAL", nullptr };
+		} else if (!(descriptor & static_cast<uint32_t>(RenderNormal)) &&
+				   (descriptor & static_cast<uint32_t>(RenderNormalClear))) {
+			defines[lastIndex++] = { "RENDER_NORMAL_CLEAR", nullptr };
+		} else if ((descriptor & static_cast<uint32_t>(RenderNormal)) &&
+				   (descriptor & static_cast<uint32_t>(RenderNormalClear))) {
+			defines[lastIndex++] = { "STENCIL_ABOVE_WATER", nullptr };
+		}
+
+		AppendFlagDefines(descriptor, UtilityShaderRenderFlagDefines, defines, lastIndex);
+
+		if (descriptor & static_cast<uint32_t>(OpaqueEffect)) {
+			defines[lastIndex++] = { "OPAQUE_EFFECT", nullptr };
+			if (!(descriptor & static_cast<uint32_t>(RenderShadowmap)) &&
+				(descriptor & static_cast<uint32_t>(AdditionalAlphaMask))) {
+				defines[lastIndex++] = { "ADDITIONAL_ALPHA_MASK", nullptr };
+			}
+			if (descriptor & static_cast<uint32_t>(GrayscaleToAlpha)) {
+				defines[lastIndex++] = { "GRAYSCALE_TO_ALPHA", nullptr };
+			}
+		} else {
+			if (descriptor & static_cast<uint32_t>(RenderShadowmap)) {
+				defines[lastIndex++] = { "RENDER_SHADOWMAP", nullptr };
+				if (descriptor & static_cast<uint32_t>(RenderShadowmapPb)) {
+					defines[lastIndex++] = { "RENDER_SHADOWMAP_PB", nullptr };
+				}
+			} else if (descriptor &
+					   static_cast<uint32_t>(AdditionalAlphaMask)) {
+				defines[lastIndex++] = { "ADDITIONAL_ALPHA_MASK", nullptr };
+			}
+			if (descriptor & static_cast<uint32_t>(RenderShadowmapClamped)) {
+				defines[lastIndex++] = { "RENDER_SHADOWMAP_CLAMPED", nullptr };
+			}
+		}
+
+		AppendFlagDefines(descriptor, UtilityShaderMaskFlagDefines, defines, lastIndex);
+
+		if (descriptor & (static_cast<uint32_t>(RenderShadowmask) |
+							 static_cast<uint32_t>(RenderShadowmaskDpb) |
+							 static_cast<uint32_t>(RenderShadowmaskPb) |
+							 static_cast<uint32_t>(RenderShadowmaskSpot))) {
+			static constexpr std::array<const char*, 5> shadowFilters = { { "0", "1", "2",
+				"3", "4" } };
+			const size_t shadowFilterIndex = std::clamp((descriptor >> 17) & 0b111, 0u, 4u);
+			defines[lastIndex++] = { "SHADOWFILTER", shadowFilters[shadowFilterIndex] };
+		} else if ((!(descriptor & static_cast<uint32_t>(OpaqueEffect)) &&
+					   (descriptor &
+						   static_cast<uint32_t>(RenderShadowmap))) ||
+				   (descriptor & static_cast<uint32_t>(RenderDepth))) {
+			if (descriptor & static_cast<uint32_t>(DepthWriteDecals)) {
+				defines[lastIndex++] = { "DEPTH_WRITE_DECALS", nullptr };
+			}
+		} else {
+			if (descriptor & (static_cast<uint32_t>(DepthWriteDecals) |
+								 static_cast<uint32_t>(DebugColor))) {
+				defines[lastIndex++] = { "DEBUG_COLOR", nullptr };
+			}
+			if (descriptor & static_cast<uint32_t>(DebugShadowSplit)) {
+				defines[lastIndex++] = { "DEBUG_SHADOWSPLIT", nullptr };
+			}
+		}
+
+		defines[lastIndex++] = { "SHADOWSPLITCOUNT", "3" };
+
+		if ((descriptor & 0x14000) != 0x14000 &&
+			((descriptor & 0x20004000) == 0x4000 || (descriptor & 0x1E02000) == 0x2000) &&
+			!(descriptor & 0x80) && (descriptor & 0x14000) != 0x10000) {
+			defines[lastIndex++] = { "NO_PIXEL_SHADER", nullptr };
+		}
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+namespace SIE::SShaderCache
+{
+	// Layout of D3D_SHADER_MACRO, so the tables do not depend on the D3D headers
+	struct ShaderMacro
+	{
+		const char* Name;
+		const char* Definition;
+	};
+
+	struct FlagDefine
+	{
+		uint32_t mask;
+		const char* name;
+	};
+
+	template <class Flags>
+	constexpr FlagDefine MakeFlagDefine(Flags flag, const char* name)
+	{
+		return { static_cast<uint32_t>(flag), name };
+	}
+
+	void AppendFlagDefines(uint32_t descriptor, std::span<const FlagDefine> table, ShaderMacro* defines, int& lastIndex);
+
+	// Descriptor dependent defines of each shader type, without feature defines or the terminator.
+	void AppendDistantTreeShaderDescriptorDefines(uint32_t descriptor, ShaderMacro* defines, int& lastIndex);
+	void AppendGrassShaderDescriptorDefines(uint32_t descriptor, ShaderMacro* defines, int& lastIndex);
+	void AppendEffectShaderDescriptorDefines(uint32_t descriptor, ShaderMacro* defines, int& lastIndex);
+	void AppendWaterShaderDescriptorDefines(uint32_t descriptor, ShaderMacro* defines, int& lastIndex);
+	void AppendUtilityShaderDescriptorDefines(uint32_t descriptor, ShaderMacro* defines, int& lastIndex);
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "ShaderTools/ShaderDescriptors.h"
+
+#include <execution>
+
+namespace SIE
+{
+	/**
+	 * Disk cache and device access of warm loading. Load and Create are called from several threads at once.
+	 */
+	template <class Blob, class Object>
+	class WarmLoadBackend
+	{
+	public:
+		virtual ~WarmLoadBackend() = default;
+
+		/**
+		 * @return Whether a descriptor is replaced, not loaded yet and has a disk cache entry
+		 */
+		virtual bool IsLoadable(ShaderClass a_class, uint32_t a_descriptor) = 0;
+
+		/**
+		 * @return Shader string of a descriptor, as compared against the blocked key
+		 */
+		virtual std::string GetKey(ShaderClass a_class, uint32_t a_descriptor) = 0;
+
+		/**
+		 * Read and decode the disk cache entry of a descriptor and register its bytecode.
+		 * @param o_hash Receives the hash of the bytecode
+		 * @return The blob, nullptr when the entry is missing or invalid
+		 */
+		virtual Blob* Load(ShaderClass a_class, uint32_t a_descriptor, uint64_t& o_hash) = 0;
+
+		/**
+		 * @return Whether a loaded permutation already has an object of the bytecode
+		 */
+		virtual bool HasObject(ShaderClass a_class, uint64_t a_hash) = 0;
+
+		/**
+		 * @return A new object of the bytecode, nullptr when the device rejects it
+		 */
+		virtual Object* Create(ShaderClass a_class, Blob& a_blob) = 0;
+
+		virtual void Release(Object& a_object) = 0;
+	};
+
+	/**
+	 * Loads the disk cached permutations of one shader: enumerates the descriptors worth loading, decodes their entries
+	 * in parallel, then creates one object per new bytecode in parallel. Publishing the results is left to the caller.
+	 */
+	template <class Blob, class Object>
+	class WarmLoad
+	{
+	public:
+		struct Entry
+		{
+			ShaderClass shaderClass;
+			uint32_t descriptor;
+			Blob* blob = nullptr;  // nullptr when the entry failed to load
+			uint64_t hash = 0;
+		};
+
+		explicit WarmLoad(WarmLoadBackend<Blob, Object>& a_backend) :
+			backend(a_backend) {}
+
+		WarmLoad(const WarmLoad&) = delete;
+		WarmLoad& operator=(const WarmLoad&) = delete;
+
+		~WarmLoad()
+		{
+			for (auto& classObjects : objects) {
+				for (auto& [hash, object] : classObjects) {
+					if (object)
+						backend.Release(*object);
+				}
+			}
+		}
+
+		/**
+		 * Add each loadable descriptor once, skipping the one of a_blockedKey, which GetVertexShader/GetPixelShader record.
+		 * @param a_blockedKey Empty when no shader is blocked
+		 */
+		void Enumerate(ShaderClass a_class, std::span<const uint32_t> a_descriptors, std::string_view a_blockedKey)
+		{
+			std::vector<uint32_t> unique(a_descriptors.begin(), a_descriptors.end());
+			std::ranges::sort(unique);
+			unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+			for (auto descriptor : unique) {
+				if (!a_blockedKey.empty() && backend.GetKey(a_class, descriptor) == a_blockedKey)
+					continue;
+				if (backend.IsLoadable(a_class, descriptor))
+					entries.push_back({ a_class, descriptor });
+			}
+		}
+
+		// Disk stage, reads and decodes every entry in parallel
+		void Load()
+		{
+			std::for_each(std::execution::par, entries.begin(), entries.end(), [this](Entry& entry) {
+				entry.blob = backend.Load(entry.shaderClass, entry.descriptor, entry.hash);
+			});
+		}
+
+		// Device stage, creates one object per bytecode of a_class that no loaded permutation has an object of, in parallel
+		void Create(ShaderClass a_class)
+		{
+			auto& classObjects = objects[static_cast<size_t>(a_class)];
+			std::vector<std::pair<uint64_t, Blob*>> created;
+			for (const auto& entry : entries) {
+				if (entry.shaderClass == a_class && entry.blob && !classObjects.contains(entry.hash) && !backend.HasObject(a_class, entry.hash)) {
+					classObjects.emplace(entry.hash, nullptr);
+					created.emplace_back(entry.hash, entry.blob);
+				}
+			}
+
+			std::vector<Object*> results(created.size(), nullptr);
+			std::for_each(std::execution::par, created.begin(), created.end(), [&](const auto& pair) {
+				results[&pair - created.data()] = backend.Create(a_class, *pair.second);
+			});
+			for (size_t i = 0; i < created.size(); ++i)
+				classObjects[created[i].first] = results[i];
+		}
+
+		const std::vector<Entry>& GetEntries() const { return entries; }
+
+		/**
+		 * @return The object created for a bytecode, owned by the caller from now on; nullptr when none was created or it failed
+		 */
+		Object* TakeObject(ShaderClass a_class, uint64_t a_hash)
+		{
+			auto& classObjects = objects[static_cast<size_t>(a_class)];
+			auto it = classObjects.find(a_hash);
+			return it != classObjects.end() ? std::exchange(it->second, nullptr) : nullptr;
+		}
+
+	private:
+		WarmLoadBackend<Blob, Object>& backend;
+		std::vector<Entry> entries;
+		std::array<ankerl::unordered_dense::map<uint64_t, Object*>, static_cast<size_t>(ShaderClass::Total)> objects;  // released on destruction unless taken
+	};
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// Shadow constants of the game's shadowmask draw, gathered into one structured buffer for the deferred passes
+namespace ShadowCopyLayout
+{
+	// Same as PerGeometry in CopyShadowData.hlsl and ShadowSampling.hlsli
+	struct alignas(16) PerGeometry
+	{
+		float4 VPOSOffset;
+		float4 ShadowSampleParam;    // fPoissonRadiusScale / iShadowMapResolution in z and w
+		float4 EndSplitDistances;    // cascade end distances int xyz, cascade count int z
+		float4 StartSplitDistances;  // cascade start ditances int xyz, 4 int z
+		float4 FocusShadowFadeParam;
+		float4 DebugColor;
+		float4 PropertyColor;
+		float4 AlphaTestRef;
+		float4 ShadowLightParam;  // Falloff in x, ShadowDistance squared in z
+		DirectX::XMFLOAT4X3 FocusShadowMapProj[4];
+		// Since PerGeometry is passed between c++ and hlsl, can't have different defines due to strong typing
+		DirectX::XMFLOAT4X3 ShadowMapProj[2][3];
+		DirectX::XMFLOAT4X4 CameraViewProjInverse[2];  // row major, as in the camera constants
+	};
+
+	// Constants copied into PerGeometry as they are laid out in the pixel shader buffers of the shadowmask draw
+	struct Region
+	{
+		uint slot;         // pixel shader constant buffer
+		uint firstVector;  // first float4 register in that buffer
+		uint numVectors;
+		uint dstOffset;  // bytes into PerGeometry
+	};
+
+	/**
+	 * @return Regions that together fill PerGeometry, the flat game repeats its single eye
+	 */
+	inline std::span<const Region> GetRegions(bool a_vr)
+	{
+		// PerFrame3 in b0, PerFrame in b2 and PerFrame2 in b12, see CopyShadowData.hlsl
+		static const Region flat[] = {
+			{ 0, 0, 5, offsetof(PerGeometry, VPOSOffset) },
+			{ 2, 0, 25, offsetof(PerGeometry, DebugColor) },  // up to and including ShadowMapProj[0]
+			{ 2, 16, 9, offsetof(PerGeometry, ShadowMapProj[1]) },
+			{ 12, 32, 4, offsetof(PerGeometry, CameraViewProjInverse[0]) },
+			{ 12, 32, 4, offsetof(PerGeometry, CameraViewProjInverse[1]) },
+		};
+
+		static const Region vr[] = {
+			{ 0, 0, 5, offsetof(PerGeometry, VPOSOffset) },
+			{ 2, 0, 4, offsetof(PerGeometry, DebugColor) },
+			{ 2, 5, 12, offsetof(PerGeometry, FocusShadowMapProj) },
+			{ 2, 29, 18, offsetof(PerGeometry, ShadowMapProj) },
+			{ 12, 64, 8, offsetof(PerGeometry, CameraViewProjInverse) },
+		};
+
+		if (a_vr)
+			return vr;
+		return flat;
+	}
+}
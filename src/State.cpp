@@ -164,8 +164,12 @@ void State::Load(ConfigMode a_configMode)
 			shaderCache.backgroundCompilationThreadCount = std::clamp(advanced["Background Compiler Threads"].get<int32_t>(), 1, static_cast<int32_t>(std::thread::hardware_concurrency()));
 		if (advanced["Use FileWatcher"].is_boolean())
 			shaderCache.SetFileWatcher(advanced["Use FileWatcher"]);
+		if (advanced["Disk Cache Compression"].is_number_integer())
+			shaderCache.SetDiskCacheCodec(static_cast<SIE::ShaderCacheEntry::Codec>(advanced["Disk Cache Compression"].get<uint32_t>()));
 		if (advanced["Extended Frame Annotations"].is_boolean())
 			extendedFrameAnnotations = advanced["Extended Frame Annotations"];
+		if (advanced["G-Buffer Layout"].is_number_integer())
+			Deferred::GetSingleton()->gbufferLayout = static_cast<Deferred::GBufferLayout>(std::clamp(advanced["G-Buffer Layout"].get<uint32_t>(), 0u, 1u));
 	}
 
 	if (settings["General"].is_object()) {
@@ -193,6 +197,7 @@ void State::Load(ConfigMode a_configMode)
 
 	for (auto* feature : Feature::GetFeatureList())
 		feature->Load(settings);
+	shaderCache.InvalidateShaderDefines();
 	i.close();
 	if (settings["Version"].is_string() && settings["Version"].get<std::string>() != Plugin::VERSION.string()) {
 		logger::info("Found older config for version {}; upgrading to {}", (std::string)settings["Version"], Plugin::VERSION.string());
@@ -216,7 +221,9 @@ void State::Save(ConfigMode a_configMode)
 	advanced["Compiler Threads"] = shaderCache.compilationThreadCount;
 	advanced["Background Compiler Threads"] = shaderCache.backgroundCompilationThreadCount;
 	advanced["Use FileWatcher"] = shaderCache.UseFileWatcher();
+	advanced["Disk Cache Compression"] = static_cast<uint32_t>(shaderCache.GetDiskCacheCodec());
 	advanced["Extended Frame Annotations"] = extendedFrameAnnotations;
+	advanced["G-Buffer Layout"] = static_cast<uint32_t>(Deferred::GetSingleton()->gbufferLayout);
 	settings["Advanced"] = advanced;
 
 	json general;
@@ -341,6 +348,7 @@ void State::SetupResources()
 
 	permutationCB = new ConstantBuffer(ConstantBufferDesc<PermutationCB>());
 	sharedDataCB = new ConstantBuffer(ConstantBufferDesc<SharedDataCB>());
+	sharedViewCB = new ConstantBuffer(ConstantBufferDesc<SharedViewCB>());
 
 	auto [data, size] = GetFeatureBufferData();
 	featureDataCB = new ConstantBuffer(ConstantBufferDesc((uint32_t)size));
@@ -466,35 +474,41 @@ void State::SetPerfMarker(std::string_view title)
 
 void State::UpdateSharedData()
 {
+	// shared by the graphics and the compute constants
+	const auto& shaderManager = RE::BSShaderManager::State::GetSingleton();
+	DirectX::XMFLOAT3X4 directionalAmbient;
+	Util::StoreTransform3x4NoScale(directionalAmbient, shaderManager.directionalAmbientTransform);
+
+	float4 cameraData = Util::GetCameraData();
+	float4 bufferDim = { screenSize.x, screenSize.y, 1.0f / screenSize.x, 1.0f / screenSize.y };
+
+	auto imageSpaceManager = RE::ImageSpaceManager::GetSingleton();
+	auto viewport = RE::BSGraphics::State::GetSingleton();
+
+	auto bTAA = !REL::Module::IsVR() ? imageSpaceManager->GetRuntimeData().BSImagespaceShaderISTemporalAA->taaEnabled :
+	                                   imageSpaceManager->GetVRRuntimeData().BSImagespaceShaderISTemporalAA->taaEnabled;
+	uint frameCount = viewport->frameCount * (bTAA || upscalerLoaded);
+
 	{
 		SharedDataCB data{};
 
-		const auto& shaderManager = RE::BSShaderManager::State::GetSingleton();
-		const RE::NiTransform& dalcTransform = shaderManager.directionalAmbientTransform;
-		Util::StoreTransform3x4NoScale(data.DirectionalAmbient, dalcTransform);
+		data.DirectionalAmbient = directionalAmbient;
 
 		auto shadowSceneNode = RE::BSShaderManager::State::GetSingleton().shadowSceneNode[0];
 		auto dirLight = skyrim_cast<RE::NiDirectionalLight*>(shadowSceneNode->GetRuntimeData().sunLight->light.get());
 
 		data.DirLightColor = { dirLight->GetLightRuntimeData().diffuse.red, dirLight->GetLightRuntimeData().diffuse.green, dirLight->GetLightRuntimeData().diffuse.blue, 1.0f };
 
-		auto imageSpaceManager = RE::ImageSpaceManager::GetSingleton();
 		data.DirLightColor *= !isVR ? imageSpaceManager->GetRuntimeData().data.baseData.hdr.sunlightScale : imageSpaceManager->GetVRRuntimeData().data.baseData.hdr.sunlightScale;
 
 		const auto& direction = dirLight->GetWorldDirection();
 		data.DirLightDirection = { -direction.x, -direction.y, -direction.z, 0.0f };
 		data.DirLightDirection.Normalize();
 
-		data.CameraData = Util::GetCameraData();
-		data.BufferDim = { screenSize.x, screenSize.y, 1.0f / screenSize.x, 1.0f / screenSize.y };
+		data.CameraData = cameraData;
+		data.BufferDim = bufferDim;
 		data.Timer = timer;
-
-		auto viewport = RE::BSGraphics::State::GetSingleton();
-
-		auto bTAA = !REL::Module::IsVR() ? imageSpaceManager->GetRuntimeData().BSImagespaceShaderISTemporalAA->taaEnabled :
-		                                   imageSpaceManager->GetVRRuntimeData().BSImagespaceShaderISTemporalAA->taaEnabled;
-
-		data.FrameCount = viewport->frameCount * (bTAA || State::GetSingleton()->upscalerLoaded);
+		data.FrameCount = frameCount;
 
 		for (int i = -2; i <= 2; i++) {
 			for (int k = -2; k <= 2; k++) {
@@ -506,6 +520,37 @@ void State::UpdateSharedData()
 		sharedDataCB->Update(data);
 	}
 
+	{
+		SharedViewCB data{};
+
+		data.BufferDim = bufferDim;
+		data.CameraData = cameraData;
+		data.DirectionalAmbient = directionalAmbient;
+		data.FrameCount = frameCount;
+		data.FrameCountAlwaysActive = viewport->frameCount;
+
+		float2 dynres = Util::ConvertToDynamic(screenSize);
+		data.FrameDim = { floor(dynres.x), floor(dynres.y) };
+		data.RcpFrameDim = float2(1.0f) / data.FrameDim;
+
+		for (int eyeIndex = 0; eyeIndex < (1 + isVR); ++eyeIndex) {
+			auto eye = Util::GetCameraData(eyeIndex);
+
+			if (eyeIndex == 0)
+				data.ProjScale = { eye.projMat(0, 0), eye.projMat(1, 1) };
+
+			data.NDCToViewMul[eyeIndex] = { 2.0f / eye.projMat(0, 0), -2.0f / eye.projMat(1, 1) };
+			data.NDCToViewAdd[eyeIndex] = { -1.0f / eye.projMat(0, 0), 1.0f / eye.projMat(1, 1) };
+			if (isVR)
+				data.NDCToViewMul[eyeIndex].x *= 2;
+
+			data.PrevInvViewMat[eyeIndex] = prevInvView[eyeIndex];
+			prevInvView[eyeIndex] = eye.viewMat.Invert();
+		}
+
+		sharedViewCB->Update(data);
+	}
+
 	{
 		auto [data, size] = GetFeatureBufferData();
 
@@ -132,6 +132,28 @@ public:
 	ConstantBuffer* sharedDataCB = nullptr;
 	ConstantBuffer* featureDataCB = nullptr;
 
+	// per-frame view constants of deferred and screen-space compute passes, PerFrameDeferredShared in DeferredShared.hlsli
+	struct alignas(16) SharedViewCB
+	{
+		float4 BufferDim;
+		float4 CameraData;
+		DirectX::XMFLOAT3X4 DirectionalAmbient;
+		uint FrameCount;
+		uint FrameCountAlwaysActive;
+		float2 FrameDim;  // dynamic resolution
+		float2 RcpFrameDim;
+		float2 ProjScale;  // projection x and y scale of the first eye
+		float2 NDCToViewMul[2];
+		float2 NDCToViewAdd[2];
+		float4x4 PrevInvViewMat[2];
+	};
+	static_assert(offsetof(SharedViewCB, NDCToViewMul) == 112 && offsetof(SharedViewCB, PrevInvViewMat) == 144);  // float4 packed in HLSL
+
+	static constexpr uint SharedViewSlot = 11;
+
+	ConstantBuffer* sharedViewCB = nullptr;
+	float4x4 prevInvView[2] = {};
+
 	// Skyrim constants
 	bool isVR = false;
 	float2 screenSize = {};
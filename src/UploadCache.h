@@ -0,0 +1,24 @@
+#pragma once
+
+// bytes of the last upload, so buffers derived from settings are only uploaded when they change
+class UploadCache
+{
+public:
+	// true and remembered when the data differs from the last call
+	template <typename T>
+	bool Changed(T const& src_data)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		auto bytes = reinterpret_cast<const std::byte*>(&src_data);
+		if (lastData.size() == sizeof(T) && std::equal(bytes, bytes + sizeof(T), lastData.begin()))
+			return false;
+
+		lastData.assign(bytes, bytes + sizeof(T));
+		return true;
+	}
+
+	void Invalidate() { lastData.clear(); }
+
+private:
+	std::vector<std::byte> lastData;
+};
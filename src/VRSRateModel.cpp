@@ -0,0 +1,85 @@
+#include "VRSRateModel.h"
+
+VRSRateModel::Parameters VRSRateModel::GetParameters(Preset a_preset)
+{
+	switch (a_preset) {
+	case Preset::Quality:
+		return { 0.05f, 0.10f, 0.30f, 0.5f };
+	case Preset::Performance:
+		return { 0.10f, 0.20f, 0.20f, 1.5f };
+	default:
+		return { 0.07f, 0.14f, 0.25f, 1.0f };
+	}
+}
+
+float VRSRateModel::GetThreshold(const Parameters& a_parameters, float2 a_uv)
+{
+	return std::lerp(a_parameters.thresholdCentre, a_parameters.thresholdEdge, float2::Distance({ 0.5f, 0.5f }, a_uv));
+}
+
+namespace
+{
+	struct AxisLevels
+	{
+		uint strict;      // coarsest level that clears the hysteresis margin
+		uint loose;       // coarsest level at the threshold
+		float halfError;  // error at half rate
+	};
+
+	uint GetLevel(float a_halfError, float a_quarterError, float a_threshold)
+	{
+		return a_halfError >= a_threshold ? 0 : (a_quarterError > a_threshold ? 1 : 2);
+	}
+
+	AxisLevels GetAxisLevels(float a_error, float a_motion, float a_threshold, const VRSRateModel::Parameters& a_parameters)
+	{
+		// Error scalers (equations from the I3D 2019 paper), fast motion hides coarser shading
+		float motion = std::abs(a_motion) * a_parameters.motionScale;
+		float halfError = a_error * std::pow(1.0f / (1.0f + std::pow(1.05f * motion, 3.1f)), 0.35f);
+		float quarterError = a_error * 2.13f * std::pow(1.0f / (1.0f + std::pow(0.55f * motion, 2.41f)), 0.49f);
+
+		return {
+			GetLevel(halfError, quarterError, a_threshold * (1.0f - a_parameters.hysteresis)),
+			GetLevel(halfError, quarterError, a_threshold),
+			halfError
+		};
+	}
+}
+
+VRSRateModel::Levels VRSRateModel::GetLevels(float2 a_error, float2 a_motion, float a_threshold, const Parameters& a_parameters, Levels a_previous)
+{
+	auto x = GetAxisLevels(a_error.x, a_motion.x, a_threshold, a_parameters);
+	auto y = GetAxisLevels(a_error.y, a_motion.y, a_threshold, a_parameters);
+
+	// finer right away, coarser only once the margin is cleared
+	Levels levels{
+		std::clamp(a_previous.x, x.strict, x.loose),
+		std::clamp(a_previous.y, y.strict, y.loose)
+	};
+
+	if (levels.x == 2 && levels.y == 2) {
+		// 4x4 is low quality for little gain, keep the quarter rate along the flatter axis
+		if (x.halfError > y.halfError)
+			levels.x = 1;
+		else
+			levels.y = 1;
+	} else if (levels.x == 2 && levels.y == 0) {
+		// 4x1 and 1x4 are not supported
+		levels.x = 1;
+	} else if (levels.y == 2 && levels.x == 0) {
+		levels.y = 1;
+	}
+
+	return levels;
+}
+
+uint VRSRateModel::GetRateIndex(Levels a_levels)
+{
+	// rows by y level, columns by x level, matching the shading rate table in VariableRateShading
+	static constexpr uint indices[3][3] = {
+		{ 0, 1, 1 },
+		{ 2, 3, 4 },
+		{ 2, 5, 6 }
+	};
+	return indices[std::min(a_levels.y, 2u)][std::min(a_levels.x, 2u)];
+}
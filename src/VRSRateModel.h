@@ -0,0 +1,41 @@
+#pragma once
+
+// CPU reference of the shading rate decision in ComputeShadingRate.hlsl, a change to one belongs in the other
+class VRSRateModel
+{
+public:
+	enum class Preset : uint
+	{
+		Quality,
+		Balanced,
+		Performance
+	};
+
+	struct alignas(16) Parameters
+	{
+		float thresholdCentre;  // error a tile in the centre of the screen may have before it is shaded finer
+		float thresholdEdge;    // the same one uv unit from the centre, the corners are at 0.71
+		float hysteresis;       // fraction the error must fall below the threshold before a tile coarsens
+		float motionScale;      // scales motion in pixels per frame before it hides error
+	};
+
+	struct Levels
+	{
+		uint x = 0;  // 0 full, 1 half, 2 quarter rate
+		uint y = 0;
+	};
+
+	static Parameters GetParameters(Preset a_preset);
+
+	static float GetThreshold(const Parameters& a_parameters, float2 a_uv);
+
+	/**
+	 * @return Levels for a tile with a_error and a_motion that had a_previous last frame
+	 */
+	static Levels GetLevels(float2 a_error, float2 a_motion, float a_threshold, const Parameters& a_parameters, Levels a_previous);
+
+	/**
+	 * @return Index into the NVAPI shading rate table set up in VariableRateShading
+	 */
+	static uint GetRateIndex(Levels a_levels);
+};
@@ -0,0 +1,31 @@
+#include "VRSTransitionCache.h"
+
+void VRSTransitionCache::SetScreenTargets(std::span<const uint> a_targets)
+{
+	screenTargets.clear();
+	for (auto target : a_targets) {
+		if (target >= screenTargets.size())
+			screenTargets.resize(target + 1, false);
+		screenTargets[target] = true;
+	}
+}
+
+void VRSTransitionCache::BeginFrame(bool a_allowed)
+{
+	allowed = a_allowed;
+	lastFrameTransitions = transitions;
+	transitions = 0;
+}
+
+bool VRSTransitionCache::Update(uint a_renderTarget, bool a_screenDepth, bool a_enable)
+{
+	bool screenTarget = a_renderTarget < screenTargets.size() && screenTargets[a_renderTarget];
+	bool enable = allowed && a_enable && (screenTarget || a_screenDepth);
+
+	if (enable == enabled)
+		return false;
+
+	enabled = enable;
+	transitions++;
+	return true;
+}
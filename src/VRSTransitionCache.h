@@ -0,0 +1,32 @@
+#pragma once
+
+// Decides per draw whether variable rate shading applies, and reports only the draws that change it
+class VRSTransitionCache
+{
+public:
+	void SetScreenTargets(std::span<const uint> a_targets);
+
+	/**
+	 * Starts a frame, a_allowed covers everything that holds for the whole frame
+	 */
+	void BeginFrame(bool a_allowed);
+
+	/**
+	 * @return Whether the draw changes the state, the new one is then IsEnabled
+	 */
+	bool Update(uint a_renderTarget, bool a_screenDepth, bool a_enable);
+
+	bool IsEnabled() const { return enabled; }
+
+	/**
+	 * @return Transitions in the last complete frame
+	 */
+	uint GetTransitions() const { return lastFrameTransitions; }
+
+private:
+	std::vector<bool> screenTargets;
+	bool allowed = false;
+	bool enabled = false;
+	uint transitions = 0;
+	uint lastFrameTransitions = 0;
+};
@@ -38,6 +38,16 @@ void VariableRateShading::DrawSettings()
 {
 	ImGui::Checkbox("Enable Variable Rate Shading", &enableVRS);
 
+	{
+		static const char* presetOptions[] = { "Quality", "Balanced", "Performance" };
+		ImGui::Combo("Preset", (int*)&preset, presetOptions, 3);
+		if (auto _tt = Util::HoverTooltipWrapper()) {
+			ImGui::Text(
+				"How readily flat and fast-moving areas are shaded at a coarser rate. "
+				"Performance saves the most and is the most likely to show blocky shading.");
+		}
+	}
+
 	ImGui::Spacing();
 }
 
@@ -52,7 +62,10 @@ void VariableRateShading::UpdateVRS()
 
 	temporal = bTAA || State::GetSingleton()->upscalerLoaded;
 
-	if (enableVRS && temporal && !RE::UI::GetSingleton()->GameIsPaused()) {
+	bool allowed = enableVRS && temporal && !RE::UI::GetSingleton()->GameIsPaused();
+	transitionCache.BeginFrame(allowed);
+
+	if (allowed) {
 		auto renderer = RE::BSGraphics::Renderer::GetSingleton();
 		auto& context = State::GetSingleton()->context;
 
@@ -109,14 +122,19 @@ void VariableRateShading::ComputeShadingRate()
 {
 	auto& context = State::GetSingleton()->context;
 
+	shadingRateCB->UpdateIfChanged(VRSRateModel::GetParameters(preset));
+
+	ID3D11Buffer* buffers[1]{ shadingRateCB->CB() };
+	context->CSSetConstantBuffers(0, 1, buffers);
+
 	ID3D11ShaderResourceView* srvs[1]{
 		reductionData->srv.get()
 	};
 
 	context->CSSetShaderResources(0, 1, srvs);
 
-	ID3D11UnorderedAccessView* uavs[1]{ singleEyeVRSUAV[0] };
-	context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
+	ID3D11UnorderedAccessView* uavs[2]{ singleEyeVRSUAV[0], levelHistory->uav.get() };
+	context->CSSetUnorderedAccessViews(0, 2, uavs, nullptr);
 
 	auto shader = GetComputeShadingRate();
 	context->CSSetShader(shader, nullptr, 0);
@@ -124,8 +142,8 @@ void VariableRateShading::ComputeShadingRate()
 	float resolutionX = (float)reductionData->desc.Width;
 	float resolutionY = (float)reductionData->desc.Height;
 
-	uint32_t dispatchX = (uint32_t)std::ceil(resolutionX / 8.0f);
-	uint32_t dispatchY = (uint32_t)std::ceil(resolutionY / 8.0f);
+	uint32_t dispatchX = (uint32_t)std::ceil(resolutionX / 32.0f);
+	uint32_t dispatchY = (uint32_t)std::ceil(resolutionY / 32.0f);
 
 	context->Dispatch(dispatchX, dispatchY, 1);
 
@@ -133,7 +151,11 @@ void VariableRateShading::ComputeShadingRate()
 	context->CSSetShaderResources(0, 1, srvs);
 
 	uavs[0] = nullptr;
-	context->CSSetUnorderedAccessViews(0, 1, uavs, nullptr);
+	uavs[1] = nullptr;
+	context->CSSetUnorderedAccessViews(0, 2, uavs, nullptr);
+
+	buffers[0] = nullptr;
+	context->CSSetConstantBuffers(0, 1, buffers);
 
 	context->CSSetShader(nullptr, nullptr, 0);
 }
@@ -204,7 +226,8 @@ void VariableRateShading::Setup()
 		main.SRV->GetDesc(&srvDesc);
 		main.UAV->GetDesc(&uavDesc);
 
-		texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		// signed, the motion vectors are stored next to the error
+		texDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
 		srvDesc.Format = texDesc.Format;
 		uavDesc.Format = texDesc.Format;
 
@@ -214,9 +237,20 @@ void VariableRateShading::Setup()
 		reductionData = new Texture2D(texDesc);
 		reductionData->CreateSRV(srvDesc);
 		reductionData->CreateUAV(uavDesc);
+
+		// levels of the last frame for the hysteresis, read and written in place
+		// any starting content is fine, the shader clamps it to the levels the error allows
+		texDesc.Format = DXGI_FORMAT_R32_UINT;
+		uavDesc.Format = texDesc.Format;
+
+		levelHistory = new Texture2D(texDesc);
+		levelHistory->CreateUAV(uavDesc);
 	}
 
+	shadingRateCB = new ConstantBuffer(ConstantBufferDesc<VRSRateModel::Parameters>());
+
 	{
+		std::vector<uint> screenTargets;
 		for (uint i = 0; i < static_cast<uint>(REL::Relocate(RE::RENDER_TARGET::kTOTAL, RE::RENDER_TARGET::k116, RE::RENDER_TARGET::kVRTOTAL)); i++) {
 			auto& target = renderer->GetRuntimeData().renderTargets[i];
 			if (target.texture) {
@@ -224,10 +258,11 @@ void VariableRateShading::Setup()
 				target.texture->GetDesc(&texDesc);
 
 				if (texDesc.Width == screenSize.x && texDesc.Height == screenSize.y) {
-					screenTargets.insert(i);
+					screenTargets.push_back(i);
 				}
 			}
 		}
+		transitionCache.SetScreenTargets(screenTargets);
 	}
 }
 
@@ -278,32 +313,64 @@ void VariableRateShading::SetupSingleEyeVRS(int eye, int width, int height)
 	}
 }
 
+// Shading rate tables for every viewport, with variable rate shading off and on
+static NV_D3D11_VIEWPORTS_SHADING_RATE_DESC& GetViewportsShadingRates(bool a_enable)
+{
+	static constexpr uint viewportCount = 8;
+
+	static auto viewports = [] {
+		std::array<std::array<NV_D3D11_VIEWPORT_SHADING_RATE_DESC, viewportCount>, 2> viewports{};
+		for (uint i = 0; i < viewportCount; i++) {
+			auto& off = viewports[0][i];
+			off.enableVariablePixelShadingRate = false;
+			memset(off.shadingRateTable, NV_PIXEL_X0_CULL_RASTER_PIXELS, sizeof(off.shadingRateTable));
+
+			auto& on = viewports[1][i];
+			on.enableVariablePixelShadingRate = true;
+			memset(on.shadingRateTable, NV_PIXEL_X1_PER_RASTER_PIXEL, sizeof(on.shadingRateTable));
+			on.shadingRateTable[0] = NV_PIXEL_X1_PER_RASTER_PIXEL;
+			on.shadingRateTable[1] = NV_PIXEL_X1_PER_2X1_RASTER_PIXELS;
+			on.shadingRateTable[2] = NV_PIXEL_X1_PER_1X2_RASTER_PIXELS;
+			on.shadingRateTable[3] = NV_PIXEL_X1_PER_2X2_RASTER_PIXELS;
+			on.shadingRateTable[4] = NV_PIXEL_X1_PER_4X2_RASTER_PIXELS;
+			on.shadingRateTable[5] = NV_PIXEL_X1_PER_2X4_RASTER_PIXELS;
+			on.shadingRateTable[6] = NV_PIXEL_X1_PER_4X4_RASTER_PIXELS;
+		}
+		return viewports;
+	}();
+
+	static auto descs = [] {
+		std::array<NV_D3D11_VIEWPORTS_SHADING_RATE_DESC, 2> descs{};
+		for (uint i = 0; i < 2; i++) {
+			descs[i].version = NV_D3D11_VIEWPORTS_SHADING_RATE_DESC_VER;
+			descs[i].numViewports = viewportCount;
+			descs[i].pViewports = viewports[i].data();
+		}
+		return descs;
+	}();
+
+	return descs[a_enable];
+}
+
 void VariableRateShading::UpdateViews(bool a_enable)
 {
 	if (!vrsActive)
 		return;
 
-	auto& context = State::GetSingleton()->context;
-
 	auto state = RE::BSGraphics::RendererShadowState::GetSingleton();
 
 	GET_INSTANCE_MEMBER(renderTargets, state);
 	GET_INSTANCE_MEMBER(depthStencil, state);
 
-	vrsPass = screenTargets.contains(renderTargets[0]);
-
-	if (depthStencil == RE::RENDER_TARGETS_DEPTHSTENCIL::kMAIN || depthStencil == RE::RENDER_TARGETS_DEPTHSTENCIL::kPOST_ZPREPASS_COPY) {
-		vrsPass = true;
-	}
-
-	vrsPass = enableVRS && vrsPass && temporal && a_enable && notLandscape && !RE::UI::GetSingleton()->GameIsPaused();
-
-	static bool currentVRS = false;
+	bool screenDepth = depthStencil == RE::RENDER_TARGETS_DEPTHSTENCIL::kMAIN || depthStencil == RE::RENDER_TARGETS_DEPTHSTENCIL::kPOST_ZPREPASS_COPY;
 
-	if (currentVRS == vrsPass)
+	// most draws keep the state of the one before, those never reach the driver
+	if (!transitionCache.Update(renderTargets[0], screenDepth, a_enable && notLandscape))
 		return;
 
-	currentVRS = vrsPass;
+	vrsPass = transitionCache.IsEnabled();
+
+	auto& context = State::GetSingleton()->context;
 
 	if (vrsPass) {
 		ID3D11NvShadingRateResourceView* shadingRateView = singleEyeVRSView[0];
@@ -313,36 +380,9 @@ void VariableRateShading::UpdateViews(bool a_enable)
 			logger::info("Setting the shading rate resource view failed");
 	}
 
-	NV_D3D11_VIEWPORT_SHADING_RATE_DESC vsrd[8];
-	for (uint i = 0; i < 8; i++) {
-		vsrd[i].enableVariablePixelShadingRate = false;
-		memset(vsrd[i].shadingRateTable, NV_PIXEL_X0_CULL_RASTER_PIXELS, sizeof(vsrd[0].shadingRateTable));
-	}
-
-	uint viewportCount = 8;
-
-	if (vrsPass) {
-		for (uint i = 0; i < viewportCount; i++) {
-			vsrd[i].enableVariablePixelShadingRate = true;
-			memset(vsrd[i].shadingRateTable, NV_PIXEL_X1_PER_RASTER_PIXEL, sizeof(vsrd[i].shadingRateTable));
-			vsrd[i].shadingRateTable[0] = NV_PIXEL_X1_PER_RASTER_PIXEL;
-			vsrd[i].shadingRateTable[1] = NV_PIXEL_X1_PER_2X1_RASTER_PIXELS;
-			vsrd[i].shadingRateTable[2] = NV_PIXEL_X1_PER_1X2_RASTER_PIXELS;
-			vsrd[i].shadingRateTable[3] = NV_PIXEL_X1_PER_2X2_RASTER_PIXELS;
-			vsrd[i].shadingRateTable[4] = NV_PIXEL_X1_PER_4X2_RASTER_PIXELS;
-			vsrd[i].shadingRateTable[5] = NV_PIXEL_X1_PER_2X4_RASTER_PIXELS;
-			vsrd[i].shadingRateTable[6] = NV_PIXEL_X1_PER_4X4_RASTER_PIXELS;
-		}
-	}
-
-	NV_D3D11_VIEWPORTS_SHADING_RATE_DESC srd;
-	srd.version = NV_D3D11_VIEWPORTS_SHADING_RATE_DESC_VER;
-	srd.numViewports = viewportCount;
-	srd.pViewports = vsrd;
-
 	{
-		NvAPI_Status statusVPSR = NvAPI_D3D11_RSSetViewportsPixelShadingRates(context, &srd);
+		NvAPI_Status statusVPSR = NvAPI_D3D11_RSSetViewportsPixelShadingRates(context, &GetViewportsShadingRates(vrsPass));
 		if (statusVPSR != NVAPI_OK)
 			logger::info("Setting the viewport pixel shading rate failed");
 	}
-}
\ No newline at end of file
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Buffer.h"
+#include "VRSRateModel.h"
+#include "VRSTransitionCache.h"
 #include <nvapi.h>
 
 class VariableRateShading
@@ -13,6 +15,7 @@ public:
 	}
 
 	bool enableVRS = false;
+	VRSRateModel::Preset preset = VRSRateModel::Preset::Balanced;
 
 	bool nvapiLoaded = false;
 	bool vrsActive = false;
@@ -23,9 +26,11 @@ public:
 	ID3D11UnorderedAccessView* singleEyeVRSUAV[2];
 	ID3D11NvShadingRateResourceView* singleEyeVRSView[2];
 
-	std::unordered_set<uint> screenTargets;
+	VRSTransitionCache transitionCache;
 
 	Texture2D* reductionData = nullptr;
+	Texture2D* levelHistory = nullptr;
+	ConstantBuffer* shadingRateCB = nullptr;
 	ID3D11ComputeShader* computeNASDataCS = nullptr;
 	ID3D11ComputeShader* computeShadingRateCS = nullptr;
 
@@ -0,0 +1,136 @@
+#include "Features/ScreenSpaceShadows/DispatchCache.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+
+// The original builder, in its own namespace as DispatchCache.cpp already defines Bend::BuildDispatchList
+namespace Reference
+{
+#pragma warning(push)
+#pragma warning(disable: 4838 4244)
+#include "Features/ScreenSpaceShadows/bend_sss_cpu.h"
+#pragma warning(pop)
+}
+
+namespace
+{
+	struct View
+	{
+		float lightProjection[4];
+		int viewportSize[2];
+		int minRenderBounds[2];
+		int maxRenderBounds[2];
+	};
+
+	View RandomView(std::mt19937& a_rng)
+	{
+		std::uniform_real_distribution<float> xy(-3.0f, 3.0f), z(0.0f, 1.0f), w(-1.0f, 1.0f);
+		std::uniform_int_distribution<int> size(1, 4000);
+
+		View view{ { xy(a_rng), xy(a_rng), z(a_rng), w(a_rng) }, { size(a_rng), size(a_rng) }, { 0, 0 }, {} };
+		view.maxRenderBounds[0] = view.viewportSize[0];
+		view.maxRenderBounds[1] = view.viewportSize[1];
+		return view;
+	}
+
+	// Checks the layout against a fresh BuildDispatchList, and that the merged dispatch runs each of its groups once
+	void RequireMatchesReference(const BendDispatchCache::Layout& a_layout, View a_view)
+	{
+		auto list = Reference::Bend::BuildDispatchList(a_view.lightProjection, a_view.viewportSize, a_view.minRenderBounds, a_view.maxRenderBounds, false, BendDispatchCache::WaveSize);
+
+		REQUIRE(std::equal(a_layout.lightCoordinate, a_layout.lightCoordinate + 4, list.LightCoordinate_Shader));
+		REQUIRE(a_layout.dispatchCount == (uint)list.DispatchCount);
+
+		std::vector<std::vector<uint>> runs(a_layout.dispatchCount);
+		uint groupCount = 0;
+		for (uint i = 0; i < a_layout.dispatchCount; i++) {
+			auto& dispatch = list.Dispatch[i];
+			REQUIRE(dispatch.WaveCount[0] == BendDispatchCache::WaveSize);
+			REQUIRE(a_layout.dispatches[i][0] == dispatch.WaveOffset_Shader[0]);
+			REQUIRE(a_layout.dispatches[i][1] == dispatch.WaveOffset_Shader[1]);
+			runs[i].resize(dispatch.WaveCount[1] * dispatch.WaveCount[2]);
+			groupCount += dispatch.WaveCount[1] * dispatch.WaveCount[2];
+		}
+		REQUIRE(a_layout.groupCount == groupCount);
+
+		// group lookup of RaymarchCS
+		for (uint groupY = 0; groupY < a_layout.groupCount; groupY++) {
+			uint dispatchIndex = 0;
+			for (uint i = 1; i < BendDispatchCache::MaxDispatches; i++)
+				dispatchIndex += (i < a_layout.dispatchCount && (int)groupY >= a_layout.dispatches[i][2]) ? 1 : 0;
+
+			auto& dispatch = a_layout.dispatches[dispatchIndex];
+			int group = (int)groupY - dispatch[2];
+			int y = group % dispatch[3], z = group / dispatch[3];
+			REQUIRE(y < list.Dispatch[dispatchIndex].WaveCount[1]);
+			REQUIRE(z < list.Dispatch[dispatchIndex].WaveCount[2]);
+			runs[dispatchIndex][z * list.Dispatch[dispatchIndex].WaveCount[1] + y]++;
+		}
+
+		for (auto& dispatchRuns : runs)
+			REQUIRE(std::ranges::all_of(dispatchRuns, [](uint a_count) { return a_count == 1; }));
+	}
+}
+
+TEST_CASE("Layouts match BuildDispatchList", "[BendDispatchCache]")
+{
+	std::mt19937 rng(7);
+	for (uint i = 0; i < 2000; i++) {
+		auto view = RandomView(rng);
+		BendDispatchCache cache;
+		RequireMatchesReference(cache.Update(view.lightProjection, view.viewportSize, view.minRenderBounds, view.maxRenderBounds), view);
+	}
+}
+
+TEST_CASE("Reused layouts still match BuildDispatchList", "[BendDispatchCache]")
+{
+	std::mt19937 rng(11);
+	std::uniform_real_distribution<float> drift(-0.0004f, 0.0004f);
+
+	for (uint i = 0; i < 200; i++) {
+		auto view = RandomView(rng);
+		BendDispatchCache cache;
+
+		// a slowly turning camera, most frames keep the light in the same pixel
+		for (uint frame = 0; frame < 50; frame++) {
+			view.lightProjection[0] += drift(rng);
+			view.lightProjection[1] += drift(rng);
+			RequireMatchesReference(cache.Update(view.lightProjection, view.viewportSize, view.minRenderBounds, view.maxRenderBounds), view);
+		}
+	}
+}
+
+TEST_CASE("Only a new pixel, viewport or bounds rebuilds the list", "[BendDispatchCache]")
+{
+	BendDispatchCache cache;
+	View view{ { 0.1f, -0.2f, 0.5f, 1.0f }, { 1920, 1080 }, { 0, 0 }, { 1920, 1080 } };
+
+	cache.Update(view.lightProjection, view.viewportSize, view.minRenderBounds, view.maxRenderBounds);
+	REQUIRE(cache.GetRebuildCount() == 1);
+
+	// a tenth of a pixel
+	view.lightProjection[0] += 0.1f * 2.0f / 1920.0f;
+	auto& layout = cache.Update(view.lightProjection, view.viewportSize, view.minRenderBounds, view.maxRenderBounds);
+	REQUIRE(cache.GetRebuildCount() == 1);
+
+	// the exact coordinate still follows the light
+	float lightCoordinate[4];
+	BendDispatchCache::GetLightCoordinate(view.lightProjection, view.viewportSize, lightCoordinate);
+	REQUIRE(std::equal(lightCoordinate, lightCoordinate + 4, layout.lightCoordinate));
+
+	view.lightProjection[0] += 2.0f * 2.0f / 1920.0f;
+	cache.Update(view.lightProjection, view.viewportSize, view.minRenderBounds, view.maxRenderBounds);
+	REQUIRE(cache.GetRebuildCount() == 2);
+
+	view.maxRenderBounds[0] = 1600;
+	cache.Update(view.lightProjection, view.viewportSize, view.minRenderBounds, view.maxRenderBounds);
+	REQUIRE(cache.GetRebuildCount() == 3);
+
+	view.viewportSize[0] = 1600;
+	cache.Update(view.lightProjection, view.viewportSize, view.minRenderBounds, view.maxRenderBounds);
+	REQUIRE(cache.GetRebuildCount() == 4);
+
+	cache.Update(view.lightProjection, view.viewportSize, view.minRenderBounds, view.maxRenderBounds);
+	REQUIRE(cache.GetRebuildCount() == 4);
+}
@@ -0,0 +1,108 @@
+#include "ShaderTools/BlobIndex.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+	// the part of ID3DBlob the index reads
+	struct FakeBlob
+	{
+		std::vector<uint8_t> bytes;
+
+		void* GetBufferPointer() { return bytes.data(); }
+		size_t GetBufferSize() { return bytes.size(); }
+	};
+
+	using Index = SIE::BlobIndex<FakeBlob>;
+
+	SIE::ShaderReflection MakeReflection(uint32_t a_size)
+	{
+		SIE::ShaderReflection reflection{};
+		reflection.bufferSizes = { a_size, 0, 0 };
+		return reflection;
+	}
+}
+
+TEST_CASE("Identical bytecode shares the first blob", "[BlobIndex]")
+{
+	Index index;
+	FakeBlob first{ { 1, 2, 3, 4 } };
+	FakeBlob second{ { 1, 2, 3, 4 } };
+
+	REQUIRE(index.Add(7, &first, MakeReflection(1)) == &first);
+	REQUIRE(index.Add(7, &second, MakeReflection(2)) == &first);
+	REQUIRE(index.Add(7, &first, MakeReflection(3)) == &first);
+
+	auto entry = index.Find(7);
+	REQUIRE(entry);
+	REQUIRE(entry->blob == &first);
+	REQUIRE(entry->reflection.bufferSizes[0] == 1);
+}
+
+TEST_CASE("A hash of other bytes does not share the blob", "[BlobIndex]")
+{
+	Index index;
+	FakeBlob first{ { 1, 2, 3, 4 } };
+	FakeBlob sameSize{ { 1, 2, 3, 5 } };
+	FakeBlob longer{ { 1, 2, 3, 4, 0 } };
+	FakeBlob empty{};
+
+	index.Add(7, &first, MakeReflection(1));
+	REQUIRE(index.Add(7, &sameSize, MakeReflection(2)) == &sameSize);
+	REQUIRE(index.Add(7, &longer, MakeReflection(3)) == &longer);
+	REQUIRE(index.Add(7, &empty, MakeReflection(4)) == &empty);
+
+	// the first blob stays the one of the hash
+	REQUIRE(index.Find(7)->blob == &first);
+	REQUIRE(index.Find(7)->reflection.bufferSizes[0] == 1);
+	REQUIRE(index.Find(8) == nullptr);
+}
+
+TEST_CASE("A source only skips compilation to bytecode that was shared", "[BlobIndex]")
+{
+	Index index;
+	FakeBlob compiled{ { 1, 2, 3, 4 } };
+	FakeBlob collision{ { 9, 9, 9, 9 } };
+
+	REQUIRE(index.FindForSource(100) == nullptr);
+
+	auto shared = index.Add(7, &compiled, MakeReflection(1));
+	index.AddSource(100, 7, shared);
+	REQUIRE(index.FindForSource(100) == &compiled);
+
+	// other bytes under the same bytecode hash would hand this source the wrong shader
+	shared = index.Add(7, &collision, MakeReflection(2));
+	REQUIRE(shared == &collision);
+	index.AddSource(200, 7, shared);
+	REQUIRE(index.FindForSource(200) == nullptr);
+
+	// and a source of bytecode that was never added is not remembered
+	index.AddSource(300, 8, &compiled);
+	REQUIRE(index.FindForSource(300) == nullptr);
+}
+
+TEST_CASE("A remembered source maps to the bytecode of its latest compile", "[BlobIndex]")
+{
+	Index index;
+	FakeBlob first{ { 1 } };
+	FakeBlob second{ { 2 } };
+
+	index.AddSource(100, 7, index.Add(7, &first, MakeReflection(1)));
+	index.AddSource(100, 8, index.Add(8, &second, MakeReflection(2)));
+	REQUIRE(index.FindForSource(100) == &second);
+}
+
+TEST_CASE("Clearing forgets blobs and sources", "[BlobIndex]")
+{
+	Index index;
+	FakeBlob blob{ { 1, 2 } };
+
+	index.AddSource(100, 7, index.Add(7, &blob, MakeReflection(1)));
+	index.Clear();
+
+	REQUIRE(index.Find(7) == nullptr);
+	REQUIRE(index.FindForSource(100) == nullptr);
+
+	FakeBlob other{ { 3 } };
+	REQUIRE(index.Add(7, &other, MakeReflection(2)) == &other);
+}
@@ -0,0 +1,136 @@
+#include "Features/DynamicCubemaps/CubemapScheduler.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+	CubemapScheduler::Environment MakeEnvironment()
+	{
+		return { .cameraForward = { 0, 0, 1 }, .sunDirection = { 0, 0, -1 } };
+	}
+}
+
+TEST_CASE("The first update clears and captures every face", "[CubemapScheduler]")
+{
+	CubemapScheduler scheduler;
+	auto now = std::chrono::steady_clock::now();
+
+	auto plan = scheduler.Update(MakeEnvironment(), now, 1, 4);
+	REQUIRE(plan.reset);
+	REQUIRE(plan.captureFaces.size() == CubemapScheduler::FaceCount);
+
+	plan = scheduler.Update(MakeEnvironment(), now, 1, 4);
+	REQUIRE_FALSE(plan.reset);
+	REQUIRE(plan.captureFaces.size() == 1);
+}
+
+TEST_CASE("Plans stay within the per frame budgets", "[CubemapScheduler]")
+{
+	CubemapScheduler scheduler;
+	auto now = std::chrono::steady_clock::now();
+	auto environment = MakeEnvironment();
+	environment.reflections = true;
+
+	for (uint i = 0; i < 32; i++) {
+		auto plan = scheduler.Update(environment, now, 2, 3);
+		if (!plan.reset)
+			REQUIRE(plan.captureFaces.size() == 2);
+		REQUIRE(plan.inferFaces.size() <= 2);
+		REQUIRE(plan.prefilterMips.size() <= 3);
+	}
+}
+
+TEST_CASE("Faces behind the camera are still captured", "[CubemapScheduler]")
+{
+	CubemapScheduler scheduler;
+	auto now = std::chrono::steady_clock::now();
+	scheduler.Update(MakeEnvironment(), now, 1, 4);
+
+	std::array<bool, CubemapScheduler::FaceCount> captured{};
+	for (uint i = 0; i < 64; i++)
+		for (auto face : scheduler.Update(MakeEnvironment(), now, 1, 4).captureFaces)
+			captured[face] = true;
+
+	for (uint face = 0; face < CubemapScheduler::FaceCount; face++)
+		REQUIRE(captured[face]);
+}
+
+TEST_CASE("The face the camera looks at is inferred first", "[CubemapScheduler]")
+{
+	CubemapScheduler scheduler;
+	auto environment = MakeEnvironment();
+
+	auto plan = scheduler.Update(environment, std::chrono::steady_clock::now(), 1, 0);
+	REQUIRE(plan.inferFaces.size() == 1);
+	REQUIRE(CubemapScheduler::GetCaptureDirection(plan.inferFaces[0]).Dot(environment.cameraForward) == 1.f);
+}
+
+TEST_CASE("Inferred faces are prefiltered mip by mip", "[CubemapScheduler]")
+{
+	CubemapScheduler scheduler;
+	auto now = std::chrono::steady_clock::now();
+
+	auto plan = scheduler.Update(MakeEnvironment(), now, 1, CubemapScheduler::MipCount);
+	REQUIRE(plan.inferFaces.size() == 1);
+	uint face = plan.inferFaces[0];
+
+	REQUIRE(plan.prefilterMips.size() == CubemapScheduler::MipCount - 1);
+	for (uint i = 0; i < plan.prefilterMips.size(); i++)
+		REQUIRE(plan.prefilterMips[i] == std::pair{ face, i + 1 });
+}
+
+TEST_CASE("Only the environment target is updated without reflections", "[CubemapScheduler]")
+{
+	CubemapScheduler scheduler;
+	auto now = std::chrono::steady_clock::now();
+
+	for (uint i = 0; i < 4; i++)
+		REQUIRE(scheduler.Update(MakeEnvironment(), now, 1, 4).target == 0);
+
+	auto environment = MakeEnvironment();
+	environment.reflections = true;
+	std::array<bool, CubemapScheduler::TargetCount> updated{};
+	for (uint i = 0; i < 4; i++)
+		updated[scheduler.Update(environment, now, 1, 4).target] = true;
+	REQUIRE(updated[0]);
+	REQUIRE(updated[1]);
+}
+
+TEST_CASE("Deferred resets wait until requests settle", "[CubemapScheduler]")
+{
+	CubemapScheduler scheduler;
+	auto now = std::chrono::steady_clock::now();
+	scheduler.Update(MakeEnvironment(), now, 1, 4);
+
+	scheduler.RequestReset(false);
+	REQUIRE_FALSE(scheduler.Update(MakeEnvironment(), std::chrono::steady_clock::now(), 1, 4).reset);
+
+	auto settled = std::chrono::steady_clock::now() + CubemapScheduler::ResetSettleTime + std::chrono::milliseconds(1);
+	REQUIRE(scheduler.Update(MakeEnvironment(), settled, 1, 4).reset);
+	REQUIRE_FALSE(scheduler.Update(MakeEnvironment(), settled, 1, 4).reset);
+}
+
+TEST_CASE("Entering an interior resets the capture", "[CubemapScheduler]")
+{
+	CubemapScheduler scheduler;
+	auto now = std::chrono::steady_clock::now();
+	scheduler.Update(MakeEnvironment(), now, 1, 4);
+
+	auto environment = MakeEnvironment();
+	environment.interior = true;
+	REQUIRE(scheduler.Update(environment, now, 1, 4).reset);
+}
+
+TEST_CASE("Sun movement keeps the capture", "[CubemapScheduler]")
+{
+	CubemapScheduler scheduler;
+	auto now = std::chrono::steady_clock::now();
+	auto environment = MakeEnvironment();
+	scheduler.Update(environment, now, 1, 4);
+
+	environment.sunDirection = { 0.2f, 0, -1 };
+	environment.sunDirection.Normalize();
+	auto plan = scheduler.Update(environment, now, 1, 4);
+	REQUIRE_FALSE(plan.reset);
+	REQUIRE(plan.captureFaces.size() == 1);
+}
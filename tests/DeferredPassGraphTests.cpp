@@ -0,0 +1,90 @@
+#include "DeferredPassGraph.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+	enum : uint
+	{
+		Main,
+		Depth,
+		SSGI,
+		Cubemap
+	};
+
+	using enum DeferredPassGraph::Access;
+
+	// the declarations of Deferred::DeferredPasses, trimmed to what matters for fusion
+	DeferredPassGraph::Pass AmbientComposite() { return { .name = "Ambient Composite", .reads = { { Main }, { Depth }, { SSGI } }, .writes = { Main }, .fusable = true }; }
+	DeferredPassGraph::Pass SubsurfaceScattering() { return { .name = "Subsurface Scattering", .reads = { { Main, Neighbourhood }, { Depth, Neighbourhood } }, .writes = { Main } }; }
+	DeferredPassGraph::Pass DynamicCubemaps() { return { .name = "Dynamic Cubemaps", .reads = { { Main, Neighbourhood }, { Depth, Neighbourhood } }, .writes = { Cubemap } }; }
+	DeferredPassGraph::Pass DeferredComposite() { return { .name = "Deferred Composite", .reads = { { Main }, { Depth }, { Cubemap, Neighbourhood } }, .writes = { Main }, .fusable = true }; }
+}
+
+TEST_CASE("An empty graph has no steps", "[DeferredPassGraph]")
+{
+	REQUIRE(DeferredPassGraph{}.Schedule().empty());
+}
+
+TEST_CASE("Neighbouring composites share a dispatch", "[DeferredPassGraph]")
+{
+	DeferredPassGraph graph;
+	graph.AddPass({ .name = "SSGI", .reads = { { Main, Neighbourhood }, { Depth, Neighbourhood } }, .writes = { SSGI } });
+	graph.AddPass(AmbientComposite());
+	graph.AddPass(DeferredComposite());
+
+	REQUIRE(graph.Schedule() == std::vector<std::vector<uint>>{ { 0 }, { 1, 2 } });
+}
+
+TEST_CASE("A pass in between keeps the composites apart", "[DeferredPassGraph]")
+{
+	SECTION("Subsurface scattering")
+	{
+		DeferredPassGraph graph;
+		graph.AddPass(AmbientComposite());
+		graph.AddPass(SubsurfaceScattering());
+		graph.AddPass(DeferredComposite());
+		REQUIRE(graph.Schedule() == std::vector<std::vector<uint>>{ { 0 }, { 1 }, { 2 } });
+	}
+
+	SECTION("Dynamic cubemaps")
+	{
+		DeferredPassGraph graph;
+		graph.AddPass(AmbientComposite());
+		graph.AddPass(DynamicCubemaps());
+		graph.AddPass(DeferredComposite());
+		REQUIRE(graph.Schedule() == std::vector<std::vector<uint>>{ { 0 }, { 1 }, { 2 } });
+	}
+}
+
+TEST_CASE("Neighbourhood reads of the other pass block fusion", "[DeferredPassGraph]")
+{
+	// the second pass reads other pixels of what the first writes
+	DeferredPassGraph readsWriter;
+	readsWriter.AddPass({ .name = "A", .writes = { Main }, .fusable = true });
+	readsWriter.AddPass({ .name = "B", .reads = { { Main, Neighbourhood } }, .writes = { Cubemap }, .fusable = true });
+	REQUIRE(readsWriter.Schedule().size() == 2);
+
+	// the first pass reads other pixels of what the second writes
+	DeferredPassGraph writesRead;
+	writesRead.AddPass({ .name = "A", .reads = { { Cubemap, Neighbourhood } }, .writes = { Main }, .fusable = true });
+	writesRead.AddPass({ .name = "B", .reads = { { Main } }, .writes = { Cubemap }, .fusable = true });
+	REQUIRE(writesRead.Schedule().size() == 2);
+
+	// neighbourhood reads of resources neither writes are fine
+	DeferredPassGraph unrelated;
+	unrelated.AddPass({ .name = "A", .reads = { { Depth, Neighbourhood } }, .writes = { Main }, .fusable = true });
+	unrelated.AddPass({ .name = "B", .reads = { { Main }, { Depth, Neighbourhood } }, .writes = { Main }, .fusable = true });
+	REQUIRE(unrelated.Schedule().size() == 1);
+}
+
+TEST_CASE("A fused step only grows while every member agrees", "[DeferredPassGraph]")
+{
+	DeferredPassGraph graph;
+	graph.AddPass({ .name = "A", .writes = { SSGI }, .fusable = true });
+	graph.AddPass({ .name = "B", .reads = { { Main } }, .writes = { Main }, .fusable = true });
+	graph.AddPass({ .name = "C", .reads = { { SSGI, Neighbourhood } }, .writes = { Cubemap }, .fusable = true });
+
+	REQUIRE(graph.Schedule() == std::vector<std::vector<uint>>{ { 0, 1 }, { 2 } });
+	REQUIRE(graph.GetPass(2).name == "C");
+}
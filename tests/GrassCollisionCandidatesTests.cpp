@@ -0,0 +1,62 @@
+#include "Features/GrassCollision/Candidates.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+
+namespace
+{
+	std::vector<GrassCollisionCandidate> RandomCandidates(std::mt19937& a_rng, uint a_count)
+	{
+		// few distinct distances so ties across the cut are common
+		std::uniform_int_distribution<int> distance(0, 64);
+		std::vector<GrassCollisionCandidate> candidates(a_count);
+		for (uint i = 0; i < a_count; i++)
+			candidates[i] = { { (float)i, 0.0f, 0.0f }, 1.0f, (float)(distance(a_rng) * distance(a_rng)) };
+		return candidates;
+	}
+
+	std::vector<float> SortedDistances(const std::vector<GrassCollisionCandidate>& a_candidates)
+	{
+		std::vector<float> distances;
+		for (auto& candidate : a_candidates)
+			distances.push_back(candidate.distanceSquared);
+		std::ranges::sort(distances);
+		return distances;
+	}
+}
+
+TEST_CASE("Candidates that fit are kept as they are", "[GrassCollisionCandidates]")
+{
+	std::mt19937 rng(3);
+	for (uint count : { 0u, 1u, 255u, 256u }) {
+		auto candidates = RandomCandidates(rng, count);
+		auto before = candidates;
+		SelectNearestCandidates(candidates, 256);
+
+		REQUIRE(candidates.size() == count);
+		REQUIRE(std::ranges::equal(candidates, before, [](auto& a, auto& b) { return a.centre.x == b.centre.x; }));
+	}
+}
+
+TEST_CASE("The nearest candidates are kept", "[GrassCollisionCandidates]")
+{
+	std::mt19937 rng(5);
+	for (uint count : { 257u, 300u, 1000u, 5000u }) {
+		auto candidates = RandomCandidates(rng, count);
+		auto expected = SortedDistances(candidates);
+		expected.resize(256);
+
+		SelectNearestCandidates(candidates, 256);
+
+		REQUIRE(candidates.size() == 256);
+		REQUIRE(SortedDistances(candidates) == expected);
+
+		// each kept candidate is one of the originals, kept once
+		std::vector<bool> seen(count);
+		for (auto& candidate : candidates) {
+			REQUIRE_FALSE(seen[(uint)candidate.centre.x]);
+			seen[(uint)candidate.centre.x] = true;
+		}
+	}
+}
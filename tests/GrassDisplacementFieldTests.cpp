@@ -0,0 +1,130 @@
+#include "Features/GrassCollision/DisplacementField.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+
+namespace
+{
+	using Field = GrassDisplacementField;
+
+	// UpdateFieldCS: the cell a texel holds for the window starting at a_origin
+	Field::Cell GetTexelCell(const Field::Cell& a_origin, int32_t a_x, int32_t a_y)
+	{
+		auto positiveModulo = [](int32_t a_value) { return ((a_value % Field::Resolution) + Field::Resolution) % Field::Resolution; };
+		return { a_origin[0] + positiveModulo(a_x - a_origin[0]), a_origin[1] + positiveModulo(a_y - a_origin[1]) };
+	}
+
+	// UpdateFieldCS: whether a cell of the new window still holds what was written for the previous one
+	bool IsKept(const Field& a_field, const Field::Cell& a_cell)
+	{
+		auto& previous = a_field.GetPreviousOrigin();
+		return a_cell[0] >= previous[0] && a_cell[0] < previous[0] + Field::Resolution &&
+		       a_cell[1] >= previous[1] && a_cell[1] < previous[1] + Field::Resolution;
+	}
+
+	// GetFieldDisplacement: the texel a position relative to the eye samples, away from texel borders
+	std::array<int32_t, 2> GetSampledTexel(float2 a_relative, float2 a_textureOffset)
+	{
+		auto texel = [](float a_value) {
+			float uv = a_value / Field::Size;
+			return (int32_t)std::floor((uv - std::floor(uv)) * Field::Resolution) % Field::Resolution;
+		};
+		return { texel(a_relative.x + a_textureOffset.x), texel(a_relative.y + a_textureOffset.y) };
+	}
+}
+
+TEST_CASE("Cells round towards negative infinity", "[GrassDisplacementField]")
+{
+	REQUIRE(Field::GetCell(0.0f, 7.9f) == Field::Cell{ 0, 0 });
+	REQUIRE(Field::GetCell(8.0f, -0.1f) == Field::Cell{ 1, -1 });
+	REQUIRE(Field::GetCell(-8.0f, -8.1f) == Field::Cell{ -1, -2 });
+}
+
+TEST_CASE("The window is centred on the camera", "[GrassDisplacementField]")
+{
+	Field field;
+	field.Update({ 100.0f, -100.0f, 0.0f });
+
+	auto centre = Field::GetCell(100.0f, -100.0f);
+	REQUIRE(field.GetOrigin() == Field::Cell{ centre[0] - Field::Resolution / 2, centre[1] - Field::Resolution / 2 });
+
+	// the texel centres of UpdateFieldCS land on the centres of their cells
+	float3 eye{ 103.0f, -95.0f, 50.0f };
+	auto offset = field.GetOriginOffset(eye);
+	for (int32_t index : { 0, 17, Field::Resolution - 1 }) {
+		float x = offset.x + (index + 0.5f) * Field::CellSize + eye.x;
+		float y = offset.y + (index + 0.5f) * Field::CellSize + eye.y;
+		REQUIRE(Field::GetCell(x, y) == Field::Cell{ field.GetOrigin()[0] + index, field.GetOrigin()[1] + index });
+	}
+}
+
+TEST_CASE("Scrolling keeps the cells both windows share", "[GrassDisplacementField]")
+{
+	Field field;
+	field.Update({ 0.0f, 0.0f, 0.0f });
+
+	// nothing survives the first update
+	for (int32_t y = 0; y < Field::Resolution; y += 15)
+		for (int32_t x = 0; x < Field::Resolution; x += 15)
+			REQUIRE_FALSE(IsKept(field, GetTexelCell(field.GetOrigin(), x, y)));
+
+	auto previous = field.GetOrigin();
+	field.Update({ 5.0f * Field::CellSize, -3.0f * Field::CellSize, 0.0f });
+	REQUIRE(field.GetPreviousOrigin() == previous);
+	REQUIRE(field.GetOrigin() == Field::Cell{ previous[0] + 5, previous[1] - 3 });
+
+	uint kept = 0;
+	for (int32_t y = 0; y < Field::Resolution; y++) {
+		for (int32_t x = 0; x < Field::Resolution; x++) {
+			// a kept texel held the same cell in the previous window
+			auto cell = GetTexelCell(field.GetOrigin(), x, y);
+			if (IsKept(field, cell)) {
+				REQUIRE(GetTexelCell(previous, x, y) == cell);
+				kept++;
+			}
+		}
+	}
+	REQUIRE(kept == (Field::Resolution - 5) * (Field::Resolution - 3));
+
+	// a reset clears the whole field again
+	field.Reset();
+	field.Update({ 5.0f * Field::CellSize, -3.0f * Field::CellSize, 0.0f });
+	REQUIRE_FALSE(IsKept(field, field.GetOrigin()));
+}
+
+TEST_CASE("Grass samples the texel its cell was written to", "[GrassDisplacementField]")
+{
+	std::mt19937 rng(13);
+	std::uniform_real_distribution<float> world(-250000.0f, 250000.0f), nearby(-900.0f, 900.0f), inCell(0.1f, 0.9f);
+
+	for (uint i = 0; i < 10000; i++) {
+		float3 eye{ world(rng), world(rng), 0.0f };
+		Field field;
+		field.Update(eye);
+
+		// a position near the eye, kept off cell borders where either side is a valid filtered sample
+		auto cell = Field::GetCell(eye.x + nearby(rng), eye.y + nearby(rng));
+		double x = (cell[0] + inCell(rng)) * (double)Field::CellSize;
+		double y = (cell[1] + inCell(rng)) * (double)Field::CellSize;
+		float2 relative{ (float)(x - eye.x), (float)(y - eye.y) };
+
+		auto texel = GetSampledTexel(relative, Field::GetTextureOffset(eye));
+		REQUIRE(GetTexelCell(field.GetOrigin(), texel[0], texel[1]) == cell);
+	}
+}
+
+TEST_CASE("Displacement fades over the trail duration", "[GrassDisplacementField]")
+{
+	REQUIRE(Field::GetDecay(1.0f / 60.0f, 0.0f) == 0.0f);
+	REQUIRE(Field::GetDecay(0.0f, 2.0f) == 1.0f);
+	REQUIRE(Field::GetDecay(-1.0f, 2.0f) == 1.0f);
+	REQUIRE(Field::GetDecay(2.0f, 2.0f) == Catch::Approx(std::exp(-1.0f)));
+
+	// the frame rate does not change how fast trails fade
+	float perFrame = 1.0f;
+	for (uint frame = 0; frame < 144; frame++)
+		perFrame *= Field::GetDecay(1.0f / 144.0f, 2.0f);
+	REQUIRE(perFrame == Catch::Approx(Field::GetDecay(1.0f, 2.0f)));
+}
@@ -0,0 +1,110 @@
+#include "Features/TerrainOcclusion/OcclusionCache.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <numbers>
+
+TEST_CASE("Sun bucket directions map back to their own bucket", "[OcclusionCache]")
+{
+	for (uint bucket = 0; bucket < OcclusionCache::SunBucketCount; bucket++)
+		REQUIRE(OcclusionCache::GetSunBucket(OcclusionCache::GetSunBucketDirection(bucket)) == bucket);
+}
+
+TEST_CASE("Sun directions stay within half a bucket of their bucket direction", "[OcclusionCache]")
+{
+	constexpr float pi = std::numbers::pi_v<float>;
+	constexpr float maxAzimuthStep = 2 * pi / OcclusionCache::SunAzimuthBuckets;
+	constexpr float maxElevationStep = .5f * pi / OcclusionCache::SunElevationBuckets;
+	const float maxAngle = .5f * std::sqrt(maxAzimuthStep * maxAzimuthStep + maxElevationStep * maxElevationStep) + 1e-3f;
+
+	for (uint i = 0; i < 360; i++) {
+		for (uint j = 1; j < 90; j++) {
+			float azimuth = i * pi / 180;
+			float elevation = j * pi / 180;
+			float3 direction = { std::cos(elevation) * std::cos(azimuth), std::cos(elevation) * std::sin(azimuth), -std::sin(elevation) };
+
+			float3 bucketDirection = OcclusionCache::GetSunBucketDirection(OcclusionCache::GetSunBucket(direction));
+			REQUIRE(std::acos(std::clamp(direction.Dot(bucketDirection), -1.f, 1.f)) <= maxAngle);
+		}
+	}
+}
+
+TEST_CASE("Validate drops only the results a key change invalidates", "[OcclusionCache]")
+{
+	auto dir = std::filesystem::temp_directory_path() / "OcclusionCacheTests";
+	OcclusionCache cache{ dir };
+	cache.Clear();
+
+	OcclusionCache::Key key{ 1, 2, 3 };
+	REQUIRE(cache.Validate("Tamriel", key));
+	cache.AddOcclusion("Tamriel", key);
+	cache.AddShadow("Tamriel", key, 5);
+	REQUIRE_FALSE(cache.Validate("Tamriel", key));
+
+	auto shadowKey = key;
+	shadowKey.shadowSettingsHash = 4;
+	REQUIRE(cache.Validate("Tamriel", shadowKey));
+	REQUIRE(cache.HasOcclusion("Tamriel", shadowKey));
+	REQUIRE_FALSE(cache.HasShadow("Tamriel", shadowKey, 5));
+
+	// late results of the superseded key are dropped
+	cache.AddShadow("Tamriel", key, 6);
+	REQUIRE_FALSE(cache.HasShadow("Tamriel", shadowKey, 6));
+
+	auto heightmapKey = shadowKey;
+	heightmapKey.heightmapHash = 7;
+	cache.AddShadow("Tamriel", shadowKey, 5);
+	REQUIRE(cache.Validate("Tamriel", heightmapKey));
+	REQUIRE_FALSE(cache.HasOcclusion("Tamriel", heightmapKey));
+	REQUIRE_FALSE(cache.HasShadow("Tamriel", heightmapKey, 5));
+
+	cache.Clear();
+}
+
+TEST_CASE("Each part of the key follows only what its results read", "[OcclusionCache]")
+{
+	const std::string heightmap = "DDS height map bytes";
+	const OcclusionCache::OcclusionSettings occlusion{ .aoDistance = 12.f, .sliceCount = 60, .sampleCount = 60 };
+	const auto key = OcclusionCache::MakeKey(heightmap, occlusion, .01f);
+
+	auto same = OcclusionCache::MakeKey(std::string(heightmap), occlusion, .01f);
+	REQUIRE(same.heightmapHash == key.heightmapHash);
+	REQUIRE(same.occlusionSettingsHash == key.occlusionSettingsHash);
+	REQUIRE(same.shadowSettingsHash == key.shadowSettingsHash);
+
+	auto otherHeightmap = OcclusionCache::MakeKey("DDS height map byteS", occlusion, .01f);
+	REQUIRE(otherHeightmap.heightmapHash != key.heightmapHash);
+	REQUIRE(otherHeightmap.occlusionSettingsHash == key.occlusionSettingsHash);
+	REQUIRE(otherHeightmap.shadowSettingsHash == key.shadowSettingsHash);
+
+	for (auto otherOcclusion : { OcclusionCache::OcclusionSettings{ 13.f, 60, 60 }, OcclusionCache::OcclusionSettings{ 12.f, 61, 60 }, OcclusionCache::OcclusionSettings{ 12.f, 60, 59 } }) {
+		auto otherSettings = OcclusionCache::MakeKey(heightmap, otherOcclusion, .01f);
+		CHECK(otherSettings.heightmapHash == key.heightmapHash);
+		CHECK(otherSettings.occlusionSettingsHash != key.occlusionSettingsHash);
+		CHECK(otherSettings.shadowSettingsHash == key.shadowSettingsHash);
+	}
+
+	auto otherShadow = OcclusionCache::MakeKey(heightmap, occlusion, .02f);
+	REQUIRE(otherShadow.heightmapHash == key.heightmapHash);
+	REQUIRE(otherShadow.occlusionSettingsHash == key.occlusionSettingsHash);
+	REQUIRE(otherShadow.shadowSettingsHash != key.shadowSettingsHash);
+	REQUIRE(otherShadow.shadowSettingsHash == OcclusionCache::GetShadowSettingsHash(.02f));
+}
+
+TEST_CASE("Sun directions seen in game are kept without their shadows", "[OcclusionCache]")
+{
+	auto dir = std::filesystem::temp_directory_path() / "OcclusionCacheTests";
+	OcclusionCache cache{ dir };
+	cache.Clear();
+
+	OcclusionCache::Key key{ 1, 2, 3 };
+	cache.Validate("Tamriel", key);
+	REQUIRE(cache.AddVisitedSunBucket(5));
+	REQUIRE_FALSE(cache.AddVisitedSunBucket(5));
+	REQUIRE_FALSE(cache.HasShadow("Tamriel", key, 5));
+
+	cache.AddShadow("Tamriel", key, 6);
+	REQUIRE(cache.GetVisitedSunBuckets() == std::vector<uint>{ 5, 6 });
+
+	cache.Clear();
+}
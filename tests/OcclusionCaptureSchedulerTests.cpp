@@ -0,0 +1,107 @@
+#include "Features/Skylighting/OcclusionCaptureScheduler.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+	constexpr float Extent = 10000.f;  // moves of more than 625 units recapture
+
+	// runs frames of a_deltaTime along a camera path, returning the frames that captured
+	std::vector<uint> Run(OcclusionCaptureScheduler& a_scheduler, uint a_frames, float a_deltaTime, auto a_eyePos, bool a_probesPending = false)
+	{
+		std::vector<uint> captures;
+		for (uint frame = 0; frame < a_frames; ++frame) {
+			a_scheduler.Update(a_deltaTime);
+			const float3 eyePos = a_eyePos(frame);
+			if (a_scheduler.ShouldCapture(eyePos, Extent, a_probesPending)) {
+				a_scheduler.OnCapture(eyePos);
+				captures.push_back(frame);
+			}
+		}
+		return captures;
+	}
+
+	auto Still(float3 a_eyePos = {})
+	{
+		return [=](uint) { return a_eyePos; };
+	}
+
+	auto Walk(float a_unitsPerFrame)
+	{
+		return [=](uint a_frame) { return float3{ a_unitsPerFrame * (float)a_frame, 0, 0 }; };
+	}
+}
+
+TEST_CASE("A still camera is captured once", "[OcclusionCaptureScheduler]")
+{
+	OcclusionCaptureScheduler scheduler;
+	REQUIRE(scheduler.GetOffsetSinceCapture({ 1, 2, 3 }) == float3{ 0, 0, 0 });
+
+	REQUIRE(Run(scheduler, 300, 1.f / 60.f, Still({ 100, 0, 0 })) == std::vector<uint>{ 0 });
+	REQUIRE(scheduler.GetOffsetSinceCapture({ 150, 0, 0 }) == float3{ 50, 0, 0 });
+}
+
+TEST_CASE("Pending probes are captured at the convergence rate", "[OcclusionCaptureScheduler]")
+{
+	OcclusionCaptureScheduler scheduler;
+
+	// 1/8 s is 6.25 frames at 50 fps
+	const auto captures = Run(scheduler, 50, 1.f / 50.f, Still(), true);
+	REQUIRE(captures == std::vector<uint>{ 0, 7, 14, 21, 28, 35, 42, 49 });
+}
+
+TEST_CASE("Walking recaptures every threshold of distance", "[OcclusionCaptureScheduler]")
+{
+	OcclusionCaptureScheduler scheduler;
+
+	// 100 units a frame, the seventh frame is the first more than 625 units away
+	const auto captures = Run(scheduler, 30, 1.f / 60.f, Walk(100));
+	REQUIRE(captures == std::vector<uint>{ 0, 7, 14, 21, 28 });
+}
+
+TEST_CASE("Fast travel is limited to the maximum capture rate", "[OcclusionCaptureScheduler]")
+{
+	OcclusionCaptureScheduler scheduler;
+
+	// every frame moves past the threshold, but at 100 fps only every fourth frame is 1/30 s after the last capture
+	const auto captures = Run(scheduler, 100, 1.f / 100.f, Walk(1000));
+	REQUIRE(captures.size() == 25);
+	for (size_t i = 1; i < captures.size(); ++i)
+		CHECK(captures[i] - captures[i - 1] == 4);
+
+	// at 20 fps nothing holds it back
+	REQUIRE(Run(scheduler, 20, 1.f / 20.f, Walk(1000)).size() == 20);
+}
+
+TEST_CASE("Rate limits follow game frame time, not frame count", "[OcclusionCaptureScheduler]")
+{
+	OcclusionCaptureScheduler scheduler;
+	Run(scheduler, 1, 1.f / 60.f, Still());
+
+	// a single long frame is enough to recapture converging probes
+	REQUIRE(Run(scheduler, 1, 0.2f, Still(), true).size() == 1);
+
+	// and while the game is paused no time passes
+	REQUIRE(Run(scheduler, 100, 0.f, Still(), true).empty());
+}
+
+TEST_CASE("Geometry changes recapture once streaming settles", "[OcclusionCaptureScheduler]")
+{
+	OcclusionCaptureScheduler scheduler;
+	Run(scheduler, 1, 1.f / 50.f, Still());
+
+	// cells attach over ten frames at 50 fps
+	std::vector<uint> captures;
+	for (uint frame = 0; frame < 40; ++frame) {
+		if (frame < 10)
+			scheduler.OnGeometryChanged();
+		scheduler.Update(1.f / 50.f);
+		if (scheduler.ShouldCapture({}, Extent, false)) {
+			scheduler.OnCapture({});
+			captures.push_back(frame);
+		}
+	}
+
+	// 0.25 s is 12.5 frames after the last change on frame 9
+	REQUIRE(captures == std::vector<uint>{ 22 });
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+// Precompiled header of the test runner. The tested sources see only what is declared here, without the game,
+// SKSE or Windows headers, so the runner also builds and runs off Windows.
+
+#include <cstddef>
+#include <new>
+void* operator new[](std::size_t size, const char* pName, int flags, unsigned debugFlags, const char* file, int line);
+void* operator new[](std::size_t size, std::size_t alignment, std::size_t alignmentOffset, const char* pName, int flags,
+	unsigned debugFlags, const char* file, int line);
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std::literals;
+
+#include <spdlog/spdlog.h>
+namespace logger = spdlog;
+
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+#include <EASTL/fixed_vector.h>
+
+#include <ankerl/unordered_dense.h>
+
+#include <DirectXMath.h>
+
+// The members of the SimpleMath vectors that the tested sources use, on the same DirectXMath storage
+struct float2 : DirectX::XMFLOAT2
+{
+	float2() :
+		XMFLOAT2{ 0.0f, 0.0f } {}
+	float2(float a_x, float a_y) :
+		XMFLOAT2{ a_x, a_y } {}
+
+	float2 operator+(const float2& a_other) const { return { x + a_other.x, y + a_other.y }; }
+	float2 operator-(const float2& a_other) const { return { x - a_other.x, y - a_other.y }; }
+	float2 operator*(float a_scale) const { return { x * a_scale, y * a_scale }; }
+	float2 operator/(float a_scale) const { return { x / a_scale, y / a_scale }; }
+	bool operator==(const float2& a_other) const { return x == a_other.x && y == a_other.y; }
+
+	float Dot(const float2& a_other) const { return x * a_other.x + y * a_other.y; }
+	float Length() const { return std::sqrt(Dot(*this)); }
+
+	static float Distance(const float2& a_first, const float2& a_second) { return (a_first - a_second).Length(); }
+};
+
+struct float3 : DirectX::XMFLOAT3
+{
+	float3() :
+		XMFLOAT3{ 0.0f, 0.0f, 0.0f } {}
+	float3(float a_x, float a_y, float a_z) :
+		XMFLOAT3{ a_x, a_y, a_z } {}
+
+	float3 operator+(const float3& a_other) const { return { x + a_other.x, y + a_other.y, z + a_other.z }; }
+	float3 operator-(const float3& a_other) const { return { x - a_other.x, y - a_other.y, z - a_other.z }; }
+	float3 operator-() const { return { -x, -y, -z }; }
+	float3 operator*(float a_scale) const { return { x * a_scale, y * a_scale, z * a_scale }; }
+	float3 operator/(float a_scale) const { return { x / a_scale, y / a_scale, z / a_scale }; }
+	bool operator==(const float3& a_other) const { return x == a_other.x && y == a_other.y && z == a_other.z; }
+
+	float Dot(const float3& a_other) const { return x * a_other.x + y * a_other.y + z * a_other.z; }
+	float3 Cross(const float3& a_other) const { return { y * a_other.z - z * a_other.y, z * a_other.x - x * a_other.z, x * a_other.y - y * a_other.x }; }
+	float Length() const { return std::sqrt(Dot(*this)); }
+
+	void Normalize()
+	{
+		if (float length = Length(); length > 0.0f)
+			*this = *this / length;
+	}
+};
+
+struct float4 : DirectX::XMFLOAT4
+{
+	float4() :
+		XMFLOAT4{ 0.0f, 0.0f, 0.0f, 0.0f } {}
+	float4(float a_x, float a_y, float a_z, float a_w) :
+		XMFLOAT4{ a_x, a_y, a_z, a_w } {}
+
+	bool operator==(const float4& a_other) const { return x == a_other.x && y == a_other.y && z == a_other.z && w == a_other.w; }
+};
+
+using uint = uint32_t;
@@ -0,0 +1,47 @@
+#include "Features/TerrainOcclusion/PrecomputeTiles.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+	float SquaredDistance(const std::pair<uint, uint>& a_tile, float a_playerX, float a_playerY)
+	{
+		const float dx = a_tile.first + .5f - a_playerX;
+		const float dy = a_tile.second + .5f - a_playerY;
+		return dx * dx + dy * dy;
+	}
+}
+
+TEST_CASE("Every tile of the height map is scheduled once", "[PrecomputeTiles]")
+{
+	// the last column and row are partial
+	const auto tiles = PrecomputeTiles::Order(1000, 600, 256, { .3f, .7f });
+	REQUIRE(tiles.size() == 4 * 3);
+
+	const std::set<std::pair<uint, uint>> unique(tiles.begin(), tiles.end());
+	REQUIRE(unique.size() == tiles.size());
+	for (auto [x, y] : tiles) {
+		CHECK(x < 4);
+		CHECK(y < 3);
+	}
+
+	REQUIRE(PrecomputeTiles::Order(1024, 512, 256, { .5f, .5f }).size() == 4 * 2);
+	REQUIRE(PrecomputeTiles::Order(1, 1, 256, { .5f, .5f }) == std::vector<std::pair<uint, uint>>{ { 0, 0 } });
+}
+
+TEST_CASE("Tiles nearest to the player come last", "[PrecomputeTiles]")
+{
+	// player over tile 1, 2 of an 8 by 4 grid
+	const auto tiles = PrecomputeTiles::Order(2048, 1024, 256, { 1.5f / 8, 2.5f / 4 });
+	REQUIRE(tiles.size() == 8 * 4);
+	REQUIRE(tiles.back() == std::pair<uint, uint>{ 1, 2 });
+
+	for (size_t i = 1; i < tiles.size(); ++i)
+		CHECK(SquaredDistance(tiles[i - 1], 1.5f, 2.5f) >= SquaredDistance(tiles[i], 1.5f, 2.5f));
+}
+
+TEST_CASE("A player off the height map starts from the nearest edge", "[PrecomputeTiles]")
+{
+	REQUIRE(PrecomputeTiles::Order(1024, 1024, 256, { -3.f, .6f }).back() == std::pair<uint, uint>{ 0, 2 });
+	REQUIRE(PrecomputeTiles::Order(1024, 1024, 256, { 5.f, 7.f }).back() == std::pair<uint, uint>{ 3, 3 });
+}
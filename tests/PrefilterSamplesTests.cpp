@@ -0,0 +1,116 @@
+#include "Features/DynamicCubemaps/PrefilterSamples.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <numbers>
+
+namespace
+{
+	constexpr uint InputSize = 128;
+	constexpr uint MipCount = PrefilterSamples::MaxMips + 1;
+
+	// Per texel loop of the shader before the table, with the sample filter and source mip of the NVIDIA article.
+	struct ReferenceSample
+	{
+		float3 halfVector;
+		float sourceMip;
+	};
+
+	std::vector<ReferenceSample> GenerateReference(uint a_mip)
+	{
+		float roughness = PrefilterSamples::GetRoughness(a_mip, MipCount);
+		float alpha = roughness * roughness;
+		float wt = 4.0f * std::numbers::pi_v<float> / (6.0f * InputSize * InputSize);
+
+		std::vector<ReferenceSample> samples;
+		for (uint i = 0; i < PrefilterSamples::SampleCount; i++) {
+			uint bits = i;
+			bits = (bits << 16u) | (bits >> 16u);
+			bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+			bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+			bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+			bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+			float u1 = float(i) / PrefilterSamples::SampleCount;
+			float u2 = float(bits) * 2.3283064365386963e-10f;
+
+			float cosTheta = std::sqrt((1.0f - u2) / (1.0f + (alpha * alpha - 1.0f) * u2));
+			float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+			float phi = 2.0f * std::numbers::pi_v<float> * u1;
+			float3 lh = { sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta };
+
+			// Li = 2 dot(N, Lh) Lh - N with N = +z
+			float cosLi = 2.0f * lh.z * lh.z - 1.0f;
+			if (cosLi <= 0.0f)
+				continue;
+
+			float alphaSq = alpha * alpha;
+			float denom = cosTheta * cosTheta * (alphaSq - 1.0f) + 1.0f;
+			float pdf = alphaSq / (std::numbers::pi_v<float> * denom * denom) * 0.25f;
+			float ws = 1.0f / (PrefilterSamples::SampleCount * pdf);
+			samples.push_back({ lh, std::max(0.5f * std::log2(ws / wt) + 1.0f, 0.0f) });
+		}
+		return samples;
+	}
+}
+
+TEST_CASE("Sample table matches the per texel generator", "[PrefilterSamples]")
+{
+	auto table = PrefilterSamples::Generate(InputSize, MipCount);
+
+	for (uint mip = 1; mip < MipCount; mip++) {
+		auto reference = GenerateReference(mip);
+		REQUIRE(table.mips[mip - 1].count == reference.size());
+
+		for (uint i = 0; i < reference.size(); i++) {
+			auto& sample = table.samples[(mip - 1) * PrefilterSamples::SampleCount + i];
+			REQUIRE(sample.x == Catch::Approx(reference[i].halfVector.x).margin(1e-6));
+			REQUIRE(sample.y == Catch::Approx(reference[i].halfVector.y).margin(1e-6));
+			REQUIRE(sample.z == Catch::Approx(reference[i].halfVector.z).margin(1e-6));
+			REQUIRE(sample.w == Catch::Approx(reference[i].sourceMip).margin(1e-4));
+		}
+	}
+}
+
+TEST_CASE("Samples are unit half vectors above the horizon", "[PrefilterSamples]")
+{
+	auto table = PrefilterSamples::Generate(InputSize, MipCount);
+
+	for (uint mip = 1; mip < MipCount; mip++) {
+		auto count = table.mips[mip - 1].count;
+		REQUIRE(count > 0);
+		REQUIRE(count <= PrefilterSamples::SampleCount);
+
+		for (uint i = 0; i < count; i++) {
+			auto& sample = table.samples[(mip - 1) * PrefilterSamples::SampleCount + i];
+			REQUIRE(sample.x * sample.x + sample.y * sample.y + sample.z * sample.z == Catch::Approx(1.0f));
+			REQUIRE(2.0f * sample.z * sample.z - 1.0f > 0.0f);
+			REQUIRE(sample.w >= 0.0f);
+		}
+	}
+}
+
+TEST_CASE("Rougher mips keep fewer samples and read blurrier source mips", "[PrefilterSamples]")
+{
+	auto table = PrefilterSamples::Generate(InputSize, MipCount);
+
+	// the first Hammersley point is the normal itself, at the blurriest source mip of its level
+	for (uint mip = 2; mip < MipCount; mip++) {
+		REQUIRE(table.mips[mip - 1].count <= table.mips[mip - 2].count);
+		REQUIRE(table.samples[(mip - 1) * PrefilterSamples::SampleCount].w >= table.samples[(mip - 2) * PrefilterSamples::SampleCount].w);
+	}
+	REQUIRE(table.mips[0].count == PrefilterSamples::SampleCount);
+}
+
+TEST_CASE("Levels past the output mip count stay empty", "[PrefilterSamples]")
+{
+	auto table = PrefilterSamples::Generate(InputSize, 4);
+
+	for (uint mip = 1; mip < 4; mip++)
+		REQUIRE(table.mips[mip - 1].count > 0);
+	for (uint mip = 4; mip <= PrefilterSamples::MaxMips; mip++)
+		REQUIRE(table.mips[mip - 1].count == 0);
+
+	REQUIRE(PrefilterSamples::GetRoughness(0, 4) == 0.0f);
+	REQUIRE(PrefilterSamples::GetRoughness(3, 4) == 1.0f);
+}
@@ -0,0 +1,161 @@
+#include "Features/Skylighting/ProbeBrickScheduler.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+	// an occlusion capture covering every probe, or with a_xScale only those where a_xScale * x + a_xOffset is in (-1, 1)
+	ProbeBrickScheduler::Frame MakeFrame(float a_xScale = 0, float a_xOffset = 0)
+	{
+		ProbeBrickScheduler::Frame frame{};
+		frame.occlusionViewProj._11 = a_xScale;
+		frame.occlusionViewProj._14 = a_xOffset;
+		return frame;
+	}
+
+	std::array<uint, 3> Unpack(uint a_brick)
+	{
+		return { a_brick & 0xFF, (a_brick >> 8) & 0xFF, a_brick >> 16 };
+	}
+
+	// runs a full update of every brick for each capture until they converge
+	void Converge(ProbeBrickScheduler& a_scheduler, const ProbeBrickScheduler::Frame& a_frame, uint& a_captureIndex)
+	{
+		a_scheduler.Schedule(a_frame, a_captureIndex, 0);
+		while (!a_scheduler.Schedule(a_frame, ++a_captureIndex, a_scheduler.GetBrickCount()).empty()) {}
+	}
+}
+
+TEST_CASE("Every brick is dispatched after a resize whatever the budget", "[ProbeBrickScheduler]")
+{
+	ProbeBrickScheduler scheduler;
+	scheduler.Resize({ 64, 64, 32 });
+	REQUIRE(scheduler.GetBrickCount() == 8 * 8 * 4);
+
+	const auto frame = MakeFrame();
+	REQUIRE(scheduler.Schedule(frame, 0, 0).size() == scheduler.GetBrickCount());
+	REQUIRE(scheduler.GetPendingBricks() == scheduler.GetBrickCount());
+
+	// nothing new to accumulate until the next capture, the bricks still have to converge
+	REQUIRE(scheduler.Schedule(frame, 0, scheduler.GetBrickCount()).empty());
+	REQUIRE(scheduler.GetPendingBricks() == scheduler.GetBrickCount());
+}
+
+TEST_CASE("The budget goes to the bricks nearest the camera", "[ProbeBrickScheduler]")
+{
+	ProbeBrickScheduler scheduler;
+	scheduler.Resize({ 64, 64, 32 });
+	const auto frame = MakeFrame();
+	scheduler.Schedule(frame, 0, 0);
+
+	// the camera sits in the centre cell, brick 4, 4, 2, and 26 bricks surround it
+	const auto& bricks = scheduler.Schedule(frame, 1, 10);
+	REQUIRE(bricks.size() == 10);
+	for (auto brick : bricks) {
+		const auto [x, y, z] = Unpack(brick);
+		CHECK(std::max({ x > 4 ? x - 4 : 4 - x, y > 4 ? y - 4 : 4 - y, z > 2 ? z - 2 : 2 - z }) <= 1);
+	}
+	const std::set<uint> first(bricks.begin(), bricks.end());
+
+	// the rest of the capture goes to the others
+	const auto& rest = scheduler.Schedule(frame, 1, scheduler.GetBrickCount());
+	REQUIRE(rest.size() == scheduler.GetBrickCount() - 10);
+	for (auto brick : rest)
+		CHECK_FALSE(first.contains(brick));
+	REQUIRE(scheduler.GetPendingBricks() == scheduler.GetBrickCount());
+}
+
+TEST_CASE("Bricks missing more captures come first", "[ProbeBrickScheduler]")
+{
+	ProbeBrickScheduler scheduler;
+	scheduler.Resize({ 16, 16, 16 });
+	const auto frame = MakeFrame();
+	scheduler.Schedule(frame, 0, 0);
+
+	const auto updated = scheduler.Schedule(frame, 1, 4);
+	REQUIRE(updated.size() == 4);
+
+	// every brick but the camera's, 1, 1, 1, is one away, those that missed two captures beat those that missed one
+	const auto& bricks = scheduler.Schedule(frame, 2, 4);
+	REQUIRE(bricks.size() == 4);
+	for (auto brick : bricks) {
+		if (Unpack(brick) != std::array<uint, 3>{ 1, 1, 1 })
+			CHECK(std::ranges::find(updated, brick) == updated.end());
+	}
+}
+
+TEST_CASE("Bricks outside the capture are neither budgeted nor pending", "[ProbeBrickScheduler]")
+{
+	ProbeBrickScheduler scheduler;
+	scheduler.Resize({ 16, 16, 16 });
+
+	// probe centres of brick x 1 span 312 to 4688 units, those of brick x 0 mirror them
+	const auto frame = MakeFrame(1.f / 1000.f, -4.f);
+	REQUIRE(scheduler.IsInCapture({ 1, 0, 0 }, frame));
+	REQUIRE_FALSE(scheduler.IsInCapture({ 0, 0, 0 }, frame));
+
+	// exposed bricks are dispatched anyway, updateProbes resets them
+	REQUIRE(scheduler.Schedule(frame, 0, 0).size() == 8);
+	REQUIRE(scheduler.GetPendingBricks() == 4);
+
+	const auto& bricks = scheduler.Schedule(frame, 1, 8);
+	REQUIRE(bricks.size() == 4);
+	for (auto brick : bricks)
+		CHECK(Unpack(brick)[0] == 1);
+	REQUIRE(scheduler.GetPendingBricks() == 4);
+}
+
+TEST_CASE("Converged bricks are no longer pending", "[ProbeBrickScheduler]")
+{
+	ProbeBrickScheduler scheduler;
+	scheduler.Resize({ 16, 16, 16 });
+	const auto frame = MakeFrame();
+
+	uint captureIndex = 0;
+	Converge(scheduler, frame, captureIndex);
+
+	// exposed once, then one update per capture
+	REQUIRE(captureIndex == ProbeBrickScheduler::FadeInThreshold);
+	REQUIRE(scheduler.GetPendingBricks() == 0);
+	REQUIRE(scheduler.Schedule(frame, captureIndex + 1, 8).empty());
+}
+
+TEST_CASE("Newly exposed slabs are dispatched on top of the budget", "[ProbeBrickScheduler]")
+{
+	ProbeBrickScheduler scheduler;
+	scheduler.Resize({ 16, 16, 16 });
+	const auto frame = MakeFrame();
+	uint captureIndex = 0;
+	Converge(scheduler, frame, captureIndex);
+
+	const uint arrayOrigin[4] = {};
+
+	SECTION("moving forward exposes the first cells")
+	{
+		scheduler.Expose(arrayOrigin, { 8, 0, 0, 0 });
+		const auto& bricks = scheduler.Schedule(frame, captureIndex, 0);
+		REQUIRE(bricks.size() == 4);
+		for (auto brick : bricks)
+			CHECK(Unpack(brick)[0] == 0);
+		REQUIRE(scheduler.GetPendingBricks() == 4);
+	}
+
+	SECTION("moving back exposes the last cells")
+	{
+		scheduler.Expose(arrayOrigin, { 0, -1, 0, 0 });
+		const auto& bricks = scheduler.Schedule(frame, captureIndex, 0);
+		REQUIRE(bricks.size() == 4);
+		for (auto brick : bricks)
+			CHECK(Unpack(brick)[1] == 1);
+	}
+
+	SECTION("moving further than the array exposes everything")
+	{
+		scheduler.Expose(arrayOrigin, { 0, 0, -16, 0 });
+		REQUIRE(scheduler.Schedule(frame, captureIndex, 0).size() == 8);
+	}
+
+	// exposure lasts a single frame
+	scheduler.Schedule(frame, captureIndex, 0);
+	REQUIRE(scheduler.Schedule(frame, captureIndex, 0).empty());
+}
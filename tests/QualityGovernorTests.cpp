@@ -0,0 +1,124 @@
+#include "Features/ScreenSpaceGI/QualityGovernor.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+	constexpr QualityGovernor::Quality Ceiling{ .numSlices = 6, .numSteps = 8, .blurPasses = 3, .updateInterval = 1 };
+
+	// GPU time of a quality, proportional to the work it does
+	float GetCost(const QualityGovernor::Quality& a_quality)
+	{
+		return .05f * a_quality.numSlices * a_quality.numSteps / a_quality.updateInterval + .3f * a_quality.blurPasses;
+	}
+}
+
+TEST_CASE("Levels walk down from the ceiling one setting at a time", "[QualityGovernor]")
+{
+	QualityGovernor governor;
+	governor.SetCeiling(Ceiling);
+
+	REQUIRE(governor.GetLevel() == governor.GetLevelCount() - 1);
+	REQUIRE(governor.GetQuality() == Ceiling);
+
+	QualityGovernor::Quality previous = governor.GetQuality();
+	for (uint i = 0; i < governor.GetLevelCount() - 1; i++) {
+		uint level = governor.GetLevel();
+		while (governor.GetLevel() == level)
+			governor.Update(100.f, 1.f);
+
+		auto& quality = governor.GetQuality();
+		uint changed = (quality.numSlices != previous.numSlices) + (quality.numSteps != previous.numSteps) +
+		               (quality.blurPasses != previous.blurPasses) + (quality.updateInterval != previous.updateInterval);
+		REQUIRE(changed == 1);
+		REQUIRE(GetCost(quality) < GetCost(previous));
+		previous = quality;
+	}
+
+	REQUIRE(governor.GetLevel() == 0);
+	REQUIRE(previous == QualityGovernor::Quality{ .numSlices = 1, .numSteps = 2, .blurPasses = 1, .updateInterval = QualityGovernor::MaxUpdateInterval });
+}
+
+TEST_CASE("Quality holds while measurements settle", "[QualityGovernor]")
+{
+	QualityGovernor governor;
+	governor.SetCeiling(Ceiling);
+
+	for (uint i = 0; i < QualityGovernor::SettleSamples - 1; i++)
+		governor.Update(100.f, 1.f);
+	REQUIRE(governor.GetLevel() == governor.GetLevelCount() - 1);
+}
+
+TEST_CASE("Quality stays at the ceiling within budget", "[QualityGovernor]")
+{
+	QualityGovernor governor;
+	governor.SetCeiling(Ceiling);
+
+	for (uint i = 0; i < 200; i++)
+		governor.Update(GetCost(governor.GetQuality()), GetCost(Ceiling) * 1.5f);
+	REQUIRE(governor.GetQuality() == Ceiling);
+}
+
+TEST_CASE("Quality settles on the best level within budget without flickering", "[QualityGovernor]")
+{
+	QualityGovernor governor;
+	governor.SetCeiling(Ceiling);
+	const float target = .5f * GetCost(Ceiling);
+
+	// deterministic noise of +-10%
+	uint seed = 1;
+	auto measure = [&]() {
+		seed = seed * 1664525u + 1013904223u;
+		return GetCost(governor.GetQuality()) * (.9f + .2f * (seed >> 8) / float(1 << 24));
+	};
+
+	for (uint i = 0; i < 100; i++)
+		governor.Update(measure(), target);
+
+	uint settled = governor.GetLevel();
+	REQUIRE(GetCost(governor.GetQuality()) <= target);
+	for (uint i = 0; i < QualityGovernor::RetrySamples / 2; i++) {
+		governor.Update(measure(), target);
+		REQUIRE(governor.GetLevel() == settled);
+	}
+
+	// the level above is only tried again once in a while
+	uint changes = 0;
+	for (uint i = 0; i < 10 * QualityGovernor::RetrySamples; i++) {
+		uint level = governor.GetLevel();
+		governor.Update(measure(), target);
+		changes += governor.GetLevel() != level;
+	}
+	REQUIRE(changes <= 2 * 10);
+}
+
+TEST_CASE("Quality recovers once the budget allows it", "[QualityGovernor]")
+{
+	QualityGovernor governor;
+	governor.SetCeiling(Ceiling);
+
+	for (uint i = 0; i < 500; i++)
+		governor.Update(GetCost(governor.GetQuality()), .1f);
+	REQUIRE(governor.GetLevel() == 0);
+
+	for (uint i = 0; i < 500; i++)
+		governor.Update(GetCost(governor.GetQuality()), 100.f);
+	REQUIRE(governor.GetQuality() == Ceiling);
+}
+
+TEST_CASE("Changing the ceiling starts again from the top", "[QualityGovernor]")
+{
+	QualityGovernor governor;
+	governor.SetCeiling(Ceiling);
+	for (uint i = 0; i < 100; i++)
+		governor.Update(100.f, 1.f);
+	REQUIRE(governor.GetLevel() < governor.GetLevelCount() - 1);
+
+	governor.SetCeiling(Ceiling);
+	REQUIRE(governor.GetLevel() < governor.GetLevelCount() - 1);
+
+	auto ceiling = Ceiling;
+	ceiling.numSteps = 6;
+	governor.SetCeiling(ceiling);
+	REQUIRE(governor.GetQuality() == ceiling);
+}
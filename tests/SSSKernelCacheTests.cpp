@@ -0,0 +1,157 @@
+#include "Features/SubsurfaceScattering/KernelCache.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+	// The scalar CalculateKernel that SubsurfaceScattering used before the cache, one channel at a time
+	float Gaussian(float a_falloff, float a_variance, float a_r)
+	{
+		float rr = a_r / (0.001f + a_falloff);
+		return std::exp((-(rr * rr)) / (2.0f * a_variance)) / (2.0f * 3.14f * a_variance);
+	}
+
+	float Profile(float a_falloff, float a_r)
+	{
+		return 0.100f * Gaussian(a_falloff, 0.0484f, a_r) +
+		       0.118f * Gaussian(a_falloff, 0.187f, a_r) +
+		       0.113f * Gaussian(a_falloff, 0.567f, a_r) +
+		       0.358f * Gaussian(a_falloff, 1.99f, a_r) +
+		       0.078f * Gaussian(a_falloff, 7.41f, a_r);
+	}
+
+	void CalculateReference(const float3& a_falloff, const float3& a_strength, float o_kernel[SSSS_N_SAMPLES][4])
+	{
+		constexpr uint nSamples = SSSS_N_SAMPLES;
+		const float RANGE = nSamples > 20 ? 3.0f : 2.0f;
+		const float EXPONENT = 2.0f;
+
+		float falloff[3] = { a_falloff.x, a_falloff.y, a_falloff.z };
+		float strength[3] = { a_strength.x, a_strength.y, a_strength.z };
+
+		float step = 2.0f * RANGE / (nSamples - 1);
+		for (uint i = 0; i < nSamples; i++) {
+			float o = -RANGE + float(i) * step;
+			float sign = o < 0.0f ? -1.0f : 1.0f;
+			o_kernel[i][3] = RANGE * sign * std::abs(std::pow(o, EXPONENT)) / std::pow(RANGE, EXPONENT);
+		}
+
+		for (uint i = 0; i < nSamples; i++) {
+			float w0 = i > 0 ? std::abs(o_kernel[i][3] - o_kernel[i - 1][3]) : 0.0f;
+			float w1 = i < nSamples - 1 ? std::abs(o_kernel[i][3] - o_kernel[i + 1][3]) : 0.0f;
+			float area = (w0 + w1) / 2.0f;
+			for (uint c = 0; c < 3; c++)
+				o_kernel[i][c] = area * Profile(falloff[c], o_kernel[i][3]);
+		}
+
+		float centre[4];
+		std::copy_n(o_kernel[nSamples / 2], 4, centre);
+		for (uint i = nSamples / 2; i > 0; i--)
+			std::copy_n(o_kernel[i - 1], 4, o_kernel[i]);
+		std::copy_n(centre, 4, o_kernel[0]);
+
+		for (uint c = 0; c < 3; c++) {
+			float sum = 0.0f;
+			for (uint i = 0; i < nSamples; i++)
+				sum += o_kernel[i][c];
+			for (uint i = 0; i < nSamples; i++)
+				o_kernel[i][c] /= sum;
+
+			o_kernel[0][c] = (1.0f - strength[c]) * 1.0f + strength[c] * o_kernel[0][c];
+			for (uint i = 1; i < nSamples; i++)
+				o_kernel[i][c] *= strength[c];
+		}
+	}
+
+	// the default human and base profiles, and a few extremes the menu allows
+	const std::pair<float3, float3> profiles[] = {
+		{ { 1.0f, 0.37f, 0.3f }, { 0.48f, 0.41f, 0.28f } },
+		{ { 1.0f, 0.37f, 0.3f }, { 0.43f, 0.23f, 0.22f } },
+		{ { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } },
+		{ { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f } },
+		{ { 0.05f, 0.5f, 0.95f }, { 0.9f, 0.1f, 0.5f } },
+	};
+}
+
+TEST_CASE("Kernels match the scalar generator", "[SSSKernelCache]")
+{
+	for (auto& [falloff, strength] : profiles) {
+		SSSKernel kernel;
+		SSSKernelCache::Calculate(falloff, strength, kernel);
+
+		float reference[SSSS_N_SAMPLES][4];
+		CalculateReference(falloff, strength, reference);
+
+		for (uint i = 0; i < SSSS_N_SAMPLES; i++) {
+			REQUIRE(kernel.Sample[i].x == Catch::Approx(reference[i][0]).margin(1e-6));
+			REQUIRE(kernel.Sample[i].y == Catch::Approx(reference[i][1]).margin(1e-6));
+			REQUIRE(kernel.Sample[i].z == Catch::Approx(reference[i][2]).margin(1e-6));
+			REQUIRE(kernel.Sample[i].w == reference[i][3]);
+		}
+	}
+}
+
+TEST_CASE("Kernel weights sum to one at full strength", "[SSSKernelCache]")
+{
+	SSSKernel kernel;
+	SSSKernelCache::Calculate({ 1.0f, 0.37f, 0.3f }, { 1.0f, 1.0f, 1.0f }, kernel);
+
+	float3 sum;
+	for (auto& sample : kernel.Sample)
+		sum = sum + float3(sample.x, sample.y, sample.z);
+
+	REQUIRE(sum.x == Catch::Approx(1.0f));
+	REQUIRE(sum.y == Catch::Approx(1.0f));
+	REQUIRE(sum.z == Catch::Approx(1.0f));
+	REQUIRE(kernel.Sample[0].w == 0.0f);
+}
+
+TEST_CASE("The cache keeps the newest profiles", "[SSSKernelCache]")
+{
+	SSSKernelCache cache;
+	auto [falloff, strength] = profiles[0];
+
+	SSSKernel expected;
+	SSSKernelCache::Calculate(falloff, strength, expected);
+	REQUIRE(cache.Get(falloff, strength).Sample[1].x == expected.Sample[1].x);
+
+	// a hit returns the stored kernel
+	REQUIRE(&cache.Get(falloff, strength) == &cache.Get(falloff, strength));
+
+	// dragging a colour adds a key per frame, the first profile ends up evicted and is computed again
+	for (uint i = 1; i <= SSSKernelCache::MaxEntries; i++) {
+		float3 dragged = { 0.5f, 0.5f, i / (float)SSSKernelCache::MaxEntries };
+		SSSKernel kernel;
+		SSSKernelCache::Calculate(dragged, strength, kernel);
+		REQUIRE(cache.Get(dragged, strength).Sample[1].z == kernel.Sample[1].z);
+	}
+	REQUIRE(cache.Get(falloff, strength).Sample[1].x == expected.Sample[1].x);
+}
+
+TEST_CASE("Kernel generation", "[.][benchmark][SSSKernelCache]")
+{
+	auto [falloff, strength] = profiles[0];
+
+	BENCHMARK("Calculate")
+	{
+		SSSKernel kernel;
+		SSSKernelCache::Calculate(falloff, strength, kernel);
+		return kernel.Sample[0].x;
+	};
+
+	BENCHMARK("Scalar generator")
+	{
+		float kernel[SSSS_N_SAMPLES][4];
+		CalculateReference(falloff, strength, kernel);
+		return kernel[0][0];
+	};
+
+	SSSKernelCache cache;
+	cache.Get(falloff, strength);
+	BENCHMARK("Cached")
+	{
+		return cache.Get(falloff, strength).Sample[0].x;
+	};
+}
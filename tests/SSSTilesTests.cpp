@@ -0,0 +1,107 @@
+#include "Features/SubsurfaceScattering/TileClassification.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <numbers>
+#include <random>
+
+TEST_CASE("Tile lists past the group limit wrap into y", "[SSSTiles]")
+{
+	REQUIRE(SSSTiles::GetDispatchArgs(0) == std::array<uint, 3>{ 0, 0, 1 });
+	REQUIRE(SSSTiles::GetDispatchArgs(1) == std::array<uint, 3>{ 1, 1, 1 });
+	REQUIRE(SSSTiles::GetDispatchArgs(65535) == std::array<uint, 3>{ 65535, 1, 1 });
+	REQUIRE(SSSTiles::GetDispatchArgs(65536) == std::array<uint, 3>{ 65535, 2, 1 });
+
+	// every tile of a 4K frame
+	constexpr uint tileCount = (3840 / 8) * (2160 / 8);
+	auto args = SSSTiles::GetDispatchArgs(tileCount);
+	REQUIRE(args[0] <= SSSTiles::MaxGroupsPerDimension);
+	REQUIRE(args[1] <= SSSTiles::MaxGroupsPerDimension);
+
+	// each listed tile has exactly one group, the ones past the end exit early
+	std::vector<uint> groups(tileCount);
+	for (uint y = 0; y < args[1]; y++) {
+		for (uint x = 0; x < args[0]; x++) {
+			uint index = SSSTiles::GetTileIndex(x, y);
+			if (index < tileCount)
+				groups[index]++;
+		}
+	}
+	REQUIRE(std::ranges::all_of(groups, [](uint a_count) { return a_count == 1; }));
+	REQUIRE(args[0] * args[1] - tileCount < args[0]);
+}
+
+TEST_CASE("Blur reach is the furthest vertical sample", "[SSSTiles]")
+{
+	// SSSSBlurCS steps by reach / 3 over kernel offsets in [-3, 3]
+	float depth = 150, amount = .8f, radius = 1.5f, projScale = 1.3f, height = 1080;
+	float finalStep = projScale / depth * height * amount * radius / 3.0f;
+	REQUIRE(3.0f * finalStep == Catch::Approx(SSSTiles::GetBlurReach(depth, amount, radius, projScale, height)));
+}
+
+TEST_CASE("Vertical samples only read tiles the horizontal pass covered", "[SSSTiles]")
+{
+	constexpr uint width = 203, height = 117;  // not multiples of the tile size
+	std::mt19937 rng(0x5EED);
+	std::uniform_real_distribution<float> unit(0, 1);
+
+	for (uint frame = 0; frame < 32; frame++) {
+		// a few skin blobs of random size, some crossing the frame edges
+		std::vector<float> amount(width * height), reach(width * height);
+		for (uint blob = 0; blob < 3; blob++) {
+			float cx = unit(rng) * width, cy = unit(rng) * height, r = 2 + unit(rng) * 20, blobReach = unit(rng) * 60;
+			for (uint y = 0; y < height; y++) {
+				for (uint x = 0; x < width; x++) {
+					if ((x - cx) * (x - cx) + (y - cy) * (y - cy) < r * r) {
+						amount[y * width + x] = .1f + .9f * unit(rng);
+						reach[y * width + x] = blobReach * amount[y * width + x];
+					}
+				}
+			}
+		}
+
+		auto tiles = SSSTiles::Classify(width, height, amount, reach);
+		auto covered = [&](int a_x, int a_y) { return (bool)tiles.horizontal[(a_y / SSSTiles::TileSize) * tiles.tilesX + a_x / SSSTiles::TileSize]; };
+
+		for (uint y = 0; y < height; y++) {
+			for (uint x = 0; x < width; x++) {
+				// the vertical pass runs on every pixel of a listed tile, pixels without SSS only read themselves
+				if (!tiles.vertical[(y / SSSTiles::TileSize) * tiles.tilesX + x / SSSTiles::TileSize])
+					continue;
+				REQUIRE(covered(x, y));
+				if (amount[y * width + x] == 0)
+					continue;
+
+				// SSSSBlurCS, with its per pixel jitter rotation of (0, finalStep)
+				float finalStep = reach[y * width + x] / 3.0f;
+				for (float kernelOffset = -3; kernelOffset <= 3; kernelOffset += .25f) {
+					for (float jitter = 0; jitter < 2 * std::numbers::pi_v<float>; jitter += .1f) {
+						float offset = kernelOffset * finalStep;
+						int sampleX = std::clamp((int)x + (int)(-std::sin(jitter) * offset + .5f), 0, (int)width - 1);
+						int sampleY = std::clamp((int)y + (int)(std::cos(jitter) * offset + .5f), 0, (int)height - 1);
+						REQUIRE(covered(sampleX, sampleY));
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("Frames without SSS list no tiles", "[SSSTiles]")
+{
+	constexpr uint width = 64, height = 32;
+	std::vector<float> amount(width * height), reach(width * height, 100.f);
+
+	auto tiles = SSSTiles::Classify(width, height, amount, reach);
+	REQUIRE(std::ranges::none_of(tiles.vertical, std::identity{}));
+	REQUIRE(std::ranges::none_of(tiles.horizontal, std::identity{}));
+
+	// one pixel without reach only needs its own tile
+	amount[9 * width + 20] = 1;
+	reach[9 * width + 20] = 0;
+	tiles = SSSTiles::Classify(width, height, amount, reach);
+	REQUIRE(std::ranges::count(tiles.vertical, true) == 1);
+	REQUIRE(std::ranges::count(tiles.horizontal, true) == 1);
+	REQUIRE(tiles.horizontal[1 * tiles.tilesX + 2]);
+}
@@ -0,0 +1,219 @@
+#include "ShaderTools/ShaderCacheEntry.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+
+namespace
+{
+	using namespace SIE::ShaderCacheEntry;
+
+	constexpr size_t PayloadOffset = sizeof(Header) + sizeof(SIE::ShaderReflection);
+
+	SIE::ShaderReflection MakeReflection()
+	{
+		SIE::ShaderReflection reflection{};
+		reflection.bufferSizes = { 3, 17, 42 };
+		for (size_t i = 0; i < reflection.constantOffsets.size(); ++i)
+			reflection.constantOffsets[i] = static_cast<int8_t>(i % 3 == 0 ? -1 : i);
+		reflection.vertexDesc = 0x0123456789ABCDEFull;
+		return reflection;
+	}
+
+	// instruction like bytecode, repetitive enough to compress
+	std::vector<uint8_t> MakeBytecode(size_t a_size, uint32_t a_seed = 1)
+	{
+		std::mt19937 rng(a_seed);
+		std::vector<uint8_t> bytecode(a_size);
+		for (size_t i = 0; i < a_size; ++i)
+			bytecode[i] = static_cast<uint8_t>(i % 16 < 12 ? i % 7 : rng());
+		return bytecode;
+	}
+
+	bool SameReflection(const SIE::ShaderReflection& a_first, const SIE::ShaderReflection& a_second)
+	{
+		return std::memcmp(&a_first, &a_second, sizeof(SIE::ShaderReflection)) == 0;
+	}
+
+	std::optional<std::vector<uint8_t>> Read(std::span<const uint8_t> a_data, SIE::ShaderReflection& a_reflection)
+	{
+		Header header{};
+		if (!ReadHeader(a_data, header, a_reflection))
+			return std::nullopt;
+		std::vector<uint8_t> bytecode(header.bytecodeSize);
+		if (!ReadBytecode(a_data, header, bytecode))
+			return std::nullopt;
+		return bytecode;
+	}
+
+	std::vector<uint8_t> WithHeader(std::vector<uint8_t> a_data, auto a_modify)
+	{
+		Header header{};
+		std::memcpy(&header, a_data.data(), sizeof(Header));
+		a_modify(header);
+		std::memcpy(a_data.data(), &header, sizeof(Header));
+		return a_data;
+	}
+}
+
+TEST_CASE("An entry reads back its reflection and bytecode", "[ShaderCacheEntry]")
+{
+	const auto reflection = MakeReflection();
+	const auto bytecode = MakeBytecode(4096);
+	const auto data = Write(reflection, bytecode);
+
+	REQUIRE(data.size() == PayloadOffset + bytecode.size());
+
+	Header header{};
+	SIE::ShaderReflection read{};
+	REQUIRE(ReadHeader(data, header, read));
+	REQUIRE(header.magic == Magic);
+	REQUIRE(header.formatVersion == FormatVersion);
+	REQUIRE(header.bytecodeSize == bytecode.size());
+	REQUIRE(header.codec == Codec::None);
+	REQUIRE(SameReflection(read, reflection));
+
+	std::vector<uint8_t> readBytecode(header.bytecodeSize);
+	REQUIRE(ReadBytecode(data, header, readBytecode));
+	REQUIRE(readBytecode == bytecode);
+}
+
+TEST_CASE("An entry of empty bytecode reads back", "[ShaderCacheEntry]")
+{
+	SIE::ShaderReflection read{};
+	auto bytecode = Read(Write(MakeReflection(), {}), read);
+	REQUIRE(bytecode);
+	REQUIRE(bytecode->empty());
+	REQUIRE(SameReflection(read, MakeReflection()));
+}
+
+TEST_CASE("Truncated entries are rejected", "[ShaderCacheEntry]")
+{
+	const auto data = Write(MakeReflection(), MakeBytecode(256));
+
+	Header header{};
+	SIE::ShaderReflection reflection{};
+	for (size_t size : { size_t{ 0 }, sizeof(Header) - 1, sizeof(Header), PayloadOffset - 1, PayloadOffset, data.size() - 1 })
+		CHECK_FALSE(ReadHeader(std::span(data).first(size), header, reflection));
+
+	// and so are trailing bytes
+	auto longer = data;
+	longer.push_back(0);
+	CHECK_FALSE(ReadHeader(longer, header, reflection));
+}
+
+TEST_CASE("Entries of another format are rejected", "[ShaderCacheEntry]")
+{
+	const auto data = Write(MakeReflection(), MakeBytecode(256));
+	auto withHeader = [&](auto a_modify) { return WithHeader(data, a_modify); };
+
+	Header header{};
+	SIE::ShaderReflection reflection{};
+	CHECK_FALSE(ReadHeader(withHeader([](Header& a_header) { a_header.magic = 0x44585243; }), header, reflection));
+	CHECK_FALSE(ReadHeader(withHeader([](Header& a_header) { a_header.formatVersion = FormatVersion + 1; }), header, reflection));
+	CHECK_FALSE(ReadHeader(withHeader([](Header& a_header) { a_header.formatVersion = 0; }), header, reflection));
+	CHECK_FALSE(ReadHeader(withHeader([](Header& a_header) { a_header.codec = Codec::Total; }), header, reflection));
+	CHECK(ReadHeader(withHeader([](Header&) {}), header, reflection));
+}
+
+TEST_CASE("Bytecode is only read into a destination of its size", "[ShaderCacheEntry]")
+{
+	const auto bytecode = MakeBytecode(256);
+	const auto data = Write(MakeReflection(), bytecode);
+
+	Header header{};
+	SIE::ShaderReflection reflection{};
+	REQUIRE(ReadHeader(data, header, reflection));
+
+	std::vector<uint8_t> smaller(bytecode.size() - 1);
+	std::vector<uint8_t> larger(bytecode.size() + 1);
+	CHECK_FALSE(ReadBytecode(data, header, smaller));
+	CHECK_FALSE(ReadBytecode(data, header, larger));
+}
+
+TEST_CASE("Each codec reads back its bytecode", "[ShaderCacheEntry]")
+{
+	for (auto codec : { Codec::None, Codec::LZ4, Codec::LZ4HC }) {
+		const auto bytecode = MakeBytecode(16384, 7);
+		const auto data = Write(MakeReflection(), bytecode, codec);
+
+		Header header{};
+		SIE::ShaderReflection reflection{};
+		REQUIRE(ReadHeader(data, header, reflection));
+		REQUIRE(header.codec == codec);
+		REQUIRE(header.bytecodeSize == bytecode.size());
+		if (codec != Codec::None)
+			REQUIRE(data.size() < PayloadOffset + bytecode.size());
+
+		SIE::ShaderReflection read{};
+		REQUIRE(Read(data, read) == bytecode);
+		REQUIRE(SameReflection(read, MakeReflection()));
+	}
+}
+
+TEST_CASE("Incompressible bytecode is stored as is", "[ShaderCacheEntry]")
+{
+	for (auto codec : { Codec::LZ4, Codec::LZ4HC }) {
+		std::mt19937 rng(3);
+		std::vector<uint8_t> bytecode(1024);
+		for (auto& byte : bytecode)
+			byte = static_cast<uint8_t>(rng());
+		const auto data = Write(MakeReflection(), bytecode, codec);
+
+		Header header{};
+		SIE::ShaderReflection reflection{};
+		REQUIRE(ReadHeader(data, header, reflection));
+		REQUIRE(header.codec == Codec::None);
+		REQUIRE(Read(data, reflection) == bytecode);
+	}
+}
+
+TEST_CASE("Bytecode sizes a payload cannot decode to are rejected", "[ShaderCacheEntry]")
+{
+	Header header{};
+	SIE::ShaderReflection reflection{};
+
+	// zeros compress to a payload of a few bytes
+	const auto data = Write(MakeReflection(), std::vector<uint8_t>(4096), Codec::LZ4);
+	REQUIRE(ReadHeader(data, header, reflection));
+	REQUIRE(header.codec == Codec::LZ4);
+	const auto payloadSize = static_cast<uint32_t>(data.size() - PayloadOffset);
+
+	CHECK(ReadHeader(WithHeader(data, [&](Header& a_header) { a_header.bytecodeSize = payloadSize * MaxCompressionRatio; }), header, reflection));
+	CHECK_FALSE(ReadHeader(WithHeader(data, [&](Header& a_header) { a_header.bytecodeSize = payloadSize * MaxCompressionRatio + 1; }), header, reflection));
+	CHECK_FALSE(ReadHeader(WithHeader(data, [&](Header& a_header) { a_header.bytecodeSize = payloadSize; }), header, reflection));
+	CHECK_FALSE(ReadHeader(WithHeader(data, [](Header& a_header) { a_header.bytecodeSize = 0xFFFFFFFF; }), header, reflection));
+
+	// and any codec beyond the maximum size
+	std::vector<uint8_t> large(PayloadOffset + MaxBytecodeSize + 1);
+	std::memcpy(large.data(), data.data(), PayloadOffset);
+	CHECK_FALSE(ReadHeader(WithHeader(large, [](Header& a_header) {
+		a_header.codec = Codec::None;
+		a_header.bytecodeSize = MaxBytecodeSize + 1;
+	}),
+		header, reflection));
+}
+
+TEST_CASE("Corrupt compressed payloads are rejected", "[ShaderCacheEntry]")
+{
+	for (auto codec : { Codec::LZ4, Codec::LZ4HC }) {
+		const auto bytecode = MakeBytecode(4096);
+		const auto data = Write(MakeReflection(), bytecode, codec);
+
+		SIE::ShaderReflection reflection{};
+		REQUIRE(Read(data, reflection) == bytecode);
+
+		// cut short
+		CHECK_FALSE(Read(std::span(data).first(data.size() - 1), reflection));
+		CHECK_FALSE(Read(std::span(data).first(PayloadOffset + 1), reflection));
+
+		// decoding to fewer or more bytes than the header says
+		CHECK_FALSE(Read(WithHeader(data, [](Header& a_header) { a_header.bytecodeSize += 1; }), reflection));
+		CHECK_FALSE(Read(WithHeader(data, [](Header& a_header) { a_header.bytecodeSize -= 1; }), reflection));
+
+		// overwritten with garbage, the length bytes run past the end of the payload
+		auto garbage = data;
+		std::fill(garbage.begin() + PayloadOffset, garbage.end(), uint8_t{ 0xFF });
+		CHECK_FALSE(Read(garbage, reflection));
+	}
+}
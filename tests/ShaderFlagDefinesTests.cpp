@@ -0,0 +1,493 @@
+#include "ShaderTools/ShaderFlagDefines.h"
+
+#include "ShaderTools/ShaderDescriptors.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+
+// Per flag generators as they were before the flag tables, without the feature defines.
+namespace Reference
+{
+	using ShaderCache = SIE::ShaderDescriptors;
+	using SIE::SShaderCache::ShaderMacro;
+
+	void GetDistantTreeShaderDefines(uint32_t descriptor, ShaderMacro* defines)
+	{
+		const auto technique = descriptor & 1;
+		int lastIndex = 0;
+		if (technique == static_cast<uint32_t>(ShaderCache::DistantTreeShaderTechniques::Depth)) {
+			defines[lastIndex++] = { "RENDER_DEPTH", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::DistantTreeShaderFlags::AlphaTest)) {
+			defines[lastIndex++] = { "DO_ALPHA_TEST", nullptr };
+		}
+
+		if (descriptor & static_cast<uint32_t>(ShaderCache::DistantTreeShaderFlags::Deferred)) {
+			defines[lastIndex++] = { "DEFERRED", nullptr };
+		}
+
+		defines[lastIndex] = { nullptr, nullptr };
+	}
+
+	void GetGrassShaderDefines(uint32_t descriptor, ShaderMacro* defines)
+	{
+		const auto technique = descriptor & 0b1111;
+		int lastIndex = 0;
+		if (technique == static_cast<uint32_t>(ShaderCache::GrassShaderTechniques::RenderDepth)) {
+			defines[lastIndex++] = { "RENDER_DEPTH", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::GrassShaderFlags::AlphaTest)) {
+			defines[lastIndex++] = { "DO_ALPHA_TEST", nullptr };
+		}
+
+		defines[lastIndex] = { nullptr, nullptr };
+	}
+
+	void GetEffectShaderDefines(uint32_t descriptor, ShaderMacro* defines)
+	{
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Vc)) {
+			defines[0] = { "VC", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::TexCoord)) {
+			defines[0] = { "TEXCOORD", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::TexCoordIndex)) {
+			defines[0] = { "TEXCOORD_INDEX", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Skinned)) {
+			defines[0] = { "SKINNED", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Normals)) {
+			defines[0] = { "NORMALS", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::BinormalTangent)) {
+			defines[0] = { "BINORMAL_TANGENT", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Texture)) {
+			defines[0] = { "TEXTURE", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::IndexedTexture)) {
+			defines[0] = { "INDEXED_TEXTURE", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Falloff)) {
+			defines[0] = { "FALLOFF", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::AddBlend)) {
+			defines[0] = { "ADDBLEND", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::MultBlend)) {
+			defines[0] = { "MULTBLEND", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Particles)) {
+			defines[0] = { "PARTICLES", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::StripParticles)) {
+			defines[0] = { "STRIP_PARTICLES", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Blood)) {
+			defines[0] = { "BLOOD", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Membrane)) {
+			defines[0] = { "MEMBRANE", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Lighting)) {
+			defines[0] = { "LIGHTING", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::ProjectedUv)) {
+			defines[0] = { "PROJECTED_UV", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Soft)) {
+			defines[0] = { "SOFT", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::GrayscaleToColor)) {
+			defines[0] = { "GRAYSCALE_TO_COLOR", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::GrayscaleToAlpha)) {
+			defines[0] = { "GRAYSCALE_TO_ALPHA", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::IgnoreTexAlpha)) {
+			defines[0] = { "IGNORE_TEX_ALPHA", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::MultBlendDecal)) {
+			defines[0] = { "MULTBLEND_DECAL", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::AlphaTest)) {
+			defines[0] = { "ALPHA_TEST", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::SkyObject)) {
+			defines[0] = { "SKY_OBJECT", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::MsnSpuSkinned)) {
+			defines[0] = { "MSN_SPU_SKINNED", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::MotionVectorsNormals)) {
+			defines[0] = { "MOTIONVECTORS_NORMALS", nullptr };
+			++defines;
+		}
+
+		if (descriptor & static_cast<uint32_t>(ShaderCache::EffectShaderFlags::Deferred)) {
+			defines[0] = { "DEFERRED", nullptr };
+			++defines;
+		}
+
+		defines[0] = { nullptr, nullptr };
+	}
+
+	void GetWaterShaderDefines(uint32_t descriptor, ShaderMacro* defines)
+	{
+		int lastIndex = 0;
+		defines[lastIndex++] = { "WATER", nullptr };
+		defines[lastIndex++] = { "FOG", nullptr };
+
+		if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Vc)) {
+			defines[lastIndex++] = { "VC", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::NormalTexCoord)) {
+			defines[lastIndex++] = { "NORMAL_TEXCOORD", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Reflections)) {
+			defines[lastIndex++] = { "REFLECTIONS", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Refractions)) {
+			defines[lastIndex++] = { "REFRACTIONS", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Depth)) {
+			defines[lastIndex++] = { "DEPTH", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Interior)) {
+			defines[lastIndex++] = { "INTERIOR", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Wading)) {
+			defines[lastIndex++] = { "WADING", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::VertexAlphaDepth)) {
+			defines[lastIndex++] = { "VERTEX_ALPHA_DEPTH", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Cubemap)) {
+			defines[lastIndex++] = { "CUBEMAP", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::Flowmap)) {
+			defines[lastIndex++] = { "FLOWMAP", nullptr };
+		}
+		if (descriptor & static_cast<uint32_t>(ShaderCache::WaterShaderFlags::BlendNormals)) {
+			defines[lastIndex++] = { "BLEND_NORMALS", nullptr };
+		}
+
+		const auto technique = (descriptor >> 11) & 0xF;
+		if (technique == static_cast<uint32_t>(ShaderCache::WaterShaderTechniques::Underwater)) {
+			defines[lastIndex++] = { "UNDERWATER", nullptr };
+		} else if (technique == static_cast<uint32_t>(ShaderCache::WaterShaderTechniques::Lod)) {
+			defines[lastIndex++] = { "LOD", nullptr };
+		} else if (technique == static_cast<uint32_t>(ShaderCache::WaterShaderTechniques::Stencil)) {
+			defines[lastIndex++] = { "STENCIL", nullptr };
+		} else if (technique == static_cast<uint32_t>(ShaderCache::WaterShaderTechniques::Simple)) {
+			defines[lastIndex++] = { "SIMPLE", nullptr };
+		} else if (technique < 8) {
+			static constexpr std::array<const char*, 8> numLightDefines = { { "0", "1", "2", "3", "4",
+				"5", "6", "7" } };
+			defines[lastIndex++] = { "SPECULAR", nullptr };
+			defines[lastIndex++] = { "NUM_SPECULAR_LIGHTS", numLightDefines[technique] };
+		}
+
+		defines[lastIndex] = { nullptr, nullptr };
+	}
+
+	void GetUtilityShaderDefines(uint32_t descriptor, ShaderMacro* defines)
+	{
+		using enum ShaderCache::UtilityShaderFlags;
+
+		if (descriptor & static_cast<uint32_t>(Vc)) {
+			defines[0] = { "VC", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(Texture)) {
+			defines[0] = { "TEXTURE", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(Skinned)) {
+			defines[0] = { "SKINNED", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(Normals)) {
+			defines[0] = { "NORMALS", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(AlphaTest)) {
+			defines[0] = { "ALPHA_TEST", nullptr };
+			++defines;
+		}
+
+		if (descriptor & static_cast<uint32_t>(LodLandscape)) {
+			if (descriptor &
+				(static_cast<uint32_t>(RenderShadowmask) |
+					static_cast<uint32_t>(RenderShadowmaskSpot))) {
+				defines[0] = { "FOCUS_SHADOW", nullptr };
+			} else {
+				defines[0] = { "LOD_LANDSCAPE", nullptr };
+			}
+			++defines;
+		}
+
+		if ((descriptor & static_cast<uint32_t>(RenderNormal)) &&
+			!(descriptor & static_cast<uint32_t>(RenderNormalClear))) {
+			defines[0] = { "RENDER_NORMAL", nullptr };
+			++defines;
+		} else if (!(descriptor & static_cast<uint32_t>(RenderNormal)) &&
+				   (descriptor & static_cast<uint32_t>(RenderNormalClear))) {
+			defines[0] = { "RENDER_NORMAL_CLEAR", nullptr };
+			++defines;
+		} else if ((descriptor & static_cast<uint32_t>(RenderNormal)) &&
+				   (descriptor & static_cast<uint32_t>(RenderNormalClear))) {
+			defines[0] = { "STENCIL_ABOVE_WATER", nullptr };
+			++defines;
+		}
+
+		if (descriptor & static_cast<uint32_t>(RenderNormalFalloff)) {
+			defines[0] = { "RENDER_NORMAL_FALLOFF", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(RenderNormalClamp)) {
+			defines[0] = { "RENDER_NORMAL_CLAMP", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(RenderDepth)) {
+			defines[0] = { "RENDER_DEPTH", nullptr };
+			++defines;
+		}
+
+		if (descriptor & static_cast<uint32_t>(OpaqueEffect)) {
+			defines[0] = { "OPAQUE_EFFECT", nullptr };
+			++defines;
+			if (!(descriptor & static_cast<uint32_t>(RenderShadowmap)) &&
+				(descriptor & static_cast<uint32_t>(AdditionalAlphaMask))) {
+				defines[0] = { "ADDITIONAL_ALPHA_MASK", nullptr };
+				++defines;
+			}
+			if (descriptor & static_cast<uint32_t>(GrayscaleToAlpha)) {
+				defines[0] = { "GRAYSCALE_TO_ALPHA", nullptr };
+				++defines;
+			}
+		} else {
+			if (descriptor & static_cast<uint32_t>(RenderShadowmap)) {
+				defines[0] = { "RENDER_SHADOWMAP", nullptr };
+				++defines;
+				if (descriptor & static_cast<uint32_t>(RenderShadowmapPb)) {
+					defines[0] = { "RENDER_SHADOWMAP_PB", nullptr };
+					++defines;
+				}
+			} else if (descriptor &
+					   static_cast<uint32_t>(AdditionalAlphaMask)) {
+				defines[0] = { "ADDITIONAL_ALPHA_MASK", nullptr };
+				++defines;
+			}
+			if (descriptor & static_cast<uint32_t>(RenderShadowmapClamped)) {
+				defines[0] = { "RENDER_SHADOWMAP_CLAMPED", nullptr };
+				++defines;
+			}
+		}
+
+		if (descriptor & static_cast<uint32_t>(GrayscaleMask)) {
+			defines[0] = { "GRAYSCALE_MASK", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(RenderShadowmask)) {
+			defines[0] = { "RENDER_SHADOWMASK", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(RenderShadowmaskSpot)) {
+			defines[0] = { "RENDER_SHADOWMASKSPOT", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(RenderShadowmaskPb)) {
+			defines[0] = { "RENDER_SHADOWMASKPB", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(RenderShadowmaskDpb)) {
+			defines[0] = { "RENDER_SHADOWMASKDPB", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(RenderBaseTexture)) {
+			defines[0] = { "RENDER_BASE_TEXTURE", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(TreeAnim)) {
+			defines[0] = { "TREE_ANIM", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(LodObject)) {
+			defines[0] = { "LOD_OBJECT", nullptr };
+			++defines;
+		}
+		if (descriptor & static_cast<uint32_t>(LocalMapFogOfWar)) {
+			defines[0] = { "LOCALMAP_FOGOFWAR", nullptr };
+			++defines;
+		}
+
+		if (descriptor & (static_cast<uint32_t>(RenderShadowmask) |
+							 static_cast<uint32_t>(RenderShadowmaskDpb) |
+							 static_cast<uint32_t>(RenderShadowmaskPb) |
+							 static_cast<uint32_t>(RenderShadowmaskSpot))) {
+			static constexpr std::array<const char*, 5> shadowFilters = { { "0", "1", "2",
+				"3", "4" } };
+			const size_t shadowFilterIndex = std::clamp((descriptor >> 17) & 0b111, 0u, 4u);
+			defines[0] = { "SHADOWFILTER", shadowFilters[shadowFilterIndex] };
+			++defines;
+		} else if ((!(descriptor & static_cast<uint32_t>(OpaqueEffect)) &&
+					   (descriptor &
+						   static_cast<uint32_t>(RenderShadowmap))) ||
+				   (descriptor & static_cast<uint32_t>(RenderDepth))) {
+			if (descriptor & static_cast<uint32_t>(DepthWriteDecals)) {
+				defines[0] = { "DEPTH_WRITE_DECALS", nullptr };
+				++defines;
+			}
+		} else {
+			if (descriptor & (static_cast<uint32_t>(DepthWriteDecals) |
+								 static_cast<uint32_t>(DebugColor))) {
+				defines[0] = { "DEBUG_COLOR", nullptr };
+				++defines;
+			}
+			if (descriptor & static_cast<uint32_t>(DebugShadowSplit)) {
+				defines[0] = { "DEBUG_SHADOWSPLIT", nullptr };
+				++defines;
+			}
+		}
+
+		defines[0] = { "SHADOWSPLITCOUNT", "3" };
+		++defines;
+
+		if ((descriptor & 0x14000) != 0x14000 &&
+			((descriptor & 0x20004000) == 0x4000 || (descriptor & 0x1E02000) == 0x2000) &&
+			!(descriptor & 0x80) && (descriptor & 0x14000) != 0x10000) {
+			defines[0] = { "NO_PIXEL_SHADER", nullptr };
+			++defines;
+		}
+
+		defines[0] = { nullptr, nullptr };
+	}
+}
+
+namespace
+{
+	using SIE::SShaderCache::ShaderMacro;
+
+	using Generator = void (*)(uint32_t, ShaderMacro*);
+	using Appender = void (*)(uint32_t, ShaderMacro*, int&);
+
+	bool Equal(const char* a, const char* b)
+	{
+		return a == b || (a && b && std::strcmp(a, b) == 0);
+	}
+
+	bool Matches(Generator reference, Appender appender, uint32_t descriptor)
+	{
+		std::array<ShaderMacro, 64> expected{};
+		reference(descriptor, expected.data());
+
+		std::array<ShaderMacro, 64> actual{};
+		int lastIndex = 0;
+		appender(descriptor, actual.data(), lastIndex);
+		actual[lastIndex] = { nullptr, nullptr };
+
+		for (size_t i = 0; i < actual.size(); ++i) {
+			if (!Equal(expected[i].Name, actual[i].Name) || !Equal(expected[i].Definition, actual[i].Definition)) {
+				return false;
+			}
+			if (!expected[i].Name) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Every subset of the bits in mask.
+	std::optional<uint32_t> FindMismatchInSubsets(Generator reference, Appender appender, uint32_t mask)
+	{
+		uint32_t descriptor = 0;
+		do {
+			if (!Matches(reference, appender, descriptor)) {
+				return descriptor;
+			}
+			descriptor = (descriptor - mask) & mask;
+		} while (descriptor != 0);
+		return std::nullopt;
+	}
+
+	// Every combination within each 16 bit window of the descriptor, plus random descriptors.
+	std::optional<uint32_t> FindMismatchInWindows(Generator reference, Appender appender)
+	{
+		for (uint32_t shift = 0; shift <= 16; ++shift) {
+			if (auto descriptor = FindMismatchInSubsets(reference, appender, 0xFFFFu << shift)) {
+				return descriptor;
+			}
+		}
+
+		std::mt19937 random(0x5EED);
+		for (int i = 0; i < 1 << 20; ++i) {
+			const uint32_t descriptor = random();
+			if (!Matches(reference, appender, descriptor)) {
+				return descriptor;
+			}
+		}
+		return std::nullopt;
+	}
+}
+
+TEST_CASE("Distant tree defines match the per flag generator for every descriptor", "[ShaderFlagDefines]")
+{
+	// technique bit and both flags
+	CHECK(FindMismatchInSubsets(Reference::GetDistantTreeShaderDefines, SIE::SShaderCache::AppendDistantTreeShaderDescriptorDefines, 0x10101) == std::nullopt);
+	CHECK(FindMismatchInWindows(Reference::GetDistantTreeShaderDefines, SIE::SShaderCache::AppendDistantTreeShaderDescriptorDefines) == std::nullopt);
+}
+
+TEST_CASE("Grass defines match the per flag generator for every descriptor", "[ShaderFlagDefines]")
+{
+	// technique nibble and the alpha test flag
+	CHECK(FindMismatchInSubsets(Reference::GetGrassShaderDefines, SIE::SShaderCache::AppendGrassShaderDescriptorDefines, 0x1000F) == std::nullopt);
+	CHECK(FindMismatchInWindows(Reference::GetGrassShaderDefines, SIE::SShaderCache::AppendGrassShaderDescriptorDefines) == std::nullopt);
+}
+
+TEST_CASE("Water defines match the per flag generator for every descriptor", "[ShaderFlagDefines]")
+{
+	// eleven flags and the technique nibble
+	CHECK(FindMismatchInSubsets(Reference::GetWaterShaderDefines, SIE::SShaderCache::AppendWaterShaderDescriptorDefines, 0x7FFF) == std::nullopt);
+	CHECK(FindMismatchInWindows(Reference::GetWaterShaderDefines, SIE::SShaderCache::AppendWaterShaderDescriptorDefines) == std::nullopt);
+}
+
+TEST_CASE("Effect defines match the per flag generator for every flag combination", "[ShaderFlagDefines]")
+{
+	CHECK(FindMismatchInWindows(Reference::GetEffectShaderDefines, SIE::SShaderCache::AppendEffectShaderDescriptorDefines) == std::nullopt);
+}
+
+TEST_CASE("Utility defines match the per flag generator for every flag combination", "[ShaderFlagDefines]")
+{
+	// the flags with cross dependencies: alpha test, lod landscape, the render normal, depth and shadowmap modes,
+	// the shadowmask variants and opaque effect
+	CHECK(FindMismatchInSubsets(Reference::GetUtilityShaderDefines, SIE::SShaderCache::AppendUtilityShaderDescriptorDefines, 0x21FFF380) == std::nullopt);
+	CHECK(FindMismatchInWindows(Reference::GetUtilityShaderDefines, SIE::SShaderCache::AppendUtilityShaderDescriptorDefines) == std::nullopt);
+}
@@ -0,0 +1,121 @@
+#include "ShadowCopyLayout.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+	using ShadowCopyLayout::PerGeometry;
+
+	constexpr uint VectorSize = 16;
+	constexpr uint VectorCount = sizeof(PerGeometry) / VectorSize;
+
+	struct Source
+	{
+		uint slot;
+		uint vector;
+
+		bool operator==(const Source&) const = default;
+	};
+
+	// where each member of PerGeometry is read from, by the packoffsets of CopyShadowData.hlsl
+	// PerFrame3 is bound from b0, PerFrame from b2 and PerFrame2 from b12
+	struct Member
+	{
+		size_t offset;
+		size_t size;
+		Source source;
+	};
+
+	std::vector<Member> GetMembers(bool a_vr)
+	{
+		std::vector<Member> members = {
+			{ offsetof(PerGeometry, VPOSOffset), sizeof(float4), { 0, 0 } },
+			{ offsetof(PerGeometry, ShadowSampleParam), sizeof(float4), { 0, 1 } },
+			{ offsetof(PerGeometry, EndSplitDistances), sizeof(float4), { 0, 2 } },
+			{ offsetof(PerGeometry, StartSplitDistances), sizeof(float4), { 0, 3 } },
+			{ offsetof(PerGeometry, FocusShadowFadeParam), sizeof(float4), { 0, 4 } },
+			{ offsetof(PerGeometry, DebugColor), sizeof(float4), { 2, 0 } },
+			{ offsetof(PerGeometry, PropertyColor), sizeof(float4), { 2, 1 } },
+			{ offsetof(PerGeometry, AlphaTestRef), sizeof(float4), { 2, 2 } },
+			{ offsetof(PerGeometry, ShadowLightParam), sizeof(float4), { 2, 3 } },
+			{ offsetof(PerGeometry, FocusShadowMapProj), sizeof(PerGeometry::FocusShadowMapProj), { 2, a_vr ? 5u : 4u } },
+		};
+		if (a_vr) {
+			members.push_back({ offsetof(PerGeometry, ShadowMapProj), sizeof(PerGeometry::ShadowMapProj), { 2, 29 } });
+			members.push_back({ offsetof(PerGeometry, CameraViewProjInverse), sizeof(PerGeometry::CameraViewProjInverse), { 12, 64 } });
+		} else {
+			// the single eye is repeated
+			for (uint eye = 0; eye < 2; eye++) {
+				members.push_back({ offsetof(PerGeometry, ShadowMapProj) + eye * sizeof(PerGeometry::ShadowMapProj[0]), sizeof(PerGeometry::ShadowMapProj[0]), { 2, 16 } });
+				members.push_back({ offsetof(PerGeometry, CameraViewProjInverse) + eye * sizeof(PerGeometry::CameraViewProjInverse[0]), sizeof(PerGeometry::CameraViewProjInverse[0]), { 12, 32 } });
+			}
+		}
+		return members;
+	}
+
+	// the source of each vector of PerGeometry, failing on gaps and overlaps
+	std::vector<std::optional<Source>> Copy(bool a_vr)
+	{
+		std::vector<std::optional<Source>> copied(VectorCount);
+		for (const auto& region : ShadowCopyLayout::GetRegions(a_vr)) {
+			REQUIRE(region.dstOffset % VectorSize == 0);
+			REQUIRE(region.numVectors > 0);
+			REQUIRE(region.dstOffset / VectorSize + region.numVectors <= VectorCount);
+			for (uint i = 0; i < region.numVectors; i++) {
+				auto& vector = copied[region.dstOffset / VectorSize + i];
+				REQUIRE_FALSE(vector.has_value());
+				vector = Source{ region.slot, region.firstVector + i };
+			}
+		}
+		return copied;
+	}
+}
+
+TEST_CASE("PerGeometry is a whole number of vectors", "[ShadowCopyLayout]")
+{
+	REQUIRE(sizeof(PerGeometry) % VectorSize == 0);
+	REQUIRE(sizeof(PerGeometry) == 47 * VectorSize);
+}
+
+TEST_CASE("Shadow copy regions fill PerGeometry exactly", "[ShadowCopyLayout]")
+{
+	for (bool vr : { false, true }) {
+		INFO("VR " << vr);
+
+		auto regions = ShadowCopyLayout::GetRegions(vr);
+		std::vector<ShadowCopyLayout::Region> sorted(regions.begin(), regions.end());
+		std::ranges::sort(sorted, {}, &ShadowCopyLayout::Region::dstOffset);
+
+		size_t end = 0;
+		for (const auto& region : sorted) {
+			CHECK(region.dstOffset == end);
+			end = region.dstOffset + region.numVectors * VectorSize;
+		}
+		REQUIRE(end == sizeof(PerGeometry));
+
+		for (const auto& vector : Copy(vr))
+			CHECK(vector.has_value());
+	}
+}
+
+TEST_CASE("Shadow copy regions read the registers CopyShadowData.hlsl reads", "[ShadowCopyLayout]")
+{
+	for (bool vr : { false, true }) {
+		INFO("VR " << vr);
+
+		const auto copied = Copy(vr);
+		size_t covered = 0;
+		for (const auto& member : GetMembers(vr)) {
+			INFO("Member at " << member.offset);
+			REQUIRE(member.offset % VectorSize == 0);
+			REQUIRE(member.size % VectorSize == 0);
+			for (uint i = 0; i < member.size / VectorSize; i++) {
+				const auto& vector = copied[member.offset / VectorSize + i];
+				REQUIRE(vector.has_value());
+				CHECK(*vector == Source{ member.source.slot, member.source.vector + i });
+			}
+			covered += member.size;
+		}
+		REQUIRE(covered == sizeof(PerGeometry));
+	}
+}
@@ -0,0 +1,95 @@
+#include "Features/TerrainBlending/BlendPrepass.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+
+namespace
+{
+	struct Scene
+	{
+		uint width;
+		uint height;
+		std::vector<float> main, terrain, mainAfterTerrain;
+
+		TerrainBlendPrepass::Depths GetDepths() const { return { main, terrain, mainAfterTerrain }; }
+	};
+
+	// Terrain in a few patches, with objects drawn before and after it
+	Scene RandomScene(std::mt19937& a_rng, uint a_width, uint a_height)
+	{
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		Scene scene{ a_width, a_height, std::vector<float>(a_width * a_height), std::vector<float>(a_width * a_height, 1.0f), std::vector<float>(a_width * a_height) };
+
+		std::vector<std::array<float, 3>> patches;
+		for (uint i = 0; i < 3; i++)
+			patches.push_back({ unit(a_rng) * a_width, unit(a_rng) * a_height, unit(a_rng) * 20.0f });
+
+		for (uint y = 0; y < a_height; y++) {
+			for (uint x = 0; x < a_width; x++) {
+				uint pixel = y * a_width + x;
+				bool terrain = std::ranges::any_of(patches, [&](auto& a_patch) {
+					return (x - a_patch[0]) * (x - a_patch[0]) + (y - a_patch[1]) * (y - a_patch[1]) < a_patch[2] * a_patch[2];
+				});
+				if (terrain)
+					scene.terrain[pixel] = unit(a_rng);
+
+				// depth when terrain finished, then later prepass draws only bring it closer
+				scene.mainAfterTerrain[pixel] = unit(a_rng);
+				scene.main[pixel] = unit(a_rng) < 0.3f ? scene.mainAfterTerrain[pixel] * unit(a_rng) : scene.mainAfterTerrain[pixel];
+			}
+		}
+		return scene;
+	}
+}
+
+TEST_CASE("The early-out only changes pixels without terrain", "[TerrainBlendPrepass]")
+{
+	std::mt19937 rng(29);
+	for (auto [width, height] : { std::pair{ 64u, 64u }, std::pair{ 203u, 117u }, std::pair{ 1u, 9u } }) {
+		for (uint i = 0; i < 50; i++) {
+			auto scene = RandomScene(rng, width, height);
+			auto merged = TerrainBlendPrepass::Run(width, height, scene.GetDepths(), true);
+			auto separate = TerrainBlendPrepass::Run(width, height, scene.GetDepths(), false);
+
+			REQUIRE(merged.blendedDepth == separate.blendedDepth);
+
+			// Lighting reads the offset at the terrain pixel being shaded
+			for (uint pixel = 0; pixel < width * height; pixel++)
+				if (scene.terrain[pixel] < 1.0f)
+					REQUIRE(merged.terrainOffset[pixel] == separate.terrainOffset[pixel]);
+		}
+	}
+}
+
+TEST_CASE("Tiles skip only when none of their pixels is terrain", "[TerrainBlendPrepass]")
+{
+	constexpr uint width = 40, height = 24;
+	std::vector<float> main(width * height, 0.5f), terrain(width * height, 1.0f), mainAfterTerrain(width * height, 0.75f);
+	TerrainBlendPrepass::Depths depths{ main, terrain, mainAfterTerrain };
+
+	auto empty = TerrainBlendPrepass::Run(width, height, depths, true);
+	REQUIRE(std::ranges::none_of(empty.tileHasTerrain, std::identity{}));
+	REQUIRE(std::ranges::all_of(empty.terrainOffset, [](float a_depth) { return a_depth == 0.5f; }));
+
+	// one terrain pixel in the last corner of a tile
+	terrain[15 * width + 23] = 0.9f;
+	auto single = TerrainBlendPrepass::Run(width, height, depths, true);
+	REQUIRE(std::ranges::count(single.tileHasTerrain, true) == 1);
+	REQUIRE(single.tileHasTerrain[1 * single.tilesX + 2]);
+	REQUIRE(single.terrainOffset[15 * width + 23] == 1.0f);
+	REQUIRE(single.terrainOffset[15 * width + 24] == 0.5f);
+}
+
+TEST_CASE("Partial tiles at the screen edge never skip", "[TerrainBlendPrepass]")
+{
+	constexpr uint width = 20, height = 10;
+	std::vector<float> main(width * height, 0.5f), terrain(width * height, 1.0f), mainAfterTerrain(width * height, 0.75f);
+
+	auto result = TerrainBlendPrepass::Run(width, height, { main, terrain, mainAfterTerrain }, true);
+	REQUIRE(result.tilesX == 3);
+	REQUIRE(result.tilesY == 2);
+	for (uint y = 0; y < result.tilesY; y++)
+		for (uint x = 0; x < result.tilesX; x++)
+			REQUIRE(result.tileHasTerrain[y * result.tilesX + x] == (x == 2 || y == 1));
+}
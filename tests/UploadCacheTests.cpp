@@ -0,0 +1,69 @@
+#include "UploadCache.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+	struct alignas(16) Settings
+	{
+		float radius = 1.f;
+		uint steps = 4;
+		float2 pad;
+	};
+}
+
+TEST_CASE("The first upload always goes through", "[UploadCache]")
+{
+	UploadCache cache;
+	REQUIRE(cache.Changed(Settings{}));
+}
+
+TEST_CASE("Unchanged data is skipped until it changes", "[UploadCache]")
+{
+	UploadCache cache;
+	Settings settings{};
+	REQUIRE(cache.Changed(settings));
+	REQUIRE_FALSE(cache.Changed(settings));
+	REQUIRE_FALSE(cache.Changed(settings));
+
+	settings.steps = 5;
+	REQUIRE(cache.Changed(settings));
+	REQUIRE_FALSE(cache.Changed(settings));
+
+	// going back to an older value is still a change
+	settings.steps = 4;
+	REQUIRE(cache.Changed(settings));
+}
+
+TEST_CASE("Data of another size is a change", "[UploadCache]")
+{
+	UploadCache cache;
+	REQUIRE(cache.Changed(float4{ 0, 0, 0, 0 }));
+	REQUIRE(cache.Changed(float2{ 0, 0 }));
+	REQUIRE_FALSE(cache.Changed(float2{ 0, 0 }));
+}
+
+TEST_CASE("Invalidating forces the next upload", "[UploadCache]")
+{
+	UploadCache cache;
+	Settings settings{};
+	REQUIRE(cache.Changed(settings));
+
+	cache.Invalidate();
+	REQUIRE(cache.Changed(settings));
+	REQUIRE_FALSE(cache.Changed(settings));
+}
+
+TEST_CASE("Every byte of the data is compared", "[UploadCache]")
+{
+	UploadCache cache;
+	std::array<std::byte, 64> data{};
+	REQUIRE(cache.Changed(data));
+
+	for (auto& byte : data) {
+		byte = std::byte{ 1 };
+		REQUIRE(cache.Changed(data));
+		byte = std::byte{ 0 };
+		REQUIRE(cache.Changed(data));
+	}
+}
@@ -0,0 +1,129 @@
+#include "VRSRateModel.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+
+namespace
+{
+	using Levels = VRSRateModel::Levels;
+
+	// pixels covered along x and y by each entry of the shading rate table in VariableRateShading
+	constexpr std::pair<uint, uint> rateFootprints[] = { { 1, 1 }, { 2, 1 }, { 1, 2 }, { 2, 2 }, { 4, 2 }, { 2, 4 }, { 4, 4 } };
+
+	bool IsSupported(Levels a_levels)
+	{
+		bool quarterX = a_levels.x == 2, quarterY = a_levels.y == 2;
+		return a_levels.x <= 2 && a_levels.y <= 2 && !(quarterX && quarterY) && !(quarterX && a_levels.y == 0) && !(quarterY && a_levels.x == 0);
+	}
+
+	VRSRateModel::Parameters Balanced() { return VRSRateModel::GetParameters(VRSRateModel::Preset::Balanced); }
+}
+
+TEST_CASE("Every level pair maps to the rate it describes", "[VRSRateModel]")
+{
+	for (uint y = 0; y < 3; y++) {
+		for (uint x = 0; x < 3; x++) {
+			Levels levels{ x, y };
+			if (!IsSupported(levels))
+				continue;
+			auto [width, height] = rateFootprints[VRSRateModel::GetRateIndex(levels)];
+			REQUIRE(width == 1u << x);
+			REQUIRE(height == 1u << y);
+		}
+	}
+
+	// anything past quarter rate is clamped
+	REQUIRE(VRSRateModel::GetRateIndex({ 7, 1 }) == VRSRateModel::GetRateIndex({ 2, 1 }));
+}
+
+TEST_CASE("Thresholds grow from the centre of the screen", "[VRSRateModel]")
+{
+	auto parameters = Balanced();
+	REQUIRE(VRSRateModel::GetThreshold(parameters, { 0.5f, 0.5f }) == parameters.thresholdCentre);
+	REQUIRE(VRSRateModel::GetThreshold(parameters, { 0.5f, 0.0f }) == Catch::Approx((parameters.thresholdCentre + parameters.thresholdEdge) / 2));
+	REQUIRE(VRSRateModel::GetThreshold(parameters, { 0.0f, 0.0f }) == VRSRateModel::GetThreshold(parameters, { 1.0f, 1.0f }));
+	REQUIRE(VRSRateModel::GetThreshold(parameters, { 0.1f, 0.1f }) > VRSRateModel::GetThreshold(parameters, { 0.3f, 0.3f }));
+
+	// presets only get more lenient
+	auto quality = VRSRateModel::GetParameters(VRSRateModel::Preset::Quality);
+	auto performance = VRSRateModel::GetParameters(VRSRateModel::Preset::Performance);
+	REQUIRE(quality.thresholdCentre < parameters.thresholdCentre);
+	REQUIRE(parameters.thresholdCentre < performance.thresholdCentre);
+	REQUIRE(quality.motionScale < performance.motionScale);
+}
+
+TEST_CASE("Flat tiles are coarse and detailed tiles full rate", "[VRSRateModel]")
+{
+	auto parameters = Balanced();
+	float threshold = parameters.thresholdCentre;
+
+	auto flat = VRSRateModel::GetLevels({ 0.0f, 0.001f }, { 0.0f, 0.0f }, threshold, parameters, {});
+	REQUIRE(flat.x == 2);  // the flatter axis keeps the quarter rate
+	REQUIRE(flat.y == 1);
+
+	auto detailed = VRSRateModel::GetLevels({ 1.0f, 1.0f }, { 0.0f, 0.0f }, threshold, parameters, { 2, 1 });
+	REQUIRE(detailed.x == 0);
+	REQUIRE(detailed.y == 0);
+
+	// a quarter rate next to a full one is not supported
+	auto stripe = VRSRateModel::GetLevels({ 0.0f, 1.0f }, { 0.0f, 0.0f }, threshold, parameters, {});
+	REQUIRE(stripe.x == 1);
+	REQUIRE(stripe.y == 0);
+}
+
+TEST_CASE("Error near the threshold does not flicker", "[VRSRateModel]")
+{
+	auto parameters = Balanced();
+	float threshold = parameters.thresholdCentre;
+
+	// just under the threshold at half rate, but inside the hysteresis margin
+	float2 error{ threshold * 0.9f, threshold * 0.9f };
+
+	// a full rate tile stays full, it has not cleared the margin
+	auto full = VRSRateModel::GetLevels(error, { 0.0f, 0.0f }, threshold, parameters, { 0, 0 });
+	REQUIRE(full.x == 0);
+	REQUIRE(full.y == 0);
+
+	// a half rate tile stays half, it is still under the threshold
+	auto half = VRSRateModel::GetLevels(error, { 0.0f, 0.0f }, threshold, parameters, { 1, 1 });
+	REQUIRE(half.x == 1);
+	REQUIRE(half.y == 1);
+
+	// noise around the threshold settles after the first frame
+	std::mt19937 rng(19);
+	std::uniform_real_distribution<float> noise(0.85f, 1.0f);
+	Levels levels{};
+	uint changes = 0;
+	for (uint frame = 0; frame < 1000; frame++) {
+		auto next = VRSRateModel::GetLevels({ threshold * noise(rng), threshold * noise(rng) }, { 0.0f, 0.0f }, threshold, parameters, levels);
+		changes += next.x != levels.x || next.y != levels.y;
+		levels = next;
+	}
+	REQUIRE(changes <= 1);
+}
+
+TEST_CASE("Levels are supported and motion only coarsens them", "[VRSRateModel]")
+{
+	std::mt19937 rng(23);
+	std::uniform_real_distribution<float> error(0.0f, 0.3f), motion(-20.0f, 20.0f);
+	std::uniform_int_distribution<uint> level(0, 2);
+
+	for (auto preset : { VRSRateModel::Preset::Quality, VRSRateModel::Preset::Balanced, VRSRateModel::Preset::Performance }) {
+		auto parameters = VRSRateModel::GetParameters(preset);
+		for (uint i = 0; i < 20000; i++) {
+			float2 tileError{ error(rng), error(rng) };
+			float2 tileMotion{ motion(rng), motion(rng) };
+			Levels previous{ level(rng), level(rng) };
+			float threshold = VRSRateModel::GetThreshold(parameters, { 0.3f, 0.6f });
+
+			auto levels = VRSRateModel::GetLevels(tileError, tileMotion, threshold, parameters, previous);
+			REQUIRE(IsSupported(levels));
+
+			// at rest the same tile is shaded at least as finely, counting pixels per shade
+			auto still = VRSRateModel::GetLevels(tileError, { 0.0f, 0.0f }, threshold, parameters, previous);
+			REQUIRE(still.x + still.y <= levels.x + levels.y);
+		}
+	}
+}
@@ -0,0 +1,131 @@
+#include "VRSTransitionCache.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+
+namespace
+{
+	// Stands in for the NVAPI calls of VariableRateShading::UpdateViews
+	struct FakeBackend
+	{
+		bool enabled = false;
+		uint calls = 0;
+
+		void Apply(bool a_enabled)
+		{
+			enabled = a_enabled;
+			calls++;
+		}
+	};
+
+	constexpr uint screenTargets[] = { 1, 2, 5 };
+
+	// The per draw decision before the cache, from scratch for every draw
+	bool IsEnabled(bool a_allowed, uint a_renderTarget, bool a_screenDepth, bool a_enable)
+	{
+		return a_allowed && a_enable && (std::ranges::find(screenTargets, a_renderTarget) != std::end(screenTargets) || a_screenDepth);
+	}
+}
+
+TEST_CASE("Only draws that change the state reach the backend", "[VRSTransitionCache]")
+{
+	VRSTransitionCache cache;
+	cache.SetScreenTargets(screenTargets);
+	FakeBackend backend;
+
+	auto draw = [&](uint a_renderTarget, bool a_screenDepth, bool a_enable) {
+		if (cache.Update(a_renderTarget, a_screenDepth, a_enable))
+			backend.Apply(cache.IsEnabled());
+	};
+
+	cache.BeginFrame(true);
+	draw(1, false, true);
+	draw(2, false, true);
+	draw(5, true, true);
+	REQUIRE(backend.calls == 1);
+	REQUIRE(backend.enabled);
+
+	// an off-screen target, then a screen sized one again
+	draw(3, false, true);
+	draw(4, false, true);
+	draw(1, false, true);
+	REQUIRE(backend.calls == 3);
+	REQUIRE(backend.enabled);
+
+	// the screen depth buffer makes any target count
+	draw(7, true, true);
+	REQUIRE(backend.calls == 3);
+
+	// transitions are reported for the last complete frame
+	REQUIRE(cache.GetTransitions() == 0);
+	cache.BeginFrame(true);
+	REQUIRE(cache.GetTransitions() == 3);
+}
+
+TEST_CASE("A disallowed frame turns shading off at its first draw", "[VRSTransitionCache]")
+{
+	VRSTransitionCache cache;
+	cache.SetScreenTargets(screenTargets);
+	FakeBackend backend;
+
+	cache.BeginFrame(true);
+	if (cache.Update(1, false, true))
+		backend.Apply(cache.IsEnabled());
+	REQUIRE(backend.enabled);
+
+	cache.BeginFrame(false);
+	for (uint target : { 1u, 2u, 5u })
+		if (cache.Update(target, true, true))
+			backend.Apply(cache.IsEnabled());
+
+	REQUIRE_FALSE(backend.enabled);
+	REQUIRE(backend.calls == 2);
+}
+
+TEST_CASE("The backend always holds the uncached decision", "[VRSTransitionCache]")
+{
+	VRSTransitionCache cache;
+	cache.SetScreenTargets(screenTargets);
+	FakeBackend backend;
+
+	std::mt19937 rng(17);
+	std::uniform_int_distribution<uint> target(0, 8);
+	std::bernoulli_distribution coin(0.5), rarely(0.05), mostly(0.9);
+
+	uint draws = 0;
+	for (uint frame = 0; frame < 200; frame++) {
+		bool allowed = !rarely(rng);
+		cache.BeginFrame(allowed);
+
+		uint frameCalls = backend.calls;
+		for (uint i = 0; i < 500; i++, draws++) {
+			uint renderTarget = target(rng);
+			bool screenDepth = coin(rng), enable = mostly(rng);
+
+			if (cache.Update(renderTarget, screenDepth, enable))
+				backend.Apply(cache.IsEnabled());
+
+			REQUIRE(backend.enabled == IsEnabled(allowed, renderTarget, screenDepth, enable));
+		}
+
+		cache.BeginFrame(allowed);
+		REQUIRE(cache.GetTransitions() == backend.calls - frameCalls);
+	}
+
+	REQUIRE(backend.calls < draws);
+}
+
+TEST_CASE("Targets outside the screen table never enable shading", "[VRSTransitionCache]")
+{
+	VRSTransitionCache cache;
+	cache.BeginFrame(true);
+	REQUIRE_FALSE(cache.Update(1000, false, true));
+	REQUIRE_FALSE(cache.IsEnabled());
+
+	cache.SetScreenTargets(screenTargets);
+	REQUIRE(cache.Update(5, false, true));
+	REQUIRE_FALSE(cache.Update(6, true, true));
+	REQUIRE(cache.Update(6, false, true));
+	REQUIRE_FALSE(cache.IsEnabled());
+}
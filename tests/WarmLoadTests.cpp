@@ -0,0 +1,233 @@
+#include "ShaderTools/WarmLoad.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+	using SIE::ShaderClass;
+
+	struct FakeBlob
+	{
+		uint64_t hash;
+	};
+
+	struct FakeObject
+	{
+		ShaderClass shaderClass;
+		uint64_t hash;
+	};
+
+	// disk cache and device of a shader, keyed by the descriptor
+	class FakeBackend : public SIE::WarmLoadBackend<FakeBlob, FakeObject>
+	{
+	public:
+		// bytecode hash of each cached descriptor, 0 for an entry that fails to load
+		std::map<std::pair<ShaderClass, uint32_t>, uint64_t> cached;
+		std::set<std::pair<ShaderClass, uint32_t>> loaded;
+		std::set<std::pair<ShaderClass, uint64_t>> objects;  // of loaded permutations
+		std::set<uint64_t> rejected;                         // by the device
+
+		std::mutex mutex;
+		std::map<std::pair<ShaderClass, uint32_t>, int> loads;
+		std::map<std::pair<ShaderClass, uint64_t>, int> creates;
+		std::vector<std::unique_ptr<FakeBlob>> blobs;
+		std::vector<std::unique_ptr<FakeObject>> created;
+		int releases = 0;
+
+		bool IsLoadable(ShaderClass a_class, uint32_t a_descriptor) override
+		{
+			return cached.contains({ a_class, a_descriptor }) && !loaded.contains({ a_class, a_descriptor });
+		}
+
+		std::string GetKey(ShaderClass a_class, uint32_t a_descriptor) override
+		{
+			return std::format("{}:{:X}", a_class == ShaderClass::Vertex ? "VS" : "PS", a_descriptor);
+		}
+
+		FakeBlob* Load(ShaderClass a_class, uint32_t a_descriptor, uint64_t& o_hash) override
+		{
+			std::scoped_lock lock{ mutex };
+			loads[{ a_class, a_descriptor }]++;
+			const auto hash = cached.at({ a_class, a_descriptor });
+			if (!hash)
+				return nullptr;
+			o_hash = hash;
+			return blobs.emplace_back(std::make_unique<FakeBlob>(hash)).get();
+		}
+
+		bool HasObject(ShaderClass a_class, uint64_t a_hash) override
+		{
+			return objects.contains({ a_class, a_hash });
+		}
+
+		FakeObject* Create(ShaderClass a_class, FakeBlob& a_blob) override
+		{
+			std::scoped_lock lock{ mutex };
+			creates[{ a_class, a_blob.hash }]++;
+			if (rejected.contains(a_blob.hash))
+				return nullptr;
+			return created.emplace_back(std::make_unique<FakeObject>(a_class, a_blob.hash)).get();
+		}
+
+		void Release(FakeObject&) override
+		{
+			std::scoped_lock lock{ mutex };
+			releases++;
+		}
+	};
+
+	using WarmLoad = SIE::WarmLoad<FakeBlob, FakeObject>;
+
+	std::vector<uint32_t> GetDescriptors(const WarmLoad& a_warmLoad, ShaderClass a_class)
+	{
+		std::vector<uint32_t> descriptors;
+		for (const auto& entry : a_warmLoad.GetEntries()) {
+			if (entry.shaderClass == a_class)
+				descriptors.push_back(entry.descriptor);
+		}
+		return descriptors;
+	}
+}
+
+TEST_CASE("Duplicate descriptors are loaded once", "[WarmLoad]")
+{
+	FakeBackend backend;
+	backend.cached = { { { ShaderClass::Vertex, 1 }, 10 }, { { ShaderClass::Vertex, 2 }, 20 }, { { ShaderClass::Vertex, 3 }, 30 } };
+
+	WarmLoad warmLoad(backend);
+	const uint32_t descriptors[] = { 3, 1, 3, 2, 1, 1 };
+	warmLoad.Enumerate(ShaderClass::Vertex, descriptors, {});
+	REQUIRE(GetDescriptors(warmLoad, ShaderClass::Vertex) == std::vector<uint32_t>{ 1, 2, 3 });
+
+	warmLoad.Load();
+	for (auto& [key, count] : backend.loads)
+		CHECK(count == 1);
+	REQUIRE(backend.loads.size() == 3);
+}
+
+TEST_CASE("The blocked key is left to the shader lookups", "[WarmLoad]")
+{
+	FakeBackend backend;
+	backend.cached = { { { ShaderClass::Vertex, 0xA }, 10 }, { { ShaderClass::Pixel, 0xA }, 20 }, { { ShaderClass::Pixel, 0xB }, 30 } };
+	const uint32_t descriptors[] = { 0xA, 0xB };
+
+	SECTION("blocking one pixel shader")
+	{
+		WarmLoad warmLoad(backend);
+		warmLoad.Enumerate(ShaderClass::Vertex, descriptors, "PS:A");
+		warmLoad.Enumerate(ShaderClass::Pixel, descriptors, "PS:A");
+		REQUIRE(GetDescriptors(warmLoad, ShaderClass::Vertex) == std::vector<uint32_t>{ 0xA });
+		REQUIRE(GetDescriptors(warmLoad, ShaderClass::Pixel) == std::vector<uint32_t>{ 0xB });
+	}
+
+	SECTION("without a blocked shader")
+	{
+		WarmLoad warmLoad(backend);
+		warmLoad.Enumerate(ShaderClass::Vertex, descriptors, {});
+		warmLoad.Enumerate(ShaderClass::Pixel, descriptors, {});
+		REQUIRE(GetDescriptors(warmLoad, ShaderClass::Vertex) == std::vector<uint32_t>{ 0xA });
+		REQUIRE(GetDescriptors(warmLoad, ShaderClass::Pixel) == std::vector<uint32_t>{ 0xA, 0xB });
+	}
+}
+
+TEST_CASE("Loaded and uncached descriptors are skipped", "[WarmLoad]")
+{
+	FakeBackend backend;
+	backend.cached = { { { ShaderClass::Pixel, 1 }, 10 }, { { ShaderClass::Pixel, 2 }, 20 } };
+	backend.loaded = { { ShaderClass::Pixel, 2 } };
+
+	WarmLoad warmLoad(backend);
+	const uint32_t descriptors[] = { 1, 2, 3 };
+	warmLoad.Enumerate(ShaderClass::Pixel, descriptors, {});
+	REQUIRE(GetDescriptors(warmLoad, ShaderClass::Pixel) == std::vector<uint32_t>{ 1 });
+}
+
+TEST_CASE("Entries that fail to load get no object", "[WarmLoad]")
+{
+	FakeBackend backend;
+	backend.cached = { { { ShaderClass::Vertex, 1 }, 10 }, { { ShaderClass::Vertex, 2 }, 0 } };
+
+	WarmLoad warmLoad(backend);
+	const uint32_t descriptors[] = { 1, 2 };
+	warmLoad.Enumerate(ShaderClass::Vertex, descriptors, {});
+	warmLoad.Load();
+	warmLoad.Create(ShaderClass::Vertex);
+
+	const auto& entries = warmLoad.GetEntries();
+	REQUIRE(entries.size() == 2);
+	REQUIRE(entries[0].blob);
+	REQUIRE(entries[0].hash == 10);
+	REQUIRE(entries[1].blob == nullptr);
+	REQUIRE(backend.creates.size() == 1);
+	REQUIRE(backend.creates.contains({ ShaderClass::Vertex, 10 }));
+}
+
+TEST_CASE("Permutations of the same bytecode share one new object", "[WarmLoad]")
+{
+	FakeBackend backend;
+	backend.cached = {
+		{ { ShaderClass::Vertex, 1 }, 10 },
+		{ { ShaderClass::Vertex, 2 }, 10 },
+		{ { ShaderClass::Vertex, 3 }, 30 },
+		{ { ShaderClass::Vertex, 4 }, 40 },
+		{ { ShaderClass::Pixel, 1 }, 10 },
+	};
+	backend.objects = { { ShaderClass::Vertex, 40 } };
+
+	WarmLoad warmLoad(backend);
+	const uint32_t descriptors[] = { 1, 2, 3, 4 };
+	warmLoad.Enumerate(ShaderClass::Vertex, descriptors, {});
+	warmLoad.Enumerate(ShaderClass::Pixel, descriptors, {});
+	warmLoad.Load();
+	warmLoad.Create(ShaderClass::Vertex);
+	warmLoad.Create(ShaderClass::Pixel);
+
+	// bytecode 40 is shared with a loaded permutation instead
+	REQUIRE(backend.creates == std::map<std::pair<ShaderClass, uint64_t>, int>{
+								   { { ShaderClass::Vertex, 10 }, 1 },
+								   { { ShaderClass::Vertex, 30 }, 1 },
+								   { { ShaderClass::Pixel, 10 }, 1 },
+							   });
+
+	auto object = warmLoad.TakeObject(ShaderClass::Vertex, 10);
+	REQUIRE(object);
+	REQUIRE(object->shaderClass == ShaderClass::Vertex);
+	REQUIRE(warmLoad.TakeObject(ShaderClass::Vertex, 10) == nullptr);
+	REQUIRE(warmLoad.TakeObject(ShaderClass::Vertex, 40) == nullptr);
+	REQUIRE(warmLoad.TakeObject(ShaderClass::Pixel, 10)->shaderClass == ShaderClass::Pixel);
+}
+
+TEST_CASE("Objects the device rejects are not handed out", "[WarmLoad]")
+{
+	FakeBackend backend;
+	backend.cached = { { { ShaderClass::Pixel, 1 }, 10 }, { { ShaderClass::Pixel, 2 }, 20 } };
+	backend.rejected = { 20 };
+
+	WarmLoad warmLoad(backend);
+	const uint32_t descriptors[] = { 1, 2 };
+	warmLoad.Enumerate(ShaderClass::Pixel, descriptors, {});
+	warmLoad.Load();
+	warmLoad.Create(ShaderClass::Pixel);
+
+	REQUIRE(warmLoad.TakeObject(ShaderClass::Pixel, 20) == nullptr);
+	REQUIRE(warmLoad.TakeObject(ShaderClass::Pixel, 10));
+}
+
+TEST_CASE("Objects that are not taken are released", "[WarmLoad]")
+{
+	FakeBackend backend;
+	backend.cached = { { { ShaderClass::Pixel, 1 }, 10 }, { { ShaderClass::Pixel, 2 }, 20 }, { { ShaderClass::Pixel, 3 }, 30 } };
+	backend.rejected = { 30 };
+
+	{
+		WarmLoad warmLoad(backend);
+		const uint32_t descriptors[] = { 1, 2, 3 };
+		warmLoad.Enumerate(ShaderClass::Pixel, descriptors, {});
+		warmLoad.Load();
+		warmLoad.Create(ShaderClass::Pixel);
+		REQUIRE(warmLoad.TakeObject(ShaderClass::Pixel, 10));
+	}
+
+	// only the object of 20, the taken one belongs to the caller and 30 was never created
+	REQUIRE(backend.releases == 1);
+}